@@ -157,6 +157,29 @@ void xPortSysTickHandler( void )
     portCLEAR_INTERRUPT_MASK_FROM_ISR( isrstate );
 }
 
+#if configGENERATE_RUN_TIME_STATS == 1
+/*
+ * Run-time stats counter: the 24-bit RTC counter (at the tick rate) extended
+ * to 32 bits.  It is read at least on every context switch, so well within
+ * the 24-bit wrap (the longest tickless sleep is limited to less than that).
+ */
+uint32_t ulPortGetRunTimeCounterValue( void )
+{
+    static uint32_t last = 0;
+    static uint32_t high = 0;
+    uint32_t isrstate = portSET_INTERRUPT_MASK_FROM_ISR();
+    uint32_t counter = nrf_rtc_counter_get(portNRF_RTC_REG);
+    if (counter < last)
+    {
+        high += portNRF_RTC_MAXTICKS + 1;
+    }
+    last = counter;
+    uint32_t value = high | counter;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( isrstate );
+    return value;
+}
+#endif
+
 /*
  * Setup the RTC time to generate the tick interrupts at the required
  * frequency.
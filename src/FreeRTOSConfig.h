@@ -33,6 +33,9 @@
   #include "nrf_soc.h"
 #endif
 #include "app_util_platform.h"
+#if !(defined(__ASSEMBLY__) || defined(__ASSEMBLER__))
+  #include "cueband.h" /* CUEBAND_TASK_PROFILE */
+#endif
 
 /*-----------------------------------------------------------
  * Possible configurations for system timer
@@ -83,7 +86,15 @@
 #define configUSE_MALLOC_FAILED_HOOK   0
 
 /* Run time and task stats gathering related definitions. */
+/* Only for the task profile, as the counter is read on every context switch */
+#ifdef CUEBAND_TASK_PROFILE
+/* Run-time counter: RTC1 (the tick source, 1024 Hz) extended to 32 bits, see port_cmsis_systick.c */
+#define configGENERATE_RUN_TIME_STATS        1
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE() ulPortGetRunTimeCounterValue()
+#else
 #define configGENERATE_RUN_TIME_STATS        0
+#endif
 #define configUSE_TRACE_FACILITY             1
 #define configUSE_STATS_FORMATTING_FUNCTIONS 0
 
@@ -180,6 +191,11 @@ standard names - or at least those used in the unmodified vector table. */
     #error "This port requires __NVIC_PRIO_BITS to be defined"
   #endif
 
+  #if configGENERATE_RUN_TIME_STATS == 1
+    #include <stdint.h>
+uint32_t ulPortGetRunTimeCounterValue(void);
+  #endif
+
   /* Access to current system core clock is required only if we are ticking the system by systimer */
   #if (configTICK_SOURCE == FREERTOS_USE_SYSTICK)
     #include <stdint.h>
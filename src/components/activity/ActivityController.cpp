@@ -18,6 +18,22 @@ using namespace Pinetime::Controllers;
 
 #define ACTIVITY_DATA_FILENAME "ACTV%04d.BIN"
 
+#ifdef CUEBAND_ACTIVITY_RAW_LOG
+static_assert(RAW_LOG_BLOCK_SIZE == ACTIVITY_BLOCK_SIZE, "Raw log slots must be activity blocks");
+
+static int raw_log_fs_read(void *context, uint32_t offset, uint8_t *buffer, size_t size) {
+  return static_cast<Pinetime::Controllers::FS*>(context)->RawLogRead(offset, buffer, size);
+}
+
+static int raw_log_fs_program(void *context, uint32_t offset, const uint8_t *buffer, size_t size) {
+  return static_cast<Pinetime::Controllers::FS*>(context)->RawLogProgram(offset, buffer, size);
+}
+
+static int raw_log_fs_erase(void *context, uint32_t offset) {
+  return static_cast<Pinetime::Controllers::FS*>(context)->RawLogErase(offset);
+}
+#endif
+
 #ifdef CUEBAND_DEBUG_ACTIVITY
 static struct {
   int16_t lastX, lastY, lastZ;
@@ -51,6 +67,12 @@ ActivityController::ActivityController(Controllers::Settings& settingsController
 {
 
   resampler_init(&this->resampler, CUEBAND_BUFFER_EFFECTIVE_RATE, ACTIVITY_RATE, 0, CUEBAND_AXES);
+#ifdef CUEBAND_ACTIVITY_RAW_LOG
+  raw_log_init(&this->rawLog, &fs, raw_log_fs_read, raw_log_fs_program, raw_log_fs_erase, CUEBAND_ACTIVITY_RAW_LOG_SECTORS);
+#endif
+#ifdef CUEBAND_DETECT_SLEEP
+  sleep_classifier_init(&this->sleepClassifier, CUEBAND_DETECT_SLEEP);
+#endif
   InitConfig();
 }
 
@@ -214,11 +236,27 @@ bool ActivityController::IsUnmovingActivity() {
 }
 #endif
 
-// Device interaction -- clear wear/face-down detections
+#ifdef CUEBAND_DETECT_SLEEP
+bool ActivityController::IsAsleep() {
+  return isInitialized && sleepClassifier.state == SLEEP_STATE_ASLEEP;
+}
+
+// Classify the epoch, given its activity (mean filtered SVMMO, or 0xffff if invalid)
+void ActivityController::SleepEpoch(uint16_t activity) {
+  if (sleep_classifier_epoch(&sleepClassifier, activity) == SLEEP_STATE_ASLEEP) {
+    epochEvents |= ACTIVITY_EVENT_ASLEEP;
+  }
+}
+#endif
+
+// Device interaction -- clear wear/face-down/sleep detections
 void ActivityController::DeviceInteraction() {
 #ifdef CUEBAND_DETECT_FACE_DOWN
   this->faceDownTime = 0;
 #endif
+#ifdef CUEBAND_DETECT_SLEEP
+  sleep_classifier_reset(&this->sleepClassifier);
+#endif
 #ifdef CUEBAND_DETECT_WEAR_TIME
   for (int chan = 0; chan < CUEBAND_AXES; chan++) {
     this->unmoving[chan] = 0;
@@ -242,105 +280,107 @@ void ActivityController::AddSamples(MotionController &motionController) {
     uptime1024_t now = dateTimeController.Uptime1024();
     unsigned int sampleTicks = lastCount * 1024 / CUEBAND_BUFFER_EFFECTIVE_RATE;
     uptime1024_t firstSampleTime = (now < sampleTicks) ? 0 : (now - sampleTicks);
-    uptime1024_t lastMovement = motorController.GetLastMovement();
-    uptime1024_t overlap = (firstSampleTime < lastMovement) ? (lastMovement - firstSampleTime) : 0;
-
-    // If some of this buffer overlaps the movement, discard the start of the buffer (up to all of it)
-    if (overlap > 0 && overlap < (60 * CUEBAND_BUFFER_EFFECTIVE_RATE * 1024)) {    // Do not believe a large amount of overlap
-      unsigned int skip = ((unsigned int)overlap * CUEBAND_BUFFER_EFFECTIVE_RATE / 1024);
-      if (skip > lastCount) skip = lastCount;
 
+    // Mask each sample that overlaps any recent motor activity
 #if (CUEBAND_DEBUG_TRACK_MOTOR_TIMES == 2 || CUEBAND_DEBUG_TRACK_MOTOR_TIMES == 3 || CUEBAND_DEBUG_TRACK_MOTOR_TIMES == 4)
-      // (Optionally) clear streamed data and do not actually skip the data
-      for (unsigned int i = 0; i < skip; i++) {
+    // (Optionally) clear streamed data and do not actually skip the data
+    for (unsigned int i = 0; i < lastCount; i++) {
+      if (!motorController.GetMovements().IsMasked(firstSampleTime + (uptime1024_t)i * 1024 / CUEBAND_BUFFER_EFFECTIVE_RATE)) continue;
 #if (CUEBAND_DEBUG_TRACK_MOTOR_TIMES == 3 || CUEBAND_DEBUG_TRACK_MOTOR_TIMES == 4)
-        if ((i & 7) >= 7) continue;   // ...in a pattern to visualize overlap
+      if ((i & 7) >= 7) continue;   // ...in a pattern to visualize overlap
 #endif
-        accelValues[CUEBAND_AXES * i + 0] = 0;
-        accelValues[CUEBAND_AXES * i + 1] = 0;
-        accelValues[CUEBAND_AXES * i + 2] = 0;
-      }
+      accelValues[CUEBAND_AXES * i + 0] = 0;
+      accelValues[CUEBAND_AXES * i + 1] = 0;
+      accelValues[CUEBAND_AXES * i + 2] = 0;
+    }
+    AddSampleRun(accelValues, lastCount);
 #else
-      accelValues += skip * CUEBAND_AXES;
-      lastCount -= skip;
+    // Only the unmasked runs of samples are used
+    motorMaskedSamples += motorController.GetMovements().UnmaskedRuns(firstSampleTime, CUEBAND_BUFFER_EFFECTIVE_RATE, lastCount, [&](unsigned int first, unsigned int end) {
+      AddSampleRun(accelValues + CUEBAND_AXES * first, end - first);
+    });
 #endif
-    }
+#else
+    AddSampleRun(accelValues, lastCount);
 #endif
+  }
+}
 
+// Add a contiguous run of samples at the original source rate
+void ActivityController::AddSampleRun(int16_t *accelValues, unsigned int lastCount) {
 #ifdef CUEBAND_ACTIVITY_STATS
-    for (unsigned int i = 0; i < lastCount; i++) {
+  for (unsigned int i = 0; i < lastCount; i++) {
 
-      // At 1 Hz
-      if (this->statsIndex < 0 || this->statsIndex >= CUEBAND_BUFFER_EFFECTIVE_RATE) {
-        // If we have data (not just the initial state)
-        if (this->statsIndex >= 0) {
+    // At 1 Hz
+    if (this->statsIndex < 0 || this->statsIndex >= CUEBAND_BUFFER_EFFECTIVE_RATE) {
+      // If we have data (not just the initial state)
+      if (this->statsIndex >= 0) {
 #ifdef CUEBAND_DETECT_FACE_DOWN
-          // min/max of x < 0.4, y < 0.4, z > 0.9
-          bool isFaceDown =    this->statsMin[0] <= CUEBAND_SCALE_MILLI_G(400) && this->statsMax[0] <= CUEBAND_SCALE_MILLI_G(400)   // x <= 0.4 g
-                            && this->statsMin[1] <= CUEBAND_SCALE_MILLI_G(400) && this->statsMax[1] <= CUEBAND_SCALE_MILLI_G(400)   // y <= 0.4 g
-                            && this->statsMin[2] >= CUEBAND_SCALE_MILLI_G(900) && this->statsMax[2] >= CUEBAND_SCALE_MILLI_G(900)   // z >= 0.9 g
-                            ;
-          if (isFaceDown) {
-            this->faceDownTime++;
-          } else {
-            this->faceDownTime = 0;
-          }
+        // min/max of x < 0.4, y < 0.4, z > 0.9
+        bool isFaceDown =    this->statsMin[0] <= CUEBAND_SCALE_MILLI_G(400) && this->statsMax[0] <= CUEBAND_SCALE_MILLI_G(400)   // x <= 0.4 g
+                          && this->statsMin[1] <= CUEBAND_SCALE_MILLI_G(400) && this->statsMax[1] <= CUEBAND_SCALE_MILLI_G(400)   // y <= 0.4 g
+                          && this->statsMin[2] >= CUEBAND_SCALE_MILLI_G(900) && this->statsMax[2] >= CUEBAND_SCALE_MILLI_G(900)   // z >= 0.9 g
+                          ;
+        if (isFaceDown) {
+          this->faceDownTime++;
+        } else {
+          this->faceDownTime = 0;
+        }
 #endif
 #ifdef CUEBAND_DETECT_WEAR_TIME
-          // range <= 0.05 g for at least 2 out of the 3 axes
-          for (int chan = 0; chan < CUEBAND_AXES; chan++) {
-            bool unmoving = (this->statsMax[chan] - this->statsMin[chan]) <= CUEBAND_SCALE_MILLI_G(50);
-            if (unmoving) {
-              this->unmoving[chan]++;
-            } else {
-              this->unmoving[chan] = 0;
-            }
+        // range <= 0.05 g for at least 2 out of the 3 axes
+        for (int chan = 0; chan < CUEBAND_AXES; chan++) {
+          bool unmoving = (this->statsMax[chan] - this->statsMin[chan]) <= CUEBAND_SCALE_MILLI_G(50);
+          if (unmoving) {
+            this->unmoving[chan]++;
+          } else {
+            this->unmoving[chan] = 0;
           }
-#endif
-          ;
         }
-        // Reset stats
-        this->statsIndex = 0;
+#endif
+        ;
       }
+      // Reset stats
+      this->statsIndex = 0;
+    }
 
-      // Add current stats
-      for (int chan = 0; chan < CUEBAND_AXES; chan++) {
-        int value = accelValues[CUEBAND_AXES * i + chan];
-        if (this->statsIndex == 0 || value < this->statsMin[chan]) this->statsMin[chan] = value;
-        if (this->statsIndex == 0 || value > this->statsMax[chan]) this->statsMax[chan] = value;
-      }
-      
-      this->statsIndex++;
+    // Add current stats
+    for (int chan = 0; chan < CUEBAND_AXES; chan++) {
+      int value = accelValues[CUEBAND_AXES * i + chan];
+      if (this->statsIndex == 0 || value < this->statsMin[chan]) this->statsMin[chan] = value;
+      if (this->statsIndex == 0 || value > this->statsMax[chan]) this->statsMax[chan] = value;
     }
     
+    this->statsIndex++;
+  }
+  
 #endif
 
 #if (CUEBAND_BUFFER_EFFECTIVE_RATE == ACTIVITY_RATE)
-    #if defined(CUEBAND_STREAM_RESAMPLED)
-      unsigned int count = (lastCount > ACTIVITY_RESAMPLE_BUFFER_SIZE) ? ACTIVITY_RESAMPLE_BUFFER_SIZE : lastCount;
-      memcpy(this->outputBuffer, accelValues, count * CUEBAND_AXES * sizeof(accelValues[0]));
-      this->lastCount = count;
-      this->totalSamples += count;
-    #endif
-    for (unsigned int i = 0; i < lastCount; i++) {
-      AddSingleSample(accelValues[CUEBAND_AXES * i + 0], accelValues[CUEBAND_AXES * i + 1], accelValues[CUEBAND_AXES * i + 2]);
-    }
+  #if defined(CUEBAND_STREAM_RESAMPLED)
+    unsigned int count = (lastCount > ACTIVITY_RESAMPLE_BUFFER_SIZE) ? ACTIVITY_RESAMPLE_BUFFER_SIZE : lastCount;
+    memcpy(this->outputBuffer, accelValues, count * CUEBAND_AXES * sizeof(accelValues[0]));
+    this->lastCount = count;
+    this->totalSamples += count;
+  #endif
+  for (unsigned int i = 0; i < lastCount; i++) {
+    AddSingleSample(accelValues[CUEBAND_AXES * i + 0], accelValues[CUEBAND_AXES * i + 1], accelValues[CUEBAND_AXES * i + 2]);
+  }
 #else
-    // Filter/resample data to a rate of (ACTIVITY_RATE) Hz
-    resampler_input(&resampler, accelValues, lastCount);
-    
-    size_t outputCount;
-    while ((outputCount = resampler_output(&resampler, this->outputBuffer, sizeof(this->outputBuffer) / sizeof(this->outputBuffer[0]) / CUEBAND_AXES)) != 0) {  // ACTIVITY_RESAMPLE_BUFFER_SIZE
-      const int16_t *out = this->outputBuffer;
-      for (unsigned int i = 0; i < outputCount; i++) {
-        AddSingleSample(out[0], out[1], out[2]);
-        out += CUEBAND_AXES;
-      }
-      this->lastCount = outputCount;
-      this->totalSamples += outputCount;
+  // Filter/resample data to a rate of (ACTIVITY_RATE) Hz
+  resampler_input(&resampler, accelValues, lastCount);
+  
+  size_t outputCount;
+  while ((outputCount = resampler_output(&resampler, this->outputBuffer, sizeof(this->outputBuffer) / sizeof(this->outputBuffer[0]) / CUEBAND_AXES)) != 0) {  // ACTIVITY_RESAMPLE_BUFFER_SIZE
+    const int16_t *out = this->outputBuffer;
+    for (unsigned int i = 0; i < outputCount; i++) {
+      AddSingleSample(out[0], out[1], out[2]);
+      out += CUEBAND_AXES;
     }
-#endif
+    this->lastCount = outputCount;
+    this->totalSamples += outputCount;
   }
+#endif
 }
 #endif
 
@@ -376,6 +416,10 @@ void ActivityController::AddSingleSample(int16_t x, int16_t y, int16_t z) {
 #endif
   epochSumSvmMO += abs_svmmo;
   epochSumCount++;
+#ifdef CUEBAND_HR_LOGGER
+  int16_t axes[3] = { x, y, z };
+  axis_stats_add(&epochAxisStats, axes);
+#endif
 
 #ifdef CUEBAND_DEBUG_ACTIVITY
   activity_debug_info.lastX = x;
@@ -403,6 +447,13 @@ void ActivityController::StartEpoch() {
   epochSumCount = 0;
   epochEvents = 0x0000;
   epochSteps = 0;
+#ifdef CUEBAND_HR_LOGGER
+  axis_stats_reset(&epochAxisStats);
+  #ifdef CUEBAND_DETECT_SLEEP
+    epochSumMicroActivity = 0;
+    epochCountMicroActivity = 0;
+  #endif
+#endif
   epochPromptCount = 0;
   epochSnoozeMutedPromptCount = 0;
   epochUnwornMutedPromptCount = 0;
@@ -479,8 +530,23 @@ bool ActivityController::WriteMicroEpoch() {
       meanSvmMO = 0xffff;
     }
 
+#ifdef CUEBAND_DETECT_SLEEP
+    if (meanFilteredSvmMO != 0xffff) {
+      epochSumMicroActivity += meanFilteredSvmMO;
+      epochCountMicroActivity++;
+    }
+#endif
+
     int stepCount = (epochSteps > 31) ? 31 : epochSteps;
 
+#ifdef CUEBAND_HR_EPOCH
+    // HR confidence: consecutive stable BPM updates (saturates at 7, 0=no reading)
+    int hrConfidence = hasData ? heartRateController.HrStableCount() : 0;
+    if (hrConfidence > 7) hrConfidence = 7;
+#else
+    int hrConfidence = 0;
+#endif
+
     // Reset micro epoch stats
 #ifdef CUEBAND_ACTIVITY_HIGH_PASS
     epochSumFilteredSvmMO = 0;
@@ -497,7 +563,7 @@ bool ActivityController::WriteMicroEpoch() {
     data[0] = (unsigned char)(meanFilteredSvmMO & 0xff);
     data[1] = (unsigned char)((meanFilteredSvmMO >> 8) & 0xff);
     data[2] = (unsigned char)meanBpm;
-    data[3] = (unsigned char)(stepCount);
+    data[3] = (unsigned char)((hrConfidence << 5) | stepCount);
 
     written = true;
   }
@@ -516,10 +582,33 @@ bool ActivityController::WriteEpoch() {
     // Epoch summary data
     memset(data, 0xff, MICRO_EPOCH_OFFSET); // @0-25
 
-    // TODO: Additional summary fields (@0-@25)
-    // * (6 bytes) mean x/y/z (e.g. calibration stationary points, orientation)
-    // * (6 bytes) SD x/y/z (for wear-time and calibration stationary points)
-    // * (6 bytes) ??? unfiltered axis magnitude x/y/z
+    if (format >= CUEBAND_FORMAT_VERSION_MICRO_EPOCHS_STATS_0081) {
+      axis_stats_summary_t summary;
+      axis_stats_summary(&epochAxisStats, &summary);
+      for (int i = 0; i < 3; i++) {
+        data[0 + 2 * i] = (uint8_t)summary.mean[i]; data[1 + 2 * i] = (uint8_t)((uint16_t)summary.mean[i] >> 8);   // @0  (6 bytes) mean x/y/z (e.g. calibration stationary points, orientation)
+        data[6 + 2 * i] = (uint8_t)summary.sd[i]; data[7 + 2 * i] = (uint8_t)(summary.sd[i] >> 8);                   // @6  (6 bytes) SD x/y/z (for wear-time and calibration stationary points)
+        data[12 + 2 * i] = (uint8_t)summary.meanAbs[i]; data[13 + 2 * i] = (uint8_t)(summary.meanAbs[i] >> 8);       // @12 (6 bytes) mean abs x/y/z (unfiltered axis magnitude)
+      }
+      uint16_t count = summary.count > 0xffff ? 0xffff : (uint16_t)summary.count;
+      data[18] = (uint8_t)count; data[19] = (uint8_t)(count >> 8);                                                 // @18 (2 bytes) sample count
+    }
+
+#ifdef CUEBAND_DETECT_SLEEP
+    // Sleep classification from the mean of the micro-epoch activity (invalid if fewer than half were valid)
+    uint32_t sleepActivity = 0xffff;
+    if (epochCountMicroActivity > 0 && epochCountMicroActivity * 2 >= MICRO_EPOCH_COUNT) {
+      sleepActivity = epochSumMicroActivity / epochCountMicroActivity;
+      if (sleepActivity > 0xfffe) sleepActivity = 0xfffe;
+    }
+    SleepEpoch((uint16_t)sleepActivity);
+    if (format >= CUEBAND_FORMAT_VERSION_MICRO_EPOCHS_STATS_0081) {
+      data[20] = (uint8_t)sleepClassifier.state;                                                                  // @20 (1 byte) sleep state (0=unknown, 1=awake, 2=asleep; 0xff=not classified)
+    }
+#endif
+    // @21 (5 bytes) reserved (0xff)
+
+    // TODO: Additional summary fields (@21-@25)
     // * (6 bytes) ??? filtered axis magnitude x/y/z
     // * (2 bytes) ??? steps / HR signal reliability (swap with steps in micro epoch???)
 
@@ -576,9 +665,6 @@ bool ActivityController::WriteEpoch() {
     steps |= (epochSnoozeMutedPromptCount > 3 ? 3 : epochSnoozeMutedPromptCount) << 10;
     steps |= (epochSteps > 1023) ? 1023 : epochSteps;
 
-    // @0 Event flags
-    data[0] = (uint8_t)epochEvents; data[1] = (uint8_t)(epochEvents >> 8);
-
     // @2 Lower 10-bits: step count; next 2-bits: snooze-muted prompt count (0-3, saturates); next 2-bits: unworn-muted prompt count (0-3, saturates); top 2-bits: prompt count (0-3, saturates).
     data[2] = (uint8_t)steps; data[3] = (uint8_t)(steps >> 8);
 
@@ -618,6 +704,18 @@ bool ActivityController::WriteEpoch() {
       meanSvmMO = 0xffff;
     }
 
+#ifdef CUEBAND_DETECT_SLEEP
+    // Sleep classification (sets the event flag for this epoch)
+  #ifdef CUEBAND_ACTIVITY_HIGH_PASS
+    SleepEpoch((uint16_t)meanFilteredSvmMO);
+  #else
+    SleepEpoch((uint16_t)meanSvmMO);
+  #endif
+#endif
+
+    // @0 Event flags
+    data[0] = (uint8_t)epochEvents; data[1] = (uint8_t)(epochEvents >> 8);
+
     // @4 Mean of the SVM values for the entire epoch
     if (format == CUEBAND_FORMAT_VERSION_ORIGINAL_ACTIVITY_0002) {
       #ifdef CUEBAND_ACTIVITY_HIGH_PASS
@@ -674,6 +772,30 @@ void ActivityController::TimeChanged(uint32_t time) {
   if (hrmInterval > 0) {
     hrEpochOffset = currentTime % hrmInterval;
     hrWithinSampling = (hrEpochOffset < hrmDuration);
+#ifdef CUEBAND_HR_EPOCH_ADAPTIVE
+    // Adaptive duty cycling (only when not sampling continuously)
+    if (hrmDuration < hrmInterval) {
+      uint32_t window = currentTime / hrmInterval;
+      if (window != hrWindow) {
+        hrWindow = window;
+        hrWindowDone = false;
+      }
+      // End the window early once the reading is stable
+      if (!hrWindowDone && heartRateController.IsHrEpoch() && heartRateController.HrStableCount() >= CUEBAND_HR_ADAPTIVE_STABLE) {
+        hrWindowDone = true;
+      }
+      if (hrWindowDone) {
+        if (hrWithinSampling) hrAdaptiveSaved++;
+        hrWithinSampling = false;
+      } else if (!hrWithinSampling && heartRateController.IsHrEpoch() && hrEpochOffset < (uint32_t)hrmDuration + CUEBAND_HR_ADAPTIVE_EXTEND) {
+        // Extend an unstable window while moving
+        if (epochSumCount > 0 && epochSumSvmMO / epochSumCount > CUEBAND_HR_ADAPTIVE_MOTION) {
+          hrWithinSampling = true;
+          hrAdaptiveExtended++;
+        }
+      }
+    }
+#endif
   }
   heartRateController.SetHrEpoch(hrWithinSampling);
 #endif
@@ -702,6 +824,9 @@ void ActivityController::TimeChanged(uint32_t time) {
       // If the block is full, or we're not in the correct sequence (e.g. the time changed)...
       if (countEpochs >= ACTIVITY_MAX_SAMPLES || epochNow - blockEpoch != countEpochs) {
         FlushBlock();
+#ifdef CUEBAND_ACTIVITY_RECORDS
+        WriteRecords();
+#endif
         StartNewBlock();
       } else {
         StartEpoch();
@@ -744,9 +869,14 @@ bool ActivityController::DeleteFile(int file) {
 }
 
 void ActivityController::DestroyData() {
+#ifdef CUEBAND_ACTIVITY_RAW_LOG
+  FinishedReading();
+  raw_log_format(&rawLog);
+#else
   for (int file = 0; file < CUEBAND_ACTIVITY_FILES; file++) {
     DeleteFile(file);
   }
+#endif
 
   // Erase config file and use default config
   fs.FileDelete(ACTIVITY_CONFIG_FILENAME);
@@ -786,7 +916,7 @@ bool ActivityController::FinalizeBlock(uint32_t logicalIndex) {
     activeBlock[23] = hrmDuration > 255 ? 255 : hrmDuration;
     activeBlock[24] = 0xff;
     activeBlock[25] = 0xff;
-  } else if (format == CUEBAND_FORMAT_VERSION_MICRO_EPOCHS_0080) {
+  } else if (format == CUEBAND_FORMAT_VERSION_MICRO_EPOCHS_0080 || format == CUEBAND_FORMAT_VERSION_MICRO_EPOCHS_STATS_0081) {
     activeBlock[22] = hrmInterval > 255 ? 255 : hrmInterval;
     activeBlock[23] = hrmDuration > 255 ? 255 : hrmDuration;
     activeBlock[24] = 0xff;
@@ -847,11 +977,15 @@ bool ActivityController::OpenFileReading(int file) {
 }
 
 uint32_t ActivityController::BlockCount() {
+#ifdef CUEBAND_ACTIVITY_RAW_LOG
+  return rawLog.count;
+#else
   uint32_t countBlocks = 0;
   for (int file = 0; file < CUEBAND_ACTIVITY_FILES; file++) {
     countBlocks += meta[file].blockCount;
   }
   return countBlocks;
+#endif
 }
 
 uint32_t ActivityController::EarliestLogicalBlock() {
@@ -1013,6 +1147,15 @@ bool ActivityController::ReadLogicalBlock(uint32_t logicalBlockNumber, uint8_t *
     return true;
   }
 
+#ifdef CUEBAND_ACTIVITY_RAW_LOG
+  // Direct from the log (fills the buffer with 0xff if not held or not valid)
+  if (!raw_log_read(&rawLog, logicalBlockNumber, buffer)) {
+    errRead++;
+    errReadLogicalLast = 5;
+    return false;
+  }
+  return true;
+#else
   // Find physical block location
   int physicalFile = -1;
   uint32_t physicalBlockNumber = LogicalBlockToPhysicalBlock(logicalBlockNumber, &physicalFile);
@@ -1031,6 +1174,7 @@ bool ActivityController::ReadLogicalBlock(uint32_t logicalBlockNumber, uint8_t *
   }
 
   return true;
+#endif
 }
 
 
@@ -1102,6 +1246,9 @@ void ActivityController::DebugTextConfig(char *debugText) {
   p += sprintf(p, "fmt:%04X e:%d\n", format, epochInterval);
   p += sprintf(p, "hr:%d/%d\n", hrmInterval, hrmDuration);
   p += sprintf(p, "samp:%s @%d\n", hrWithinSampling ? "t" : "f", (int)hrEpochOffset);
+#ifdef CUEBAND_HR_EPOCH_ADAPTIVE
+  p += sprintf(p, "adpt:%s -%d +%d\n", hrWindowDone ? "t" : "f", (int)hrAdaptiveSaved, (int)hrAdaptiveExtended);
+#endif
   
   // Get heart rate tracker stats and clear
   int meanBpm = -1, minBpm = -1, maxBpm = -1;
@@ -1160,6 +1307,9 @@ void ActivityController::DebugText(char *debugText, bool additionalInfo) {
 
 #ifdef CUEBAND_DEBUG_ACTIVITY
     p += sprintf(p, "#:%u e:%u/%u\n", (unsigned int)epochSumCount, (unsigned int)(currentTime - epochStartTime), (unsigned int)epochInterval);
+#ifdef CUEBAND_TRACK_MOTOR_TIMES
+    p += sprintf(p, "mm:%u\n", (unsigned int)motorMaskedSamples);
+#endif
     p += sprintf(p, "%+4d%+4d%+4d\n", activity_debug_info.lastX, activity_debug_info.lastY, activity_debug_info.lastZ);
     p += sprintf(p, "SSq:%u\n", (unsigned int)activity_debug_info.lastSumSquares);
     p += sprintf(p, "SVM:%u\n", (unsigned int)activity_debug_info.lastSVM);
@@ -1196,6 +1346,40 @@ bool ActivityController::FlushBlock() {
   return written;
 }
 
+#ifdef CUEBAND_ACTIVITY_RECORDS
+// The record must fit before the spare bytes that FinalizeBlock() fills
+static_assert(ACTIVITY_RECORD_MAX <= ACTIVITY_MAX_SAMPLES * ACTIVITY_SAMPLE_SIZE, "ACTIVITY_RECORD_MAX too large for the block payload");
+
+bool ActivityController::QueueRecord(uint16_t recordFormat, const uint8_t *data, size_t length) {
+  if (!isInitialized || length > ACTIVITY_RECORD_MAX || countRecords >= ACTIVITY_RECORD_PENDING) return false;
+  records[countRecords].format = recordFormat;
+  records[countRecords].length = (uint8_t)length;
+  memcpy(records[countRecords].data, data, length);
+  countRecords++;
+  return true;
+}
+
+// Each record is written through the active block (its contents are discarded by the following StartNewBlock())
+void ActivityController::WriteRecords() {
+  if (countRecords <= 0) return;
+  uint16_t blockFormat = format;
+  for (int i = 0; i < countRecords; i++) {
+    memset(activeBlock + ACTIVITY_HEADER_SIZE, 0xff, ACTIVITY_PAYLOAD_SIZE);
+    memcpy(activeBlock + ACTIVITY_HEADER_SIZE, records[i].data, records[i].length);
+    format = records[i].format;
+    blockStartTime = currentTime;
+    countEpochs = records[i].length;    // @20 is the record length
+    if (WriteActiveBlock()) {
+      activeBlockLogicalIndex++;
+    } else {
+      errWrite++;
+    }
+  }
+  format = blockFormat;
+  countRecords = 0;
+}
+#endif
+
 // Write block: seek to block location (append additional bytes if location after end, or wrap-around if file maximum size or no more drive space)
 bool ActivityController::WriteActiveBlock() {
 
@@ -1207,6 +1391,18 @@ bool ActivityController::WriteActiveBlock() {
 
   FinalizeBlock(activeBlockLogicalIndex);
 
+#ifdef CUEBAND_ACTIVITY_RAW_LOG
+  errWriteLast = 0;
+  bool written = raw_log_append(&rawLog, activeBlockLogicalIndex, activeBlock);
+  if (!written) {
+    errWriteLast = 11;
+    // A failed program still uses the index, so continue with the next one
+    if (rawLog.headIndex == activeBlockLogicalIndex) activeBlockLogicalIndex++;
+  }
+  errWriteLastInitial = errWriteLast;
+  countEpochs = 0;
+  return written;
+#else
   // If the index is just past the end of the file, and not greater than maximum size...
   if (meta[activeFile].blockCount >= CUEBAND_ACTIVITY_MAXIMUM_BLOCKS) {
     // Wrap to oldest file
@@ -1238,6 +1434,7 @@ bool ActivityController::WriteActiveBlock() {
   countEpochs = 0;
 
   return written;
+#endif
 }
 
 bool ActivityController::IsSampling() {
@@ -1276,6 +1473,25 @@ void ActivityController::SensorValues(int8_t battery, int8_t temperature) { // (
 // Scan for most recent logical block and its physical index, returns if data successfully continued
 bool ActivityController::InitialFileScan() {
 
+#ifdef CUEBAND_ACTIVITY_RAW_LOG
+  // Find the newest block in the log, continuing with the next logical block
+  errScan = 0;
+  if (!raw_log_recover(&rawLog)) {
+    errScan = 0x40;   // diagnostic: log not consistent
+    DestroyData();
+    return false;
+  }
+  if (rawLog.headIndex == RAW_LOG_INVALID) {
+    raw_log_format(&rawLog);    // Empty: remove anything else from the region (e.g. an earlier file system)
+    activeBlockLogicalIndex = 0;
+  } else {
+    activeBlockLogicalIndex = rawLog.headIndex + 1;
+  }
+  activeFile = 0;
+  isInitialized = true;
+  StartNewBlock();
+  return true;
+#else
   // Determine metadata for each file
   for (int file = 0; file < CUEBAND_ACTIVITY_FILES; file++) {
     int err = 0;
@@ -1371,6 +1587,7 @@ bool ActivityController::InitialFileScan() {
   }
 
   return !anyErrors;
+#endif
 }
 
 
@@ -2,6 +2,11 @@
 
 #include "cueband.h"
 #include "resampler.h"
+#include "axisstats.h"
+#include "sleepclassifier.h"
+#ifdef CUEBAND_ACTIVITY_RAW_LOG
+#include "rawlog.h"
+#endif
 
 #ifdef CUEBAND_ACTIVITY_ENABLED
 
@@ -143,7 +148,10 @@ namespace Pinetime {
       bool IsUnmovingActivity();
       unsigned int unmoving[CUEBAND_AXES] = {0};
 #endif
-      // Device interaction -- clear wear/face-down detections
+#ifdef CUEBAND_DETECT_SLEEP
+      bool IsAsleep();
+#endif
+      // Device interaction -- clear wear/face-down/sleep detections
       void DeviceInteraction();
 
       uint32_t temp_transmit_count_all = 0;   // TODO: Remove this
@@ -158,6 +166,9 @@ namespace Pinetime {
       void DeferWriteConfig();
       bool FlushBlock(); // New block required (block full, or config changed): if any epochs are stored, write block
       void StartNewBlock();
+#ifdef CUEBAND_ACTIVITY_RECORDS
+      bool QueueRecord(uint16_t recordFormat, const uint8_t *data, size_t length);  // Written as its own block at the next block boundary
+#endif
 
     private:
       Pinetime::Controllers::Settings& settingsController;
@@ -171,6 +182,12 @@ namespace Pinetime {
       // Only for debugging status
       bool hrWithinSampling = false;
       uint32_t hrEpochOffset = 0;
+#ifdef CUEBAND_HR_EPOCH_ADAPTIVE
+      uint32_t hrWindow = 0;          // Current HR sampling window (time / hrmInterval)
+      bool hrWindowDone = false;      // Sampling window ended early with a stable reading
+      uint32_t hrAdaptiveSaved = 0;   // (Debug) Seconds of the sampling windows skipped after a stable reading
+      uint32_t hrAdaptiveExtended = 0; // (Debug) Seconds the sampling windows were extended while moving
+#endif
 #if defined(CUEBAND_DEBUG_PREVIOUS_BPM) && (CUEBAND_DEBUG_PREVIOUS_BPM > 0)
       int debugMeanBpm[CUEBAND_DEBUG_PREVIOUS_BPM] = { -1, -1, -1, -1, -1 };
       int debugDeltaMin[CUEBAND_DEBUG_PREVIOUS_BPM] = { -1, -1, -1, -1, -1 };
@@ -187,6 +204,17 @@ namespace Pinetime {
       bool AppendPhysicalBlock(int physicalFile, uint32_t logicalBlockNumber, uint8_t *buffer);
 
       bool WriteActiveBlock();                    // Write active block
+#ifdef CUEBAND_ACTIVITY_RECORDS
+      void WriteRecords();                        // Write any queued records (between flushing a block and starting the next)
+      #define ACTIVITY_RECORD_MAX 120
+      #define ACTIVITY_RECORD_PENDING 2
+      struct {
+        uint16_t format;
+        uint8_t length;
+        uint8_t data[ACTIVITY_RECORD_MAX];
+      } records[ACTIVITY_RECORD_PENDING];
+      int countRecords = 0;
+#endif
       bool FinalizeBlock(uint32_t logicalIndex);  // Write into buffer (even if partial) -- used before storing/transmitting
 
       bool InitialFileScan();
@@ -221,6 +249,9 @@ namespace Pinetime {
       int WriteConfig();
 
       ActivityMeta meta[CUEBAND_ACTIVITY_FILES] = {0};
+#ifdef CUEBAND_ACTIVITY_RAW_LOG
+      raw_log_t rawLog;             // Blocks are stored in this log rather than the files
+#endif
 
       uint32_t activeBlockLogicalIndex = ACTIVITY_BLOCK_INVALID;
       int activeFile = 0;
@@ -256,6 +287,17 @@ namespace Pinetime {
       uint32_t epochPromptCount = 0;
       uint32_t epochSnoozeMutedPromptCount = 0;
       uint32_t epochUnwornMutedPromptCount = 0;
+      #ifdef CUEBAND_HR_LOGGER
+            axis_stats_t epochAxisStats = {0};  // Per-axis summary over the whole (macro) epoch
+      #endif
+      #ifdef CUEBAND_DETECT_SLEEP
+            sleep_classifier_t sleepClassifier;
+            void SleepEpoch(uint16_t activity);
+            #ifdef CUEBAND_HR_LOGGER
+                  uint32_t epochSumMicroActivity = 0;   // Sum of valid micro-epoch mean filtered SVMMO values
+                  uint32_t epochCountMicroActivity = 0;
+            #endif
+      #endif
 
       // Reading (file stays open until written to, or FinishedReading() called)
       int readingFile = -1;
@@ -273,6 +315,10 @@ namespace Pinetime {
 
 #ifdef CUEBAND_BUFFER_ENABLED
       unsigned int lastTotalSamples = 0;
+      void AddSampleRun(int16_t *accelValues, unsigned int lastCount);
+#endif
+#ifdef CUEBAND_TRACK_MOTOR_TIMES
+      uint32_t motorMaskedSamples = 0;    // (Debug) Samples discarded as overlapping motor activity
 #endif
 
     };
@@ -0,0 +1,83 @@
+// Host test for the per-axis epoch statistics accumulators: compares against a long double reference, including
+// worst-case inputs (full-scale alternating values) over long epochs to check that the accumulators cannot overflow.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "axisstats.h"
+
+typedef int16_t (*generator_t)(uint32_t i, int axis);
+
+static int16_t genFullScale(uint32_t i, int axis) { return (i + axis) & 1 ? 32767 : -32768; }     // Maximum variance and |sum| swings
+static int16_t genNegative(uint32_t i, int axis) { (void)i; (void)axis; return -32768; }           // Maximum negative mean/abs
+static int16_t genStationary(uint32_t i, int axis) { return (int16_t)((axis == 2 ? 4096 : -100 * axis) + (int)(i % 7) - 3); }
+static int16_t genStepChange(uint32_t i, int axis) { return i < 1000 ? -32768 : 32767 - axis; }    // First sample (offset) far from the mean
+static int16_t genRandom(uint32_t i, int axis) { (void)i; (void)axis; return (int16_t)((rand() & 0xffff) - 0x8000); }
+
+static int failures = 0;
+
+static void run(const char *name, generator_t generator, uint32_t count) {
+    axis_stats_t stats;
+    axis_stats_reset(&stats);
+
+    long double sum[AXIS_STATS_AXES] = {0}, sumSquares[AXIS_STATS_AXES] = {0}, sumAbs[AXIS_STATS_AXES] = {0};
+    srand(1);
+    for (uint32_t i = 0; i < count; i++) {
+        int16_t values[AXIS_STATS_AXES];
+        for (int axis = 0; axis < AXIS_STATS_AXES; axis++) {
+            values[axis] = generator(i, axis);
+            sum[axis] += values[axis];
+            sumSquares[axis] += (long double)values[axis] * values[axis];
+            sumAbs[axis] += fabsl((long double)values[axis]);
+        }
+        axis_stats_add(&stats, values);
+    }
+
+    axis_stats_summary_t summary;
+    axis_stats_summary(&stats, &summary);
+
+    bool ok = summary.count == count;
+    for (int axis = 0; axis < AXIS_STATS_AXES; axis++) {
+        long double mean = sum[axis] / count;
+        long double variance = sumSquares[axis] / count - mean * mean;
+        long double sd = variance > 0 ? sqrtl(variance) : 0;
+        long double meanAbs = sumAbs[axis] / count;
+        // Rounded values (allowing for the reference's own rounding error)
+        bool axisOk = fabsl(summary.mean[axis] - mean) <= 0.5L + 1e-6L
+                   && fabsl(summary.sd[axis] - sd) <= 0.5L + 1e-3L
+                   && fabsl(summary.meanAbs[axis] - meanAbs) <= 0.5L + 1e-6L;
+        printf("%-12s n=%-8u axis=%d mean=%6d (%10.3Lf) sd=%5u (%10.3Lf) abs=%5u (%10.3Lf) %s\n", name, count, axis, summary.mean[axis], mean, summary.sd[axis], sd, summary.meanAbs[axis], meanAbs, axisOk ? "OK" : "FAIL");
+        ok &= axisOk;
+    }
+    if (!ok) failures++;
+}
+
+int main(int argc, char *argv[]) {
+    const uint32_t longEpoch = 65535 * 50;     // Longest configurable epoch (seconds) at 50 Hz
+
+    // Empty
+    axis_stats_t stats;
+    axis_stats_reset(&stats);
+    axis_stats_summary_t summary;
+    axis_stats_summary(&stats, &summary);
+    bool emptyOk = summary.count == 0 && summary.sd[0] == AXIS_STATS_INVALID && summary.meanAbs[0] == AXIS_STATS_INVALID;
+    printf("%-12s %s\n", "empty", emptyOk ? "OK" : "FAIL");
+    if (!emptyOk) failures++;
+
+    run("single", genRandom, 1);
+    run("stationary", genStationary, 3000);
+    run("stationary", genStationary, longEpoch);
+    run("random", genRandom, 3000);
+    run("random", genRandom, longEpoch);
+    run("full-scale", genFullScale, 3000);
+    run("full-scale", genFullScale, 3001);
+    run("full-scale", genFullScale, longEpoch);
+    run("negative", genNegative, longEpoch);
+    run("step", genStepChange, 3000);
+    run("step", genStepChange, longEpoch);
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,507 @@
+// Host test and benchmark of the raw circular activity log.
+// On a simulated SPI NOR flash (NOR semantics, busy times, SPI transfer times, vTaskDelay(1) polling while busy, as the
+// DFU write model), checks recovery of the newest and oldest blocks after every append over several wraps of a small
+// region, after a power loss just after erasing a sector for reuse, and after a torn (partly programmed) block.
+// Then compares the raw log with the littlefs files (ACTV%04d.BIN) for the same workload.  littlefs is not built on
+// the host, so its flash accesses are modelled from what lfs.c issues with the FS.cpp configuration (read_size 16,
+// prog_size 8, cache_size 16, lookahead_size 16, 4 KB blocks): opening a file fetches the metadata log; appending to a
+// closed file copies its partly-filled last block into a newly erased block (lfs_ctz_extend()); closing commits to the
+// metadata log (compacting it when full); reading a block walks the CTZ skip-list from the last block (lfs_ctz_find()).
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rawlog.h"
+
+#define FLASH_SIZE (4 * 1024 * 1024)
+#define PAGE_SIZE 256
+#define SECTOR_SIZE 4096
+#define REGION_BASE 0x37F000        // Top of the external flash (129 sectors, the default configuration)
+#define REGION_SECTORS 129          // 4 files x 512 blocks, plus the sector erased ahead
+
+// Flash timing (typical datasheet values for 4 KB erase and 256-byte page program), SPI at 8 MHz
+#define ERASE_US 45000.0
+#define PROGRAM_BASE_US 100.0
+#define PROGRAM_PAGE_US 600.0       // ...plus this scaled by the fraction of the page programmed
+#define SPI_BYTE_US 1.0
+#define SPI_CALL_US 10.0
+#define TICK_US (1000000.0 / 1024)  // vTaskDelay(1)
+
+static uint8_t *memory;
+static double simNow;
+static double busyUntil;
+static unsigned long long bytesRead, bytesProgrammed, bytesErased, commands;
+
+static void spiTransfer(size_t bytes) {
+  simNow += SPI_CALL_US + bytes * SPI_BYTE_US;
+  commands++;
+}
+
+// SpiNorFlash::WaitWriteComplete()
+static void waitWriteComplete() {
+  spiTransfer(2);
+  while (simNow < busyUntil) {
+    simNow = ((unsigned long)(simNow / TICK_US) + 1) * TICK_US;
+    spiTransfer(2);
+  }
+}
+
+static void flashRead(uint32_t address, uint8_t *buffer, size_t size) {
+  spiTransfer(4 + size);
+  if (buffer != NULL) memcpy(buffer, memory + address, size);
+  bytesRead += size;
+}
+
+// SpiNorFlash::Write() within a page
+static void flashProgram(uint32_t address, const uint8_t *buffer, size_t size) {
+  spiTransfer(1);       // Write enable
+  spiTransfer(2);       // ...checked
+  spiTransfer(4 + size);
+  for (size_t i = 0; i < size; i++) memory[address + i] &= buffer ? buffer[i] : 0x00;
+  busyUntil = simNow + PROGRAM_BASE_US + PROGRAM_PAGE_US * size / PAGE_SIZE;
+  waitWriteComplete();
+  bytesProgrammed += size;
+}
+
+static void flashErase(uint32_t address) {
+  spiTransfer(1);
+  spiTransfer(2);
+  spiTransfer(4);
+  memset(memory + (address & ~(SECTOR_SIZE - 1)), 0xff, SECTOR_SIZE);
+  busyUntil = simNow + ERASE_US;
+  waitWriteComplete();
+  bytesErased += SECTOR_SIZE;
+}
+
+// Raw log region access (as the FS::RawLog*() methods)
+static int regionRead(void *context, uint32_t offset, uint8_t *buffer, size_t size) {
+  flashRead(*(uint32_t *)context + offset, buffer, size);
+  return 0;
+}
+
+static int regionProgram(void *context, uint32_t offset, const uint8_t *buffer, size_t size) {
+  uint32_t address = *(uint32_t *)context + offset;
+  while (size > 0) {
+    size_t len = PAGE_SIZE - (address & (PAGE_SIZE - 1));
+    if (len > size) len = size;
+    flashProgram(address, buffer, len);
+    address += len;
+    buffer += len;
+    size -= len;
+  }
+  return 0;
+}
+
+static int regionErase(void *context, uint32_t offset) {
+  flashErase(*(uint32_t *)context + offset);
+  return 0;
+}
+
+// An activity block as ActivityController::FinalizeBlock()
+static void makeBlock(uint8_t *block, uint32_t index) {
+  for (int i = 0; i < RAW_LOG_BLOCK_SIZE; i++) block[i] = (uint8_t)(index * 7 + i);
+  block[0] = 'A'; block[1] = 'D';
+  block[2] = (uint8_t)(RAW_LOG_BLOCK_SIZE - 4); block[3] = (uint8_t)((RAW_LOG_BLOCK_SIZE - 4) >> 8);
+  block[6] = (uint8_t)index; block[7] = (uint8_t)(index >> 8); block[8] = (uint8_t)(index >> 16); block[9] = (uint8_t)(index >> 24);
+  uint16_t sum = 0;
+  for (int i = 0; i < RAW_LOG_BLOCK_SIZE - 2; i += 2) sum += block[i] + ((uint16_t)block[i + 1] << 8);
+  uint16_t checksum = (uint16_t)-sum;
+  block[RAW_LOG_BLOCK_SIZE - 2] = (uint8_t)checksum;
+  block[RAW_LOG_BLOCK_SIZE - 1] = (uint8_t)(checksum >> 8);
+}
+
+static int failures = 0;
+
+// Recover a second log from the flash and compare with the live one, and read back every block held
+static bool checkRecovery(raw_log_t *live, uint32_t *base, const char *label, uint32_t step, uint32_t skipIndex = RAW_LOG_INVALID) {
+  raw_log_t log;
+  raw_log_init(&log, base, regionRead, regionProgram, regionErase, live->sectorCount);
+  bool ok = raw_log_recover(&log);
+  if (!ok || log.headIndex != live->headIndex || log.headSlot != live->headSlot || log.count != live->count) {
+    printf("FAIL: %s @%u: recovered head %u slot %u count %u (ok=%d), expected head %u slot %u count %u\n", label, step,
+      log.headIndex, log.headSlot, log.count, ok, live->headIndex, live->headSlot, live->count);
+    failures++;
+    return false;
+  }
+  uint8_t block[RAW_LOG_BLOCK_SIZE], expected[RAW_LOG_BLOCK_SIZE];
+  uint32_t earliest = raw_log_earliest(&log);
+  for (uint32_t i = 0; i < log.count; i++) {
+    uint32_t index = earliest + i;
+    makeBlock(expected, index);
+    bool read = raw_log_read(&log, index, block);
+    if (index == skipIndex ? read : (!read || memcmp(block, expected, sizeof(block)) != 0)) {
+      printf("FAIL: %s @%u: block %u read back wrongly\n", label, step, index);
+      failures++;
+      return false;
+    }
+  }
+  if ((earliest > 0 && raw_log_read(&log, earliest - 1, block)) || raw_log_read(&log, log.headIndex + 1, block)) {
+    printf("FAIL: %s @%u: read outside the log\n", label, step);
+    failures++;
+    return false;
+  }
+  return true;
+}
+
+static void testRecovery() {
+  const uint32_t sectors = 5;
+  uint32_t base = 0x100000;
+  uint8_t block[RAW_LOG_BLOCK_SIZE];
+  raw_log_t log;
+
+  // Every step over several wraps, starting from a non-zero index
+  raw_log_init(&log, &base, regionRead, regionProgram, regionErase, sectors);
+  memset(memory + base, 0x5a, sectors * SECTOR_SIZE);    // Previous contents
+  raw_log_format(&log);
+  bool ok = true;
+  const uint32_t first = 1000;
+  for (uint32_t i = first; i < first + 6 * sectors * RAW_LOG_BLOCKS_PER_SECTOR && ok; i++) {
+    makeBlock(block, i);
+    if (!raw_log_append(&log, i, block)) { printf("FAIL: append %u\n", i); failures++; ok = false; break; }
+    if (raw_log_append(&log, i + 2, block)) { printf("FAIL: append out of sequence accepted\n"); failures++; ok = false; break; }
+    if (log.count < raw_log_capacity(&log) && i - first + 1 > raw_log_capacity(&log)) { printf("FAIL: holds %u of capacity %u\n", log.count, raw_log_capacity(&log)); failures++; ok = false; break; }
+    ok = checkRecovery(&log, &base, "append", i);
+  }
+  printf("Recovery after each append (%u sectors, %u wraps): %s\n", sectors, 6, ok ? "OK" : "FAIL");
+
+  // Power lost after erasing the next sector for reuse: recovered log skips the blank sector, then continues
+  ok = true;
+  while ((log.headSlot + 1) % RAW_LOG_BLOCKS_PER_SECTOR != 0) {
+    makeBlock(block, log.headIndex + 1);
+    raw_log_append(&log, log.headIndex + 1, block);
+  }
+  uint32_t nextSector = ((log.headSlot + 1) / RAW_LOG_BLOCKS_PER_SECTOR) % sectors;
+  flashErase(base + nextSector * SECTOR_SIZE);
+  if (log.count > raw_log_capacity(&log)) log.count = raw_log_capacity(&log);   // As the append would have discarded
+  ok = checkRecovery(&log, &base, "erased", log.headIndex);
+  raw_log_t recovered;
+  raw_log_init(&recovered, &base, regionRead, regionProgram, regionErase, sectors);
+  raw_log_recover(&recovered);
+  for (int i = 0; i < 40 && ok; i++) {
+    makeBlock(block, recovered.headIndex + 1);
+    ok = raw_log_append(&recovered, recovered.headIndex + 1, block) && checkRecovery(&recovered, &base, "after erased", i);
+  }
+  printf("Recovery after a power loss following a sector erase: %s\n", ok ? "OK" : "FAIL");
+
+  // Torn block mid-sector: its slot and index are used up, the following blocks are kept
+  ok = true;
+  while ((recovered.headSlot + 1) % RAW_LOG_BLOCKS_PER_SECTOR != 5) {
+    makeBlock(block, recovered.headIndex + 1);
+    raw_log_append(&recovered, recovered.headIndex + 1, block);
+  }
+  uint32_t tornIndex = recovered.headIndex + 1;
+  makeBlock(block, tornIndex);
+  uint32_t tornSlot = recovered.headSlot + 1;
+  flashProgram(base + tornSlot * RAW_LOG_BLOCK_SIZE, block, 100);
+  raw_log_init(&log, &base, regionRead, regionProgram, regionErase, sectors);
+  raw_log_recover(&log);
+  if (log.headIndex != tornIndex || log.headSlot != tornSlot) { printf("FAIL: torn block not used up (head %u)\n", log.headIndex); failures++; ok = false; }
+  for (uint32_t i = 1; i <= 3 && ok; i++) {
+    makeBlock(block, tornIndex + i);
+    ok = raw_log_append(&log, tornIndex + i, block) && checkRecovery(&log, &base, "torn", i, tornIndex);
+  }
+  printf("Recovery after a torn block: %s\n", ok ? "OK" : "FAIL");
+
+  // Empty and blank-sector-0 cases
+  raw_log_init(&log, &base, regionRead, regionProgram, regionErase, sectors);
+  raw_log_format(&log);
+  ok = raw_log_recover(&log) && log.headIndex == RAW_LOG_INVALID && log.count == 0 && raw_log_earliest(&log) == RAW_LOG_INVALID;
+  if (!ok) { printf("FAIL: empty log\n"); failures++; }
+  printf("Empty log: %s\n", ok ? "OK" : "FAIL");
+}
+
+// CTZ skip-list layout of a littlefs file (lfs_ctz_index(), lfs_ctz_find())
+#define LFS_BLOCK 4096
+#define LFS_CACHE 16
+#define LFS_LOOKAHEAD_BLOCKS (16 * 8)
+#define LFS_COMMIT_BYTES 32         // CTZ struct tag and data, CRC tag and padding to prog_size
+#define LFS_LIVE_METADATA 200       // Superblock, config file, activity file entries after compaction
+
+static uint32_t ctzPointers(uint32_t index) {
+  return index == 0 ? 0 : (uint32_t)__builtin_ctz(index) + 1;
+}
+
+// Block index and offset within the block of a file position
+static void ctzIndex(uint32_t pos, uint32_t *index, uint32_t *off) {
+  uint32_t i = 0;
+  for (;;) {
+    uint32_t capacity = LFS_BLOCK - 4 * ctzPointers(i);
+    if (pos < capacity) break;
+    pos -= capacity;
+    i++;
+  }
+  *index = i;
+  *off = 4 * ctzPointers(i) + pos;
+}
+
+class LfsModel {
+public:
+  uint32_t fileSize[8] = {0};
+  uint32_t fileHead[8] = {0};           // Address of the last block
+  int openFile = -1;
+  uint32_t readPos = 0xffffffff;
+  uint32_t metaAddr = 0x0B4000, metaUsed = LFS_LIVE_METADATA;
+  uint32_t nextAlloc = 0x0B6000;
+  uint32_t allocs = 0;
+  uint32_t rcacheLine = 0xffffffff;
+
+  // Where the model reads a block of a file from (only the offset within the block affects the accesses)
+  static uint32_t BlockAddress(int file, uint32_t index) {
+    return 0x0B6000 + (file * 64 + index) * LFS_BLOCK;
+  }
+
+  // Reads through the 16-byte read cache
+  void CachedRead(uint32_t address, uint32_t size) {
+    for (uint32_t line = address & ~(LFS_CACHE - 1); line < address + size; line += LFS_CACHE) {
+      if (line != rcacheLine) { flashRead(line, NULL, LFS_CACHE); rcacheLine = line; }
+    }
+  }
+
+  // Reads bypass the cache for the aligned part
+  void DataRead(uint32_t address, uint32_t size) {
+    uint32_t alignedStart = (address + LFS_CACHE - 1) & ~(LFS_CACHE - 1);
+    uint32_t alignedEnd = (address + size) & ~(LFS_CACHE - 1);
+    if (alignedStart > address) CachedRead(address, alignedStart - address);
+    if (alignedEnd > alignedStart) flashRead(alignedStart, NULL, alignedEnd - alignedStart);
+    if (address + size > alignedEnd && alignedEnd >= alignedStart) CachedRead(alignedEnd, address + size - alignedEnd);
+  }
+
+  // Programs through the 16-byte program cache
+  void CachedProgram(uint32_t address, uint32_t size) {
+    while (size > 0) {
+      uint32_t len = LFS_CACHE - (address & (LFS_CACHE - 1));
+      if (len > size) len = size;
+      flashProgram(address, NULL, len);
+      address += len;
+      size -= len;
+    }
+  }
+
+  void FetchMetadata() {
+    rcacheLine = 0xffffffff;
+    CachedRead(metaAddr, 4);
+    CachedRead(metaAddr ^ LFS_BLOCK, 4);
+    CachedRead(metaAddr, metaUsed);
+  }
+
+  void Commit() {
+    CachedProgram(metaAddr + metaUsed, LFS_COMMIT_BYTES);
+    CachedRead(metaAddr + metaUsed, LFS_COMMIT_BYTES);     // CRC check of the commit
+    metaUsed += LFS_COMMIT_BYTES;
+    if (metaUsed + LFS_COMMIT_BYTES > LFS_BLOCK) {
+      metaAddr ^= LFS_BLOCK;
+      flashErase(metaAddr);
+      CachedProgram(metaAddr, LFS_LIVE_METADATA);
+      metaUsed = LFS_LIVE_METADATA;
+    }
+  }
+
+  uint32_t Allocate() {
+    // Lookahead exhausted: traverse the file system for blocks in use
+    if (++allocs % LFS_LOOKAHEAD_BLOCKS == 0) {
+      FetchMetadata();
+      for (int f = 0; f < 8; f++) {
+        uint32_t index, off;
+        if (fileSize[f] == 0) continue;
+        ctzIndex(fileSize[f] - 1, &index, &off);
+        for (uint32_t i = index; i > 0; i -= (i > 1 ? 2 : 1)) CachedRead(BlockAddress(f, i), 8);
+      }
+    }
+    uint32_t address = nextAlloc;
+    nextAlloc += LFS_BLOCK;
+    if (nextAlloc >= REGION_BASE) nextAlloc = 0x0B6000;
+    return address;
+  }
+
+  // lfs_ctz_find() from the last block
+  uint32_t CtzFind(int file, uint32_t targetIndex) {
+    uint32_t current, off;
+    ctzIndex(fileSize[file] - 1, &current, &off);
+    uint32_t steps = 0;
+    while (current > targetIndex) {
+      uint32_t skip = 31 - __builtin_clz(current - targetIndex + 1);
+      uint32_t ctz = __builtin_ctz(current);
+      if (skip > ctz) skip = ctz;
+      CachedRead(BlockAddress(file, current) + 4 * skip, 4);
+      current -= 1u << skip;
+      steps++;
+    }
+    return steps;
+  }
+
+  // ActivityController::AppendPhysicalBlock(): open, write the block, close
+  void Append(int file) {
+    openFile = -1;
+    FetchMetadata();
+    uint32_t pos = fileSize[file];
+    uint32_t remaining = RAW_LOG_BLOCK_SIZE;
+    bool writing = false;
+    while (remaining > 0) {
+      uint32_t index, off;
+      if (pos == 0) { index = 0; off = 0; } else { ctzIndex(pos - 1, &index, &off); off++; }
+      uint32_t address;
+      if (pos == 0) {
+        address = Allocate();
+        flashErase(address);
+      } else if (off >= LFS_BLOCK) {
+        // Last block full: a new block with its skip-list pointers
+        address = Allocate();
+        flashErase(address);
+        index++;
+        CachedRead(fileHead[file], 4 * (ctzPointers(index) - 1));
+        CachedProgram(address, 4 * ctzPointers(index));
+        off = 4 * ctzPointers(index);
+      } else if (!writing) {
+        // Extending a closed file: copy the last block to a new block
+        address = Allocate();
+        flashErase(address);
+        CachedRead(fileHead[file], off);
+        CachedProgram(address, off);
+      } else {
+        address = fileHead[file];
+      }
+      uint32_t len = LFS_BLOCK - off;
+      if (len > remaining) len = remaining;
+      CachedProgram(address + off, len);
+      fileHead[file] = address;
+      pos += len;
+      remaining -= len;
+      writing = true;
+    }
+    fileSize[file] = pos;
+    Commit();
+  }
+
+  // ActivityController::ReadPhysicalBlock(): the file stays open, seeking only if not sequential
+  void Read(int file, uint32_t physicalBlock) {
+    if (openFile != file) {
+      FetchMetadata();
+      openFile = file;
+      readPos = 0xffffffff;
+    }
+    uint32_t pos = physicalBlock * RAW_LOG_BLOCK_SIZE;
+    uint32_t remaining = RAW_LOG_BLOCK_SIZE;
+    while (remaining > 0) {
+      uint32_t index, off;
+      ctzIndex(pos, &index, &off);
+      if (pos != readPos || off == 4 * ctzPointers(index)) CtzFind(file, index);
+      uint32_t len = LFS_BLOCK - off;
+      if (len > remaining) len = remaining;
+      DataRead(BlockAddress(file, index) + off, len);
+      pos += len;
+      remaining -= len;
+      readPos = pos;
+    }
+  }
+
+  // ActivityController::InitialFileScan(): size, first and last block header of each file
+  void Scan(int files) {
+    for (int f = 0; f < files; f++) {
+      openFile = -1;
+      Read(f, 0);
+      Read(f, fileSize[f] / RAW_LOG_BLOCK_SIZE - 1);
+    }
+  }
+};
+
+typedef struct {
+  double us;
+  unsigned long long read, programmed, erased, commands;
+} measure_t;
+
+static measure_t measureStart() {
+  measure_t m = { simNow, bytesRead, bytesProgrammed, bytesErased, commands };
+  return m;
+}
+
+static measure_t measureEnd(measure_t start) {
+  measure_t m = { simNow - start.us, bytesRead - start.read, bytesProgrammed - start.programmed, bytesErased - start.erased, commands - start.commands };
+  return m;
+}
+
+static void report(const char *label, measure_t m, unsigned int count, bool writes) {
+  printf("  %-24s %8.2f ms/op  %7.1f SPI commands/op  %8.1f bytes read/op", label, m.us / 1000 / count, (double)m.commands / count, (double)m.read / count);
+  if (writes) printf("  write amplification %5.2f (programmed) + %5.2f (erased)", (double)m.programmed / count / RAW_LOG_BLOCK_SIZE, (double)m.erased / count / RAW_LOG_BLOCK_SIZE);
+  printf("\n");
+}
+
+static void benchmark() {
+  const int files = 4, blocksPerFile = 512;
+  const unsigned int totalBlocks = files * blocksPerFile;
+  uint8_t block[RAW_LOG_BLOCK_SIZE];
+  measure_t m;
+
+  // Raw log
+  uint32_t base = REGION_BASE;
+  raw_log_t log;
+  raw_log_init(&log, &base, regionRead, regionProgram, regionErase, REGION_SECTORS);
+  raw_log_format(&log);
+  printf("Raw log (%u sectors, %u blocks):\n", REGION_SECTORS, raw_log_capacity(&log));
+  m = measureStart();
+  for (uint32_t i = 0; i < totalBlocks; i++) {
+    makeBlock(block, i);
+    if (!raw_log_append(&log, i, block)) { printf("FAIL: append %u\n", i); failures++; break; }
+  }
+  report("append", measureEnd(m), totalBlocks, true);
+
+  raw_log_t recovered;
+  raw_log_init(&recovered, &base, regionRead, regionProgram, regionErase, REGION_SECTORS);
+  m = measureStart();
+  bool ok = raw_log_recover(&recovered);
+  report("start-up recovery", measureEnd(m), 1, false);
+  if (!ok || recovered.headIndex != totalBlocks - 1 || recovered.count != totalBlocks) { printf("FAIL: recovered head %u count %u\n", recovered.headIndex, recovered.count); failures++; }
+  printf("  (%u blocks read to recover)\n", recovered.probes);
+
+  srand(1);
+  unsigned int reads = 2000, wrong = 0;
+  m = measureStart();
+  for (unsigned int i = 0; i < reads; i++) {
+    uint32_t index = rand() % totalBlocks;
+    if (!raw_log_read(&recovered, index, block) || raw_log_block_index(block) != index) wrong++;
+  }
+  report("random read", measureEnd(m), reads, false);
+  m = measureStart();
+  for (uint32_t i = 0; i < totalBlocks; i++) {
+    if (!raw_log_read(&recovered, i, block)) wrong++;
+  }
+  report("sequential read", measureEnd(m), totalBlocks, false);
+  if (wrong) { printf("FAIL: %u blocks read wrongly\n", wrong); failures++; }
+
+  // littlefs model
+  LfsModel lfs;
+  printf("littlefs files (model, %d files x %d blocks):\n", files, blocksPerFile);
+  m = measureStart();
+  for (int f = 0; f < files; f++) {
+    for (int b = 0; b < blocksPerFile; b++) lfs.Append(f);
+  }
+  report("append", measureEnd(m), totalBlocks, true);
+  m = measureStart();
+  lfs.Scan(files);
+  report("start-up scan", measureEnd(m), 1, false);
+  srand(1);
+  m = measureStart();
+  for (unsigned int i = 0; i < reads; i++) {
+    uint32_t index = rand() % totalBlocks;
+    lfs.Read(index / blocksPerFile, index % blocksPerFile);
+  }
+  report("random read", measureEnd(m), reads, false);
+  m = measureStart();
+  for (int f = 0; f < files; f++) {
+    for (int b = 0; b < blocksPerFile; b++) lfs.Read(f, b);
+  }
+  report("sequential read", measureEnd(m), totalBlocks, false);
+}
+
+int main(int argc, char *argv[]) {
+  memory = (uint8_t *)malloc(FLASH_SIZE);
+  memset(memory, 0xff, FLASH_SIZE);
+
+  testRecovery();
+  benchmark();
+
+  free(memory);
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+// Host test for the epoch-level sleep/wake classifier.
+// Replays a recorded epoch sequence (or a synthetic day/night) through the classifier and reports agreement with a reference.
+//
+// Epoch CSV lines: time,activity[,reference]   (activity is the epoch mean filtered abs(SVM-1) at 1g=4096, 65535=invalid;
+//                                               reference: 1=asleep, 0=awake; non-numeric lines ignored)
+//
+// e.g. from a downloaded 0x0002 log: tools/activity_decode.py log.bin | cut -d, -f1,10
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "sleepclassifier.h"
+
+#ifndef CUEBAND_DETECT_SLEEP
+    #define CUEBAND_DETECT_SLEEP 40
+#endif
+
+typedef struct {
+    sleep_classifier_t classifier;
+    FILE *output;
+
+    unsigned int epochs;
+    unsigned int asleep;
+    unsigned int unknown;
+    // Against the reference
+    unsigned int truePositive, falsePositive, trueNegative, falseNegative;
+    double totalNanos;
+} replay_state_t;
+
+static void processEpoch(replay_state_t *state, double time, unsigned int activity, int reference) {
+    auto start = std::chrono::steady_clock::now();
+    sleep_state_t result = sleep_classifier_epoch(&state->classifier, (uint16_t)(activity > 0xffff ? 0xffff : activity));
+    state->totalNanos += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    state->epochs++;
+    bool asleep = result == SLEEP_STATE_ASLEEP;
+    if (asleep) state->asleep++;
+    if (result == SLEEP_STATE_UNKNOWN) state->unknown++;
+    if (reference >= 0) {
+        if (asleep && reference) state->truePositive++;
+        if (asleep && !reference) state->falsePositive++;
+        if (!asleep && !reference) state->trueNegative++;
+        if (!asleep && reference) state->falseNegative++;
+    }
+    if (state->output != NULL) {
+        fprintf(state->output, "%.0f,%u,%d,%d\n", time, activity, (int)result, reference);
+    }
+}
+
+static int processFile(replay_state_t *state, const char *filename) {
+    FILE *fp = fopen(filename, "rt");
+    if (fp == NULL) {
+        fprintf(stderr, "ERROR: Problem opening epoch file: %s\n", filename);
+        return -1;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        double time = 0;
+        unsigned int activity = 0;
+        int reference = -1;
+        int fields = sscanf(line, "%lf,%u,%d", &time, &activity, &reference);
+        if (fields < 2) continue;   // Header or comment
+        if (fields < 3) reference = -1;
+        processEpoch(state, time, activity, reference);
+    }
+    fclose(fp);
+    return 0;
+}
+
+// Synthetic day: awake 07:00-23:00 (mostly active, with quiet sitting spells), asleep 23:00-07:00 (sensor noise, with brief movements)
+static void processSynthetic(replay_state_t *state, int days) {
+    srand(1);
+    for (int epoch = 0; epoch < days * 24 * 60; epoch++) {
+        int minute = epoch % (24 * 60);
+        bool night = minute < 7 * 60 || minute >= 23 * 60;
+        unsigned int activity;
+        if (night) {
+            activity = 6 + rand() % 10;                                 // Still: ~2-4 mg
+            if (rand() % 45 == 0) activity = 100 + rand() % 200;        // Brief movement
+        } else if (minute % 180 < 30) {
+            activity = 35 + rand() % 60;                                // Sitting quietly (e.g. reading)
+        } else {
+            activity = 80 + rand() % 400;                               // Active
+        }
+        // Sleep onset takes a few minutes in the reference too
+        int reference = night && !(minute >= 23 * 60 && minute < 23 * 60 + 10) ? 1 : 0;
+        processEpoch(state, epoch * 60.0, activity, reference);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *inputFile = NULL;
+    const char *outputFile = NULL;
+    int threshold = CUEBAND_DETECT_SLEEP;
+    int days = 3;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-input") && i + 1 < argc) {
+            inputFile = argv[++i];
+        } else if (!strcmp(argv[i], "-output") && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (!strcmp(argv[i], "-threshold") && i + 1 < argc) {
+            threshold = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-days") && i + 1 < argc) {
+            days = atoi(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "ERROR: Unrecognized parameter: %s\n", argv[i]);
+            fprintf(stderr, "Usage: %s [[-input] epochs.csv | -days 3] [-threshold %d] [-output scored.csv]\n", argv[0], CUEBAND_DETECT_SLEEP);
+            return -1;
+        } else {
+            inputFile = argv[i];
+        }
+    }
+
+    replay_state_t state = {0};
+    sleep_classifier_init(&state.classifier, (uint16_t)threshold);
+
+    if (outputFile != NULL) {
+        state.output = strcmp(outputFile, "-") ? fopen(outputFile, "wt") : stdout;
+        if (state.output == NULL) {
+            fprintf(stderr, "ERROR: Problem opening output file: %s\n", outputFile);
+            return -1;
+        }
+        fprintf(state.output, "time,activity,state,reference\n");
+    }
+
+    if (inputFile != NULL) {
+        if (processFile(&state, inputFile) != 0) return -1;
+    } else {
+        processSynthetic(&state, days);
+    }
+
+    if (state.output != NULL && state.output != stdout) fclose(state.output);
+
+    FILE *report = (state.output == stdout) ? stderr : stdout;
+    fprintf(report, "Epochs: %u, asleep %u (%.1f%%), unknown %u\n", state.epochs, state.asleep, state.epochs ? 100.0 * state.asleep / state.epochs : 0.0, state.unknown);
+    unsigned int compared = state.truePositive + state.falsePositive + state.trueNegative + state.falseNegative;
+    double sensitivity = 0, specificity = 0, accuracy = 0;
+    if (compared > 0) {
+        sensitivity = (state.truePositive + state.falseNegative) ? (double)state.truePositive / (state.truePositive + state.falseNegative) : 1.0;
+        specificity = (state.trueNegative + state.falsePositive) ? (double)state.trueNegative / (state.trueNegative + state.falsePositive) : 1.0;
+        accuracy = (double)(state.truePositive + state.trueNegative) / compared;
+        fprintf(report, "Reference: accuracy %.1f%%, sensitivity (sleep) %.1f%%, specificity (wake) %.1f%% (%u compared)\n", 100 * accuracy, 100 * sensitivity, 100 * specificity, compared);
+    } else {
+        fprintf(report, "Reference: (none)\n");
+    }
+    fprintf(report, "Cost: %.1f ns/epoch (host), classifier %u bytes\n", state.epochs ? state.totalNanos / state.epochs : 0.0, (unsigned int)sizeof(sleep_classifier_t));
+
+    // The synthetic day/night should be classified well
+    if (inputFile == NULL && (sensitivity < 0.90 || specificity < 0.98)) {
+        fprintf(report, "FAILED\n");
+        return 1;
+    }
+    return 0;
+}
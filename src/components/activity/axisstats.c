@@ -0,0 +1,56 @@
+// Per-axis epoch summary statistics (mean, standard deviation, mean absolute value)
+
+#include <string.h>
+
+#include "axisstats.h"
+
+static uint16_t isqrt32(uint32_t x) {
+	uint16_t add = UINT16_C(0x8000), res = 0;
+	for (int i = 0; i < 16; i++) {
+		uint16_t temp = res | add;
+		uint32_t g2 = (uint32_t)temp * temp;
+		if (x >= g2) res = temp;
+		add >>= 1;
+	}
+	return res;
+}
+
+void axis_stats_reset(axis_stats_t *stats) {
+	memset(stats, 0, sizeof(*stats));
+}
+
+void axis_stats_summary(const axis_stats_t *stats, axis_stats_summary_t *summary) {
+	uint32_t n = stats->count;
+	summary->count = n;
+	for (int i = 0; i < AXIS_STATS_AXES; i++) {
+		if (n == 0) {
+			summary->mean[i] = 0;
+			summary->sd[i] = AXIS_STATS_INVALID;
+			summary->meanAbs[i] = AXIS_STATS_INVALID;
+			continue;
+		}
+
+		// Split |sum| = q * n + r (q < 65536, r < n) so that sum^2 / n = q^2 * n + 2 * q * r + r^2 / n can be formed without overflow
+		uint64_t a = (stats->sum[i] < 0) ? (uint64_t)-stats->sum[i] : (uint64_t)stats->sum[i];
+		uint64_t q = a / n;
+		uint64_t r = a % n;
+
+		// Mean (rounded half away from zero)
+		int32_t meanDelta = (int32_t)(q + (2 * r >= n ? 1 : 0));
+		if (stats->sum[i] < 0) meanDelta = -meanDelta;
+		summary->mean[i] = (int16_t)(stats->offset[i] + meanDelta);
+
+		// Population variance: (sumSquares - sum^2 / n) / n -- each partial subtraction stays non-negative (Cauchy-Schwarz)
+		uint64_t m2 = stats->sumSquares[i];
+		m2 -= q * q * n;
+		m2 -= 2 * q * r;
+		m2 -= (r * r) / n;
+		uint64_t variance = m2 / n;		// at most (65535/2)^2
+		uint16_t sd = isqrt32((uint32_t)variance);
+		if ((uint32_t)variance - (uint32_t)sd * sd > sd) sd++;	// Round to nearest
+		summary->sd[i] = sd;
+
+		uint64_t meanAbs = (stats->sumAbs[i] + n / 2) / n;	// at most 32768
+		summary->meanAbs[i] = (uint16_t)meanAbs;
+	}
+}
@@ -0,0 +1,55 @@
+// Per-axis epoch summary statistics (mean, standard deviation, mean absolute value)
+// Single-pass integer accumulators, updated for every sample and summarized once per epoch.
+
+#ifndef AXISSTATS_H
+#define AXISSTATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define AXIS_STATS_AXES 3
+#define AXIS_STATS_INVALID 0xffff		// Summary value when there are no samples
+
+// Values are accumulated relative to the first sample of the epoch (so that the sum-of-squares stays small for a
+// stationary device). Each squared difference is at most (65535^2 <) 2^32, so none of the sums can overflow for any
+// uint32_t count of samples.
+typedef struct {
+	uint32_t count;
+	int16_t offset[AXIS_STATS_AXES];			// First sample
+	int64_t sum[AXIS_STATS_AXES];				// Sum of (value - offset)
+	uint64_t sumSquares[AXIS_STATS_AXES];		// Sum of (value - offset)^2
+	uint64_t sumAbs[AXIS_STATS_AXES];			// Sum of abs(value)
+} axis_stats_t;
+
+typedef struct {
+	uint32_t count;
+	int16_t mean[AXIS_STATS_AXES];				// Mean value (rounded)
+	uint16_t sd[AXIS_STATS_AXES];				// Population standard deviation (rounded), AXIS_STATS_INVALID if no samples
+	uint16_t meanAbs[AXIS_STATS_AXES];			// Mean absolute value (rounded), AXIS_STATS_INVALID if no samples
+} axis_stats_summary_t;
+
+void axis_stats_reset(axis_stats_t *stats);
+void axis_stats_summary(const axis_stats_t *stats, axis_stats_summary_t *summary);
+
+// Called at the sample rate, so kept inline
+static inline void axis_stats_add(axis_stats_t *stats, const int16_t *values) {
+	if (stats->count == 0) {
+		for (int i = 0; i < AXIS_STATS_AXES; i++) stats->offset[i] = values[i];
+	}
+	for (int i = 0; i < AXIS_STATS_AXES; i++) {
+		int32_t delta = (int32_t)values[i] - stats->offset[i];
+		stats->sum[i] += delta;
+		stats->sumSquares[i] += (uint32_t)delta * (uint32_t)delta;	// (-65535..65535)^2 fits in uint32_t (unsigned to avoid signed overflow)
+		stats->sumAbs[i] += (uint32_t)(values[i] < 0 ? -(int32_t)values[i] : values[i]);
+	}
+	stats->count++;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,173 @@
+// Raw circular log of activity blocks
+
+#include <string.h>
+
+#include "rawlog.h"
+
+void raw_log_init(raw_log_t *log, void *context, raw_log_read_t read, raw_log_program_t program, raw_log_erase_t erase, uint32_t sectorCount) {
+	memset(log, 0, sizeof(*log));
+	log->context = context;
+	log->read = read;
+	log->program = program;
+	log->erase = erase;
+	log->sectorCount = sectorCount;
+	log->headIndex = RAW_LOG_INVALID;
+}
+
+uint32_t raw_log_block_index(const uint8_t *block) {
+	// 'AD' header with the length of a whole block
+	if (block[0] != 'A' || block[1] != 'D' || block[2] + (block[3] << 8) != RAW_LOG_BLOCK_SIZE - 4) return RAW_LOG_INVALID;
+	// Checksum: the 16-bit little-endian words sum to zero
+	uint16_t sum = 0;
+	for (size_t i = 0; i < RAW_LOG_BLOCK_SIZE; i += 2) {
+		sum += block[i] + ((uint16_t)block[i + 1] << 8);
+	}
+	if (sum != 0) return RAW_LOG_INVALID;
+	return (uint32_t)block[6] | ((uint32_t)block[7] << 8) | ((uint32_t)block[8] << 16) | ((uint32_t)block[9] << 24);
+}
+
+static bool raw_log_blank(const uint8_t *buffer, size_t size) {
+	for (size_t i = 0; i < size; i++) {
+		if (buffer[i] != 0xff) return false;
+	}
+	return true;
+}
+
+static uint32_t raw_log_probe(raw_log_t *log, uint32_t slot, uint8_t *buffer) {
+	log->probes++;
+	if (log->read(log->context, slot * RAW_LOG_BLOCK_SIZE, buffer, RAW_LOG_BLOCK_SIZE) != 0) return RAW_LOG_INVALID;
+	return raw_log_block_index(buffer);
+}
+
+uint32_t raw_log_capacity(const raw_log_t *log) {
+	return (log->sectorCount - 1) * RAW_LOG_BLOCKS_PER_SECTOR;
+}
+
+uint32_t raw_log_earliest(const raw_log_t *log) {
+	if (log->headIndex == RAW_LOG_INVALID || log->count == 0) return RAW_LOG_INVALID;
+	return log->headIndex + 1 - log->count;
+}
+
+bool raw_log_recover(raw_log_t *log) {
+	uint8_t buffer[RAW_LOG_BLOCK_SIZE];
+	const uint32_t sectors = log->sectorCount;
+
+	log->headSlot = 0;
+	log->headIndex = RAW_LOG_INVALID;
+	log->count = 0;
+	log->probes = 0;
+	if (sectors < 2) return false;
+
+	// Sectors are written in turn, so from the first sector the first blocks of the sectors are consecutive (+16 each)
+	// up to the sector holding the newest block.  Sector 0 may be blank if power was lost just after erasing it for
+	// reuse, in which case the run starts at sector 1.
+	uint32_t baseSector = 0;
+	uint32_t baseIndex = raw_log_probe(log, 0, buffer);
+	if (baseIndex == RAW_LOG_INVALID) {
+		baseSector = 1;
+		baseIndex = raw_log_probe(log, RAW_LOG_BLOCKS_PER_SECTOR, buffer);
+	}
+	if (baseIndex == RAW_LOG_INVALID) return true;	// Empty
+
+	// Binary search for the last sector of the run
+	uint32_t lo = baseSector, hi = sectors - 1;
+	uint32_t headSectorIndex = baseIndex;
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo + 1) / 2;
+		uint32_t index = raw_log_probe(log, mid * RAW_LOG_BLOCKS_PER_SECTOR, buffer);
+		if (index != RAW_LOG_INVALID && index - baseIndex == (mid - baseSector) * RAW_LOG_BLOCKS_PER_SECTOR) {
+			lo = mid;
+			headSectorIndex = index;
+		} else {
+			hi = mid - 1;
+		}
+	}
+	const uint32_t headSector = lo;
+
+	// Binary search for the last written slot within that sector (a block torn by a power loss uses up its slot and index)
+	lo = 0; hi = RAW_LOG_BLOCKS_PER_SECTOR - 1;
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo + 1) / 2;
+		raw_log_probe(log, headSector * RAW_LOG_BLOCKS_PER_SECTOR + mid, buffer);
+		if (!raw_log_blank(buffer, RAW_LOG_BLOCK_SIZE)) {
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
+	}
+	log->headSlot = headSector * RAW_LOG_BLOCKS_PER_SECTOR + lo;
+	log->headIndex = headSectorIndex + lo;
+
+	// The oldest blocks are in the next written sector (skipping one blank from a lost erase); none if not yet wrapped
+	uint32_t earliest = baseIndex;
+	for (uint32_t k = 1; k <= 2 && k < sectors; k++) {
+		uint32_t index = raw_log_probe(log, ((headSector + k) % sectors) * RAW_LOG_BLOCKS_PER_SECTOR, buffer);
+		if (index != RAW_LOG_INVALID) {
+			if (index < headSectorIndex) earliest = index;
+			break;
+		}
+	}
+	if (earliest > log->headIndex || log->headIndex - earliest >= sectors * RAW_LOG_BLOCKS_PER_SECTOR) {
+		log->headSlot = 0;
+		log->headIndex = RAW_LOG_INVALID;
+		return false;
+	}
+	log->count = log->headIndex - earliest + 1;
+	return true;
+}
+
+bool raw_log_format(raw_log_t *log) {
+	uint8_t buffer[RAW_LOG_BLOCK_SIZE];
+	bool ok = true;
+	for (uint32_t sector = 0; sector < log->sectorCount; sector++) {
+		uint32_t offset = sector * RAW_LOG_SECTOR_SIZE;
+		bool blank = true;
+		for (uint32_t i = 0; i < RAW_LOG_SECTOR_SIZE && blank; i += RAW_LOG_BLOCK_SIZE) {
+			if (log->read(log->context, offset + i, buffer, RAW_LOG_BLOCK_SIZE) != 0 || !raw_log_blank(buffer, RAW_LOG_BLOCK_SIZE)) blank = false;
+		}
+		if (!blank) {
+			log->erases++;
+			if (log->erase(log->context, offset) != 0) ok = false;
+		}
+	}
+	log->headSlot = 0;
+	log->headIndex = RAW_LOG_INVALID;
+	log->count = 0;
+	return ok;
+}
+
+bool raw_log_append(raw_log_t *log, uint32_t logicalIndex, const uint8_t *block) {
+	const uint32_t slots = log->sectorCount * RAW_LOG_BLOCKS_PER_SECTOR;
+	if (logicalIndex == RAW_LOG_INVALID) return false;
+	if (log->headIndex != RAW_LOG_INVALID && logicalIndex != log->headIndex + 1) return false;
+
+	uint32_t slot = (log->headIndex == RAW_LOG_INVALID) ? 0 : (log->headSlot + 1) % slots;
+
+	// Starting a sector: erase it, discarding any (oldest) blocks it holds
+	if (slot % RAW_LOG_BLOCKS_PER_SECTOR == 0) {
+		uint32_t others = slots - RAW_LOG_BLOCKS_PER_SECTOR;
+		if (log->count > others) log->count = others;
+		log->erases++;
+		if (log->erase(log->context, slot * RAW_LOG_BLOCK_SIZE) != 0) return false;
+	}
+
+	// The slot and index are used even if programming fails (the block then reads back as invalid)
+	log->programs++;
+	int ret = log->program(log->context, slot * RAW_LOG_BLOCK_SIZE, block, RAW_LOG_BLOCK_SIZE);
+	log->headSlot = slot;
+	log->headIndex = logicalIndex;
+	log->count++;
+	return ret == 0;
+}
+
+bool raw_log_read(raw_log_t *log, uint32_t logicalIndex, uint8_t *buffer) {
+	const uint32_t slots = log->sectorCount * RAW_LOG_BLOCKS_PER_SECTOR;
+	if (log->headIndex != RAW_LOG_INVALID && logicalIndex <= log->headIndex && log->headIndex - logicalIndex < log->count) {
+		uint32_t slot = (log->headSlot + slots - (log->headIndex - logicalIndex)) % slots;
+		if (log->read(log->context, slot * RAW_LOG_BLOCK_SIZE, buffer, RAW_LOG_BLOCK_SIZE) == 0 && raw_log_block_index(buffer) == logicalIndex) {
+			return true;
+		}
+	}
+	memset(buffer, 0xff, RAW_LOG_BLOCK_SIZE);
+	return false;
+}
@@ -0,0 +1,68 @@
+// Raw circular log of activity blocks in a reserved region of the external flash (bypassing the file system).
+// Blocks are 256-byte pages written in logical index order; the sector after the newest block is erased just before it
+// is written, discarding its (oldest) blocks.  The blocks are self-describing ('AD' header, logical index @6, sum_16
+// checksum), so the newest block is found at start-up by binary search, and a logical index maps directly to an address.
+
+#ifndef RAWLOG_H
+#define RAWLOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define RAW_LOG_BLOCK_SIZE 256				// ACTIVITY_BLOCK_SIZE, and the flash page size
+#define RAW_LOG_SECTOR_SIZE 4096
+#define RAW_LOG_BLOCKS_PER_SECTOR (RAW_LOG_SECTOR_SIZE / RAW_LOG_BLOCK_SIZE)
+#define RAW_LOG_INVALID 0xffffffff
+
+// Flash access within the region (offsets from the start of the region), returning 0 on success
+typedef int (*raw_log_read_t)(void *context, uint32_t offset, uint8_t *buffer, size_t size);
+typedef int (*raw_log_program_t)(void *context, uint32_t offset, const uint8_t *buffer, size_t size);
+typedef int (*raw_log_erase_t)(void *context, uint32_t offset);	// One sector
+
+typedef struct {
+	void *context;
+	raw_log_read_t read;
+	raw_log_program_t program;
+	raw_log_erase_t erase;
+	uint32_t sectorCount;					// At least 2 (one is always being reused)
+
+	uint32_t headSlot;						// Slot of the newest block
+	uint32_t headIndex;						// Logical index of the newest block (RAW_LOG_INVALID if empty)
+	uint32_t count;							// Blocks held (ending at the newest)
+
+	uint32_t probes;						// diagnostic: blocks read by the last raw_log_recover()
+	uint32_t erases;						// diagnostic: sectors erased
+	uint32_t programs;						// diagnostic: blocks programmed
+} raw_log_t;
+
+void raw_log_init(raw_log_t *log, void *context, raw_log_read_t read, raw_log_program_t program, raw_log_erase_t erase, uint32_t sectorCount);
+
+// Find the newest and oldest blocks; false if the region is not a consistent log (it should then be formatted)
+bool raw_log_recover(raw_log_t *log);
+
+// Erase the region (skipping sectors that are already blank) and empty the log
+bool raw_log_format(raw_log_t *log);
+
+// Append the next block: the logical index must follow the newest block (any index if empty, after formatting).
+// If programming fails, the index is still used.
+bool raw_log_append(raw_log_t *log, uint32_t logicalIndex, const uint8_t *block);
+
+// Read a block held in the log: false (and the buffer filled with 0xff) if not held or not valid
+bool raw_log_read(raw_log_t *log, uint32_t logicalIndex, uint8_t *buffer);
+
+uint32_t raw_log_capacity(const raw_log_t *log);	// Blocks that can be held
+uint32_t raw_log_earliest(const raw_log_t *log);	// Logical index of the oldest block (RAW_LOG_INVALID if empty)
+
+// Logical index of a valid block, otherwise RAW_LOG_INVALID
+uint32_t raw_log_block_index(const uint8_t *block);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,35 @@
+// Little-endian fields of the binary record blocks queued into the activity log (ActivityController::QueueRecord)
+
+#ifndef RECORDFIELDS_H
+#define RECORDFIELDS_H
+
+#include <stdint.h>
+
+// u16, saturated
+static inline void record_put16(uint8_t *p, uint32_t value) {
+	if (value > 0xffff) value = 0xffff;
+	p[0] = (uint8_t)value;
+	p[1] = (uint8_t)(value >> 8);
+}
+
+static inline void record_put32(uint8_t *p, uint32_t value) {
+	p[0] = (uint8_t)value;
+	p[1] = (uint8_t)(value >> 8);
+	p[2] = (uint8_t)(value >> 16);
+	p[3] = (uint8_t)(value >> 24);
+}
+
+// u32 from a 64-bit total, saturated
+static inline void record_put32_saturated(uint8_t *p, uint64_t value) {
+	record_put32(p, value > 0xffffffff ? 0xffffffff : (uint32_t)value);
+}
+
+static inline uint16_t record_get16(const uint8_t *p) {
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t record_get32(const uint8_t *p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+#endif
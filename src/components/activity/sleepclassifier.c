@@ -0,0 +1,65 @@
+// Epoch-level sleep/wake classifier
+
+#include "sleepclassifier.h"
+
+// Cole-Kripke (1992) 1-minute epoch weights for A(-4)..A(0) (the look-ahead terms are dropped for on-line use)
+static const uint16_t weights[SLEEP_CLASSIFIER_WINDOW] = { 106, 54, 58, 76, 230 };
+#define WEIGHT_TOTAL (106 + 54 + 58 + 76 + 230)
+
+#define RUN_MAX 255
+
+void sleep_classifier_reset(sleep_classifier_t *classifier) {
+	classifier->index = 0;
+	classifier->count = 0;
+	classifier->wakeRun = RUN_MAX;		// Assume a long period awake, so the full rescoring applies
+	classifier->sleepRun = 0;
+	classifier->state = SLEEP_STATE_UNKNOWN;
+}
+
+void sleep_classifier_init(sleep_classifier_t *classifier, uint16_t meanThreshold) {
+	classifier->threshold = (uint32_t)meanThreshold * WEIGHT_TOTAL;
+	sleep_classifier_reset(classifier);
+}
+
+// Webster rescoring: after at least 4/10/15 epochs of wake, the first 1/3/4 sleep epochs are scored as wake
+static uint8_t rescore_allowance(uint8_t wakeRun) {
+	if (wakeRun >= 15) return 4;
+	if (wakeRun >= 10) return 3;
+	if (wakeRun >= 4) return 1;
+	return 0;
+}
+
+sleep_state_t sleep_classifier_epoch(sleep_classifier_t *classifier, uint16_t activity) {
+	if (activity == SLEEP_CLASSIFIER_INVALID) {
+		sleep_classifier_reset(classifier);
+		return classifier->state;
+	}
+
+	classifier->activity[classifier->index] = activity;
+	classifier->index = (classifier->index + 1) % SLEEP_CLASSIFIER_WINDOW;
+	if (classifier->count < SLEEP_CLASSIFIER_WINDOW) classifier->count++;
+	if (classifier->count < SLEEP_CLASSIFIER_WINDOW) {
+		classifier->state = SLEEP_STATE_UNKNOWN;
+		return classifier->state;
+	}
+
+	// Oldest first: the ring index now points at the oldest entry
+	uint32_t sum = 0;	// at most (0xfffe * 524 <) 2^25
+	for (int i = 0; i < SLEEP_CLASSIFIER_WINDOW; i++) {
+		sum += (uint32_t)weights[i] * classifier->activity[(classifier->index + i) % SLEEP_CLASSIFIER_WINDOW];
+	}
+	bool sleep = sum < classifier->threshold;
+
+	if (sleep) {
+		if (classifier->sleepRun < RUN_MAX) classifier->sleepRun++;
+		classifier->state = (classifier->sleepRun > rescore_allowance(classifier->wakeRun)) ? SLEEP_STATE_ASLEEP : SLEEP_STATE_AWAKE;
+	} else {
+		if (classifier->sleepRun > 0) {
+			classifier->sleepRun = 0;
+			classifier->wakeRun = 0;
+		}
+		if (classifier->wakeRun < RUN_MAX) classifier->wakeRun++;
+		classifier->state = SLEEP_STATE_AWAKE;
+	}
+	return classifier->state;
+}
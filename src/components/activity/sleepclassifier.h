@@ -0,0 +1,47 @@
+// Epoch-level sleep/wake classifier
+// Cole-Kripke-style weighted sum of recent epoch activity (causal: no look-ahead), with Webster-style rescoring of
+// the first sleep epochs after a period of wake. Intended for 60 second epochs; constant cost per epoch.
+
+#ifndef SLEEPCLASSIFIER_H
+#define SLEEPCLASSIFIER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SLEEP_CLASSIFIER_WINDOW 5			// Current epoch and the four preceding
+#define SLEEP_CLASSIFIER_INVALID 0xffff		// Invalid epoch activity (e.g. too few samples)
+
+typedef enum {
+	SLEEP_STATE_UNKNOWN = 0,				// Not enough (valid) epochs yet
+	SLEEP_STATE_AWAKE = 1,
+	SLEEP_STATE_ASLEEP = 2,
+} sleep_state_t;
+
+typedef struct {
+	uint32_t threshold;						// Weighted sum threshold (sleep if below)
+
+	uint16_t activity[SLEEP_CLASSIFIER_WINDOW];	// Ring of recent epoch activity values
+	uint8_t index;							// Next position in the ring
+	uint8_t count;							// Valid entries in the ring
+
+	uint8_t wakeRun;						// Consecutive (unscored) wake epochs before the current sleep run (saturates)
+	uint8_t sleepRun;						// Consecutive (unscored) sleep epochs (saturates)
+	sleep_state_t state;					// Scored state of the most recent epoch
+} sleep_classifier_t;
+
+// meanThreshold: a steady epoch activity below this is scored as sleep
+void sleep_classifier_init(sleep_classifier_t *classifier, uint16_t meanThreshold);
+// Clear the history (e.g. after invalid data or interaction with the device) -- treated as awake
+void sleep_classifier_reset(sleep_classifier_t *classifier);
+// Add the activity value for an epoch, returns the scored state for that epoch
+sleep_state_t sleep_classifier_epoch(sleep_classifier_t *classifier, uint16_t activity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,3 @@
+gcc -c axisstats.c -o axisstats.o && g++ AxisStatsTest.cpp axisstats.o -o ./axisstatstest && ./axisstatstest
+gcc -c sleepclassifier.c -o sleepclassifier.o && g++ SleepClassifierTest.cpp sleepclassifier.o -o ./sleepclassifiertest && ./sleepclassifiertest
+gcc -O2 -c rawlog.c -o rawlog.o && g++ -O2 RawLogTest.cpp rawlog.o -o ./rawlogtest && ./rawlogtest
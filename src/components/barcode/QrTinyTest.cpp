@@ -0,0 +1,446 @@
+// Host round-trip test of the V1-V6 QR Code generator.
+// Each generated symbol is rendered to a 1bpp bitmap (as InfoApp) and read back by a separate reference decoder written
+// from the specification (ISO/IEC 18004): function patterns, both format information copies (BCH checked), unmasking,
+// codeword placement, de-interleaving, Reed-Solomon syndromes (all zero for an undamaged symbol), segments and padding.
+// Also checks the chosen versions against the specification's character capacities, and reports the image memory.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "qrtiny.h"
+
+static int failures = 0;
+
+// --- Reference decoder ---
+
+// [Table 9] Error correction characteristics: ECC codewords per block, then (blocks, data codewords) for up to two groups
+typedef struct { int ecc; int blocks1, data1, blocks2, data2; } block_info_t;
+static const block_info_t blockInfo[6][4] = {     // [version-1][L, M, Q, H]
+    { {  7, 1,  19 }, { 10, 1, 16 }, { 13, 1, 13 },        { 17, 1,  9 } },
+    { { 10, 1,  34 }, { 16, 1, 28 }, { 22, 1, 22 },        { 28, 1, 16 } },
+    { { 15, 1,  55 }, { 26, 1, 44 }, { 18, 2, 17 },        { 22, 2, 13 } },
+    { { 20, 1,  80 }, { 18, 2, 32 }, { 26, 2, 24 },        { 16, 4,  9 } },
+    { { 26, 1, 108 }, { 24, 2, 43 }, { 18, 2, 15, 2, 16 }, { 22, 2, 11, 2, 12 } },
+    { { 18, 2,  68 }, { 16, 4, 27 }, { 24, 4, 19 },        { 28, 4, 15 } },
+};
+enum { ECL_L, ECL_M, ECL_Q, ECL_H };
+static const char *eclNames = "LMQH";
+static const int eclFromBits[4] = { ECL_M, ECL_L, ECL_H, ECL_Q };     // Format information 2-bit code
+
+static uint8_t gfExp[512], gfLog[256];
+
+static void gfInit() {
+    int x = 1;
+    for (int i = 0; i < 255; i++) {
+        gfExp[i] = (uint8_t)x;
+        gfLog[x] = (uint8_t)i;
+        x <<= 1;
+        if (x & 0x100) x ^= 0x11d;
+    }
+    for (int i = 255; i < 512; i++) gfExp[i] = gfExp[i - 255];
+}
+
+static uint8_t gfMul(uint8_t a, uint8_t b) {
+    return (a == 0 || b == 0) ? 0 : gfExp[gfLog[a] + gfLog[b]];
+}
+
+// 15-bit format information for 5 data bits
+static int formatWord(int data) {
+    int rem = data;
+    for (int i = 0; i < 10; i++) rem = (rem << 1) ^ ((rem >> 9) * 0x537);
+    return ((data << 10) | rem) ^ 0x5412;
+}
+
+typedef struct {
+    const uint8_t *bitmap;
+    size_t stride;
+    int quiet;
+    int size;
+} symbol_t;
+
+static int module(const symbol_t *s, int x, int y) {
+    x += s->quiet; y += s->quiet;
+    return (s->bitmap[(size_t)y * s->stride + (x >> 3)] >> (7 - (x & 7))) & 1;
+}
+
+static bool isFunction(int size, int version, int x, int y) {
+    if ((x < 9 && y < 9) || (x >= size - 8 && y < 9) || (x < 9 && y >= size - 8)) return true;    // Finders, separators, format
+    if (x == 6 || y == 6) return true;                                                              // Timing
+    if (version >= 2 && abs(x - (size - 7)) <= 2 && abs(y - (size - 7)) <= 2) return true;          // Alignment
+    return false;
+}
+
+static bool maskBit(int mask, int x, int y) {
+    int i = y, j = x;
+    switch (mask) {
+        case 0: return (i + j) % 2 == 0;
+        case 1: return i % 2 == 0;
+        case 2: return j % 3 == 0;
+        case 3: return (i + j) % 3 == 0;
+        case 4: return (i / 2 + j / 3) % 2 == 0;
+        case 5: return (i * j) % 2 + (i * j) % 3 == 0;
+        case 6: return ((i * j) % 2 + (i * j) % 3) % 2 == 0;
+        default: return ((i + j) % 2 + (i * j) % 3) % 2 == 0;
+    }
+}
+
+// Decodes the symbol to text (segments concatenated); returns false with a reason if anything does not conform
+static bool decode(const symbol_t *s, char *text, size_t textSize, int *ecl, const char **reason) {
+    int size = s->size;
+    int version = (size - 17) / 4;
+    if (version < 1 || version > 6 || size != 17 + 4 * version) { *reason = "size"; return false; }
+
+    // Finder patterns
+    for (int f = 0; f < 3; f++) {
+        int ox = (f == 1) ? size - 7 : 0, oy = (f == 2) ? size - 7 : 0;
+        for (int y = -1; y <= 7; y++) for (int x = -1; x <= 7; x++) {
+            if (ox + x < 0 || oy + y < 0 || ox + x >= size || oy + y >= size) continue;
+            int d = abs(x - 3) > abs(y - 3) ? abs(x - 3) : abs(y - 3);
+            int expected = (d == 2 || d == 4) ? 0 : 1;
+            if (module(s, ox + x, oy + y) != expected) { *reason = "finder"; return false; }
+        }
+    }
+    // Timing patterns
+    for (int i = 8; i < size - 8; i++) {
+        if (module(s, i, 6) != !(i & 1) || module(s, 6, i) != !(i & 1)) { *reason = "timing"; return false; }
+    }
+    // Alignment pattern
+    if (version >= 2) {
+        for (int y = -2; y <= 2; y++) for (int x = -2; x <= 2; x++) {
+            int d = abs(x) > abs(y) ? abs(x) : abs(y);
+            if (module(s, size - 7 + x, size - 7 + y) != (d != 1)) { *reason = "alignment"; return false; }
+        }
+    }
+    if (!module(s, 8, size - 8)) { *reason = "dark module"; return false; }
+
+    // Format information: both copies must be valid codewords and agree
+    int copy1 = 0, copy2 = 0;
+    for (int i = 0; i <= 5; i++) copy1 |= module(s, 8, i) << i;
+    copy1 |= module(s, 8, 7) << 6;
+    copy1 |= module(s, 8, 8) << 7;
+    copy1 |= module(s, 7, 8) << 8;
+    for (int i = 9; i < 15; i++) copy1 |= module(s, 14 - i, 8) << i;
+    for (int i = 0; i < 8; i++) copy2 |= module(s, size - 1 - i, 8) << i;
+    for (int i = 8; i < 15; i++) copy2 |= module(s, 8, size - 15 + i) << i;
+    int formatData = -1;
+    for (int d = 0; d < 32; d++) {
+        if (formatWord(d) == copy1 && formatWord(d) == copy2) formatData = d;
+    }
+    if (formatData < 0) { *reason = "format"; return false; }
+    *ecl = eclFromBits[formatData >> 3];
+    int mask = formatData & 7;
+
+    // Read the codewords in placement order
+    static uint8_t codewords[256];
+    memset(codewords, 0, sizeof(codewords));
+    int bitIndex = 0;
+    for (int right = size - 1; right >= 1; right -= 2) {
+        if (right == 6) right = 5;
+        for (int vert = 0; vert < size; vert++) {
+            for (int j = 0; j < 2; j++) {
+                int x = right - j;
+                bool upward = ((right + 1) & 2) == 0;
+                int y = upward ? size - 1 - vert : vert;
+                if (isFunction(size, version, x, y)) continue;
+                int bit = module(s, x, y) ^ (maskBit(mask, x, y) ? 1 : 0);
+                if (bitIndex / 8 < (int)sizeof(codewords)) codewords[bitIndex / 8] |= bit << (7 - (bitIndex % 8));
+                bitIndex++;
+            }
+        }
+    }
+    int totalCodewords = bitIndex / 8;
+    int remainderBits = bitIndex % 8;
+    if (remainderBits != (version >= 2 ? 7 : 0)) { *reason = "remainder bits"; return false; }
+
+    // De-interleave into blocks
+    const block_info_t *info = &blockInfo[version - 1][*ecl];
+    int blocks = info->blocks1 + info->blocks2;
+    int dataLen[8];
+    int dataTotal = 0, maxData = 0;
+    for (int b = 0; b < blocks; b++) {
+        dataLen[b] = (b < info->blocks1) ? info->data1 : info->data2;
+        dataTotal += dataLen[b];
+        if (dataLen[b] > maxData) maxData = dataLen[b];
+    }
+    if (dataTotal + blocks * info->ecc != totalCodewords) { *reason = "codeword count"; return false; }
+    static uint8_t block[8][256];
+    int k = 0;
+    for (int j = 0; j < maxData; j++) for (int b = 0; b < blocks; b++) if (j < dataLen[b]) block[b][j] = codewords[k++];
+    for (int j = 0; j < info->ecc; j++) for (int b = 0; b < blocks; b++) block[b][dataLen[b] + j] = codewords[k++];
+
+    // Reed-Solomon: codeword polynomial evaluated at a^0..a^(ecc-1) is zero
+    for (int b = 0; b < blocks; b++) {
+        int n = dataLen[b] + info->ecc;
+        for (int i = 0; i < info->ecc; i++) {
+            uint8_t syndrome = 0;
+            for (int c = 0; c < n; c++) syndrome = gfMul(syndrome, gfExp[i]) ^ block[b][c];
+            if (syndrome != 0) { *reason = "error correction"; return false; }
+        }
+    }
+
+    // Data bit stream
+    static uint8_t data[256];
+    int d = 0;
+    for (int b = 0; b < blocks; b++) for (int j = 0; j < dataLen[b]; j++) data[d++] = block[b][j];
+    int bits = dataTotal * 8;
+    int pos = 0;
+    auto read = [&](int count) -> int {
+        int value = 0;
+        for (int i = 0; i < count; i++, pos++) value = (value << 1) | ((pos < bits) ? (data[pos / 8] >> (7 - pos % 8)) & 1 : 0);
+        return value;
+    };
+
+    // Segments
+    static const char *alphanumeric = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ $%*+-./:";
+    size_t length = 0;
+    for (;;) {
+        if (bits - pos < 4) { pos = bits; break; }    // Terminator may be truncated at capacity
+        int mode = read(4);
+        if (mode == 0) break;
+        if (mode == 1) {
+            int count = read(10);
+            for (int i = 0; i < count; i += 3) {
+                int digits = (count - i) >= 3 ? 3 : count - i;
+                int value = read(digits * 3 + 1);
+                char group[4];
+                snprintf(group, sizeof(group), "%0*d", digits, value);
+                for (int g = 0; g < digits && length + 1 < textSize; g++) text[length++] = group[g];
+            }
+        } else if (mode == 2) {
+            int count = read(9);
+            for (int i = 0; i < count; i += 2) {
+                if (count - i >= 2) {
+                    int value = read(11);
+                    if (value >= 45 * 45) { *reason = "alphanumeric value"; return false; }
+                    if (length + 2 < textSize) { text[length++] = alphanumeric[value / 45]; text[length++] = alphanumeric[value % 45]; }
+                } else {
+                    int value = read(6);
+                    if (value >= 45) { *reason = "alphanumeric value"; return false; }
+                    if (length + 1 < textSize) text[length++] = alphanumeric[value];
+                }
+            }
+        } else if (mode == 4) {
+            int count = read(8);
+            for (int i = 0; i < count; i++) {
+                int value = read(8);
+                if (length + 1 < textSize) text[length++] = (char)value;
+            }
+        } else {
+            *reason = "mode";
+            return false;
+        }
+        if (pos > bits) { *reason = "overrun"; return false; }
+    }
+    text[length] = '\0';
+
+    // Zero bits to a codeword boundary, then alternating pad codewords
+    while (pos < bits && (pos % 8) != 0) if (read(1) != 0) { *reason = "padding bits"; return false; }
+    for (int i = 0; pos < bits; i++) {
+        if (read(8) != ((i & 1) ? 0x11 : 0xec)) { *reason = "pad codewords"; return false; }
+    }
+    return true;
+}
+
+// --- Generator round trip ---
+
+// Format information for the error correction level and mask
+static uint16_t formatInfo(int ecl, int mask) {
+    static const int eclBits[4] = { 1, 0, 3, 2 };     // L, M, Q, H
+    return (uint16_t)formatWord((eclBits[ecl] << 3) | mask);
+}
+
+enum { MODE_NUMERIC, MODE_ALPHANUMERIC, MODE_8_BIT, MODE_MIXED };
+static const char *modeNames[] = { "numeric", "alphanumeric", "8-bit", "mixed" };
+
+static size_t writePayload(uint8_t *buffer, int mode, const char *text) {
+    memset(buffer, 0, QRTINY_BUFFER_SIZE);
+    if (mode == MODE_NUMERIC) return QrTinyWriteNumeric(buffer, 0, text);
+    if (mode == MODE_ALPHANUMERIC) return QrTinyWriteAlphanumeric(buffer, 0, text);
+    if (mode == MODE_8_BIT) return QrTinyWrite8Bit(buffer, 0, text);
+    // Mixed: alphanumeric prefix (as a URL) followed by an 8-bit remainder
+    size_t split = strlen(text) / 2;
+    char first[256];
+    memcpy(first, text, split);
+    first[split] = '\0';
+    size_t length = QrTinyWriteAlphanumeric(buffer, 0, first);
+    length += QrTinyWrite8Bit(buffer, length, text + split);
+    return length;
+}
+
+static void randomText(char *text, size_t length, int mode) {
+    static const char *alphanumeric = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ $%*+-./:";
+    for (size_t i = 0; i < length; i++) {
+        if (mode == MODE_NUMERIC) text[i] = (char)('0' + rand() % 10);
+        else if (mode == MODE_8_BIT || (mode == MODE_MIXED && i >= length / 2)) text[i] = (char)(1 + rand() % 255);
+        else text[i] = alphanumeric[rand() % 45];
+    }
+    text[length] = '\0';
+}
+
+// Generate, render and decode; returns the version used (0 if it did not fit)
+static int roundTrip(const char *text, int mode, int ecl, int mask, int quiet) {
+    uint8_t buffer[QRTINY_BUFFER_SIZE];
+    uint16_t format = formatInfo(ecl, mask);
+    size_t payloadLength = writePayload(buffer, mode, text);
+    int version = QrTinyVersionForPayload(payloadLength, format);
+    if (version == 0) return 0;
+    if (!QrTinyGenerate(buffer, version, payloadLength, format)) {
+        printf("FAIL: generate %s v%d-%c\n", modeNames[mode], version, eclNames[ecl]);
+        failures++;
+        return version;
+    }
+
+    static uint8_t bitmap[QRTINY_BITMAP_SIZE(QRTINY_VERSION_MAX, QRTINY_QUIET_STANDARD)];
+    memset(bitmap, 0xa5, sizeof(bitmap));
+    size_t stride = QRTINY_BITMAP_STRIDE(version, quiet);
+    QrTinyRender(buffer, version, format, quiet, bitmap, stride);
+
+    symbol_t symbol = { bitmap, stride, quiet, QRTINY_DIMENSION_FOR_VERSION(version) };
+    char decoded[512];
+    int decodedEcl = -1;
+    const char *reason = "";
+    bool ok = decode(&symbol, decoded, sizeof(decoded), &decodedEcl, &reason);
+    if (ok && (strcmp(decoded, text) != 0 || decodedEcl != ecl)) { ok = false; reason = "content"; }
+
+    // Quiet zone is light
+    for (int y = -quiet; ok && y < symbol.size + quiet; y++) for (int x = -quiet; x < symbol.size + quiet; x++) {
+        if ((x < 0 || y < 0 || x >= symbol.size || y >= symbol.size) && module(&symbol, x, y)) { ok = false; reason = "quiet zone"; }
+    }
+    // Single module reads agree with the rendering
+    for (int i = 0; ok && i < 16; i++) {
+        int x = rand() % symbol.size, y = rand() % symbol.size;
+        if (QrTinyModuleGet(buffer, version, format, x, y) != module(&symbol, x, y)) { ok = false; reason = "module get"; }
+    }
+
+    if (!ok) {
+        printf("FAIL: %s v%d-%c mask %d (%u characters): %s\n", modeNames[mode], version, eclNames[ecl], mask, (unsigned int)strlen(text), reason);
+        failures++;
+    }
+    return version;
+}
+
+// [Table 7] Character capacities V1-V6: numeric, alphanumeric, 8-bit
+static const int capacity[6][4][3] = {     // [version-1][L, M, Q, H][mode]
+    { {  41,  25,  17 }, {  34,  20,  14 }, {  27,  16,  11 }, {  17,  10,   7 } },
+    { {  77,  47,  32 }, {  63,  38,  26 }, {  48,  29,  20 }, {  34,  20,  14 } },
+    { { 127,  77,  53 }, { 101,  61,  42 }, {  77,  47,  32 }, {  58,  35,  24 } },
+    { { 187, 114,  78 }, { 149,  90,  62 }, { 111,  67,  46 }, {  82,  50,  34 } },
+    { { 255, 154, 106 }, { 202, 122,  84 }, { 144,  87,  60 }, { 106,  64,  44 } },
+    { { 322, 195, 134 }, { 255, 154, 106 }, { 178, 108,  74 }, { 139,  84,  58 } },
+};
+
+static void testCapacities() {
+    int checked = 0, bad = 0;
+    char text[512];
+    for (int ecl = 0; ecl < 4; ecl++) {
+        for (int mode = MODE_NUMERIC; mode <= MODE_8_BIT; mode++) {
+            for (int v = 1; v <= QRTINY_VERSION_MAX; v++) {
+                int characters = capacity[v - 1][ecl][mode];
+                // Exactly at capacity uses this version (round trip), one more needs the next version (or does not fit)
+                randomText(text, (size_t)characters, mode);
+                int version = roundTrip(text, mode, ecl, rand() % 8, QRTINY_QUIET_NONE);
+                randomText(text, (size_t)characters + 1, mode);
+                int over = roundTrip(text, mode, ecl, rand() % 8, QRTINY_QUIET_NONE);
+                checked++;
+                if (version != v || over != (v < QRTINY_VERSION_MAX ? v + 1 : 0)) {
+                    printf("FAIL: %s %c capacity %d: version %d, +1 version %d (expected %d)\n", modeNames[mode], eclNames[ecl], characters, version, over, v);
+                    bad++;
+                }
+            }
+        }
+    }
+    printf("Capacities: %d checked, %d wrong -- %s\n", checked, bad, bad ? "FAIL" : "OK");
+    failures += bad;
+}
+
+static void testRandom() {
+    int counts[QRTINY_VERSION_MAX + 1] = {0};
+    int before = failures;
+    char text[512];
+    for (int trial = 0; trial < 4000; trial++) {
+        int mode = rand() % 4;
+        int ecl = rand() % 4;
+        randomText(text, (size_t)(1 + rand() % 200), mode);
+        int version = roundTrip(text, mode, ecl, rand() % 8, (trial & 1) ? QRTINY_QUIET_STANDARD : QRTINY_QUIET_NONE);
+        counts[version]++;
+    }
+    printf("Random round trips: V1-V6 %d/%d/%d/%d/%d/%d, %d too long -- %s\n", counts[1], counts[2], counts[3], counts[4], counts[5], counts[6], counts[0], failures > before ? "FAIL" : "OK");
+}
+
+// The provisioning URL (prefix, address and device key -- all alphanumeric) as shown by InfoApp
+static void testProvisioning() {
+    const char *url = "HTTPS://CUE.BAND/D/A0B1C2D3E4F5/0123ABCD";
+    uint8_t buffer[QRTINY_BUFFER_SIZE] = {0};
+    size_t payloadLength = QrTinyWriteAlphanumeric(buffer, 0, url);
+    uint16_t format = QRTINY_FORMATINFO_MASK_000_ECC_QUARTILE;
+    int version = QrTinyVersionForPayload(payloadLength, format);
+    bool ok = version > 0 && QrTinyGenerate(buffer, version, payloadLength, format);
+
+    static uint8_t bitmap[QRTINY_BITMAP_SIZE(QRTINY_VERSION_MAX, 0)];
+    QrTinyRender(buffer, version, format, 0, bitmap, QRTINY_BITMAP_STRIDE(version, 0));
+    symbol_t symbol = { bitmap, (size_t)QRTINY_BITMAP_STRIDE(version, 0), 0, QRTINY_DIMENSION_FOR_VERSION(version) };
+    char decoded[512];
+    int ecl = -1;
+    const char *reason = "content";
+    ok = ok && decode(&symbol, decoded, sizeof(decoded), &ecl, &reason) && strcmp(decoded, url) == 0 && ecl == ECL_Q;
+    printf("Provisioning URL (%u characters): V%d-Q %dx%d -- %s\n", (unsigned int)strlen(url), version, symbol.size, symbol.size, ok ? "OK" : reason);
+    if (!ok) failures++;
+
+    // Image memory in InfoApp: previous true color source (x4 zoom) vs. 1bpp (scaled when drawn), no quiet zone
+    int size = symbol.size;
+    printf("Image memory for %dx%d: true color %d bytes, 1bpp %d bytes (+8 palette); V1 true color was %d bytes\n",
+        size, size, size * size * 2, (int)QRTINY_BITMAP_SIZE(version, 0), QRTINY_DIMENSION_FOR_VERSION(1) * QRTINY_DIMENSION_FOR_VERSION(1) * 2);
+    if ((int)QRTINY_BITMAP_SIZE(version, 0) + 8 > size * size * 2 / 10) failures++;
+}
+
+// InfoApp's image decoder: lines of the bitmap (with the standard quiet zone) scaled to fit, in chunks, as the palette colors
+static void testReadLine() {
+    const char *url = "HTTPS://CUE.BAND/D/A0B1C2D3E4F5/0123ABCD";
+    uint8_t buffer[QRTINY_BUFFER_SIZE] = {0};
+    size_t payloadLength = QrTinyWriteAlphanumeric(buffer, 0, url);
+    uint16_t format = QRTINY_FORMATINFO_MASK_000_ECC_QUARTILE;
+    int version = QrTinyVersionForPayload(payloadLength, format);
+    QrTinyGenerate(buffer, version, payloadLength, format);
+    const int quiet = QRTINY_QUIET_STANDARD;
+    const size_t stride = QRTINY_BITMAP_STRIDE(version, quiet);
+    const int dimension = QRTINY_DIMENSION_FOR_VERSION(version);
+    const int size = QRTINY_BITMAP_DIMENSION(version, quiet);
+    static uint8_t bitmap[QRTINY_BITMAP_SIZE(QRTINY_VERSION_MAX, QRTINY_QUIET_STANDARD)];
+    QrTinyRender(buffer, version, format, quiet, bitmap, stride);
+
+    const uint16_t light = 0xffff, dark = 0x0000;   // Palette: index 0 light, index 1 dark
+    const int scale = 96 / size > 1 ? 96 / size : 1;
+    const int width = size * scale;
+    const int chunk = 37;                             // Drawn in pieces not aligned to the modules
+    uint16_t line[96];
+    int bad = 0, darkCount = 0;
+    for (int y = 0; y < width; y++) {
+        for (int x = 0; x < width; x += chunk) {
+            int length = width - x < chunk ? width - x : chunk;
+            QrTinyBitmapReadLine(bitmap, stride, scale, x, y, length, light, dark, line);
+            for (int i = 0; i < length; i++) {
+                int mx = (x + i) / scale - quiet, my = y / scale - quiet;
+                bool inside = mx >= 0 && my >= 0 && mx < dimension && my < dimension;
+                uint16_t expected = (inside && QrTinyModuleGet(buffer, version, format, mx, my)) ? dark : light;
+                if (line[i] != expected) bad++;
+                if (line[i] == dark) darkCount++;
+            }
+        }
+    }
+    bool ok = bad == 0 && darkCount > 0 && darkCount < width * width;
+    printf("Decoder lines %dx%d (x%d): %d pixel(s) wrong, %d dark -- %s\n", width, width, scale, bad, darkCount, ok ? "OK" : "FAIL");
+    if (!ok) failures++;
+}
+
+int main(int argc, char *argv[]) {
+    gfInit();
+    srand(1);
+    testCapacities();
+    testRandom();
+    testProvisioning();
+    testReadLine();
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
@@ -1,4 +1,4 @@
-// QR Code V1 Generator
+// QR Code V1-V6 Generator
 // Dan Jackson, 2020
 
 #include <stdint.h>
@@ -40,10 +40,10 @@ static size_t QrTinyBufferAppend(uint8_t *writeBuffer, size_t writePosition, uin
 #define QRTINY_MODE_INDICATOR_8_BIT        0x4      // 0b0100 8-bit byte
 #define QRTINY_MODE_INDICATOR_TERMINATOR   0x0      // 0b0000 Terminator (End of Message)
 
-#define QRTINY_MODE_NUMERIC_COUNT_BITS      10      // for V1
-#define QRTINY_MODE_ALPHANUMERIC_COUNT_BITS  9      // for V1
-#define QRTINY_MODE_8BIT_COUNT_BITS          8      // for V1
-// Segment buffer sizes (payload, 4-bit mode indicator, V1 sized char count)
+#define QRTINY_MODE_NUMERIC_COUNT_BITS      10      // for V1-V9
+#define QRTINY_MODE_ALPHANUMERIC_COUNT_BITS  9      // for V1-V9
+#define QRTINY_MODE_8BIT_COUNT_BITS          8      // for V1-V9
+// Segment buffer sizes (payload, 4-bit mode indicator, V1-V9 sized char count)
 #define QRTINY_SEGMENT_NUMERIC_BUFFER_BITS(_c) (QRTINY_SIZE_MODE_INDICATOR + QRTINY_MODE_NUMERIC_COUNT_BITS + (10 * ((_c) / 3)) + (((_c) % 3) * 4) - (((_c) % 3) / 2))
 #define QRTINY_SEGMENT_ALPHANUMERIC_BUFFER_BITS(_c) (QRTINY_SIZE_MODE_INDICATOR + QRTINY_MODE_ALPHANUMERIC_COUNT_BITS + 11 * ((_c) >> 1) + 6 * ((_c) & 1))
 #define QRTINY_SEGMENT_8_BIT_BUFFER_BITS(_c) (QRTINY_SIZE_MODE_INDICATOR + QRTINY_MODE_8BIT_COUNT_BITS + 8 * (_c))
@@ -110,38 +110,21 @@ size_t QrTinyWrite8Bit(void *buffer, size_t bitPosition, const char *text)
 
 #define QRTINY_FINDER_SIZE 7
 #define QRTINY_TIMING_OFFSET 6
-#define QRTINY_VERSION_SIZE 3
 #define QRTINY_ALIGNMENT_RADIUS 2
 
-// Determine the data bit index for a V1 QR Code at a given coordinate (only valid at data module coordinates).
-static size_t QrTinyIdentifyIndex(int x, int y)
-{
-    // Coordinates skipping timing
-    int xx = x - ((x >= QRTINY_TIMING_OFFSET) ? 1 : 0);
-    int yy = y - ((y >= QRTINY_TIMING_OFFSET) ? 1 : 0);
-    int dir = (xx >> 1) & 1;  // bottom-up?
-    int half = xx & 1;  // right-hand-side?
-    int h = 9 - (xx >> 1);
-    int v = 4 - (yy >> 2);
-    int module = -1;
-    if (h < 4) module = dir ? h * 3 + v : h * 3 + 2 - v;
-    else if (h < 6) module = 12 + (dir ? (h-4) * 5 + v : (h-4) * 5 + 4 - v);
-    else module = 22 + h - 6;
-    int bit = (((dir ? 0x0 : 0x3) ^ (yy & 3)) << 1) + half;
-    return ((module << 3) | bit);
-}
-
 // Determines whether a specified module coordinate is light/dark or part of the data
-static int QrTinyIdentifyModule(int x, int y, uint16_t formatInfo)
+static int QrTinyIdentifyModule(int version, int x, int y, uint16_t formatInfo)
 {
+    int dimension = QRTINY_DIMENSION_FOR_VERSION(version);
+
     // Quiet zone
-    if (x < 0 || y < 0 || x >= QRTINY_DIMENSION || y >= QRTINY_DIMENSION) { return QRTINY_MODULE_LIGHT; } // Outside
+    if (x < 0 || y < 0 || x >= dimension || y >= dimension) { return QRTINY_MODULE_LIGHT; } // Outside
     
     // Finders
     for (int f = 0; f < 3; f++)
     {
-        int dx = abs(x - (f & 1 ? QRTINY_DIMENSION - 1 - QRTINY_FINDER_SIZE / 2 : QRTINY_FINDER_SIZE / 2));
-        int dy = abs(y - (f & 2 ? QRTINY_DIMENSION - 1 - QRTINY_FINDER_SIZE / 2 : QRTINY_FINDER_SIZE / 2));
+        int dx = abs(x - (f & 1 ? dimension - 1 - QRTINY_FINDER_SIZE / 2 : QRTINY_FINDER_SIZE / 2));
+        int dy = abs(y - (f & 2 ? dimension - 1 - QRTINY_FINDER_SIZE / 2 : QRTINY_FINDER_SIZE / 2));
         if (dx == 0 && dy == 0) return QRTINY_MODULE_DARK;
         if (dx <= 1 + QRTINY_FINDER_SIZE / 2 && dy <= 1 + QRTINY_FINDER_SIZE / 2)
         {
@@ -149,6 +132,17 @@ static int QrTinyIdentifyModule(int x, int y, uint16_t formatInfo)
         }
     }
 
+    // Alignment (V2-V6 have a single one, the other positions would overlap the finders)
+    if (version >= 2)
+    {
+        int dx = abs(x - (dimension - 1 - QRTINY_TIMING_OFFSET));
+        int dy = abs(y - (dimension - 1 - QRTINY_TIMING_OFFSET));
+        if (dx <= QRTINY_ALIGNMENT_RADIUS && dy <= QRTINY_ALIGNMENT_RADIUS)
+        {
+            return (dx > dy ? dx : dy) == 1 ? QRTINY_MODULE_LIGHT : QRTINY_MODULE_DARK;
+        }
+    }
+
     // Timing
     if (x == QRTINY_TIMING_OFFSET || y == QRTINY_TIMING_OFFSET) { return ((x^y)&1) ? QRTINY_MODULE_LIGHT : QRTINY_MODULE_DARK; } // Timing: vertical
 
@@ -158,11 +152,11 @@ static int QrTinyIdentifyModule(int x, int y, uint16_t formatInfo)
 
     // --- Encoding region ---
     // Format info (2*15+1=31 modules)
-    if (x == QRTINY_FINDER_SIZE + 1 && y == QRTINY_DIMENSION - QRTINY_FINDER_SIZE - 1) { return QRTINY_MODULE_DARK; }  // Always-black module, right of bottom-left finder
+    if (x == QRTINY_FINDER_SIZE + 1 && y == dimension - QRTINY_FINDER_SIZE - 1) { return QRTINY_MODULE_DARK; }  // Always-black module, right of bottom-left finder
     int formatIndex = -1;
     if (xx <= QRTINY_FINDER_SIZE && yy <= QRTINY_FINDER_SIZE) { formatIndex = 7 - xx + yy; }
-    if (x == QRTINY_FINDER_SIZE + 1 && y >= QRTINY_DIMENSION - QRTINY_FINDER_SIZE - 1) { formatIndex = y + 14 - (QRTINY_DIMENSION - 1); }  // Format info (right of bottom-left finder)
-    if (y == QRTINY_FINDER_SIZE + 1 && x >= QRTINY_DIMENSION - QRTINY_FINDER_SIZE - 1) { formatIndex = QRTINY_DIMENSION - 1 - x; }  // Format info (bottom of top-right finder)
+    if (x == QRTINY_FINDER_SIZE + 1 && y >= dimension - QRTINY_FINDER_SIZE - 1) { formatIndex = y + 14 - (dimension - 1); }  // Format info (right of bottom-left finder)
+    if (y == QRTINY_FINDER_SIZE + 1 && x >= dimension - QRTINY_FINDER_SIZE - 1) { formatIndex = dimension - 1 - x; }  // Format info (bottom of top-right finder)
     if (formatIndex >= 0)
     {
         return (formatInfo >> formatIndex) & 1 ? QRTINY_MODULE_DARK : QRTINY_MODULE_LIGHT;
@@ -190,6 +184,36 @@ static bool QrTinyCalculateMask(uint16_t formatInfo, int j, int i)
 
 // --- Reed-Solomon Error-Correction Code ---
 // This error-correction calculation derived from https://www.nayuki.io/page/qr-code-generator-library Copyright (c) Project Nayuki. (MIT License)
+// Product modulo GF(2^8/0x011D)
+static uint8_t QrTinyRSMultiply(uint8_t x, uint8_t y)
+{
+    uint8_t value = 0;
+    for (int k = 7; k >= 0; k--)
+    {
+        value = (uint8_t)((value << 1) ^ ((value >> 7) * 0x011D));
+        value ^= ((y >> k) & 1) * x;
+    }
+    return value;
+}
+
+// Generator polynomial coefficients (highest power first, excluding the leading 1) of the given degree
+static void QrTinyRSDivisor(int degree, uint8_t result[])
+{
+    memset(result, 0, (size_t)degree * sizeof(result[0]));
+    result[degree - 1] = 1;
+    uint8_t root = 1;
+    for (int i = 0; i < degree; i++)
+    {
+        // Multiply by (x - r^i)
+        for (int j = 0; j < degree; j++)
+        {
+            result[j] = QrTinyRSMultiply(result[j], root);
+            if (j + 1 < degree) result[j] ^= result[j + 1];
+        }
+        root = QrTinyRSMultiply(root, 0x02);
+    }
+}
+
 static void QrTinyRSRemainder(const uint8_t data[], size_t dataLen, const uint8_t generator[], int degree, uint8_t result[])
 {
     memset(result, 0, (size_t)degree * sizeof(result[0]));
@@ -200,42 +224,94 @@ static void QrTinyRSRemainder(const uint8_t data[], size_t dataLen, const uint8_
         result[degree - 1] = 0;
         for (int j = 0; j < degree; j++)
         {
-            // Product modulo GF(2^8/0x011D)
-            uint8_t value = 0;
-            for (int k = 7; k >= 0; k--)
-            {
-                value = (uint8_t)((value << 1) ^ ((value >> 7) * 0x011D));
-                value ^= ((factor >> k) & 1) * generator[j];
-            }
-            result[j] ^= value;
+            result[j] ^= QrTinyRSMultiply(generator[j], factor);
         }
     }
 }
 
-#define QRTINY_ECC_CODEWORDS_MAX 17
-// [Table 13] Number of error correction codewords (count of data 8-bit codewords in each block; for each error-correction level in V1)
-static const int8_t qrcode_ecc_block_codewords[1 << QRTINY_SIZE_ECL] = {
-    10, // 0b00 Medium
-    7,  // 0b01 Low
-    17, // 0b10 High
-    13, // 0b11 Quartile
+#define QRTINY_ECC_CODEWORDS_MAX 28
+// [Table 9] Number of error correction codewords per block (for each error-correction level, V1-V6)
+static const uint8_t qrtinyEccBlockCodewords[1 << QRTINY_SIZE_ECL][QRTINY_VERSION_MAX] = {
+    { 10, 16, 26, 18, 24, 16 }, // 0b00 Medium
+    {  7, 10, 15, 20, 26, 18 }, // 0b01 Low
+    { 17, 28, 22, 16, 22, 28 }, // 0b10 High
+    { 13, 22, 18, 26, 18, 24 }, // 0b11 Quartile
+};
+// [Table 9] Number of error correction blocks (for each error-correction level, V1-V6)
+static const uint8_t qrtinyEccBlocks[1 << QRTINY_SIZE_ECL][QRTINY_VERSION_MAX] = {
+    { 1, 1, 1, 2, 2, 4 },       // 0b00 Medium
+    { 1, 1, 1, 1, 1, 2 },       // 0b01 Low
+    { 1, 1, 2, 4, 4, 4 },       // 0b10 High
+    { 1, 1, 2, 2, 4, 4 },       // 0b11 Quartile
 };
-static const uint8_t eccDivisorsMedium[] = { 0xd8, 0xc2, 0x9f, 0x6f, 0xc7, 0x5e, 0x5f, 0x71, 0x9d, 0xc1 }; // V1 0b00 Medium ECL
-static const uint8_t eccDivisorsLow[] = { 0x7f, 0x7a, 0x9a, 0xa4, 0x0b, 0x44, 0x75 }; // V1 0b01 Low ECL
-static const uint8_t eccDivisorsHigh[] = { 0x77, 0x42, 0x53, 0x78, 0x77, 0x16, 0xc5, 0x53, 0xf9, 0x29, 0x8f, 0x86, 0x55, 0x35, 0x7d, 0x63, 0x4f }; // V1 0b10 High ECL
-static const uint8_t eccDivisorsQuartile[] = { 0x89, 0x49, 0xe3, 0x11, 0xb1, 0x11, 0x34, 0x0d, 0x2e, 0x2b, 0x53, 0x84, 0x78 }; // V1 0b11 Quartile ECL
-static const uint8_t *eccDivisors[1 << QRTINY_SIZE_ECL] = { eccDivisorsMedium, eccDivisorsLow, eccDivisorsHigh, eccDivisorsQuartile };
 
-// Generate the code
-bool QrTinyGenerate(uint8_t* buffer, size_t payloadLength, uint16_t formatInfo)
+// Codeword arrangement for a version and error correction level
+typedef struct
+{
+    size_t totalCodewords;      // Data and ECC codewords (excluding any remainder bits)
+    size_t dataCodewords;       // Data codewords over all blocks
+    size_t shortDataCodewords;  // Data codewords in each of the first 'shortBlocks' blocks (the rest have one more)
+    int blocks;
+    int shortBlocks;
+    int eccCodewords;           // ECC codewords in each block
+} qrtiny_layout_t;
+
+static bool QrTinyLayout(int version, uint16_t formatInfo, qrtiny_layout_t *layout)
 {
-    // Number of error correction blocks (count of error-correction-blocks; for each error-correction level in V1)
+    if (version < QRTINY_VERSION_MIN || version > QRTINY_VERSION_MAX) return false;
     int errorCorrectionLevel = QRTINY_FORMATINFO_TO_ECL(formatInfo);
-    int eccCodewords = qrcode_ecc_block_codewords[errorCorrectionLevel]; // (sizeof(eccDivisors[errorCorrectionLevel]) / sizeof(eccDivisors[errorCorrectionLevel][0]));
-    const uint8_t *eccDivisor = eccDivisors[errorCorrectionLevel];
+    layout->totalCodewords = QRTINY_TOTAL_CAPACITY_FOR_VERSION(version) / 8;
+    layout->blocks = qrtinyEccBlocks[errorCorrectionLevel][version - 1];
+    layout->eccCodewords = qrtinyEccBlockCodewords[errorCorrectionLevel][version - 1];
+    layout->shortBlocks = layout->blocks - (int)(layout->totalCodewords % (size_t)layout->blocks);
+    layout->shortDataCodewords = layout->totalCodewords / (size_t)layout->blocks - (size_t)layout->eccCodewords;
+    layout->dataCodewords = layout->totalCodewords - (size_t)layout->blocks * (size_t)layout->eccCodewords;
+    return true;
+}
+
+// Buffer offset of the first data codeword in a block (the buffer holds all data codewords in block order, then each block's ECC codewords)
+static size_t QrTinyBlockOffset(const qrtiny_layout_t *layout, int block)
+{
+    return (size_t)block * layout->shortDataCodewords + (size_t)(block > layout->shortBlocks ? block - layout->shortBlocks : 0);
+}
+
+// Buffer offset of the codeword at the given position in the (interleaved) sequence placed in the symbol
+static size_t QrTinyCodewordOffset(const qrtiny_layout_t *layout, size_t index)
+{
+    size_t blocks = (size_t)layout->blocks;
+    if (index < layout->shortDataCodewords * blocks)
+    {
+        return QrTinyBlockOffset(layout, (int)(index % blocks)) + index / blocks;
+    }
+    if (index < layout->dataCodewords)
+    {
+        // Final data codeword of the longer blocks
+        int block = layout->shortBlocks + (int)(index - layout->shortDataCodewords * blocks);
+        return QrTinyBlockOffset(layout, block) + layout->shortDataCodewords;
+    }
+    index -= layout->dataCodewords;
+    return layout->dataCodewords + (index % blocks) * (size_t)layout->eccCodewords + index / blocks;
+}
+
+int QrTinyVersionForPayload(size_t payloadLength, uint16_t formatInfo)
+{
+    for (int version = QRTINY_VERSION_MIN; version <= QRTINY_VERSION_MAX; version++)
+    {
+        qrtiny_layout_t layout;
+        QrTinyLayout(version, formatInfo, &layout);
+        if (payloadLength <= layout.dataCodewords * 8) return version;
+    }
+    return 0;   // Does not fit
+}
+
+// Generate the code
+bool QrTinyGenerate(uint8_t* buffer, int version, size_t payloadLength, uint16_t formatInfo)
+{
+    qrtiny_layout_t layout;
+    if (!QrTinyLayout(version, formatInfo, &layout)) return false;
 
     // Total number of data bits available in the codewords (cooked: after ecc and remainder)
-    size_t dataCapacity = ((QRTINY_TOTAL_CAPACITY / 8) - (size_t)eccCodewords) * 8;
+    size_t dataCapacity = layout.dataCodewords * 8;
 
     int spareCapacity = (int)dataCapacity - (int)payloadLength;
     if (spareCapacity < 0) return false;  // Does not fit
@@ -264,20 +340,119 @@ bool QrTinyGenerate(uint8_t* buffer, size_t payloadLength, uint16_t formatInfo)
     }
 
     // --- Calculate ECC at end of codewords ---
-    // Calculate ECC for the block -- write all consecutively after the data (no interleave required for V1)
-    QrTinyRSRemainder(buffer, dataCapacity / 8, eccDivisor, eccCodewords, buffer + (QRTINY_TOTAL_CAPACITY - ((size_t)8 * eccCodewords)) / 8);
+    // Calculate ECC for each block -- written consecutively after the data (interleaved when placed in the symbol)
+    uint8_t eccDivisor[QRTINY_ECC_CODEWORDS_MAX];
+    QrTinyRSDivisor(layout.eccCodewords, eccDivisor);
+    for (int block = 0; block < layout.blocks; block++)
+    {
+        size_t blockData = layout.shortDataCodewords + (block >= layout.shortBlocks ? 1 : 0);
+        QrTinyRSRemainder(buffer + QrTinyBlockOffset(&layout, block), blockData, eccDivisor, layout.eccCodewords, buffer + layout.dataCodewords + (size_t)block * (size_t)layout.eccCodewords);
+    }
     return true;
 }
 
-int QrTinyModuleGet(uint8_t *buffer, uint16_t formatInfo, int x, int y)
+// Visit each data module in placement order (upwards/downwards in two-module columns from the bottom-right), with its masked value
+typedef bool (*QrTinyDataVisitor)(void *context, int x, int y, int module);
+
+static void QrTinyPlaceData(const uint8_t *buffer, int version, uint16_t formatInfo, QrTinyDataVisitor visitor, void *context)
 {
-    int type = QrTinyIdentifyModule(x, y, formatInfo);
+    qrtiny_layout_t layout;
+    if (!QrTinyLayout(version, formatInfo, &layout)) return;
+    int dimension = QRTINY_DIMENSION_FOR_VERSION(version);
+    size_t index = 0;
+    uint8_t codeword = 0;
+    for (int right = dimension - 1; right >= 1; right -= 2)
+    {
+        if (right == QRTINY_TIMING_OFFSET) right--;     // Skip the vertical timing column
+        bool upwards = ((right + 1) & 2) == 0;
+        for (int vert = 0; vert < dimension; vert++)
+        {
+            int y = upwards ? dimension - 1 - vert : vert;
+            for (int x = right; x >= right - 1; x--)
+            {
+                if (QrTinyIdentifyModule(version, x, y, formatInfo) != QRTINY_MODULE_DATA) continue;
+                if ((index & 7) == 0)
+                {
+                    // Remainder bits after the final codeword are zero
+                    codeword = (index >> 3) < layout.totalCodewords ? buffer[QrTinyCodewordOffset(&layout, index >> 3)] : 0;
+                }
+                int module = (codeword >> (7 - (index & 7))) & 1;
+                if (QrTinyCalculateMask(formatInfo, x, y)) module ^= 1;
+                index++;
+                if (!visitor(context, x, y, module)) return;
+            }
+        }
+    }
+}
+
+typedef struct
+{
+    int x, y;
+    int module;
+} qrtiny_find_t;
+
+static bool QrTinyFindVisitor(void *context, int x, int y, int module)
+{
+    qrtiny_find_t *find = (qrtiny_find_t *)context;
+    if (x != find->x || y != find->y) return true;
+    find->module = module;
+    return false;
+}
+
+int QrTinyModuleGet(const uint8_t *buffer, int version, uint16_t formatInfo, int x, int y)
+{
+    int type = QrTinyIdentifyModule(version, x, y, formatInfo);
     if (type == QRTINY_MODULE_DATA)
     {
-        int index = QrTinyIdentifyIndex(x, y);
-        type = (buffer[index >> 3] & (1 << (index & 7))) ? 1 : 0;
-        bool mask = QrTinyCalculateMask(formatInfo, x, y);
-        if (mask) type ^= 1;
+        qrtiny_find_t find = { x, y, QRTINY_MODULE_LIGHT };
+        QrTinyPlaceData(buffer, version, formatInfo, QrTinyFindVisitor, &find);
+        type = find.module;
     }
     return type;
 }
+
+typedef struct
+{
+    uint8_t *bitmap;
+    size_t stride;
+    int quiet;
+} qrtiny_render_t;
+
+static void QrTinyRenderSet(qrtiny_render_t *render, int x, int y, int module)
+{
+    uint8_t *p = render->bitmap + (size_t)(y + render->quiet) * render->stride + ((size_t)(x + render->quiet) >> 3);
+    uint8_t mask = (uint8_t)(0x80 >> ((x + render->quiet) & 7));
+    if (module) *p |= mask; else *p &= (uint8_t)~mask;
+}
+
+static bool QrTinyRenderVisitor(void *context, int x, int y, int module)
+{
+    QrTinyRenderSet((qrtiny_render_t *)context, x, y, module);
+    return true;
+}
+
+void QrTinyRender(const uint8_t *buffer, int version, uint16_t formatInfo, int quiet, uint8_t *bitmap, size_t stride)
+{
+    int dimension = QRTINY_DIMENSION_FOR_VERSION(version);
+    qrtiny_render_t render = { bitmap, stride, quiet };
+    // Quiet zone and function patterns (data modules are placed afterwards)
+    memset(bitmap, 0, stride * (size_t)(dimension + 2 * quiet));
+    for (int y = -quiet; y < dimension + quiet; y++)
+    {
+        for (int x = -quiet; x < dimension + quiet; x++)
+        {
+            if (QrTinyIdentifyModule(version, x, y, formatInfo) == QRTINY_MODULE_DARK) QrTinyRenderSet(&render, x, y, QRTINY_MODULE_DARK);
+        }
+    }
+    QrTinyPlaceData(buffer, version, formatInfo, QrTinyRenderVisitor, &render);
+}
+
+void QrTinyBitmapReadLine(const uint8_t *bitmap, size_t stride, int scale, int x, int y, int length, uint16_t color0, uint16_t color1, uint16_t *line)
+{
+    const uint8_t *row = bitmap + (size_t)(y / scale) * stride;
+    for (int i = 0; i < length; i++)
+    {
+        int column = (x + i) / scale;
+        line[i] = (row[column >> 3] & (0x80 >> (column & 7))) ? color1 : color0;
+    }
+}
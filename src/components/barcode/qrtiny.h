@@ -1,10 +1,11 @@
-// QR Code V1 Generator
+// QR Code V1-V6 Generator
 // Dan Jackson, 2020
 
 #ifndef QRTINY_H
 #define QRTINY_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -15,15 +16,22 @@ extern "C" {
 #define QRTINY_QUIET_NONE 0
 #define QRTINY_QUIET_STANDARD 4
 
-// This tiny creator only supports V1 QR Codes, 21x21 modules
-#define QRTINY_VERSION 1
-#define QRTINY_DIMENSION 21
+// This tiny creator supports V1-V6 QR Codes, 21x21 to 41x41 modules (single alignment pattern, no version information)
+#define QRTINY_VERSION_MIN 1
+#define QRTINY_VERSION_MAX 6
+#define QRTINY_DIMENSION_FOR_VERSION(_v) (17 + 4 * (_v))
+#define QRTINY_DIMENSION_MAX QRTINY_DIMENSION_FOR_VERSION(QRTINY_VERSION_MAX)
 
 // Total data modules (raw: data, ecc and remainder) minus function pattern and format/version = data capacity in bits
-#define QRTINY_TOTAL_CAPACITY (((16 * (size_t)(QRTINY_VERSION) + 128) * (size_t)(QRTINY_VERSION)) + 64 - ((size_t)(QRTINY_VERSION) < 2 ? 0 : (25 * ((size_t)(QRTINY_VERSION) / 7 + 2) - 10) * (size_t)((QRTINY_VERSION) / 7 + 2) - 55) - ((size_t)(QRTINY_VERSION) < 7 ? 0 : 36))
+#define QRTINY_TOTAL_CAPACITY_FOR_VERSION(_v) (((16 * (size_t)(_v) + 128) * (size_t)(_v)) + 64 - ((size_t)(_v) < 2 ? 0 : (25 * ((size_t)(_v) / 7 + 2) - 10) * (size_t)((_v) / 7 + 2) - 55) - ((size_t)(_v) < 7 ? 0 : 36))
 
-// Required buffer size
-#define QRTINY_BUFFER_SIZE (((QRTINY_TOTAL_CAPACITY) + 7) >> 3)
+// Required buffer size (data and ECC codewords for the largest version: 172 bytes)
+#define QRTINY_BUFFER_SIZE (((QRTINY_TOTAL_CAPACITY_FOR_VERSION(QRTINY_VERSION_MAX)) + 7) >> 3)
+
+// 1bpp bitmap (rows of whole bytes, most-significant bit first) for a version with the given quiet zone
+#define QRTINY_BITMAP_DIMENSION(_v, _quiet) (QRTINY_DIMENSION_FOR_VERSION(_v) + 2 * (_quiet))
+#define QRTINY_BITMAP_STRIDE(_v, _quiet) ((QRTINY_BITMAP_DIMENSION(_v, _quiet) + 7) >> 3)
+#define QRTINY_BITMAP_SIZE(_v, _quiet) (QRTINY_BITMAP_STRIDE(_v, _quiet) * QRTINY_BITMAP_DIMENSION(_v, _quiet))
 
 // 0b00 Error-Correction Medium   (~15%, 10 codewords), V1 fits: 14 full characters / 20 alphanumeric / 34 numeric
 #define QRTINY_FORMATINFO_MASK_000_ECC_MEDIUM   0x5412
@@ -34,7 +42,7 @@ extern "C" {
 #define QRTINY_FORMATINFO_MASK_101_ECC_MEDIUM   0x40ce
 #define QRTINY_FORMATINFO_MASK_110_ECC_MEDIUM   0x4f97
 #define QRTINY_FORMATINFO_MASK_111_ECC_MEDIUM   0x4aa0
-// 0b01 Error-Correction Low      (~ 7%,  7 codewords), V1 fits: 17 full characters / 26 alphanumeric / 41 numeric
+// 0b01 Error-Correction Low      (~ 7%,  7 codewords), V1 fits: 17 full characters / 25 alphanumeric / 41 numeric
 #define QRTINY_FORMATINFO_MASK_000_ECC_LOW      0x77c4
 #define QRTINY_FORMATINFO_MASK_001_ECC_LOW      0x72f3
 #define QRTINY_FORMATINFO_MASK_010_ECC_LOW      0x7daa
@@ -63,15 +71,25 @@ extern "C" {
 #define QRTINY_FORMATINFO_MASK_111_ECC_QUARTILE 0x2bed
 
 // Encode one or more segments of text to the buffer (at bit offset specified), returning the number of bits written. Caller must ensure buffer has capacity.
+// Capacities for V1 below; V6 fits 58-134 8-bit characters / 84-195 alphanumeric, depending on ECC.
 size_t QrTinyWriteNumeric(void *buffer, size_t offset, const char *text);       // 17-41 digits, depending on ECC.
-size_t QrTinyWriteAlphanumeric(void *buffer, size_t offset, const char *text);  // 10-26 characters (upper-case/digits/symbols), depending on ECC.
+size_t QrTinyWriteAlphanumeric(void *buffer, size_t offset, const char *text);  // 10-25 characters (upper-case/digits/symbols), depending on ECC.
 size_t QrTinyWrite8Bit(void *buffer, size_t offset, const char *text);          //  7-17 8-bit characters, depending on ECC.
 
-// Compute the remaining buffer contents: any required padding and the calculated error-correction information
-bool QrTinyGenerate(uint8_t *buffer, size_t payloadLength, uint16_t formatInfo);
+// Smallest version that fits the payload (in bits) at the error correction level in the format, or 0 if none do
+int QrTinyVersionForPayload(size_t payloadLength, uint16_t formatInfo);
+
+// Compute the remaining buffer contents: any required padding and the calculated error-correction information (each block's ECC after the data)
+bool QrTinyGenerate(uint8_t *buffer, int version, size_t payloadLength, uint16_t formatInfo);
+
+// Get the module at the given coordinate (0=light, 1=dark) -- walks the data placement, so use QrTinyRender() for the whole symbol
+int QrTinyModuleGet(const uint8_t *buffer, int version, uint16_t formatInfo, int x, int y);
+
+// Render the symbol, with a quiet zone, to a 1bpp bitmap (set bits for dark modules) of QRTINY_BITMAP_SIZE() with rows of 'stride' bytes
+void QrTinyRender(const uint8_t *buffer, int version, uint16_t formatInfo, int quiet, uint8_t *bitmap, size_t stride);
 
-// Get the module at the given coordinate (0=light, 1=dark)
-int QrTinyModuleGet(uint8_t *buffer, uint16_t formatInfo, int x, int y);
+// Read 'length' pixels of row 'y' from 'x' of a 1bpp bitmap drawn scaled up by a whole factor, as one of two 16-bit colors (a clear bit is color0, a set bit color1)
+void QrTinyBitmapReadLine(const uint8_t *bitmap, size_t stride, int scale, int x, int y, int length, uint16_t color0, uint16_t color1, uint16_t *line);
 
 #ifdef __cplusplus
 }
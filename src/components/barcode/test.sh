@@ -0,0 +1 @@
+gcc -c qrtiny.c -o qrtiny.o && g++ QrTinyTest.cpp qrtiny.o -o ./qrtinytest && ./qrtinytest "$@"
@@ -15,6 +15,10 @@ Battery::Battery() {
 }
 
 void Battery::ReadPowerState() {
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+  bool wasCharging = IsCharging();
+  bool wasPowerPresent = isPowerPresent;
+#endif
   isCharging = !nrf_gpio_pin_read(PinMap::Charging);
   isPowerPresent = !nrf_gpio_pin_read(PinMap::PowerPresent);
 
@@ -23,6 +27,11 @@ void Battery::ReadPowerState() {
   } else if (!isPowerPresent) {
     isFull = false;
   }
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+  if (IsCharging() != wasCharging || isPowerPresent != wasPowerPresent) {
+    changeCount++;
+  }
+#endif
 }
 
 void Battery::MeasureVoltage() {
@@ -85,6 +94,9 @@ void Battery::SaadcEventHandler(nrfx_saadc_evt_t const* p_event) {
 
     if ((isPowerPresent && newPercent > percentRemaining) || (!isPowerPresent && newPercent < percentRemaining) || firstMeasurement) {
       firstMeasurement = false;
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+      if (newPercent != percentRemaining) changeCount++;
+#endif
       percentRemaining = newPercent;
       systemTask->PushMessage(System::Messages::BatteryPercentageUpdated);
     }
@@ -1,4 +1,6 @@
 #pragma once
+#include "cueband.h"
+
 #include <cstdint>
 #include <drivers/include/nrfx_saadc.h>
 #include <systemtask/SystemTask.h>
@@ -32,6 +34,13 @@ namespace Pinetime {
         return isPowerPresent;
       }
 
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+      // Incremented whenever the percentage, charging or power present state changes
+      uint32_t ChangeCount() const {
+        return changeCount;
+      }
+#endif
+
     private:
       static Battery* instance;
       nrf_saadc_value_t saadc_value;
@@ -44,6 +53,9 @@ namespace Pinetime {
       bool isCharging = false;
       bool isPowerPresent = false;
       bool firstMeasurement = true;
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+      uint32_t changeCount = 0;
+#endif
 
       void SaadcInit();
 
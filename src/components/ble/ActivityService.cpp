@@ -12,6 +12,9 @@
 #include "ActivityService.h"
 
 #include "systemtask/SystemTask.h"
+#ifdef CUEBAND_SCRATCH_ARENA
+#include "components/scratch/scratch.h"
+#endif
 
 #define MAX_PACKET 20
 
@@ -88,7 +91,11 @@ void Pinetime::Controllers::ActivityService::Disconnect() {
   readLogicalBlockIndex = ACTIVITY_BLOCK_INVALID;
   blockLength = 0;
   blockOffset = 0;
+#ifdef CUEBAND_SCRATCH_ARENA
+  scratch_release(SCRATCH_OWNER_ACTIVITY_BLOCK, blockBuffer);
+#else
   free(blockBuffer);
+#endif
   blockBuffer = nullptr;
   packetTransmitting = false;
 }
@@ -128,6 +135,14 @@ void Pinetime::Controllers::ActivityService::SendNextPacket() {
             }
         }
     }
+
+#ifdef CUEBAND_SCRATCH_ARENA
+    // The notifications hold copies of the data, so the buffer is returned once the whole block is queued
+    if (blockBuffer != nullptr && !IsSending()) {
+        scratch_release(SCRATCH_OWNER_ACTIVITY_BLOCK, blockBuffer);
+        blockBuffer = nullptr;
+    }
+#endif
 }
 
 void Pinetime::Controllers::ActivityService::TxNotification(ble_gap_event* event) {
@@ -155,7 +170,11 @@ void Pinetime::Controllers::ActivityService::StartRead() {
     if (readLogicalBlockIndex == ACTIVITY_BLOCK_INVALID) { return; }
 
     if (blockBuffer == nullptr) {
+#ifdef CUEBAND_SCRATCH_ARENA
+        blockBuffer = (uint8_t *)scratch_acquire(SCRATCH_OWNER_ACTIVITY_BLOCK, prefix + len);
+#else
         blockBuffer = (uint8_t *)malloc(prefix + len);
+#endif
     }
 
     if (blockBuffer == nullptr || IsSending()) {
@@ -177,6 +196,12 @@ blockBuffer[i + prefix] = (uint8_t)i;
         // Send empty length
         auto* omLen = ble_hs_mbuf_from_flat(&len, sizeof(len));
         ble_gattc_notify_custom(tx_conn_handle, transmitHandle, omLen);
+#ifdef CUEBAND_SCRATCH_ARENA
+        if (blockBuffer != nullptr && !IsSending()) {
+            scratch_release(SCRATCH_OWNER_ACTIVITY_BLOCK, blockBuffer);
+            blockBuffer = nullptr;
+        }
+#endif
     } else {
         memcpy(blockBuffer, &len, sizeof(len));
         blockOffset = 0;
@@ -58,6 +58,12 @@ uint32_t Ble::GetChallenge() {
   return hash(data, sizeof(data));
 }
 
+// Per-device key: the response to a challenge of the address alone (does not reveal the shared key)
+uint32_t Ble::GetDeviceKey() {
+  std::array<uint8_t, 6> addr = this->Address();
+  return GetResponse(hash(addr.data(), addr.size()));
+}
+
 bool Ble::ProvideChallengeResponse(uint32_t response) {
   uint32_t challenge = GetChallenge();
   uint32_t compareResponse = GetResponse(challenge);
@@ -87,6 +93,9 @@ bool Ble::IsConnected() const {
 
 void Ble::Connect() {
   isConnected = true;
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+  changeCount++;
+#endif
 #if defined(CUEBAND_TRUSTED_CONNECTION)
   connectedElapsed = elapsed;
   connectedTime = now;
@@ -106,6 +115,9 @@ void Ble::Connect() {
 
 void Ble::Disconnect() {
   isConnected = false;
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+  changeCount++;
+#endif
 #if defined(CUEBAND_SERVICE_UART_ENABLED) || defined(CUEBAND_ACTIVITY_ENABLED)
   SetMtu(23);   // reset to base MTU
 #endif
@@ -120,10 +132,16 @@ bool Ble::IsRadioEnabled() const {
 
 void Ble::EnableRadio() {
   isRadioEnabled = true;
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+  changeCount++;
+#endif
 }
 
 void Ble::DisableRadio() {
   isRadioEnabled = false;
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+  changeCount++;
+#endif
 }
 
 void Ble::StartFirmwareUpdate() {
@@ -26,6 +26,13 @@ namespace Pinetime {
       void EnableRadio();
       void DisableRadio();
 
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+      // Incremented whenever the connection or radio state changes
+      uint32_t ChangeCount() const {
+        return changeCount;
+      }
+#endif
+
       void StartFirmwareUpdate();
       void StopFirmwareUpdate();
       void FirmwareUpdateTotalBytes(uint32_t totalBytes);
@@ -83,6 +90,7 @@ namespace Pinetime {
         }
       }
       uint32_t GetChallenge();
+      uint32_t GetDeviceKey();    // Shown in the provisioning QR Code
       bool ProvideChallengeResponse(uint32_t response);
       bool ProvideKey(const char *key, size_t length);  // testing only
       void SetBonded() {
@@ -123,6 +131,9 @@ namespace Pinetime {
 
       bool isConnected = false;
       bool isRadioEnabled = true;
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+      uint32_t changeCount = 0;
+#endif
       bool isFirmwareUpdating = false;
       uint32_t firmwareUpdateTotalBytes = 0;
       uint32_t firmwareUpdateCurrentBytes = 0;
@@ -0,0 +1,95 @@
+#include "components/ble/DfuPageWriter.h"
+#include <cstring>
+#include <algorithm>
+
+using namespace Pinetime::Controllers;
+
+void DfuPageWriter::Start(size_t totalSize) {
+  spiNorFlash.WaitWriteComplete();
+  fillPage = 0;
+  fillIndex = 0;
+  fillAddress = 0;
+  pendingPage = -1;
+  erasedEnd = 0;
+  eraseEnd = (std::min(totalSize, size) + sectorSize - 1) & ~(sectorSize - 1);
+  programs = 0;
+  erases = 0;
+}
+
+void DfuPageWriter::Append(const uint8_t* data, size_t length) {
+  while (length > 0) {
+    size_t chunk = std::min(pageSize - fillIndex, length);
+    std::memcpy(pages[fillPage] + fillIndex, data, chunk);
+    fillIndex += chunk;
+    data += chunk;
+    length -= chunk;
+    if (fillIndex == pageSize) {
+      QueuePage();
+    }
+  }
+  Service(false);
+}
+
+// Program any partial last page, and wait for all writes to complete
+void DfuPageWriter::Finish() {
+  if (fillIndex > 0) {
+    QueuePage();
+  }
+  Service(true);
+  spiNorFlash.WaitWriteComplete();
+}
+
+// Erase a sector outside of the image (e.g. for the trailer at the end of the area), after Finish()
+void DfuPageWriter::EraseSector(uint32_t address) {
+  address &= ~(sectorSize - 1);
+  if (address < erasedEnd)
+    return;
+  spiNorFlash.SectorErase(offset + address);
+  erases++;
+}
+
+void DfuPageWriter::QueuePage() {
+  // Both buffers in use: wait for the flash to take the previous page
+  if (pendingPage >= 0) {
+    Service(true);
+  }
+  pendingPage = fillPage;
+  pendingAddress = fillAddress;
+  pendingLength = fillIndex;
+  fillAddress += fillIndex;
+  fillPage ^= 1;
+  fillIndex = 0;
+}
+
+void DfuPageWriter::StartErase() {
+  spiNorFlash.SectorEraseStart(offset + erasedEnd);
+  erasedEnd += sectorSize;
+  erases++;
+}
+
+// Start the next flash operation, if any, when the flash is idle
+void DfuPageWriter::Service(bool waitForPending) {
+  while (true) {
+    bool eraseAhead = (erasedEnd < eraseEnd) && (erasedEnd <= fillAddress + sectorSize);
+    if (pendingPage < 0 && !eraseAhead)
+      return;
+
+    if (spiNorFlash.WritePending()) {
+      if (!waitForPending || pendingPage < 0)
+        return;
+      spiNorFlash.WaitWriteComplete();
+    }
+
+    if (pendingPage >= 0) {
+      if (pendingAddress >= erasedEnd) {
+        StartErase(); // Erase has fallen behind the writes
+      } else {
+        spiNorFlash.PageProgramStart(offset + pendingAddress, pages[pendingPage], pendingLength);
+        pendingPage = -1;
+        programs++;
+      }
+    } else {
+      StartErase();
+    }
+  }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "drivers/SpiNorFlash.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    /* Writes a DFU image to the external flash a whole page at a time, page-aligned, from two page buffers: one
+     * filling with the received data while the other is being programmed.  Rather than erasing the whole area
+     * before the transfer, each sector is erased just ahead of the write pointer, and the erase and program
+     * operations are started without waiting for them, so they overlap the reception of the next packets.
+     */
+    class DfuPageWriter {
+    public:
+      static constexpr size_t pageSize = Pinetime::Drivers::SpiNorFlash::pageSize;
+      static constexpr size_t sectorSize = Pinetime::Drivers::SpiNorFlash::sectorSize;
+
+      DfuPageWriter(Pinetime::Drivers::SpiNorFlash& spiNorFlash, uint32_t offset, size_t size)
+        : spiNorFlash {spiNorFlash}, offset {offset}, size {size} {
+      }
+
+      void Start(size_t totalSize);
+      void Append(const uint8_t* data, size_t length);
+      void Finish();
+      void EraseSector(uint32_t address);
+
+      // Once finished, a page buffer can be used as scratch space (e.g. to read the image back)
+      uint8_t* Buffer() {
+        return pages[0];
+      }
+
+      unsigned int programs = 0;
+      unsigned int erases = 0;
+
+    private:
+      Pinetime::Drivers::SpiNorFlash& spiNorFlash;
+      const uint32_t offset;
+      const size_t size;
+
+      uint8_t pages[2][pageSize] __attribute__((aligned(4)));
+      int fillPage = 0;
+      size_t fillIndex = 0;
+      uint32_t fillAddress = 0; // Image address of the page being filled
+      int pendingPage = -1;     // Full page waiting to be programmed
+      uint32_t pendingAddress = 0;
+      size_t pendingLength = 0;
+      uint32_t erasedEnd = 0;   // Sectors erased (or erasing) up to this image address
+      uint32_t eraseEnd = 0;    // Sectors needed by the image
+
+      void QueuePage();
+      void Service(bool waitForPending);
+      void StartErase();
+    };
+  }
+}
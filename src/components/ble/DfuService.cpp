@@ -2,10 +2,17 @@
 
 #include "components/ble/DfuService.h"
 #include <cstring>
+#include <algorithm>
 #include "components/ble/BleController.h"
 #include "drivers/SpiNorFlash.h"
 #include "systemtask/SystemTask.h"
 #include <nrf_log.h>
+#ifdef CUEBAND_DFU_STREAMING_CRC
+#include "components/ble/dfucrc.h"
+#endif
+#ifdef CUEBAND_SCRATCH_ARENA
+#include "components/scratch/scratch.h"
+#endif
 
 using namespace Pinetime::Controllers;
 
@@ -222,21 +229,32 @@ int DfuService::WritePacketHandler(uint16_t connectionHandle, os_mbuf* om) {
       // Use the new code when receiving larger packets
       if (largePackets) {
 
-#ifdef CUEBAND_GLOBAL_SCRATCH_BUFFER
+        size_t length = OS_MBUF_PKTLEN(om);
+#ifdef CUEBAND_SCRATCH_ARENA
+        // (a packet that cannot be held is dropped, and the image then fails validation)
+        uint8_t *recvData = (uint8_t *)scratch_acquire(SCRATCH_OWNER_DFU_PACKET, length);
+#elif defined(CUEBAND_GLOBAL_SCRATCH_BUFFER)
         uint8_t *recvData = (uint8_t *)cuebandGlobalScratchBuffer;
 #else
         static uint8_t recvData[253];
 #endif
 
-        size_t length = OS_MBUF_PKTLEN(om);
 #ifdef CUEBAND_DEBUG_DFU
       if (nbPacketReceived <= 1) {
         debugFirstPacketLength = length;
       }
       debugLastPacketLength = length;
 #endif
+#ifdef CUEBAND_SCRATCH_ARENA
+        if (recvData != nullptr) {
+          os_mbuf_copydata(om, 0, length, recvData);
+          dfuImage.AppendLarge(recvData, length);
+          scratch_release(SCRATCH_OWNER_DFU_PACKET, recvData);
+        }
+#else
         os_mbuf_copydata(om, 0, length, recvData);
         dfuImage.AppendLarge(recvData, length);
+#endif
       }
       else  // ...chain to original code below...
 #endif
@@ -462,6 +480,15 @@ void DfuService::DfuImage::Init(size_t chunkSize, size_t totalSize, uint16_t exp
   this->chunkSize = chunkSize;
   this->totalSize = totalSize;
   this->expectedCrc = expectedCrc;
+#ifdef CUEBAND_DFU_STREAMING_CRC
+  streamCrc = DFU_CRC16_INITIAL;
+  streamCrcLength = 0;
+#endif
+#ifdef CUEBAND_DFU_PAGE_WRITES
+  bufferWriteIndex = 0;
+  totalWriteIndex = 0;
+  pageWriter.Start(totalSize);
+#endif
   this->ready = true;
 }
 
@@ -473,6 +500,10 @@ void DfuService::DfuImage::Init(size_t chunkSize, size_t totalSize, uint16_t exp
 // ...this code chains to the original code and maintains the first condition, even when larger packets are sent.
 void DfuService::DfuImage::AppendLarge(uint8_t* data, size_t size) {
   if (!ready) return;
+#ifdef CUEBAND_DFU_PAGE_WRITES
+  // The page writer takes any packet size
+  Append(data, size);
+#else
   size_t ofs = 0;
   // Repeatedly process chunks of the incoming data
   while (ofs < size) {
@@ -491,14 +522,38 @@ void DfuService::DfuImage::AppendLarge(uint8_t* data, size_t size) {
     Append(data + ofs, len);
     ofs += len;
   }
+#endif
 }
 #endif
 
 void DfuService::DfuImage::Append(uint8_t* data, size_t size) {
   if (!ready)
     return;
+#ifndef CUEBAND_DFU_PAGE_WRITES
   ASSERT(size <= 20);
+#endif
+
+#ifdef CUEBAND_DFU_STREAMING_CRC
+  // Packets arrive in order, so the image CRC can be updated as each is received (only up to the image size)
+  if (streamCrcLength < totalSize) {
+    size_t crcSize = std::min(size, totalSize - streamCrcLength);
+    streamCrc = dfu_crc16_update(streamCrc, data, crcSize);
+    streamCrcLength += crcSize;
+  }
+#endif
 
+#ifdef CUEBAND_DFU_PAGE_WRITES
+  // Whole pages are programmed as they fill (erasing ahead), then the last partial page once the image is complete
+  if (size > totalSize - totalWriteIndex) size = totalSize - totalWriteIndex;
+  if (size == 0) return;
+  pageWriter.Append(data, size);
+  if (totalWriteIndex + size == totalSize) {
+    pageWriter.Finish();
+    if (totalSize < maxSize)
+      WriteMagicNumber();
+  }
+  totalWriteIndex += size;
+#else
   std::memcpy(tempBuffer + bufferWriteIndex, data, size);
   bufferWriteIndex += size;
 
@@ -514,6 +569,7 @@ void DfuService::DfuImage::Append(uint8_t* data, size_t size) {
     if (totalSize < maxSize)
       WriteMagicNumber();
   }
+#endif
 
 #ifdef CUEBAND_DEBUG_DFU
   debugTotalWriteIndex = totalWriteIndex;
@@ -531,6 +587,10 @@ void DfuService::DfuImage::WriteMagicNumber() {
   };
 
   uint32_t offset = writeOffset + (maxSize - (4 * sizeof(uint32_t)));
+#ifdef CUEBAND_DFU_PAGE_WRITES
+  // Only the sectors the image covers have been erased
+  pageWriter.EraseSector(maxSize - (4 * sizeof(uint32_t)));
+#endif
   spiNorFlash.Write(offset, reinterpret_cast<const uint8_t*>(magic), 4 * sizeof(uint32_t));
 
 #ifdef CUEBAND_DEBUG_DFU
@@ -539,12 +599,46 @@ void DfuService::DfuImage::WriteMagicNumber() {
 }
 
 void DfuService::DfuImage::Erase() {
+#ifdef CUEBAND_DFU_PAGE_WRITES
+  // Sectors are erased as they are needed (DfuPageWriter)
+#else
   for (size_t erased = 0; erased < maxSize; erased += 0x1000) {
     spiNorFlash.SectorErase(writeOffset + erased);
   }
+#endif
 }
 
 bool DfuService::DfuImage::Validate() {
+#if defined(CUEBAND_DFU_PAGE_WRITES) && (!defined(CUEBAND_DFU_STREAMING_CRC) || defined(CUEBAND_DFU_VERIFY_READBACK))
+  uint8_t* tempBuffer = pageWriter.Buffer();
+#endif
+#ifdef CUEBAND_DFU_STREAMING_CRC
+  uint16_t crc = streamCrc;
+  bool valid = (streamCrcLength == totalSize) && (crc == expectedCrc);
+
+#ifdef CUEBAND_DFU_VERIFY_READBACK
+  // Optional check that the image was written correctly
+  if (valid) {
+    uint16_t readCrc = DFU_CRC16_INITIAL;
+    for (size_t currentOffset = 0; currentOffset < totalSize; currentOffset += bufferSize) {
+      size_t readSize = totalSize - currentOffset;
+      if (readSize > bufferSize) readSize = bufferSize;
+      spiNorFlash.Read(writeOffset + currentOffset, tempBuffer, readSize);
+      readCrc = dfu_crc16_update(readCrc, tempBuffer, readSize);
+    }
+    if (readCrc != crc) {
+      crc = readCrc;
+      valid = false;
+    }
+  }
+#endif
+
+#ifdef CUEBAND_DEBUG_DFU
+  debugLastCalculatedCrc = crc;
+#endif
+
+  return valid;
+#else
   uint32_t chunkSize = 200;
   size_t currentOffset = 0;
   uint16_t crc = 0;
@@ -567,6 +661,7 @@ bool DfuService::DfuImage::Validate() {
 #endif
 
   return (crc == expectedCrc);
+#endif
 }
 
 uint16_t DfuService::DfuImage::ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t const* p_crc) {
@@ -10,6 +10,9 @@
 #include <host/ble_gap.h>
 #undef max
 #undef min
+#ifdef CUEBAND_DFU_PAGE_WRITES
+#include "components/ble/DfuPageWriter.h"
+#endif
 
 namespace Pinetime {
   namespace System {
@@ -54,8 +57,13 @@ namespace Pinetime {
       };
       class DfuImage {
       public:
+#ifdef CUEBAND_DFU_PAGE_WRITES
+        DfuImage(Pinetime::Drivers::SpiNorFlash& spiNorFlash) : spiNorFlash {spiNorFlash}, pageWriter {spiNorFlash, writeOffset, maxSize} {
+        }
+#else
         DfuImage(Pinetime::Drivers::SpiNorFlash& spiNorFlash) : spiNorFlash {spiNorFlash} {
         }
+#endif
         void Init(size_t chunkSize, size_t totalSize, uint16_t expectedCrc);
         void Erase();
         void Append(uint8_t* data, size_t size);
@@ -75,8 +83,16 @@ namespace Pinetime {
         size_t bufferWriteIndex = 0;
         size_t totalWriteIndex = 0;
         static constexpr size_t writeOffset = 0x40000;
+#ifdef CUEBAND_DFU_PAGE_WRITES
+        DfuPageWriter pageWriter;
+#else
         uint8_t tempBuffer[bufferSize];
+#endif
         uint16_t expectedCrc = 0;
+#ifdef CUEBAND_DFU_STREAMING_CRC
+        uint16_t streamCrc = 0xffff;      // CRC of the first streamCrcLength bytes appended
+        size_t streamCrcLength = 0;
+#endif
 
         void WriteMagicNumber();
         uint16_t ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t const* p_crc);
@@ -0,0 +1,267 @@
+// Host model of writing a DFU image to the external SPI NOR flash.
+// Runs the DfuPageWriter against a simulated flash (NOR semantics, busy times for sector erase and page program, SPI
+// transfer times, and vTaskDelay(1) polling while busy) and compares the end-to-end DFU time with the previous
+// DfuImage: erase the whole area at the start, then program each 200-byte buffer (straddling the 256-byte pages).
+// Checks the flash holds the image and the magic number, and that the flash is never accessed while busy.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "components/ble/DfuPageWriter.h"
+
+using namespace Pinetime::Drivers;
+using namespace Pinetime::Controllers;
+
+#define WRITE_OFFSET 0x40000        // DfuImage::writeOffset
+#define MAX_SIZE 475136             // DfuImage::maxSize
+#define BUFFER_SIZE 200             // DfuImage::bufferSize
+#define FLASH_SIZE (4 * 1024 * 1024)
+
+// Flash timing (typical datasheet values for 4 KB erase and 256-byte page program), SPI at 8 MHz
+#define ERASE_US 45000.0
+#define PROGRAM_BASE_US 100.0
+#define PROGRAM_PAGE_US 600.0       // ...plus this scaled by the fraction of the page programmed
+#define SPI_BYTE_US 1.0
+#define SPI_CALL_US 10.0
+#define TICK_US (1000000.0 / 1024)  // vTaskDelay(1)
+
+static double simNow;               // Time of the task writing the image (us)
+static double busyUntil;
+static uint8_t *memory;
+static unsigned int violations;
+
+static void spiTransfer(size_t bytes) {
+  simNow += SPI_CALL_US + bytes * SPI_BYTE_US;
+}
+
+// Simulated driver, with the same structure as drivers/SpiNorFlash.cpp
+SpiNorFlash::SpiNorFlash(Spi& spi) : spi {spi} {
+}
+
+bool SpiNorFlash::WriteInProgress() {
+  spiTransfer(2);
+  return simNow < busyUntil;
+}
+
+void SpiNorFlash::WriteEnable() {
+  spiTransfer(1);
+}
+
+void SpiNorFlash::Read(uint32_t address, uint8_t* buffer, size_t size) {
+  WaitWriteComplete();
+  if (simNow < busyUntil) violations++;
+  spiTransfer(4 + size);
+  memcpy(buffer, memory + address, size);
+}
+
+void SpiNorFlash::SectorErase(uint32_t sectorAddress) {
+  SectorEraseStart(sectorAddress);
+  WaitWriteComplete();
+}
+
+void SpiNorFlash::SectorEraseStart(uint32_t sectorAddress) {
+  WaitWriteComplete();
+  WriteEnable();
+  if (simNow < busyUntil) violations++;
+  spiTransfer(4);
+  memset(memory + (sectorAddress & ~(sectorSize - 1)), 0xff, sectorSize);
+  busyUntil = simNow + ERASE_US;
+  writePending = true;
+}
+
+void SpiNorFlash::PageProgramStart(uint32_t address, const uint8_t* buffer, size_t size) {
+  WaitWriteComplete();
+  WriteEnable();
+  if (simNow < busyUntil) violations++;
+  if ((address & (pageSize - 1)) + size > pageSize) violations++;    // Would wrap within the page
+  spiTransfer(4 + size);
+  for (size_t i = 0; i < size; i++) memory[address + i] &= buffer[i];
+  busyUntil = simNow + PROGRAM_BASE_US + PROGRAM_PAGE_US * size / pageSize;
+  writePending = true;
+}
+
+bool SpiNorFlash::WritePending() {
+  if (writePending && !WriteInProgress()) {
+    writePending = false;
+  }
+  return writePending;
+}
+
+void SpiNorFlash::WaitWriteComplete() {
+  if (!writePending)
+    return;
+  while (WriteInProgress())
+    simNow = ((unsigned long)(simNow / TICK_US) + 1) * TICK_US;
+  writePending = false;
+}
+
+void SpiNorFlash::Write(uint32_t address, const uint8_t* buffer, size_t size) {
+  size_t len = size;
+  uint32_t addr = address;
+  const uint8_t* b = buffer;
+  while (len > 0) {
+    uint32_t pageLimit = (addr & ~(pageSize - 1u)) + pageSize;
+    uint32_t toWrite = pageLimit - addr > len ? len : pageLimit - addr;
+
+    PageProgramStart(addr, b, toWrite);
+    WaitWriteComplete();
+
+    addr += toWrite;
+    b += toWrite;
+    len -= toWrite;
+  }
+}
+
+static const uint32_t magic[4] = {0xf395c277, 0x7fefd260, 0x0f505235, 0x8079b62c};
+
+// The previous DfuImage
+struct PreviousImage {
+  SpiNorFlash& spiNorFlash;
+  size_t totalSize;
+  uint8_t tempBuffer[BUFFER_SIZE];
+  size_t bufferWriteIndex = 0;
+  size_t totalWriteIndex = 0;
+  unsigned int writes = 0;
+
+  PreviousImage(SpiNorFlash& spiNorFlash, size_t totalSize) : spiNorFlash {spiNorFlash}, totalSize {totalSize} {}
+
+  void Erase() {
+    for (size_t erased = 0; erased < MAX_SIZE; erased += 0x1000) spiNorFlash.SectorErase(WRITE_OFFSET + erased);
+  }
+
+  void Append(const uint8_t* data, size_t size) {   // (DfuImage::AppendLarge() with the chunking to the buffer)
+    while (size > 0) {
+      size_t len = BUFFER_SIZE - bufferWriteIndex;
+      if (len > size) len = size;
+      memcpy(tempBuffer + bufferWriteIndex, data, len);
+      bufferWriteIndex += len;
+      data += len;
+      size -= len;
+      if (bufferWriteIndex == BUFFER_SIZE) {
+        spiNorFlash.Write(WRITE_OFFSET + totalWriteIndex, tempBuffer, bufferWriteIndex);
+        writes++;
+        totalWriteIndex += bufferWriteIndex;
+        bufferWriteIndex = 0;
+      }
+      if (bufferWriteIndex > 0 && totalWriteIndex + bufferWriteIndex == totalSize) {
+        spiNorFlash.Write(WRITE_OFFSET + totalWriteIndex, tempBuffer, bufferWriteIndex);
+        writes++;
+        totalWriteIndex += bufferWriteIndex;
+      }
+    }
+    if (totalWriteIndex == totalSize && totalSize < MAX_SIZE) {
+      spiNorFlash.Write(WRITE_OFFSET + MAX_SIZE - sizeof(magic), reinterpret_cast<const uint8_t*>(magic), sizeof(magic));
+    }
+  }
+};
+
+static int failures = 0;
+
+static bool checkFlash(const uint8_t* image, size_t size, bool fullErase) {
+  bool ok = memcmp(memory + WRITE_OFFSET, image, size) == 0;
+  if (size < MAX_SIZE && memcmp(memory + WRITE_OFFSET + MAX_SIZE - sizeof(magic), magic, sizeof(magic)) != 0) ok = false;
+  // The rest of the image's last sector, and (for the previous code) the whole area, is erased
+  size_t end = fullErase ? MAX_SIZE - sizeof(magic) : ((size + 0xfff) & ~(size_t)0xfff);
+  if (end > MAX_SIZE - sizeof(magic)) end = MAX_SIZE - sizeof(magic);
+  for (size_t i = size; i < end; i++) if (memory[WRITE_OFFSET + i] != 0xff) { ok = false; break; }
+  return ok;
+}
+
+// Returns the end-to-end time (ms) from the start of the DFU to the last packet written
+static double run(bool pageWriter, const uint8_t* image, size_t size, size_t packetSize, double packetIntervalUs, unsigned int* writes, unsigned int* erases) {
+  memset(memory, 0x5a, FLASH_SIZE);   // Previous contents
+  simNow = 0;
+  busyUntil = 0;
+  violations = 0;
+  static uint8_t spiStorage[64];
+  SpiNorFlash flash(*reinterpret_cast<Spi*>(spiStorage));
+
+  static DfuPageWriter* writer = nullptr;
+  if (!writer) writer = new DfuPageWriter(flash, WRITE_OFFSET, MAX_SIZE);
+  PreviousImage previous(flash, size);
+
+  // StartDFU (erase), then the packets arrive at the given rate, or as soon as the previous one has been handled
+  if (pageWriter) writer->Start(size); else previous.Erase();
+  double dataStart = simNow;
+  for (size_t offset = 0, packet = 0; offset < size; offset += packetSize, packet++) {
+    double arrival = dataStart + packet * packetIntervalUs;
+    if (simNow < arrival) simNow = arrival;
+    size_t length = (size - offset) > packetSize ? packetSize : (size - offset);
+    if (pageWriter) {
+      writer->Append(image + offset, length);
+      if (offset + length == size) {
+        writer->Finish();
+        writer->EraseSector(MAX_SIZE - sizeof(magic));
+        flash.Write(WRITE_OFFSET + MAX_SIZE - sizeof(magic), reinterpret_cast<const uint8_t*>(magic), sizeof(magic));
+      }
+    } else {
+      previous.Append(image + offset, length);
+    }
+  }
+  *writes = pageWriter ? writer->programs : previous.writes;
+  *erases = pageWriter ? writer->erases : MAX_SIZE / 0x1000;
+
+  bool ok = checkFlash(image, size, !pageWriter) && violations == 0;
+  if (!ok) {
+    printf("FAIL: %s, %u bytes, %u-byte packets: flash contents or %u access(es) while busy\n", pageWriter ? "page writer" : "previous", (unsigned int)size, (unsigned int)packetSize, violations);
+    failures++;
+  }
+  return simNow / 1000;
+}
+
+int main(int argc, char *argv[]) {
+  memory = (uint8_t*)malloc(FLASH_SIZE);
+  static uint8_t image[MAX_SIZE];
+  srand(1);
+  for (size_t i = 0; i < sizeof(image); i++) image[i] = (uint8_t)rand();
+
+  // Image sizes (including odd ones, a multiple of 200 bytes and the largest), packet rates (20-byte packets at ~8 KB/s
+  // and large MTU packets at ~40 KB/s)
+  const size_t sizes[] = { 23356, 200000, 400000, 464000, MAX_SIZE - 16 };
+  const struct { size_t size; double intervalUs; } links[] = { { 20, 2500.0 }, { 244, 6100.0 } };
+
+  printf("End-to-end DFU write time (s): flash erase %.0f ms/sector, program %.1f ms/page\n", ERASE_US / 1000, (PROGRAM_BASE_US + PROGRAM_PAGE_US) / 1000);
+  printf("   image  packet  transfer    previous  page-writer\n");
+  for (size_t l = 0; l < sizeof(links) / sizeof(links[0]); l++) {
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+      unsigned int previousWrites, previousErases, pagePrograms, pageErases;
+      double transferMs = ((sizes[s] + links[l].size - 1) / links[l].size) * links[l].intervalUs / 1000;
+      double previousMs = run(false, image, sizes[s], links[l].size, links[l].intervalUs, &previousWrites, &previousErases);
+      double pageMs = run(true, image, sizes[s], links[l].size, links[l].intervalUs, &pagePrograms, &pageErases);
+      printf("  %6u  %6u  %8.2f    %8.2f     %8.2f   (%u erases, %u buffer writes -> %u erases, %u page programs)\n",
+             (unsigned int)sizes[s], (unsigned int)links[l].size, transferMs / 1000, previousMs / 1000, pageMs / 1000,
+             previousErases, previousWrites, pageErases, pagePrograms);
+      if (pageMs > previousMs) failures++;
+    }
+  }
+
+  // Packets of irregular sizes (e.g. changing MTU), still page-aligned programs
+  {
+    memset(memory, 0x5a, FLASH_SIZE);
+    simNow = busyUntil = 0;
+    violations = 0;
+    static uint8_t spiStorage[64];
+    SpiNorFlash flash(*reinterpret_cast<Spi*>(spiStorage));
+    DfuPageWriter writer(flash, WRITE_OFFSET, MAX_SIZE);
+    size_t size = 100003;
+    writer.Start(size);
+    for (size_t offset = 0, i = 0; offset < size; i++) {
+      size_t length = 1 + (i * 37) % 253;
+      if (length > size - offset) length = size - offset;
+      writer.Append(image + offset, length);
+      offset += length;
+    }
+    writer.Finish();
+    writer.EraseSector(MAX_SIZE - sizeof(magic));
+    flash.Write(WRITE_OFFSET + MAX_SIZE - sizeof(magic), reinterpret_cast<const uint8_t*>(magic), sizeof(magic));
+    bool ok = checkFlash(image, size, false) && violations == 0 && writer.programs == (size + 255) / 256;
+    printf("Irregular packets: %u page programs, %u erases -- %s\n", writer.programs, writer.erases, ok ? "OK" : "FAIL");
+    if (!ok) failures++;
+  }
+
+  free(memory);
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures ? 1 : 0;
+}
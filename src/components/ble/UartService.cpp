@@ -16,6 +16,12 @@
 
 #include "systemtask/SystemTask.h"
 #include <hal/nrf_rtc.h>
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+#include "components/timing/frametiming.h"
+#endif
+#ifdef CUEBAND_SCRATCH_ARENA
+#include "components/scratch/scratch.h"
+#endif
 
 // offset response from the year 2000 for compatibility
 #define EPOCH_OFFSET 946684800
@@ -280,10 +286,12 @@ void Pinetime::Controllers::UartService::Disconnect() {
     sendBuffer = nullptr;
     blockLength = 0;
     blockOffset = 0;
+#ifndef CUEBAND_SCRATCH_ARENA
     if (blockBuffer != nullptr) {
         free(blockBuffer);
         blockBuffer = nullptr;
     }
+#endif
     packetTransmitting = false;
 #ifdef CUEBAND_LOG
     logging = false;
@@ -680,9 +688,14 @@ cblog("LOG STARTED\n");
                     readLogicalBlockIndex = index;
                 }
 
+#ifdef CUEBAND_SCRATCH_ARENA
+                // Leased only while the text is formatted (it is copied to the stream buffer)
+                uint8_t *blockBuffer = (uint8_t *)scratch_acquire(SCRATCH_OWNER_UART_BLOCK, ACTIVITY_BLOCK_SIZE * 2 + 1);
+#else
                 if (blockBuffer == nullptr) {
                     blockBuffer = (uint8_t *)malloc(ACTIVITY_BLOCK_SIZE * 2 + 1);
                 }
+#endif
 
                 if (blockBuffer == nullptr) {
                     sprintf(resp, "?Memory\r\n");
@@ -729,6 +742,9 @@ if (!read) {
 
                     }
                 }
+#ifdef CUEBAND_SCRATCH_ARENA
+                scratch_release(SCRATCH_OWNER_UART_BLOCK, blockBuffer);
+#endif
 #else
                 sprintf(resp, "?Disabled\r\n");
 #endif
@@ -809,6 +825,49 @@ if (!read) {
                     sprintf(resp, "?!\r\n");
                 }
 
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+            } else if (data[0] == 'z' && (data[1] == 'f' || data[1] == 'F')) { // Debug: Frame timing histograms ('zF' also resets)
+                char line[FRAME_TIMING_LINE_MAX];
+                for (int id = 0; id < FRAME_TIMING_COUNT; id++) {
+                    frame_timing_format((frame_timing_id_t)id, line, sizeof(line));
+                    StreamAppendString(line);
+                }
+                sprintf(resp, "ZF:idle %lu\r\n", (unsigned long)frame_timing_idle_count());
+                if (data[1] == 'F') frame_timing_reset();
+#endif
+#ifdef CUEBAND_SCRATCH_ARENA
+            } else if (data[0] == 'z' && data[1] == 'm') { // Debug: Scratch arena use
+                scratch_format(resp, sizeof(resp));
+#endif
+#ifdef CUEBAND_TASK_PROFILE
+            } else if (data[0] == 'z' && data[1] == 'p') { // Debug: Task CPU use, stack and heap low-water marks
+                const task_profile_t& profile = m_system.GetMonitor().Profile();
+                char line[TASK_PROFILE_LINE_MAX];
+                for (int i = 0; i < profile.count; i++) {
+                    task_profile_format(&profile, i, line, sizeof(line));
+                    StreamAppendString(line);
+                }
+                task_profile_format(&profile, profile.count, resp, sizeof(resp));
+#endif
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+            } else if (data[0] == 'z' && data[1] == 'e') { // Debug: Estimated charge per subsystem (last epoch, and since the last record)
+                const energy_account_t& energy = m_system.GetEnergy();
+                char line[ENERGY_LINE_MAX];
+                for (int i = 0; i < ENERGY_COUNT; i++) {
+                    energy_format(&energy, i, line, sizeof(line));
+                    StreamAppendString(line);
+                }
+                energy_format(&energy, ENERGY_COUNT, resp, sizeof(resp));
+#endif
+#ifdef CUEBAND_BOOT_STAGES
+            } else if (data[0] == 'z' && data[1] == 'b') { // Debug: Boot stage times (ms from main(), 0 if pending), after the scheduler start
+                sprintf(resp, "ZB:sched %lu adv %lu time %lu cues %lu log %lu\r\n",
+                    (unsigned long)m_system.BootSchedulerMs(),
+                    (unsigned long)m_system.BootStageMs(Pinetime::System::SystemTask::BootAdvertising),
+                    (unsigned long)m_system.BootStageMs(Pinetime::System::SystemTask::BootTime),
+                    (unsigned long)m_system.BootStageMs(Pinetime::System::SystemTask::BootCues),
+                    (unsigned long)m_system.BootStageMs(Pinetime::System::SystemTask::BootActivity));
+#endif
             } else if (data[0] == 'z') { // Debug: Query inactive state
                 bool faceDown = false;
                 unsigned int faceDownTime = 0;
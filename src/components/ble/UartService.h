@@ -133,7 +133,9 @@ namespace Pinetime {
       static const size_t sendCapacity = 512 + 32;
       volatile size_t blockLength = 0;
       volatile size_t blockOffset = 0;
+#ifndef CUEBAND_SCRATCH_ARENA
       uint8_t *blockBuffer = nullptr;
+#endif
       volatile bool packetTransmitting = false;
       uint16_t tx_conn_handle = BLE_HS_CONN_HANDLE_NONE;
       unsigned int transmitErrorCount = 0;
@@ -0,0 +1,22 @@
+// CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xffff) as used by the Nordic DFU init packet.
+// Table-driven, a byte at a time, so that it can be updated as each DFU packet is received.
+
+#ifndef DFUCRC_H
+#define DFUCRC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DFU_CRC16_INITIAL 0xffff
+
+uint16_t dfu_crc16_update(uint16_t crc, const uint8_t *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,2 @@
+gcc -O2 -c dfucrc.c -o dfucrc.o && g++ -O2 DfuCrcTest.cpp dfucrc.o -o ./dfucrctest && ./dfucrctest "$@"
+g++ -O2 -I../.. DfuWriteModelTest.cpp DfuPageWriter.cpp -o ./dfuwritemodeltest && ./dfuwritemodeltest "$@"
@@ -6,12 +6,19 @@
 #include "displayapp/screens/Symbols.h"
 #include "components/battery/BatteryController.h"
 
+#include <cstring>
+
 using namespace Pinetime::Controllers;
 
 #define CUE_DATA_FILENAME "CUES.BIN"
 #define CUE_FILE_VERSION 1
 #define CUE_FILE_MIN_VERSION 1
 #define CUE_PROMPT_TYPE 0
+#ifdef CUEBAND_CUE_JOURNAL
+#define CUE_JOURNAL_FILENAME "CUES.LOG"
+#define CUE_JOURNAL_RECORD_SIZE 16
+#define CUE_JOURNAL_RECORD_STATE 0x01
+#endif
 
 CueController::CueController(Controllers::Settings& settingsController, 
                              Controllers::FS& fs,
@@ -113,6 +120,13 @@ void CueController::TimeChanged(uint32_t timestamp, uint32_t uptime) {
     }
 #endif
 
+    // If not prompting while the wearer is considered asleep...
+#ifdef CUEBAND_SILENT_WHEN_ASLEEP
+    if (activityController.IsAsleep()) {
+        snoozed = true;
+    }
+#endif
+
     // If we in a valid scheduled cue...
     if (effectiveInterval > 0) {
         // ...and not snoozing or manually overridden...
@@ -173,7 +187,20 @@ void CueController::TimeChanged(uint32_t timestamp, uint32_t uptime) {
     if (this->settingsChanged != 0) {
         if (++this->settingsChanged >= 10) {
             this->settingsChanged = 0;
-            WriteCues();
+#ifdef CUEBAND_CUE_JOURNAL
+            // Only option/impromptu state changed: append a journal record rather than rewriting the whole file
+            if (!scheduleChanged && journalValid && journalCount < CUEBAND_CUE_JOURNAL) {
+                writeError = AppendJournal();
+                if (writeError != 0) {
+                    // Fall back to rewriting the whole file (which then reports the write status)
+                    journalError = writeError;
+                    writeError = WriteCues();
+                }
+            } else
+#endif
+            {
+                writeError = WriteCues();
+            }
         }
     }
 
@@ -345,8 +372,10 @@ int CueController::ReadCues(uint32_t *version) {
     options_overridden_mask = headerBuffer[10] | (headerBuffer[11] << 8);
     options_overridden_value = headerBuffer[12] | (headerBuffer[13] << 8);
 
-    // Reserved (duration?)
-    //uint16_t reserved = headerBuffer[14] | (headerBuffer[15] << 8);
+#ifdef CUEBAND_CUE_JOURNAL
+    // Journal generation (previously reserved)
+    journalGeneration = headerBuffer[14] | (headerBuffer[15] << 8);
+#endif
 
     // Last impromptu settings
     this->lastInterval = headerBuffer[16] | (headerBuffer[17] << 8);
@@ -383,19 +412,120 @@ int CueController::ReadCues(uint32_t *version) {
     }
 
     fs.FileClose(&file_p);
+
+#ifdef CUEBAND_CUE_JOURNAL
+    // Replay any state changes appended since the file was written
+    journalValid = true;
+    ReadJournal();
+#endif
+
     return 0;
 }
 
-void CueController::DeferWriteCues() {
+void CueController::DeferWriteCues(bool scheduleChanged) {
+    if (scheduleChanged) {
+        this->scheduleChanged = true;
+    }
     if (this->settingsChanged == 0) {
         this->settingsChanged = 1;
     }
 }
 
+#ifdef CUEBAND_CUE_JOURNAL
+// Journal of state changes that do not alter the schedule -- each record holds the complete option/impromptu state, so the last valid record wins
+int CueController::ReadJournal() {
+    int ret;
+    journalCount = 0;
+
+    lfs_file_t file_p = {0};
+    ret = fs.FileOpen(&file_p, CUE_JOURNAL_FILENAME, LFS_O_RDONLY);
+    if (ret == LFS_ERR_CORRUPT) fs.FileDelete(CUE_JOURNAL_FILENAME);
+    if (ret != LFS_ERR_OK) {
+        return 1;   // No journal
+    }
+
+    uint8_t record[CUE_JOURNAL_RECORD_SIZE];
+    for (;;) {
+        ret = fs.FileRead(&file_p, record, sizeof(record));
+        if (ret != sizeof(record)) break;    // End of journal (or a partially-written final record)
+
+        // Validate record
+        uint8_t sum = 0;
+        for (unsigned int i = 0; i < sizeof(record); i++) sum += record[i];
+        if (sum != 0 || record[0] != CUE_JOURNAL_RECORD_STATE) break;
+        journalCount++;
+
+        // Ignore records for a different generation of the cue file (e.g. interrupted compaction)
+        uint16_t generation = record[2] | (record[3] << 8);
+        if (generation != journalGeneration) continue;
+
+        // Apply state
+        options_base_value = record[4] | (record[5] << 8);
+        options_overridden_mask = record[6] | (record[7] << 8);
+        options_overridden_value = record[8] | (record[9] << 8);
+        this->lastInterval = record[10] | (record[11] << 8);
+        if (this->lastInterval == 0 || this->lastInterval >= 0xffff) this->lastInterval = DEFAULT_INTERVAL;
+        this->promptStyle = record[12] | (record[13] << 8);
+        if (this->promptStyle >= 0xffff) this->promptStyle = DEFAULT_PROMPT_STYLE;
+    }
+
+    fs.FileClose(&file_p);
+    return 0;
+}
+
+int CueController::AppendJournal() {
+    int ret;
+    if (!initialized) return 9;
+
+    uint8_t record[CUE_JOURNAL_RECORD_SIZE];
+    record[0] = CUE_JOURNAL_RECORD_STATE;
+    record[1] = 0; // checksum (below)
+    record[2] = (uint8_t)journalGeneration; record[3] = (uint8_t)(journalGeneration >> 8);
+    record[4] = (uint8_t)options_base_value; record[5] = (uint8_t)(options_base_value >> 8);
+    record[6] = (uint8_t)options_overridden_mask; record[7] = (uint8_t)(options_overridden_mask >> 8);
+    record[8] = (uint8_t)options_overridden_value; record[9] = (uint8_t)(options_overridden_value >> 8);
+    record[10] = (uint8_t)this->lastInterval; record[11] = (uint8_t)(this->lastInterval >> 8);
+    record[12] = (uint8_t)this->promptStyle; record[13] = (uint8_t)(this->promptStyle >> 8);
+    record[14] = 0; record[15] = 0; // reserved
+    uint8_t sum = 0;
+    for (unsigned int i = 0; i < sizeof(record); i++) sum += record[i];
+    record[1] = (uint8_t)(0x100 - sum);
+
+    lfs_file_t file_p = {0};
+    ret = fs.FileOpen(&file_p, CUE_JOURNAL_FILENAME, LFS_O_WRONLY|LFS_O_CREAT|LFS_O_APPEND);
+    if (ret == LFS_ERR_CORRUPT) fs.FileDelete(CUE_JOURNAL_FILENAME);
+    if (ret != LFS_ERR_OK) {
+        return 1;
+    }
+
+    ret = fs.FileWrite(&file_p, record, sizeof(record));
+    fs.FileClose(&file_p);
+    if (ret != sizeof(record)) {
+        return 2;
+    }
+    journalCount++;
+
+    // Notify that the cues were changed
+    activityController.Event(ACTIVITY_EVENT_CUE_CONFIGURATION);
+
+    return 0;
+}
+#endif
+
 int CueController::WriteCues() {
     int ret;
     if (!initialized) return 9;
     this->settingsChanged = 0;
+    this->scheduleChanged = false;
+
+#ifdef CUEBAND_CUE_JOURNAL
+    // New generation: any existing journal records are superseded by this file
+    journalValid = false;
+    journalGeneration++;
+    uint16_t generation = journalGeneration;
+#else
+    uint16_t generation = 0;
+#endif
 
     int promptCount = sizeof(controlPoints) / sizeof(controlPoints[0]);
     uint32_t promptVersion = store.GetVersion();
@@ -406,7 +536,7 @@ int CueController::WriteCues() {
     headerBuffer[8] = (uint8_t)options_base_value; headerBuffer[9] = (uint8_t)(options_base_value >> 8);
     headerBuffer[10] = (uint8_t)options_overridden_mask; headerBuffer[11] = (uint8_t)(options_overridden_mask >> 8);
     headerBuffer[12] = (uint8_t)options_overridden_value; headerBuffer[13] = (uint8_t)(options_overridden_value >> 8);
-    headerBuffer[14] = 0; headerBuffer[15] = 0; // reserverd
+    headerBuffer[14] = (uint8_t)generation; headerBuffer[15] = (uint8_t)(generation >> 8);
     headerBuffer[16] = (uint8_t)this->lastInterval; headerBuffer[17] = (uint8_t)(this->lastInterval >> 8);
     headerBuffer[18] = (uint8_t)this->promptStyle; headerBuffer[19] = (uint8_t)(this->promptStyle >> 8);
     headerBuffer[20] = (uint8_t)CUE_PROMPT_TYPE; headerBuffer[21] = (uint8_t)(CUE_PROMPT_TYPE >> 8); headerBuffer[22] = (uint8_t)(CUE_PROMPT_TYPE >> 16); headerBuffer[23] = (uint8_t)(CUE_PROMPT_TYPE >> 24); 
@@ -437,6 +567,13 @@ int CueController::WriteCues() {
 
     fs.FileClose(&file_p);
 
+#ifdef CUEBAND_CUE_JOURNAL
+    // Compacted: remove the journal
+    fs.FileDelete(CUE_JOURNAL_FILENAME);
+    journalCount = 0;
+    journalValid = true;
+#endif
+
     // Notify that the cues were changed
     activityController.Event(ACTIVITY_EVENT_CUE_CONFIGURATION);
 
@@ -510,7 +647,7 @@ void CueController::Reset(bool everything) {
     lastCueIndex = ControlPoint::INDEX_NONE;
     // Store
     descriptionValid = false;
-    DeferWriteCues();
+    DeferWriteCues(true);
 }
 
 ControlPoint CueController::GetStoredControlPoint(int index) {
@@ -527,7 +664,7 @@ void CueController::SetScratchControlPoint(int index, ControlPoint controlPoint)
 
 void CueController::CommitScratch(uint32_t version) {
     store.CommitScratch(version);
-    DeferWriteCues();
+    DeferWriteCues(true);
     lastCueIndex = ControlPoint::INDEX_NONE;
     descriptionValid = false;
 }
@@ -538,6 +675,9 @@ void CueController::DebugText(char *debugText) {
 
   // File debug
   p += sprintf(p, "Fil: %s%d r%d w%d\n", initialized ? "i" : "I", this->settingsChanged, readError, writeError);
+#ifdef CUEBAND_CUE_JOURNAL
+  p += sprintf(p, "Jnl: %s%u g%u e%d\n", journalValid ? "v" : "V", journalCount, (unsigned int)journalGeneration, journalError);
+#endif
 
   // Version
   p += sprintf(p, "Ver: %lu\n", (unsigned long)version);
@@ -618,6 +758,11 @@ const char *CueController::Description(bool detailed, const char **symbol) {
     // static constexpr const char* cuebandImpromptu = "\xEF\x81\x8B";                  // 0xf04b, play
 
     if (!descriptionValid || descriptionDetailed != detailed) {
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+        const char *previousIcon = icon;
+        char previous[sizeof(description)];
+        strcpy(previous, description);
+#endif
         icon = Applications::Screens::Symbols::cuebandCue;
         char *p = description;
         *p = '\0';
@@ -667,6 +812,11 @@ const char *CueController::Description(bool detailed, const char **symbol) {
                 p += sprintf(p, "Unworn Cue (%s)", niceTime(duration));
             } else
 #endif 
+#ifdef CUEBAND_SILENT_WHEN_ASLEEP
+            if (activityController.IsAsleep()) {
+                p += sprintf(p, "Asleep Cue (%s)", niceTime(duration));
+            } else
+#endif
             {
                 p += sprintf(p, "Cue (%s)", niceTime(duration));
             }
@@ -685,6 +835,11 @@ const char *CueController::Description(bool detailed, const char **symbol) {
         }
         descriptionDetailed = detailed;
         descriptionValid = true;
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+        if (icon != previousIcon || strcmp(description, previous) != 0) {
+            descriptionChangeCount++;
+        }
+#endif
     }
 
     if (symbol != nullptr) {
@@ -93,22 +93,33 @@ namespace Pinetime {
       bool SilencedAsUnworn();
 
       const char *Description(bool detailed = false, const char **symbol = nullptr);
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+      // Incremented whenever the text or symbol from Description() has changed (as of the last call)
+      uint32_t DescriptionChangeCount() { return descriptionChangeCount; }
+#endif
       void DebugText(char *debugText);
 
     private:
 
       int ReadCues(uint32_t *version);
       int WriteCues();
-      void DeferWriteCues();
+      void DeferWriteCues(bool scheduleChanged = false);
+#ifdef CUEBAND_CUE_JOURNAL
+      int ReadJournal();
+      int AppendJournal();
+#endif
 
       // State initialized (delay initialized)
       bool initialized = false;
 
       // Cache description
       bool descriptionValid = false;
-      char description[80];
+      char description[80] = "";
       const char *icon = "";
       bool descriptionDetailed = false;
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+      uint32_t descriptionChangeCount = 0;
+#endif
 
       // Options
       options_t options_base_value = OPTIONS_STARTING;
@@ -144,8 +155,16 @@ namespace Pinetime {
       unsigned int lastInterval = DEFAULT_INTERVAL;         // Last configured prompt interval
       unsigned int promptStyle = DEFAULT_PROMPT_STYLE;      // Last configured prompt style
       unsigned int settingsChanged = 0;                     // Settings change -> save debounce
+      bool scheduleChanged = false;                         // Pending change requires a full rewrite (rather than a journal record)
       int lastCueIndex = ControlPoint::INDEX_NONE;
 
+#ifdef CUEBAND_CUE_JOURNAL
+      bool journalValid = false;            // The cue file is known to be valid, so state changes can be journaled
+      uint16_t journalGeneration = 0;       // Generation of the cue file that the journal records apply to
+      unsigned int journalCount = 0;        // Number of records currently in the journal
+      int journalError = 0;                 // (Debug) Status of the last failed journal append (0 = none)
+#endif
+
       // Track the current effective sheduled interval
       unsigned int effectiveScheduledInterval = 0;
 
@@ -73,7 +73,21 @@ void DateTime::UpdateTime(uint32_t systickCounter) {
   currentDateTime += std::chrono::seconds(correctedDelta);
   uptime += std::chrono::seconds(correctedDelta);
 #ifdef CUEBAND_UPTIME_1024                 // Track system uptime in units of 1024
-  uptime1024 += systickDelta;
+  // From its own reference: previousSystickCounter keeps back the part-second remainder, which would otherwise be counted
+  // again on each call (so the count ran fast, by more the more often this was called)
+  uint32_t uptimeDelta = (systickCounter - previousUptimeCounter) & 0xffffff;
+  if (uptimeDelta < 0x800000) {   // (ignore an earlier counter, e.g. SetCurrentTime() re-applying the last one)
+    uptime1024 += uptimeDelta;
+    previousUptimeCounter = systickCounter;
+  }
+#endif
+
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+  int64_t minutes = std::chrono::duration_cast<std::chrono::minutes>(currentDateTime.time_since_epoch()).count();
+  if (minutes != currentMinute) {
+    currentMinute = minutes;
+    minuteChangeCount++;
+  }
 #endif
 
   auto dp = date::floor<date::days>(currentDateTime);
@@ -45,6 +45,13 @@ namespace Pinetime {
                    uint8_t second,
                    uint32_t systickCounter);
       void UpdateTime(uint32_t systickCounter);
+#ifdef CUEBAND_JOB_SCHEDULER
+      // Ticks from the given counter until the time next advances a second
+      uint32_t TicksToNextSecond(uint32_t systickCounter) const {
+        uint32_t elapsed = (systickCounter - previousSystickCounter) & 0xffffff;
+        return (elapsed >= 1024) ? 0 : 1024 - elapsed;
+      }
+#endif
       uint16_t Year() const {
         return year;
       }
@@ -83,6 +90,12 @@ namespace Pinetime {
         return uptime1024;
       }
 #endif
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+      // Incremented whenever the time changes to a different minute (so screens only redraw at the displayed granularity)
+      uint32_t MinuteChangeCount() const {
+        return minuteChangeCount;
+      }
+#endif
 #ifdef CUEBAND_DETECT_UNSET_TIME
       bool IsUnset() const {
           uint32_t now = std::chrono::duration_cast<std::chrono::seconds>(CurrentDateTime().time_since_epoch()).count();
@@ -104,8 +117,15 @@ namespace Pinetime {
       uint8_t second = 0;
 
       uint32_t previousSystickCounter = 0;
+#ifdef CUEBAND_UPTIME_1024
+      uint32_t previousUptimeCounter = 0;
+#endif
       std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> currentDateTime;
       std::chrono::seconds uptime {0};
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+      int64_t currentMinute = -1;
+      uint32_t minuteChangeCount = 0;
+#endif
 
       bool isMidnightAlreadyNotified = false;
       bool isHourAlreadyNotified = true;
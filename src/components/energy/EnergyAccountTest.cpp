@@ -0,0 +1,102 @@
+// Host test: energy accounting from simulated usage counters over a day of one-minute epochs (a cue every half hour,
+// the screen on briefly, connected some of the time, the accelerometer FIFO drained at 1 Hz), with the counters
+// wrapping, the UART lines, and the daily record layout.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "energyaccount.h"
+#include "components/activity/recordfields.h"
+
+#define EPOCH 60
+
+static bool check(bool ok, const char *name) {
+  printf("%s: %s\n", ok ? "OK" : "FAIL", name);
+  return ok;
+}
+
+int main(int argc, char *argv[]) {
+  int failures = 0;
+  static energy_account_t account;
+  uint32_t counters[ENERGY_COUNT];
+
+  // Counters start near the wrap to check differences across it
+  for (int i = 0; i < ENERGY_COUNT; i++) counters[i] = 0xffffffff - 1000;
+  energy_init(&account, NULL);
+  energy_epoch(&account, counters);
+  failures += !check(account.started && account.epochs == 0 && energy_epoch_total(&account) == 0, "first epoch only takes the reference");
+
+  // One epoch: 0.5 s motor, 10 s screen, connected throughout, 2 notifications, 60 FIFO drains
+  const uint32_t usage[ENERGY_COUNT] = {EPOCH, 500, 10, 0, EPOCH, 2, EPOCH};
+  for (int i = 0; i < ENERGY_COUNT; i++) counters[i] += usage[i];
+  energy_epoch(&account, counters);
+  uint32_t expected = 0;
+  bool each = true;
+  for (int i = 0; i < ENERGY_COUNT; i++) {
+    uint32_t charge = usage[i] * energy_calibration_default[i];
+    each = each && account.epochUsage[i] == usage[i] && account.epochCharge[i] == charge;
+    expected += charge;
+  }
+  failures += !check(each && energy_epoch_total(&account) == expected, "epoch usage and charge per subsystem (across the wrap)");
+
+  // Rest of the day: a cue every 30 minutes, the screen on for 10 s every 10 minutes, connected one minute in five,
+  // HR sampled for one minute an hour
+  uint64_t total = expected;
+  uint32_t maximum = expected;
+  for (int epoch = 1; epoch < 24 * 60; epoch++) {
+    uint32_t used[ENERGY_COUNT] = {EPOCH, 0, 0, 0, 0, 0, EPOCH};
+    if (epoch % 30 == 0) used[ENERGY_MOTOR] = 250 + 250 + 250;
+    if (epoch % 10 == 0) used[ENERGY_SCREEN] = 10;
+    if (epoch % 5 == 0) used[ENERGY_BLE] = EPOCH;
+    if (epoch % 60 == 0) used[ENERGY_HR] = EPOCH;
+    if (epoch % 120 == 0) used[ENERGY_NOTIFY] = 1;
+    for (int i = 0; i < ENERGY_COUNT; i++) counters[i] += used[i];
+    energy_epoch(&account, counters);
+    total += energy_epoch_total(&account);
+    if (energy_epoch_total(&account) > maximum) maximum = energy_epoch_total(&account);
+  }
+  uint64_t sum = 0;
+  for (int i = 0; i < ENERGY_COUNT; i++) sum += account.charge[i];
+  failures += !check(account.epochs == 24 * 60 && sum == total && account.usage[ENERGY_BASE] == 24 * 60 * 60, "daily totals are the sum of the epochs");
+  failures += !check(account.epochMaximum == maximum && maximum > expected, "largest epoch");
+
+  char line[ENERGY_LINE_MAX];
+  for (int i = 0; i <= ENERGY_COUNT; i++) {
+    energy_format(&account, i, line, sizeof(line));
+    printf("    %s", line);
+  }
+  printf("    estimated %.2f mAh/day\n", (double)sum / 3600 / 1000);
+  energy_format(&account, ENERGY_COUNT, line, sizeof(line));
+  failures += !check(strncmp(line, "ZE:total ", 9) == 0 && energy_format(&account, ENERGY_COUNT + 1, line, sizeof(line)) == 0, "UART lines");
+  failures += !check(energy_format(&account, 0, line, 8) == 7 && line[7] == '\0', "UART line truncated to the buffer");
+
+  // Daily record
+  uint8_t record[ENERGY_RECORD_MAX];
+  failures += !check(energy_record(&account, record, sizeof(record) - 1) == 0, "record needs the whole buffer");
+  size_t len = energy_record(&account, record, sizeof(record));
+  bool layout = len == ENERGY_RECORD_MAX && record_get32(record) == 24 * 60 && record_get32(record + 4) == maximum && record[8] == ENERGY_COUNT;
+  const uint8_t *motor = record + ENERGY_RECORD_HEADER + ENERGY_MOTOR * ENERGY_RECORD_SUBSYSTEM;
+  layout = layout && record_get32(motor) == 500 + (24 * 60 - 1) / 30 * 750 && record_get32(motor + 4) == (500 + (24 * 60 - 1) / 30 * 750) * energy_calibration_default[ENERGY_MOTOR];
+  failures += !check(layout, "record layout");
+  failures += !check(account.epochs == 0 && account.usage[ENERGY_BASE] == 0 && account.charge[ENERGY_SCREEN] == 0 && account.started, "record starts a new period");
+
+  // A period's charge beyond 32 bits is saturated in the record
+  for (int epoch = 0; epoch < 3; epoch++) {
+    counters[ENERGY_MOTOR] += 0x7fffffff;
+    energy_epoch(&account, counters);
+  }
+  len = energy_record(&account, record, sizeof(record));
+  failures += !check(len == ENERGY_RECORD_MAX && record_get32(motor + 4) == 0xffffffff && record_get32(record + 4) == 0xffffffff && record_get32(motor) == 3u * 0x7fffffff, "record charge saturated");
+
+  // Custom calibration table
+  static const uint32_t calibration[ENERGY_COUNT] = {1, 2, 3, 4, 5, 6, 7};
+  energy_init(&account, calibration);
+  energy_epoch(&account, counters);
+  for (int i = 0; i < ENERGY_COUNT; i++) counters[i] += 10;
+  energy_epoch(&account, counters);
+  failures += !check(energy_epoch_total(&account) == 10 * (1 + 2 + 3 + 4 + 5 + 6 + 7), "custom calibration");
+
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures ? 1 : 0;
+}
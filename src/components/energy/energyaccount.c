@@ -0,0 +1,92 @@
+// Energy accounting
+
+#include <string.h>
+#include <stdio.h>
+
+#include "energyaccount.h"
+#include "components/activity/recordfields.h"
+
+// Starting estimates (PineTime datasheet figures and typical currents) until measured on the bench
+const uint32_t energy_calibration_default[ENERGY_COUNT] = {
+	50,			// ENERGY_BASE: ~50 uA asleep
+	60,			// ENERGY_MOTOR: ~60 mA while on
+	12000,		// ENERGY_SCREEN: ~12 mA display, backlight and CPU
+	1500,		// ENERGY_HR: ~1.5 mA HRS3300 LED and sampling
+	200,		// ENERGY_BLE: ~200 uA average connected
+	50,			// ENERGY_NOTIFY: radio and processing (the screen and motor are counted separately)
+	6,			// ENERGY_ACCEL: ~2 ms of TWI transfer and CPU at ~3 mA
+};
+
+static const char *energy_names[ENERGY_COUNT] = { "base", "motor", "screen", "hr", "ble", "notify", "accel" };
+
+void energy_init(energy_account_t *account, const uint32_t *calibration) {
+	memset(account, 0, sizeof(*account));
+	account->calibration = (calibration != NULL) ? calibration : energy_calibration_default;
+}
+
+void energy_epoch(energy_account_t *account, const uint32_t counters[ENERGY_COUNT]) {
+	if (!account->started) {
+		memcpy(account->counters, counters, sizeof(account->counters));
+		account->started = true;
+		return;
+	}
+
+	uint64_t total = 0;
+	for (int i = 0; i < ENERGY_COUNT; i++) {
+		// Counters are free-running, so usage is the difference (wrapping)
+		uint32_t used = counters[i] - account->counters[i];
+		uint64_t charge = (uint64_t)used * account->calibration[i];
+		account->counters[i] = counters[i];
+		account->epochUsage[i] = used;
+		account->epochCharge[i] = charge > 0xffffffff ? 0xffffffff : (uint32_t)charge;
+		account->usage[i] += used;
+		account->charge[i] += charge;
+		total += charge;
+	}
+	account->epochs++;
+	if (total > account->epochMaximum) account->epochMaximum = total > 0xffffffff ? 0xffffffff : (uint32_t)total;
+}
+
+uint32_t energy_epoch_total(const energy_account_t *account) {
+	uint64_t total = 0;
+	for (int i = 0; i < ENERGY_COUNT; i++) total += account->epochCharge[i];
+	return total > 0xffffffff ? 0xffffffff : (uint32_t)total;
+}
+
+size_t energy_format(const energy_account_t *account, int index, char *buffer, size_t size) {
+	if (index < 0 || index > ENERGY_COUNT || size == 0) return 0;
+	int len;
+	if (index < ENERGY_COUNT) {
+		len = snprintf(buffer, size, "ZE:%s %lu %lu %lu %lu\r\n", energy_names[index], (unsigned long)account->epochUsage[index],
+			(unsigned long)account->epochCharge[index], (unsigned long)account->usage[index], (unsigned long)(account->charge[index] / 3600));
+	} else {
+		uint64_t charge = 0;
+		for (int i = 0; i < ENERGY_COUNT; i++) charge += account->charge[i];
+		len = snprintf(buffer, size, "ZE:total %lu %lu %lu %lu\r\n", (unsigned long)energy_epoch_total(account),
+			(unsigned long)account->epochMaximum, (unsigned long)account->epochs, (unsigned long)(charge / 3600));
+	}
+	if (len < 0) return 0;
+	return ((size_t)len < size) ? (size_t)len : size - 1;
+}
+
+size_t energy_record(energy_account_t *account, uint8_t *buffer, size_t size) {
+	if (size < ENERGY_RECORD_MAX) return 0;
+
+	record_put32(buffer + 0, account->epochs);
+	record_put32(buffer + 4, account->epochMaximum);
+	buffer[8] = ENERGY_COUNT;
+
+	uint8_t *p = buffer + ENERGY_RECORD_HEADER;
+	for (int i = 0; i < ENERGY_COUNT; i++) {
+		record_put32(p + 0, account->usage[i]);
+		record_put32_saturated(p + 4, account->charge[i]);
+		p += ENERGY_RECORD_SUBSYSTEM;
+	}
+
+	// Start the next period
+	memset(account->usage, 0, sizeof(account->usage));
+	memset(account->charge, 0, sizeof(account->charge));
+	account->epochs = 0;
+	account->epochMaximum = 0;
+	return (size_t)(p - buffer);
+}
@@ -0,0 +1,68 @@
+// Energy accounting: estimated charge drawn by each subsystem, per epoch and per record period (daily), from usage
+// counters (active time or event counts) and a calibration table of charge per unit of use.
+// The device keeps free-running (wrapping) usage counters and passes them in at the end of each epoch; this only keeps
+// the statistics.  Charge is in microcoulombs (uC = uA for one second; 3600 uC = 1 uAh).
+
+#ifndef ENERGYACCOUNT_H
+#define ENERGYACCOUNT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+	ENERGY_BASE,							// Seconds (everything not counted below: sleep current, RTC, sensors idle)
+	ENERGY_MOTOR,							// Motor on, milliseconds
+	ENERGY_SCREEN,							// Screen on (system task running), seconds
+	ENERGY_HR,								// Heart rate sensor (LED) enabled, seconds
+	ENERGY_BLE,								// BLE connected, seconds
+	ENERGY_NOTIFY,							// Notifications received
+	ENERGY_ACCEL,							// Accelerometer reads (FIFO drains or polls)
+	ENERGY_COUNT
+} energy_subsystem_t;
+
+// Default calibration: uC per unit of each subsystem's usage (uA per second, uA x 1 s per event, mA per millisecond)
+extern const uint32_t energy_calibration_default[ENERGY_COUNT];
+
+typedef struct {
+	const uint32_t *calibration;
+	uint32_t counters[ENERGY_COUNT];		// Usage counters at the end of the last epoch
+	uint32_t epochUsage[ENERGY_COUNT];		// Usage in the last epoch
+	uint32_t epochCharge[ENERGY_COUNT];		// Charge in the last epoch (uC)
+	uint32_t usage[ENERGY_COUNT];			// Usage since the last record
+	uint64_t charge[ENERGY_COUNT];			// Charge since the last record (uC)
+	uint32_t epochs;						// Epochs since the last record
+	uint32_t epochMaximum;					// Highest total charge of an epoch since the last record (uC)
+	bool started;							// Counters hold a reference
+} energy_account_t;
+
+void energy_init(energy_account_t *account, const uint32_t *calibration);
+
+// End of an epoch, with the current usage counters (the first call only takes the reference)
+void energy_epoch(energy_account_t *account, const uint32_t counters[ENERGY_COUNT]);
+
+// Total charge of the last epoch (uC)
+uint32_t energy_epoch_total(const energy_account_t *account);
+
+// One line per subsystem: "ZE:<name> <epoch usage> <epoch uC> <usage> <uAh>\r\n", then (index == ENERGY_COUNT)
+// "ZE:total <epoch uC> <epoch maximum uC> <epochs> <uAh>\r\n"; returns 0 past the end.
+#define ENERGY_LINE_MAX 64
+size_t energy_format(const energy_account_t *account, int index, char *buffer, size_t size);
+
+// Binary record of the period since the last record (then starts a new period):
+// @0 u32 epochs, @4 u32 maximum epoch charge (uC), @8 u8 subsystems,
+// then per subsystem (in energy_subsystem_t order): @0 u32 usage, @4 u32 charge (uC, saturated)
+#define ENERGY_RECORD_HEADER 9
+#define ENERGY_RECORD_SUBSYSTEM 8
+#define ENERGY_RECORD_MAX (ENERGY_RECORD_HEADER + ENERGY_COUNT * ENERGY_RECORD_SUBSYSTEM)
+size_t energy_record(energy_account_t *account, uint8_t *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1 @@
+gcc -O2 -std=c99 -Wall -Wextra -I../.. -c energyaccount.c -o energyaccount.o && g++ -O2 -Wall -I../.. EnergyAccountTest.cpp energyaccount.o -o ./energyaccounttest && ./energyaccounttest
@@ -20,8 +20,11 @@ FS::FS(Pinetime::Drivers::SpiNorFlash& driver)
       .block_count = size / blockSize,
       .block_cycles = 1000u,
 
-      .cache_size = 16,
-      .lookahead_size = 16,
+      .cache_size = cacheSize,
+      .lookahead_size = lookaheadSize,
+      .read_buffer = readCache,
+      .prog_buffer = progCache,
+      .lookahead_buffer = lookahead,
 
       .name_max = 50,
       .attr_max = 50,
@@ -117,6 +120,26 @@ lfs_ssize_t FS::GetFSSize() {
   return lfs_fs_size(&lfs);
 }
 
+#ifdef CUEBAND_ACTIVITY_RAW_LOG
+int FS::RawLogRead(uint32_t offset, uint8_t* buffer, size_t size) {
+  if (offset + size > rawLogSize) return -1;
+  flashDriver.Read(rawLogStartAddress + offset, buffer, size);
+  return 0;
+}
+
+int FS::RawLogProgram(uint32_t offset, const uint8_t* buffer, size_t size) {
+  if (offset + size > rawLogSize) return -1;
+  flashDriver.Write(rawLogStartAddress + offset, buffer, size);
+  return flashDriver.ProgramFailed() ? -1 : 0;
+}
+
+int FS::RawLogErase(uint32_t offset) {
+  if (offset >= rawLogSize) return -1;
+  flashDriver.SectorErase(rawLogStartAddress + offset);
+  return flashDriver.EraseFailed() ? -1 : 0;
+}
+#endif
+
 /*
 
     ----------- Interface between littlefs and SpiNorFlash -----------
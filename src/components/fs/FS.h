@@ -47,6 +47,13 @@ namespace Pinetime {
         return blockSize;
       }
 
+#ifdef CUEBAND_ACTIVITY_RAW_LOG
+      // Raw access to the region reserved for the activity log (offsets within the region), returning 0 on success
+      int RawLogRead(uint32_t offset, uint8_t* buffer, size_t size);
+      int RawLogProgram(uint32_t offset, const uint8_t* buffer, size_t size);
+      int RawLogErase(uint32_t offset);
+#endif
+
     private:
       Pinetime::Drivers::SpiNorFlash& flashDriver;
 
@@ -69,12 +76,38 @@ namespace Pinetime {
        *          |                                       |
        *          |                                       |
        *          |                                       |
+       *          +---------------------------------------+
+       *          |  Activity log (CUEBAND_ACTIVITY_RAW_LOG)
        * 0x400000 +---------------------------------------+
        *
        */
       static constexpr size_t startAddress = 0x0B4000;
-      static constexpr size_t size = 0x34C000;
       static constexpr size_t blockSize = 4096;
+#ifdef CUEBAND_ACTIVITY_RAW_LOG
+      static constexpr size_t rawLogSize = CUEBAND_ACTIVITY_RAW_LOG_SECTORS * blockSize;
+      static constexpr size_t size = 0x34C000 - rawLogSize;
+      static constexpr size_t rawLogStartAddress = startAddress + size;
+#else
+      static constexpr size_t size = 0x34C000;
+#endif
+
+      // Statically allocated littlefs buffers: read and program caches (each open file also allocates a cache of this
+      // size from the heap), and the lookahead bitmap of free blocks (8 blocks per byte)
+#ifdef CUEBAND_FS_CACHE_SIZE
+      static constexpr size_t cacheSize = CUEBAND_FS_CACHE_SIZE;
+#else
+      static constexpr size_t cacheSize = 16;
+#endif
+#ifdef CUEBAND_FS_LOOKAHEAD_SIZE
+      static constexpr size_t lookaheadSize = CUEBAND_FS_LOOKAHEAD_SIZE;
+#else
+      static constexpr size_t lookaheadSize = 16;
+#endif
+      static_assert(cacheSize % 16 == 0 && blockSize % cacheSize == 0, "cache size must be a multiple of the read/program sizes and a factor of the block size");
+      static_assert(lookaheadSize % 8 == 0, "lookahead size must be a multiple of 8");
+      uint8_t readCache[cacheSize] __attribute__((aligned(4)));
+      uint8_t progCache[cacheSize] __attribute__((aligned(4)));
+      uint32_t lookahead[lookaheadSize / sizeof(uint32_t)];
 
       bool resourcesValid = false;
       const struct lfs_config lfsConfig;
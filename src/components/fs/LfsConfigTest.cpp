@@ -0,0 +1,417 @@
+// Host benchmark of littlefs cache and lookahead sizes (CUEBAND_FS_CACHE_SIZE, CUEBAND_FS_LOOKAHEAD_SIZE).
+// Replays the firmware's file system workloads on a RAM flash model (NOR semantics, busy times, SPI transfer times,
+// vTaskDelay(1) polling while busy) and reports SPI transactions, bytes moved and simulated time for each configuration:
+//   - activity appends: ActivityController::AppendPhysicalBlock() filling four ACTV%04d.BIN files of 512 blocks;
+//   - config rewrites: ActivityController::WriteConfig() (ACTIVITY.CFG, truncated) and Settings::SaveSettingsToFile();
+//   - sync reads: ActivityService reading every block in order, then blocks at random (ReadPhysicalBlock());
+//   - start-up scan: ActivityController::InitialFileScan().
+// littlefs itself is not built on the host, so the flash accesses are those lfs.c issues for each operation, following
+// its caching rules (lfs_bd_read()/lfs_bd_prog()): the read cache loads at most cache_size bytes (read_size-aligned,
+// only up to the hinted length); programs go through a cache_size program cache; appending to a closed file copies its
+// partly-filled last block to a newly erased block; files up to cache_size bytes are stored inline in the metadata;
+// opening a file fetches (and checksums) the metadata log; a commit is read back to verify it; and the allocator
+// traverses every file's skip-list once per lookahead window (8 blocks per byte).
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#define FLASH_SIZE (4 * 1024 * 1024)
+#define PAGE_SIZE 256
+#define SECTOR_SIZE 4096
+
+// FS.h
+#define FS_START 0x0B4000
+#define FS_SIZE 0x34C000
+#define BLOCK_SIZE 4096
+#define BLOCK_COUNT (FS_SIZE / BLOCK_SIZE)
+#define READ_SIZE 16
+#define PROG_SIZE 8
+
+// Flash timing (typical datasheet values for 4 KB erase and 256-byte page program), SPI at 8 MHz
+#define ERASE_US 45000.0
+#define PROGRAM_BASE_US 100.0
+#define PROGRAM_PAGE_US 600.0       // ...plus this scaled by the fraction of the page programmed
+#define SPI_BYTE_US 1.0
+#define SPI_CALL_US 10.0
+#define TICK_US (1000000.0 / 1024)  // vTaskDelay(1)
+
+static double simNow;
+static double busyUntil;
+static unsigned long long transactions, bytesRead, bytesProgrammed, erases;
+
+static void spiTransfer(size_t bytes) {
+  simNow += SPI_CALL_US + bytes * SPI_BYTE_US;
+  transactions++;
+}
+
+// SpiNorFlash::WaitWriteComplete()
+static void waitWriteComplete() {
+  spiTransfer(2);
+  while (simNow < busyUntil) {
+    simNow = ((unsigned long)(simNow / TICK_US) + 1) * TICK_US;
+    spiTransfer(2);
+  }
+}
+
+static void flashRead(size_t size) {
+  spiTransfer(4 + size);
+  bytesRead += size;
+}
+
+// SpiNorFlash::Write(), a page at a time
+static void flashProgram(uint32_t address, size_t size) {
+  while (size > 0) {
+    size_t len = PAGE_SIZE - (address & (PAGE_SIZE - 1));
+    if (len > size) len = size;
+    spiTransfer(1);       // Write enable
+    spiTransfer(2);       // ...checked
+    spiTransfer(4 + len);
+    busyUntil = simNow + PROGRAM_BASE_US + PROGRAM_PAGE_US * len / PAGE_SIZE;
+    waitWriteComplete();
+    bytesProgrammed += len;
+    address += len;
+    size -= len;
+  }
+}
+
+static void flashErase() {
+  spiTransfer(1);
+  spiTransfer(2);
+  spiTransfer(4);
+  busyUntil = simNow + ERASE_US;
+  waitWriteComplete();
+  erases++;
+}
+
+static uint32_t ctzPointers(uint32_t index) {
+  return index == 0 ? 0 : (uint32_t)__builtin_ctz(index) + 1;
+}
+
+// Block index and offset within the block of a file position (lfs_ctz_index())
+static void ctzIndex(uint32_t pos, uint32_t *index, uint32_t *off) {
+  uint32_t i = 0;
+  for (;;) {
+    uint32_t capacity = BLOCK_SIZE - 4 * ctzPointers(i);
+    if (pos < capacity) break;
+    pos -= capacity;
+    i++;
+  }
+  *index = i;
+  *off = 4 * ctzPointers(i) + pos;
+}
+
+#define MAX_FILES 8
+#define COMMIT_OVERHEAD 16          // Tag for the changed entry, CRC tag and checksum
+#define LIVE_METADATA 160           // Superblock and file entries (names and structs), excluding inline data
+
+class LfsModel {
+public:
+  LfsModel(uint32_t cacheSize, uint32_t lookaheadSize) : cacheSize {cacheSize}, lookaheadBlocks {lookaheadSize * 8} {
+    if (lookaheadBlocks > BLOCK_COUNT) lookaheadBlocks = BLOCK_COUNT;
+    inlineMax = cacheSize < BLOCK_SIZE / 8 ? cacheSize : BLOCK_SIZE / 8;
+  }
+
+  // Reading a block of a file: the address only matters for alignment and caching
+  static uint32_t BlockAddress(int file, uint32_t index) {
+    return FS_START + 2 * BLOCK_SIZE + ((file * 40 + index) % (BLOCK_COUNT - 2)) * BLOCK_SIZE;
+  }
+
+  // lfs_bd_read() through a cache (the read cache, or an open file's cache)
+  struct Cache { uint32_t address = 0xffffffff, size = 0; };
+
+  void Read(Cache &cache, uint32_t address, uint32_t size, uint32_t hint) {
+    uint32_t blockEnd = (address & ~(BLOCK_SIZE - 1)) + BLOCK_SIZE;
+    while (size > 0) {
+      if (address >= cache.address && address < cache.address + cache.size) {
+        uint32_t len = cache.address + cache.size - address;
+        if (len > size) len = size;
+        address += len; size -= len; hint = hint > len ? hint - len : 0;
+        continue;
+      }
+      if (size >= hint && address % READ_SIZE == 0 && size >= READ_SIZE) {
+        uint32_t len = size - size % READ_SIZE;     // Bypass the cache
+        flashRead(len);
+        address += len; size -= len; hint = hint > len ? hint - len : 0;
+        continue;
+      }
+      cache.address = address - address % READ_SIZE;
+      uint32_t end = address + (hint > size ? hint : size);
+      end = (end + READ_SIZE - 1) / READ_SIZE * READ_SIZE;
+      if (end > blockEnd) end = blockEnd;
+      cache.size = end - cache.address;
+      if (cache.size > cacheSize) cache.size = cacheSize;
+      flashRead(cache.size);
+    }
+  }
+
+  // lfs_bd_prog() through a program cache, flushed when full (and by Flush())
+  struct ProgCache { uint32_t address = 0xffffffff, size = 0; };
+
+  void Program(ProgCache &cache, uint32_t address, uint32_t size, bool validate) {
+    while (size > 0) {
+      if (cache.size > 0 && (address != cache.address + cache.size || address / BLOCK_SIZE != cache.address / BLOCK_SIZE)) Flush(cache, validate);
+      if (cache.size == 0) cache.address = address;
+      uint32_t len = cacheSize - (address - cache.address);
+      if (len > size) len = size;
+      cache.size += len;
+      address += len; size -= len;
+      if (cache.size == cacheSize) Flush(cache, validate);
+    }
+  }
+
+  // lfs_bd_flush(): file data is read back to validate it (through the read cache, which is dropped first)
+  void Flush(ProgCache &cache, bool validate) {
+    if (cache.size == 0) return;
+    uint32_t size = (cache.size + PROG_SIZE - 1) / PROG_SIZE * PROG_SIZE;
+    flashProgram(cache.address, size);
+    if (validate) {
+      rcache = Cache();
+      Read(rcache, cache.address, size, size);
+    }
+    cache.size = 0;
+  }
+
+  // lfs_dir_fetch() of the root metadata pair (revision counts, then the checksummed log)
+  void FetchMetadata() {
+    rcache.address = 0xffffffff;
+    Read(rcache, metaAddress ^ BLOCK_SIZE, 4, 4);
+    Read(rcache, metaAddress, 4, 4);
+    Read(rcache, metaAddress, metaUsed, BLOCK_SIZE);
+  }
+
+  // lfs_dir_commit(): program the commit, read it back, compact the pair when full
+  void Commit(uint32_t size) {
+    size = (COMMIT_OVERHEAD + size + PROG_SIZE - 1) / PROG_SIZE * PROG_SIZE;
+    if (metaUsed + size > BLOCK_SIZE) {
+      metaAddress ^= BLOCK_SIZE;
+      flashErase();
+      uint32_t live = LIVE_METADATA + inlineBytes;
+      Program(pcache, metaAddress, live, false);
+      Flush(pcache, false);
+      metaUsed = live;
+    }
+    Program(pcache, metaAddress + metaUsed, size, false);
+    Flush(pcache, false);
+    Read(rcache, metaAddress + metaUsed, size, size);
+    metaUsed += size;
+  }
+
+  // lfs_alloc(): traverse the file system when the lookahead window is used up
+  uint32_t Allocate() {
+    uint32_t address = FS_START + 2 * BLOCK_SIZE + (allocated % (BLOCK_COUNT - 2)) * BLOCK_SIZE;
+    if (allocated++ % lookaheadBlocks != 0) return address;
+    FetchMetadata();
+    for (int f = 0; f < MAX_FILES; f++) {
+      if (fileSize[f] <= inlineMax) continue;
+      uint32_t index, off;
+      ctzIndex(fileSize[f] - 1, &index, &off);
+      for (uint32_t i = index; i > 0; i -= (i > 1 ? 2 : 1)) Read(rcache, BlockAddress(f, i), 8, 8);
+    }
+    return address;
+  }
+
+  // lfs_ctz_find() from the last block
+  void CtzFind(int file, uint32_t targetIndex) {
+    uint32_t current, off;
+    ctzIndex(fileSize[file] - 1, &current, &off);
+    while (current > targetIndex) {
+      uint32_t skip = 31 - __builtin_clz(current - targetIndex + 1);
+      uint32_t ctz = __builtin_ctz(current);
+      if (skip > ctz) skip = ctz;
+      Read(rcache, BlockAddress(file, current) + 4 * skip, 4, 4);
+      current -= 1u << skip;
+    }
+  }
+
+  // Open, write 'size' bytes at the end (or from the start if truncating), close
+  void Write(int file, uint32_t size, bool truncate) {
+    openFile = -1;
+    FetchMetadata();
+    uint32_t pos = truncate ? 0 : fileSize[file];
+    uint32_t newSize = pos + size;
+    if (newSize <= inlineMax) {
+      // Inline: the whole file is committed to the metadata
+      inlineBytes += newSize - (fileSize[file] <= inlineMax ? fileSize[file] : 0);
+      fileSize[file] = newSize;
+      Commit(newSize);
+      return;
+    }
+    if (fileSize[file] <= inlineMax && !truncate) {
+      inlineBytes -= fileSize[file];
+      pos = 0;      // Inline data moves to a block with the new data
+      size = newSize;
+    }
+    ProgCache fileCache;
+    bool writing = false;
+    uint32_t head = 0;
+    while (size > 0) {
+      uint32_t index, off;
+      if (pos == 0) {
+        index = 0; off = 0;
+        head = Allocate();
+        flashErase();
+      } else {
+        ctzIndex(pos - 1, &index, &off);
+        off++;
+        if (off >= BLOCK_SIZE) {
+          // Last block full: a new block with its skip-list pointers
+          Flush(fileCache, true);
+          head = Allocate();
+          flashErase();
+          index++;
+          Read(rcache, BlockAddress(file, index - 1), 4 * (ctzPointers(index) - 1), 4);
+          Program(fileCache, head, 4 * ctzPointers(index), true);
+          off = 4 * ctzPointers(index);
+        } else if (!writing) {
+          // Extending a closed file: copy its last block to a new block (a byte at a time through the caches)
+          uint32_t previous = BlockAddress(file, index);
+          head = Allocate();
+          flashErase();
+          for (uint32_t i = 0; i < off; i++) {
+            Read(rcache, previous + i, 1, off - i);
+            Program(fileCache, head + i, 1, true);
+          }
+        }
+      }
+      uint32_t len = BLOCK_SIZE - off;
+      if (len > size) len = size;
+      Program(fileCache, head + off, len, true);
+      pos += len;
+      size -= len;
+      writing = true;
+    }
+    Flush(fileCache, true);
+    fileSize[file] = newSize;
+    Commit(0);
+  }
+
+  void Close() {
+    openFile = -1;
+  }
+
+  // ActivityController::ReadPhysicalBlock() / OpenFileReading(): the file stays open between sequential reads
+  void ReadBlock(int file, uint32_t offset, uint32_t size) {
+    if (openFile != file) {
+      FetchMetadata();
+      openFile = file;
+      readPos = 0xffffffff;
+      fileCache = Cache();
+    }
+    uint32_t pos = offset;
+    while (size > 0) {
+      uint32_t index, off;
+      ctzIndex(pos, &index, &off);
+      if (pos != readPos || off == 4 * ctzPointers(index)) {
+        CtzFind(file, index);
+        fileCache = Cache();
+      }
+      uint32_t len = BLOCK_SIZE - off;
+      if (len > size) len = size;
+      Read(fileCache, BlockAddress(file, index) + off, len, BLOCK_SIZE - off);
+      pos += len;
+      size -= len;
+      readPos = pos;
+    }
+  }
+
+  uint32_t fileSize[MAX_FILES] = {0};
+
+private:
+  uint32_t cacheSize;
+  uint32_t lookaheadBlocks;
+  uint32_t inlineMax;
+  uint32_t inlineBytes = 0;
+  uint32_t metaAddress = FS_START, metaUsed = LIVE_METADATA;
+  uint32_t allocated = 0;
+  Cache rcache;
+  ProgCache pcache;
+  int openFile = -1;
+  uint32_t readPos = 0xffffffff;
+  Cache fileCache;
+};
+
+#define ACTIVITY_FILES 4
+#define ACTIVITY_BLOCKS 512
+#define ACTIVITY_BLOCK_SIZE 256
+#define CONFIG_FILE 4               // ACTIVITY.CFG
+#define CONFIG_SIZE 32
+#define SETTINGS_FILE 5             // settings.dat
+#define SETTINGS_SIZE 40
+
+typedef struct {
+  double us;
+  unsigned long long transactions, read, programmed, erases;
+} measure_t;
+
+static measure_t measureStart() {
+  measure_t m = { simNow, transactions, bytesRead, bytesProgrammed, erases };
+  return m;
+}
+
+static void report(const char *label, measure_t start, unsigned int count) {
+  printf("  %-16s %9.2f ms/op %8.1f SPI/op %9.1f B read/op %8.1f B prog/op %6.3f erase/op\n", label,
+    (simNow - start.us) / 1000 / count, (double)(transactions - start.transactions) / count,
+    (double)(bytesRead - start.read) / count, (double)(bytesProgrammed - start.programmed) / count,
+    (double)(erases - start.erases) / count);
+}
+
+static void benchmark(uint32_t cacheSize, uint32_t lookaheadSize) {
+  LfsModel lfs(cacheSize, lookaheadSize);
+  const unsigned int blocks = ACTIVITY_FILES * ACTIVITY_BLOCKS;
+  measure_t m;
+
+  printf("cache_size %u, lookahead_size %u (%u bytes static RAM, %u bytes heap per open file):\n", cacheSize, lookaheadSize, 2 * cacheSize + lookaheadSize, cacheSize);
+
+  m = measureStart();
+  for (int f = 0; f < ACTIVITY_FILES; f++) {
+    for (int b = 0; b < ACTIVITY_BLOCKS; b++) lfs.Write(f, ACTIVITY_BLOCK_SIZE, false);
+  }
+  report("activity append", m, blocks);
+
+  const int rewrites = 100;
+  m = measureStart();
+  for (int i = 0; i < rewrites; i++) {
+    if (i & 1) lfs.Write(SETTINGS_FILE, SETTINGS_SIZE, true);
+    else lfs.Write(CONFIG_FILE, CONFIG_SIZE, true);
+  }
+  report("config rewrite", m, rewrites);
+
+  m = measureStart();
+  for (int f = 0; f < ACTIVITY_FILES; f++) {
+    for (int b = 0; b < ACTIVITY_BLOCKS; b++) lfs.ReadBlock(f, b * ACTIVITY_BLOCK_SIZE, ACTIVITY_BLOCK_SIZE);
+  }
+  report("sync read", m, blocks);
+
+  srand(1);
+  const unsigned int reads = 2000;
+  m = measureStart();
+  for (unsigned int i = 0; i < reads; i++) {
+    uint32_t block = rand() % blocks;
+    lfs.ReadBlock(block / ACTIVITY_BLOCKS, (block % ACTIVITY_BLOCKS) * ACTIVITY_BLOCK_SIZE, ACTIVITY_BLOCK_SIZE);
+  }
+  report("random read", m, reads);
+
+  m = measureStart();
+  for (int f = 0; f < ACTIVITY_FILES; f++) {
+    lfs.Close();
+    lfs.ReadBlock(f, 0, 10);
+    lfs.ReadBlock(f, lfs.fileSize[f] - ACTIVITY_BLOCK_SIZE, 10);
+  }
+  report("start-up scan", m, 1);
+}
+
+int main(int argc, char *argv[]) {
+  static const uint32_t configurations[][2] = {
+    { 16, 16 },       // Previous FS::lfsConfig
+    { 64, 16 },
+    { 128, 16 },      // cueband.h default
+    { 128, 112 },     // Lookahead covering the whole file system (844 blocks)
+    { 256, 16 },
+  };
+  for (size_t i = 0; i < sizeof(configurations) / sizeof(configurations[0]); i++) {
+    benchmark(configurations[i][0], configurations[i][1]);
+  }
+  return 0;
+}
@@ -0,0 +1 @@
+g++ -O2 LfsConfigTest.cpp -o ./lfsconfigtest && ./lfsconfigtest "$@"
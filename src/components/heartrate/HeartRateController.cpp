@@ -56,6 +56,11 @@ int HeartRateController::HrStats(int *meanBpm, int *minBpm, int *maxBpm, bool cl
   if (task == nullptr) return false;
   return task->HrStats(meanBpm, minBpm, maxBpm, clear);
 }
+
+int HeartRateController::HrStableCount() {
+  if (task == nullptr) return 0;
+  return task->HrStableCount();
+}
 #endif
 
 #ifdef CUEBAND_BUFFER_RAW_HR
@@ -35,6 +35,7 @@ namespace Pinetime {
       void SetHrEpoch(bool hrEpoch);
       bool IsHrEpoch();
       int HrStats(int *meanBpm, int *minBpm, int *maxBpm, bool clear);
+      int HrStableCount();
 #endif
 
 #ifdef CUEBAND_BUFFER_RAW_HR
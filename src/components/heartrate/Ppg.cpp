@@ -1,6 +1,10 @@
 #include "components/heartrate/Ppg.h"
 #include <nrf_log.h>
 #include <vector>
+#ifdef CUEBAND_PPG_FIXED_POINT
+#include <cmath>
+#include <utility>
+#endif
 
 using namespace Pinetime::Controllers;
 
@@ -77,6 +81,7 @@ namespace {
     return max / mean;
   }
 
+#ifndef CUEBAND_PPG_FIXED_POINT
   // Simple bandpass filter using exponential moving average
   void Filter30to240(std::array<float, Ppg::dataLength>& signal) {
     // From:
@@ -102,6 +107,7 @@ namespace {
       }
     }
   }
+#endif
 
   float SpectrumMax(const std::array<float, Ppg::spectrumLength>& data, int start, int end) {
     float max = 0.0f;
@@ -113,6 +119,7 @@ namespace {
     return max;
   }
 
+#ifndef CUEBAND_PPG_FIXED_POINT
   void Detrend(std::array<float, Ppg::dataLength>& signal) {
     int size = signal.size();
     float offset = signal.front();
@@ -135,17 +142,151 @@ namespace {
     0.15088159f, 0.1882551f,  0.22872687f, 0.27189467f, 0.31732949f, 0.36457977f, 0.41317591f, 0.46263495f,
     0.51246535f, 0.56217185f, 0.61126047f, 0.65924333f, 0.70564355f, 0.75f,       0.79187184f, 0.83084292f,
     0.86652594f, 0.89856625f, 0.92664544f, 0.95048443f, 0.96984631f, 0.98453864f, 0.99441541f, 0.99937846f};
+
+#else
+  // Fixed-point equivalent of the pre-processing and FFT above.
+  // The signal is held as Q8 (raw ADC units * 256), the FFT data as Q15.
+
+  // Quarter-wave twiddle table: round(32767 * cos(2 * pi * k / dataLength)), k = 0..dataLength/4
+  // Note: Harcoded and must be updated if constexpr dataLength is changed.
+  static constexpr int16_t cosQ15[(Ppg::dataLength >> 2) + 1] {
+    32767, 32609, 32137, 31356, 30273, 28898, 27245, 25329, 23170, 20787, 18204, 15446, 12539, 9512, 6393, 3212, 0};
+
+  // cos(2 * pi * k / dataLength) as Q15
+  int16_t CosQ15(int k) {
+    k &= Ppg::dataLength - 1;
+    if (k > (Ppg::dataLength >> 1))
+      k = Ppg::dataLength - k;
+    if (k > (Ppg::dataLength >> 2))
+      return -cosQ15[(Ppg::dataLength >> 1) - k];
+    return cosQ15[k];
+  }
+
+  // sin(2 * pi * k / dataLength) as Q15
+  int16_t SinQ15(int k) {
+    return CosQ15(k - (Ppg::dataLength >> 2));
+  }
+
+#ifdef CUEBAND_PPG_SLIDING_DFT
+  // Full-period twiddle table, CosQ15(k) for k = 0..dataLength-1, so the per-sample update is a plain lookup by (k * n) mod dataLength
+  // Note: Harcoded and must be updated if constexpr dataLength is changed.
+  static constexpr int16_t cosPeriodQ15[Ppg::dataLength] {
+    32767,  32609,  32137,  31356,  30273,  28898,  27245,  25329,  23170,  20787,  18204,  15446,  12539,  9512,   6393,   3212,
+    0,      -3212,  -6393,  -9512,  -12539, -15446, -18204, -20787, -23170, -25329, -27245, -28898, -30273, -31356, -32137, -32609,
+    -32767, -32609, -32137, -31356, -30273, -28898, -27245, -25329, -23170, -20787, -18204, -15446, -12539, -9512,  -6393,  -3212,
+    0,      3212,   6393,   9512,   12539,  15446,  18204,  20787,  23170,  25329,  27245,  28898,  30273,  31356,  32137,  32609};
+#endif
+
+  // EMA (alpha as Q15) of a Q8 signal
+  int32_t ExpAverageQ8(int32_t alpha, int32_t value, int32_t average) {
+    return static_cast<int32_t>(((int64_t) alpha * value + (int64_t) (32768 - alpha) * average) >> 15);
+  }
+
+  // Filter30to240() EMA coefficients as Q15: 0.816 is ~4Hz, 0.268 is ~0.5Hz cutoff at 10Hz sampling
+  constexpr int32_t alphaLow = 26739;
+  constexpr int32_t alphaHigh = 8782;
+
+#ifdef CUEBAND_PPG_FIXED_FFT
+  // Hanning coefficients above as Q15: round(32767 * hanning[n])
+  static constexpr int16_t hanningQ15[Ppg::dataLength >> 1] {
+    0,     81,    325,   728,   1286,  1995,  2847,  3833,  4944,  6169,  7495,  8909,  10398, 11946, 13539, 15159,
+    16792, 18421, 20029, 21601, 23122, 24575, 25947, 27224, 28393, 29443, 30363, 31145, 31779, 32260, 32584, 32747};
+
+  // As Detrend(), Filter30to240() and the Hanning window, on raw ADC data to a Q8 signal
+  void PreprocessFixed(const std::array<uint16_t, Ppg::dataLength>& data, int32_t* signal) {
+    const int length = Ppg::dataLength;
+    // Detrend
+    int32_t offset = data.front();
+    int32_t rise = static_cast<int32_t>(data.at(length - 1)) - offset;
+    for (int idx = 0; idx < length; idx++) {
+      signal[idx] = ((static_cast<int32_t>(data.at(idx)) - offset) << 8) - (rise * idx * 256) / (length - 1);
+    }
+    for (int idx = 0; idx < length - 1; idx++) {
+      signal[idx] = signal[idx + 1] - signal[idx];
+    }
+    // Band-pass
+    int32_t expAvg;
+    for (int loop = 0; loop < 4; loop++) {
+      expAvg = signal[0];
+      for (int idx = 0; idx < length; idx++) {
+        expAvg = ExpAverageQ8(alphaLow, signal[idx], expAvg);
+        signal[idx] = expAvg;
+      }
+    }
+    for (int loop = 0; loop < 4; loop++) {
+      expAvg = signal[0];
+      for (int idx = 0; idx < length; idx++) {
+        expAvg = ExpAverageQ8(alphaHigh, signal[idx], expAvg);
+        signal[idx] -= expAvg;
+      }
+    }
+    // Hanning window
+    for (int idx = 0; idx < length; idx++) {
+      int hannIdx = (idx < (length >> 1)) ? idx : (length - 1 - idx);
+      signal[idx] = static_cast<int32_t>(((int64_t) signal[idx] * hanningQ15[hannIdx]) >> 15);
+    }
+  }
+
+  // In-place radix-2 complex FFT of interleaved Q15 (re, im) data, halved at each stage to prevent overflow (output scaled by 1/count).
+  // The twiddle step is relative to dataLength, so that the table is shared with the real-FFT split.
+  void ComplexFftQ15(int16_t* data, int count) {
+    // Bit-reversal permutation
+    for (int i = 1, j = 0; i < count; i++) {
+      int bit = count >> 1;
+      for (; j & bit; bit >>= 1) {
+        j ^= bit;
+      }
+      j ^= bit;
+      if (i < j) {
+        std::swap(data[2 * i], data[2 * j]);
+        std::swap(data[2 * i + 1], data[2 * j + 1]);
+      }
+    }
+    // Butterflies
+    for (int span = 1; span < count; span <<= 1) {
+      int step = Ppg::dataLength / (span << 1);
+      for (int k = 0; k < span; k++) {
+        int32_t wr = CosQ15(k * step);
+        int32_t wi = -SinQ15(k * step);
+        for (int i = k; i < count; i += span << 1) {
+          int16_t* a = &data[2 * i];
+          int16_t* b = &data[2 * (i + span)];
+          int32_t tr = (wr * b[0] - wi * b[1]) >> 15;
+          int32_t ti = (wr * b[1] + wi * b[0]) >> 15;
+          int32_t ar = a[0];
+          int32_t ai = a[1];
+          a[0] = static_cast<int16_t>((ar + tr) >> 1);
+          a[1] = static_cast<int16_t>((ai + ti) >> 1);
+          b[0] = static_cast<int16_t>((ar - tr) >> 1);
+          b[1] = static_cast<int16_t>((ai - ti) >> 1);
+        }
+      }
+    }
+  }
+#endif
+#endif
 }
 
 Ppg::Ppg() {
   dataAverage.fill(0.0f);
   spectrum.fill(0.0f);
+#ifdef CUEBAND_PPG_SLIDING_DFT
+  SlidingReset();
+#endif
 }
 
 int8_t Ppg::Preprocess(uint32_t hrs, uint32_t als) {
+#ifdef CUEBAND_PPG_SLIDING_DFT
+  // Every sample slides the window, the count only gates the analysis (as the buffer below)
+  SlidingAdd(hrs);
+  if (dataIndex < dataLength) {
+    dataIndex++;
+  }
+#else
   if (dataIndex < dataLength) {
     dataHRS[dataIndex++] = hrs;
   }
+#endif
   alsValue = als;
   if (alsValue > alsThreshold) {
     return 1;
@@ -160,10 +301,12 @@ int Ppg::HeartRate() {
   int hr = 0;
   hr = ProcessHeartRate(resetSpectralAvg);
   resetSpectralAvg = false;
+#ifndef CUEBAND_PPG_SLIDING_DFT
   // Make room for overlapWindow number of new samples
   for (int idx = 0; idx < dataLength - overlapWindow; idx++) {
     dataHRS[idx] = dataHRS[idx + overlapWindow];
   }
+#endif
   dataIndex = dataLength - overlapWindow;
   return hr;
 }
@@ -171,6 +314,9 @@ int Ppg::HeartRate() {
 void Ppg::Reset(bool resetDaqBuffer) {
   if (resetDaqBuffer) {
     dataIndex = 0;
+#ifdef CUEBAND_PPG_SLIDING_DFT
+    SlidingReset();
+#endif
   }
   avgIndex = 0;
   dataAverage.fill(0.0f);
@@ -181,9 +327,164 @@ void Ppg::Reset(bool resetDaqBuffer) {
   spectrum.fill(0.0f);
 }
 
+#ifdef CUEBAND_PPG_FIXED_FFT
+// Fixed-point magnitude spectrum of the current data, as a real FFT using a half-length complex FFT.
+// Returns spectrumLength magnitudes (scaled as the float FFT) in the upper half of the working buffer, and
+// leaves the lower half free for the caller.
+const float* Ppg::FixedPointSpectrum() {
+  const int half = dataLength >> 1;
+  int32_t* signal = work.signal;
+  int16_t* fft = work.fft;
+  float* magnitude = &work.values[half];
+
+  PreprocessFixed(dataHRS, signal);
+
+  // Block scaling so the peak value is in [2^13, 2^14): the complex magnitude then fits in Q15 and does not grow through the halved stages
+  int32_t maxValue = 0;
+  for (int idx = 0; idx < dataLength; idx++) {
+    int32_t value = signal[idx] < 0 ? -signal[idx] : signal[idx];
+    if (value > maxValue)
+      maxValue = value;
+  }
+  int shift = 0;
+  while ((maxValue >> shift) >= 16384) {
+    shift++;
+  }
+  while (maxValue > 0 && shift > -16 && (maxValue << (1 - shift)) < 16384) {
+    shift--;
+  }
+
+  // Pack the real signal as (even, odd) complex pairs.
+  // Each 16-bit element only overlaps the 32-bit element at half its index, which has already been consumed.
+  for (int idx = 0; idx < dataLength; idx++) {
+    int32_t value = signal[idx];
+    fft[idx] = static_cast<int16_t>(shift >= 0 ? (value >> shift) : (value << -shift));
+  }
+
+  ComplexFftQ15(fft, half);
+
+  // Split the half-length complex result in to the real-FFT bins: X[k] = E[k] + W^k O[k]
+  // Overall float scale: half-length FFT stage scaling, block scaling and Q8.
+  float scale = static_cast<float>(half) * std::ldexp(1.0f, shift) / 256.0f;
+  for (int k = 0; k < spectrumLength; k++) {
+    int m = (half - k) & (half - 1);
+    int32_t a = fft[2 * k];
+    int32_t b = fft[2 * k + 1];
+    int32_t c = fft[2 * m];
+    int32_t d = fft[2 * m + 1];
+    int32_t er = (a + c) >> 1;
+    int32_t ei = (b - d) >> 1;
+    int32_t orr = (b + d) >> 1;
+    int32_t oi = (c - a) >> 1;
+    int32_t wr = CosQ15(k);
+    int32_t ws = SinQ15(k);
+    int32_t xr = er + ((wr * orr + ws * oi) >> 15);
+    int32_t xi = ei + ((wr * oi - ws * orr) >> 15);
+    magnitude[k] = std::sqrt(static_cast<float>(xr) * xr + static_cast<float>(xi) * xi) * scale;
+  }
+
+  return magnitude;
+}
+#endif
+
+#ifdef CUEBAND_PPG_SLIDING_DFT
+void Ppg::SlidingReset() {
+  slidingHistory.fill(0);
+  slidingSums.fill(0);
+  slidingFilter.fill(0);
+  slidingPosition = 0;
+  lastHRS = 0;
+}
+
+// Streaming equivalent of Detrend() and Filter30to240(), then slide the window of each DFT bin by one sample
+void Ppg::SlidingAdd(uint16_t hrs) {
+  // First difference (Q8)
+  int32_t value = (dataIndex > 0) ? ((static_cast<int32_t>(hrs) - lastHRS) << 8) : 0;
+  lastHRS = hrs;
+  // Band-pass
+  for (int stage = 0; stage < 4; stage++) {
+    slidingFilter[stage] = ExpAverageQ8(alphaLow, value, slidingFilter[stage]);
+    value = slidingFilter[stage];
+  }
+  for (int stage = 4; stage < 8; stage++) {
+    slidingFilter[stage] = ExpAverageQ8(alphaHigh, value, slidingFilter[stage]);
+    value -= slidingFilter[stage];
+  }
+  // Q8 to Q4 (rounded, as a truncation bias would appear in the DC bin)
+  value = (value + 8) >> 4;
+  if (value > INT16_MAX)
+    value = INT16_MAX;
+  if (value < INT16_MIN)
+    value = INT16_MIN;
+
+  // Replace the oldest sample, which has the same phase in every bin.
+  // A sample's contribution is calculated identically when added and when removed, so the integer sums never drift.
+  int32_t sample = value;
+  int32_t oldest = slidingHistory[slidingPosition];
+  slidingHistory[slidingPosition] = static_cast<int16_t>(sample);
+  // Bin k's phase (k * n) mod dataLength steps by n from one bin to the next; sin is cos a quarter period earlier.
+  const int mask = dataLength - 1;
+  int phase = 0;
+  for (int k = 0; k < slidingBins; k++, phase = (phase + slidingPosition) & mask) {
+    int32_t c = cosPeriodQ15[phase];
+    int32_t sn = cosPeriodQ15[(phase - (dataLength >> 2)) & mask];
+    slidingSums[2 * k] += ((sample * c) >> 8) - ((oldest * c) >> 8);
+    slidingSums[2 * k + 1] -= ((sample * sn) >> 8) - ((oldest * sn) >> 8);
+  }
+  slidingPosition = (slidingPosition + 1) & (dataLength - 1);
+}
+
+// Magnitude spectrum of the current window from the sliding sums, scaled as the float FFT.
+// The Hanning window is applied in the frequency domain: Xh[k] = 0.5 X[k] - 0.25 (X[k-1] + X[k+1]).
+// Bins above the region of interest are not tracked, and are zero.
+const float* Ppg::SlidingSpectrum() {
+  static_assert(slidingBins <= spectrumLength, "Sliding DFT bins exceed spectrum length");
+  // Q4 samples, Q15 twiddles (>> 8), Q15 rotation
+  const float scale = std::ldexp(1.0f, -26);
+  // The window starts at the oldest sample, so rotate each bin from phase zero to there
+  const int start = slidingPosition;
+  const int mask = dataLength - 1;
+  float prevRe = 0.0f, prevIm = 0.0f;
+  float currRe = 0.0f, currIm = 0.0f;
+  slidingValues.fill(0.0f);
+  int phase = 0;
+  for (int k = 0; k < slidingBins; k++, phase = (phase + start) & mask) {
+    float c = cosPeriodQ15[phase];
+    float sn = cosPeriodQ15[(phase - (dataLength >> 2)) & mask];
+    float sumRe = slidingSums[2 * k];
+    float sumIm = slidingSums[2 * k + 1];
+    float nextRe = sumRe * c - sumIm * sn;
+    float nextIm = sumRe * sn + sumIm * c;
+    if (k == 1) {
+      // X[-1] is the conjugate of X[1]
+      float hannRe = 0.5f * currRe - 0.5f * nextRe;
+      slidingValues[0] = std::fabs(hannRe) * scale;
+    } else if (k > 1) {
+      float hannRe = 0.5f * currRe - 0.25f * (prevRe + nextRe);
+      float hannIm = 0.5f * currIm - 0.25f * (prevIm + nextIm);
+      slidingValues[k - 1] = std::sqrt(hannRe * hannRe + hannIm * hannIm) * scale;
+    }
+    prevRe = currRe;
+    prevIm = currIm;
+    currRe = nextRe;
+    currIm = nextIm;
+  }
+  return slidingValues.data();
+}
+#endif
+
 // Pass init == true to reset spectral averaging.
 // Returns -1 (Reset Acquisition), 0 (Unable to obtain HR) or HR (BPM).
 int Ppg::ProcessHeartRate(bool init) {
+#if defined(CUEBAND_PPG_FIXED_FFT)
+  const float* magnitude = FixedPointSpectrum();
+  // The lower half of the working buffer is free for the interpolation x values
+  float* xValues = work.values;
+#elif defined(CUEBAND_PPG_SLIDING_DFT)
+  const float* magnitude = SlidingSpectrum();
+  // The magnitudes are consumed by the spectrum average, so the buffer is free for the interpolation x values
+  float* xValues = slidingValues.data();
+#else
   std::copy(dataHRS.begin(), dataHRS.end(), vReal.begin());
   Detrend(vReal);
   Filter30to240(vReal);
@@ -204,7 +505,10 @@ int Ppg::ProcessHeartRate(bool init) {
   FFT.compute(FFTDirection::Forward);
   FFT.complexToMagnitude();
   FFT.~ArduinoFFT();
-  SpectrumAverage(vReal.data(), spectrum.data(), spectrum.size(), init);
+  const float* magnitude = vReal.data();
+  float* xValues = vImag.data();
+#endif
+  SpectrumAverage(magnitude, spectrum.data(), spectrum.size(), init);
   peakLocation = 0.0f;
   float threshold = peakDetectionThreshold;
   float peakWidth = 0.0f;
@@ -214,10 +518,10 @@ int Ppg::ProcessHeartRate(bool init) {
   if (signalToNoiseRatio > signalToNoiseThreshold && spectrum.at(0) < dcThreshold) {
     threshold *= max;
     // Reuse VImag for interpolation x values passed to PeakSearch
-    for (int idx = 0; idx < dataLength; idx++) {
-      vImag[idx] = idx;
+    for (int idx = 0; idx < specLen; idx++) {
+      xValues[idx] = idx;
     }
-    peakLocation = PeakSearch(vImag.data(),
+    peakLocation = PeakSearch(xValues,
                               spectrum.data(),
                               threshold,
                               peakWidth,
@@ -1,12 +1,16 @@
 #pragma once
 
+#include "cueband.h"
+
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#ifndef CUEBAND_PPG_FIXED_POINT
 // Note: Change internal define 'sqrt_internal sqrt' to
 // 'sqrt_internal sqrtf' to save ~3KB of flash.
 #define FFT_SPEED_OVER_PRECISION
 #include "libs/arduinoFFT/src/arduinoFFT.h"
+#endif
 
 namespace Pinetime {
   namespace Controllers {
@@ -16,6 +20,12 @@ namespace Pinetime {
       int8_t Preprocess(uint32_t hrs, uint32_t als);
       int HeartRate();
       void Reset(bool resetDaqBuffer);
+#ifdef CUEBAND_HR_EPOCH
+      // Whether the next HeartRate() call analyses a full window (rather than returning 0 while the buffer fills)
+      bool WindowReady() const {
+        return dataIndex >= dataLength;
+      }
+#endif
       static constexpr int deltaTms = 100;
       // Daq dataLength: Must be power of 2
       static constexpr uint16_t dataLength = 64;
@@ -51,12 +61,37 @@ namespace Pinetime {
       // ALS detection factor
       static constexpr float alsFactor = 2.0f;
 
+#ifndef CUEBAND_PPG_SLIDING_DFT
       // Raw ADC data
       std::array<uint16_t, dataLength> dataHRS;
+#endif
+#if defined(CUEBAND_PPG_FIXED_FFT)
+      // Shared fixed-point working buffer (replaces vReal/vImag):
+      // filtered Q8 signal -> packed Q15 complex FFT data -> spectrum magnitudes (upper half) and interpolation x values (lower half)
+      union {
+        int32_t signal[dataLength];
+        int16_t fft[dataLength];
+        float values[dataLength];
+      } work;
+#elif defined(CUEBAND_PPG_SLIDING_DFT)
+      // Sliding DFT bins: DC, and the HR region of interest with a neighbour either side (for the frequency-domain Hanning window)
+      static constexpr uint16_t slidingBins = hrROIend + 2;
+      // Band-pass filtered samples (Q4) in the window, indexed by sample number modulo dataLength
+      std::array<int16_t, dataLength> slidingHistory;
+      // Running (real, imaginary) sums of each bin, referenced to the phase of sample number zero
+      std::array<int32_t, slidingBins * 2> slidingSums;
+      // Streaming band-pass filter state (Q8): low-pass stages, then high-pass stages
+      std::array<int32_t, 8> slidingFilter;
+      uint16_t lastHRS = 0;
+      uint16_t slidingPosition = 0;
+      // Spectrum magnitudes, then the interpolation x values
+      std::array<float, spectrumLength> slidingValues;
+#else
       // Stores Real numbers from FFT
       std::array<float, dataLength> vReal;
       // Stores Imaginary numbers from FFT
       std::array<float, dataLength> vImag;
+#endif
       // Stores power spectrum calculated from FFT real and imag values
       std::array<float, (spectrumLength)> spectrum;
       // Stores each new HR value (Hz). Non zero values are averaged for HR output
@@ -72,6 +107,13 @@ namespace Pinetime {
       bool resetSpectralAvg = true;
 
       int ProcessHeartRate(bool init);
+#if defined(CUEBAND_PPG_FIXED_FFT)
+      const float* FixedPointSpectrum();
+#elif defined(CUEBAND_PPG_SLIDING_DFT)
+      void SlidingAdd(uint16_t hrs);
+      void SlidingReset();
+      const float* SlidingSpectrum();
+#endif
       float HeartRateAverage(float hr);
       void SpectrumAverage(const float* data, float* spectrum, int length, bool reset);
     };
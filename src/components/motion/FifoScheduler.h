@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+
+    // Decides when to drain the accelerometer FIFO: on the watermark interrupt, or after a fallback timeout.
+    // INT1 is a level output (active high) of the sensor's latched interrupt status, which is held until read, and the
+    // GPIOTE only senses its rising edge -- so if the FIFO is still above the watermark when the status is cleared, INT1
+    // stays high and no new edge arrives (a full read is therefore followed by another drain straight away).
+    // Kept free of driver/RTOS dependencies so it can be tested on the host (see FifoSchedulerTest.cpp).
+    class FifoScheduler {
+    public:
+      explicit FifoScheduler(uint32_t timeoutTicks) : timeoutTicks {timeoutTicks} {
+      }
+
+      // Called from the interrupt handler
+      void Interrupt() {
+        pending = true;
+      }
+
+      // Whether the FIFO should be drained now
+      bool ShouldDrain(uint32_t now) const {
+        return pending || (uint32_t)(now - lastDrain) >= timeoutTicks;
+      }
+
+      // The FIFO has been drained (and the interrupt status cleared) -- if the read filled the buffer, more may remain so drain again
+      void Drained(uint32_t now, bool full) {
+        if (pending) interrupts++;
+        else timeouts++;
+        pending = full;
+        lastDrain = now;
+      }
+
+      // Longest the caller may wait before the next drain is due (none while one is pending)
+      uint32_t WaitTicks(uint32_t now) const {
+        if (pending) return 0;
+        uint32_t elapsed = now - lastDrain;
+        return (elapsed >= timeoutTicks) ? 0 : timeoutTicks - elapsed;
+      }
+
+      bool IsPending() const {
+        return pending;
+      }
+
+      uint32_t interrupts = 0;  // (Debug) Drains triggered by the interrupt (or a full read)
+      uint32_t timeouts = 0;    // (Debug) Drains triggered by the fallback timeout
+
+    private:
+      uint32_t timeoutTicks;
+      uint32_t lastDrain = 0;
+      volatile bool pending = false;
+    };
+  }
+}
@@ -0,0 +1,211 @@
+// Host test of the accelerometer FIFO drain scheduling against a simple model of the BMA421 FIFO and its latched watermark interrupt.
+// Compares polling at CUEBAND_FIFO_POLL_RATE with draining on the watermark interrupt, reporting task wakeups and I2C transactions per minute.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "FifoScheduler.h"
+
+#define TICK_RATE 1024          // configTICK_RATE_HZ
+#define SAMPLE_RATE 50          // CUEBAND_BUFFER_SAMPLE_RATE
+#define SAMPLE_MAX 32           // CUEBAND_SAMPLE_MAX (frames read per drain)
+#define FIFO_FRAMES (1024 / 6)  // BMA421 FIFO capacity (headerless accelerometer frames)
+#define POLL_RATE 10            // CUEBAND_FIFO_POLL_RATE
+#define LOOP_TICKS 100          // SystemTask queue timeout
+
+typedef struct
+{
+    // Model
+    int fifo;                   // Frames in the FIFO
+    bool line;                  // Latched interrupt line level
+    unsigned int missEvery;     // Drop every n-th interrupt edge (0 = none)
+    unsigned int edges;
+    unsigned int lastCount;     // Frames read by the last drain (as Bma421::lastCount)
+
+    // Results
+    unsigned int wakeups;
+    unsigned int transactions;
+    unsigned long delivered;
+    unsigned long generated;
+    unsigned long overflowed;
+    int maxBurst;
+    unsigned int fullReads;
+    unsigned int emptyRedrains; // Drains straight after another (no wait) that read nothing
+} fifo_model_t;
+
+// Read up to SAMPLE_MAX frames -- as Bma421::Process(), the count is only of the frames read by this drain
+static void drain(fifo_model_t *model)
+{
+    model->lastCount = 0;
+    model->transactions++;                  // bma4_get_fifo_length()
+    if (model->fifo <= 0) return;
+    int count = model->fifo < SAMPLE_MAX ? model->fifo : SAMPLE_MAX;
+    model->transactions++;                  // bma4_read_fifo_data()
+    model->fifo -= count;
+    model->delivered += count;
+    if (count > model->maxBurst) model->maxBurst = count;
+    model->lastCount = (unsigned int)count;
+}
+
+static void report(const char *label, fifo_model_t *model, double seconds)
+{
+    double minutes = seconds / 60;
+    printf("%-22s wakeups/min: %6.1f  I2C/min: %6.1f  max burst: %2d  overflowed: %lu  undelivered: %lu\n", label, model->wakeups / minutes, model->transactions / minutes, model->maxBurst, model->overflowed, model->generated - model->delivered - model->overflowed - model->fifo);
+}
+
+// Add frames arriving by 'tick', returns true on a rising edge of the latched watermark interrupt
+static bool arrive(fifo_model_t *model, uint32_t tick, uint32_t *arrived, int watermark)
+{
+    bool edge = false;
+    while ((uint64_t)(*arrived + 1) * TICK_RATE / SAMPLE_RATE <= tick)
+    {
+        (*arrived)++;
+        model->generated++;
+        if (model->fifo < FIFO_FRAMES) model->fifo++;
+        else model->overflowed++;
+        if (watermark > 0 && !model->line && model->fifo >= watermark)
+        {
+            model->line = true;
+            model->edges++;
+            edge = !(model->missEvery > 0 && (model->edges % model->missEvery) == 0);
+        }
+    }
+    return edge;
+}
+
+// Existing behaviour: task wakes every loop, drains at the poll rate
+void simulatePolled(fifo_model_t *model, double seconds)
+{
+    uint32_t arrived = 0;
+    uint32_t lastIndex = 0;
+    for (uint32_t tick = 0; tick < seconds * TICK_RATE; tick += LOOP_TICKS)
+    {
+        arrive(model, tick, &arrived, 0);
+        model->wakeups++;
+        uint32_t index = (uint32_t)((uint64_t)tick * POLL_RATE / TICK_RATE);
+        if (index != lastIndex)
+        {
+            lastIndex = index;
+            drain(model);
+        }
+    }
+}
+
+// Watermark mode: task blocks until the interrupt or the fallback timeout
+void simulateWatermark(fifo_model_t *model, double seconds, int watermark, uint32_t timeoutTicks)
+{
+    Pinetime::Controllers::FifoScheduler scheduler(timeoutTicks);
+    uint32_t arrived = 0;
+    uint32_t tick = 0;
+    uint32_t end = (uint32_t)(seconds * TICK_RATE);
+    while (tick < end)
+    {
+        // Block until an interrupt edge or the wait expires (as the loop, a zero wait does not block)
+        uint32_t wait = scheduler.WaitTicks(tick);
+        if (wait > LOOP_TICKS * 10) wait = LOOP_TICKS * 10;
+        if (wait > 0)
+        {
+            uint32_t until = tick + wait;
+            for (; tick < until && tick < end; tick++)
+            {
+                if (arrive(model, tick, &arrived, watermark))
+                {
+                    scheduler.Interrupt();
+                    break;
+                }
+            }
+            model->wakeups++;
+        }
+
+        if (scheduler.ShouldDrain(tick))
+        {
+            unsigned long delivered = model->delivered;
+            drain(model);
+            if (model->delivered - delivered >= SAMPLE_MAX) model->fullReads++;
+            if (wait == 0 && model->delivered == delivered) model->emptyRedrains++;
+            if (model->emptyRedrains > model->fullReads) break;     // Spinning (time would not advance)
+            model->transactions++;      // bma4_read_int_status() to clear the latch
+            model->line = false;
+            if (model->fifo >= watermark)
+            {
+                model->line = true;     // Status re-latches immediately: no new edge
+            }
+            // As SystemTask::UpdateMotion(): the driver's count from this read
+            scheduler.Drained(tick, model->lastCount >= SAMPLE_MAX);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    double seconds = 600;
+    int watermark = 25;
+    uint32_t timeoutMs = 1000;
+    int fails = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-watermark") && i + 1 < argc) watermark = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-timeout") && i + 1 < argc) timeoutMs = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "ERROR: Unrecognized parameter: %s\n", argv[i]);
+            return -1;
+        }
+    }
+    uint32_t timeoutTicks = timeoutMs * TICK_RATE / 1000;
+
+    fifo_model_t polled = {0};
+    simulatePolled(&polled, seconds);
+    report("polled", &polled, seconds);
+
+    unsigned int missRates[] = { 0, 10, 2, 1 };
+    for (unsigned int m = 0; m < sizeof(missRates) / sizeof(missRates[0]); m++)
+    {
+        fifo_model_t model = {0};
+        model.missEvery = missRates[m];
+        simulateWatermark(&model, seconds, watermark, timeoutTicks);
+        char label[32];
+        if (missRates[m] == 0) sprintf(label, "watermark");
+        else sprintf(label, "watermark (miss 1/%u)", missRates[m]);
+        report(label, &model, seconds);
+
+        // No data may be lost, and each burst must fit the driver buffer
+        if (model.overflowed > 0 || model.maxBurst > SAMPLE_MAX)
+        {
+            printf("FAIL: %s\n", label);
+            fails++;
+        }
+        // A full read is followed by at most one immediate drain that finds the FIFO empty (not a spin until the next frame)
+        if (model.emptyRedrains > model.fullReads)
+        {
+            printf("FAIL: %s: %u empty immediate re-drains after %u full reads\n", label, model.emptyRedrains, model.fullReads);
+            fails++;
+        }
+        // With interrupts working, the watermark mode should wake less often than polling
+        if (missRates[m] == 0 && model.wakeups >= polled.wakeups)
+        {
+            printf("FAIL: watermark wakeups not reduced\n");
+            fails++;
+        }
+    }
+
+    // Watermark at the read size: a full read can empty the FIFO, and the following immediate drain reads nothing
+    {
+        fifo_model_t model = {0};
+        simulateWatermark(&model, seconds, SAMPLE_MAX, timeoutTicks);
+        report("watermark (full reads)", &model, seconds);
+        if (model.overflowed > 0 || model.fullReads == 0 || model.emptyRedrains > model.fullReads)
+        {
+            printf("FAIL: watermark (full reads): %u empty immediate re-drains after %u full reads\n", model.emptyRedrains, model.fullReads);
+            fails++;
+        }
+    }
+
+    printf("%s (%d failed)\n", fails ? "FAILED" : "PASSED", fails);
+    return fails;
+}
@@ -0,0 +1 @@
+g++ -std=c++17 FifoSchedulerTest.cpp -o ./fifoschedulertest && ./fifoschedulertest
@@ -34,6 +34,9 @@ void MotorController::RunForDuration(uint8_t motorDuration) {
     nrf_gpio_pin_clear(PinMap::Motor);
 #ifdef CUEBAND_TRACK_MOTOR_TIMES
     TrackActive(motorDuration);
+#endif
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+    onTimeMs += motorDuration;
 #endif
   }
 }
@@ -122,6 +125,9 @@ void MotorController::AdvancePattern() {
       nrf_gpio_pin_clear(PinMap::Motor);  // On phase of pattern
 #ifdef CUEBAND_TRACK_MOTOR_TIMES
     TrackActive(duration);
+#endif
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+      onTimeMs += duration;
 #endif
     } else {
       nrf_gpio_pin_set(PinMap::Motor);    // Off phase of pattern
@@ -136,11 +142,7 @@ void MotorController::AdvancePattern() {
 void MotorController::TrackActive(unsigned int timeMs) {
   uptime1024_t now = dateTimeController.Uptime1024();
   uptime1024_t end = now + ((timeMs + CUEBAND_TRACK_MOTOR_TIMES) * 1024 / 1000);
-  if (end > this->lastMovement) {
-    this->lastMovement = end;
-  }
-  // Check sensible range (in case of corruption -- overflow should be impossible with 64-bit)
-  //if (now + (60 * 1024) < this->lastMovement) { this->lastMovement = now; }
+  this->movements.Add(now, end);
 }
 #endif
 
@@ -4,6 +4,7 @@
 
 #ifdef CUEBAND_TRACK_MOTOR_TIMES
 #include "components/datetime/DateTimeController.h"
+#include "components/motor/MotorIntervals.h"
 //namespace Pinetime::Controllers { class DateTime; }
 #endif
 
@@ -32,7 +33,11 @@ namespace Pinetime {
       void BeginPattern(const int *pattern);
 #endif
 #ifdef CUEBAND_TRACK_MOTOR_TIMES
-      uptime1024_t GetLastMovement() { return lastMovement; }
+      uptime1024_t GetLastMovement() { return movements.LastEnd(); }
+      const MotorIntervals& GetMovements() { return movements; }
+#endif
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+      uint32_t OnTimeMs() const { return onTimeMs; }  // Total requested on-time (free-running)
 #endif
 
     private:
@@ -44,7 +49,10 @@ namespace Pinetime {
 #ifdef CUEBAND_TRACK_MOTOR_TIMES
       void TrackActive(unsigned int timeMs);
       Pinetime::Controllers::DateTime& dateTimeController;
-      uptime1024_t lastMovement = 0;
+      MotorIntervals movements;
+#endif
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+      uint32_t onTimeMs = 0;
 #endif
 #ifdef CUEBAND_MOTOR_PATTERNS
       void AdvancePattern();
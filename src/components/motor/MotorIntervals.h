@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+
+    // Small ring of recent motor activity intervals (in Uptime1024 units, each including the settle time), so that
+    // accelerometer samples affected by any of several vibrations (e.g. a multi-pulse pattern) within one buffer can be masked.
+    // Kept free of driver/RTOS dependencies so it can be tested on the host (see MotorIntervalsTest.cpp).
+    class MotorIntervals {
+    public:
+      static constexpr size_t capacity = 8;
+
+      // Motor active over [start, end) -- merged with the latest interval if they overlap
+      void Add(uint64_t start, uint64_t end) {
+        if (end <= start) return;
+        if (count > 0) {
+          Interval& latest = intervals[(head + capacity - 1) % capacity];
+          if (start <= latest.end) {
+            if (start < latest.start) latest.start = start;
+            if (end > latest.end) latest.end = end;
+            return;
+          }
+        }
+        intervals[head] = {start, end};
+        head = (head + 1) % capacity;
+        if (count < capacity) count++;    // (oldest overwritten when full)
+      }
+
+      // End of the latest motor activity (0 if none)
+      uint64_t LastEnd() const {
+        return (count > 0) ? intervals[(head + capacity - 1) % capacity].end : 0;
+      }
+
+      // Whether a sample taken at this time overlaps motor activity
+      bool IsMasked(uint64_t time) const {
+        for (size_t i = 0; i < count; i++) {
+          const Interval& interval = intervals[(head + capacity - 1 - i) % capacity];
+          if (time >= interval.start && time < interval.end) return true;
+        }
+        return false;
+      }
+
+      // Calls run(first, end) for each run of unmasked sample indexes, in order, for 'sampleCount' samples at 'rate' Hz with the
+      // first sample at 'firstTime' (sample i is taken at firstTime + i * 1024 / rate). Returns the number of masked samples.
+      template <typename F> unsigned int UnmaskedRuns(uint64_t firstTime, unsigned int rate, unsigned int sampleCount, F run) const {
+        // Masked index ranges, oldest interval first (intervals are ordered and non-overlapping once merged)
+        unsigned int position = 0;
+        unsigned int masked = 0;
+        for (size_t i = count; i > 0 && position < sampleCount; i--) {
+          const Interval& interval = intervals[(head + capacity - i) % capacity];
+          unsigned int first = IndexAtOrAfter(interval.start, firstTime, rate, sampleCount);
+          unsigned int end = IndexAtOrAfter(interval.end, firstTime, rate, sampleCount);
+          if (end <= position) continue;
+          if (first < position) first = position;
+          if (first > position) run(position, first);
+          masked += end - first;
+          position = end;
+        }
+        if (position < sampleCount) run(position, sampleCount);
+        return masked;
+      }
+
+    private:
+      struct Interval {
+        uint64_t start;
+        uint64_t end;
+      };
+
+      // First sample index taken at or after 'time' (clamped to sampleCount)
+      static unsigned int IndexAtOrAfter(uint64_t time, uint64_t firstTime, unsigned int rate, unsigned int sampleCount) {
+        if (time <= firstTime) return 0;
+        uint64_t offset = time - firstTime;
+        if (offset >= (uint64_t)sampleCount * 1024 / rate + 1024) return sampleCount;
+        uint64_t index = (offset * rate + 1023) / 1024;   // ceil(offset * rate / 1024)
+        return (index > sampleCount) ? sampleCount : (unsigned int)index;
+      }
+
+      Interval intervals[capacity] = {};
+      size_t head = 0;    // Next position to write
+      size_t count = 0;
+    };
+  }
+}
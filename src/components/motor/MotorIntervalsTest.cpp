@@ -0,0 +1,166 @@
+// Host test of masking accelerometer samples that overlap motor activity.
+// Checks MotorIntervals::UnmaskedRuns() against a per-sample reference, then replays synthetic vibration patterns (as
+// MotorController::patterns[], and a metronome) through FIFO-sized chunks, comparing the previous single "last movement"
+// masking (discard the start of the buffer up to the end of the latest movement) with the interval ring.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "MotorIntervals.h"
+
+using namespace Pinetime::Controllers;
+
+#define RATE 50                 // CUEBAND_BUFFER_EFFECTIVE_RATE
+#define CHUNK 25                // CUEBAND_FIFO_WATERMARK (samples per FIFO read)
+#define VIBRATION_SETTLE 300    // Physical settle time of the vibration in the accelerometer signal (ms)
+
+static int failures = 0;
+
+static uint64_t ms_to_1024(unsigned int ms) { return (uint64_t)ms * 1024 / 1000; }
+
+// Per-sample reference for UnmaskedRuns()
+static void testRuns() {
+    srand(1);
+    unsigned int cases = 0, bad = 0;
+    for (int trial = 0; trial < 20000; trial++) {
+        MotorIntervals intervals;
+        uint64_t t = rand() % 4096;
+        int n = rand() % (MotorIntervals::capacity + 1);     // (none dropped from the ring)
+        uint64_t starts[MotorIntervals::capacity], ends[MotorIntervals::capacity];
+        for (int i = 0; i < n; i++) {
+            t += rand() % 1500;
+            starts[i] = t;
+            ends[i] = t + 1 + rand() % 1200;
+            intervals.Add(starts[i], ends[i]);
+        }
+        uint64_t firstTime = rand() % (t + 2048);
+        unsigned int rate = (rand() % 2) ? 50 : 25;
+        unsigned int count = rand() % 80;
+
+        bool kept[80] = {0};
+        unsigned int runEnd = 0;
+        bool ordered = true;
+        unsigned int masked = intervals.UnmaskedRuns(firstTime, rate, count, [&](unsigned int first, unsigned int end) {
+            if (first < runEnd || end <= first || end > count) ordered = false;
+            for (unsigned int i = first; i < end && i < 80; i++) kept[i] = true;
+            runEnd = end;
+        });
+
+        unsigned int expectedMasked = 0;
+        bool ok = ordered;
+        for (unsigned int i = 0; i < count; i++) {
+            // Exact sample time comparison: start <= firstTime + i * 1024 / rate < end
+            bool isMasked = false;
+            for (int j = 0; j < n; j++) {
+                if (starts[j] * rate <= firstTime * rate + i * 1024 && firstTime * rate + i * 1024 < ends[j] * rate) isMasked = true;
+            }
+            if (isMasked) expectedMasked++;
+            if (kept[i] == isMasked) ok = false;
+        }
+        if (masked != expectedMasked) ok = false;
+        cases++;
+        if (!ok) bad++;
+    }
+    printf("Runs: %u cases, %u mismatched -- %s\n", cases, bad, bad ? "FAIL" : "OK");
+    if (bad) failures++;
+}
+
+typedef struct {
+    unsigned int samples;
+    unsigned int vibrationKept;     // Samples affected by vibration that were used
+    unsigned int cleanDiscarded;    // Unaffected samples that were discarded
+} result_t;
+
+// Replays 'seconds' of samples with the given pulse pattern (on/off durations in ms, repeated every 'period' ms)
+static void replay(const char *name, const int *pattern, unsigned int period, unsigned int seconds, unsigned int settleMs) {
+    MotorIntervals intervals;
+    result_t oldResult = {0}, newResult = {0};
+
+    // Actual vibration times (ms) for the ground truth
+    static unsigned int pulseStart[4096], pulseDuration[4096];
+    int pulses = 0;
+    for (unsigned int start = 1000; start < seconds * 1000 && pulses < 4000; start += period) {
+        unsigned int t = start;
+        for (int i = 0; pattern[i] > 0; i++) {
+            if ((i & 1) == 0) {
+                pulseStart[pulses] = t;
+                pulseDuration[pulses] = pattern[i];
+                pulses++;
+            }
+            t += pattern[i];
+        }
+    }
+    int tracked = 0;
+
+    unsigned int totalSamples = seconds * RATE;
+    for (unsigned int chunkStart = 0; chunkStart < totalSamples; chunkStart += CHUNK) {
+        unsigned int chunkEnd = chunkStart + CHUNK;
+        uint64_t readTime = ms_to_1024(chunkEnd * 1000 / RATE);     // Uptime1024 at the FIFO read
+
+        // Motor pulses started before this read (MotorController::TrackActive() at the start of each on phase)
+        while (tracked < pulses && pulseStart[tracked] <= chunkEnd * 1000 / RATE) {
+            intervals.Add(ms_to_1024(pulseStart[tracked]), ms_to_1024(pulseStart[tracked]) + ((pulseDuration[tracked] + settleMs) * 1024 / 1000));
+            tracked++;
+        }
+
+        // As ActivityController::AddSamples()
+        uint64_t firstSampleTime = readTime - CHUNK * 1024 / RATE;
+
+        bool keptNew[CHUNK] = {0};
+        intervals.UnmaskedRuns(firstSampleTime, RATE, CHUNK, [&](unsigned int first, unsigned int end) {
+            for (unsigned int i = first; i < end; i++) keptNew[i] = true;
+        });
+
+        uint64_t lastMovement = intervals.LastEnd();
+        uint64_t overlap = (firstSampleTime < lastMovement) ? (lastMovement - firstSampleTime) : 0;
+        unsigned int skip = (unsigned int)(overlap * RATE / 1024);
+        if (skip > CHUNK) skip = CHUNK;
+
+        for (unsigned int i = 0; i < CHUNK; i++) {
+            // Sample time in ms, and whether it is affected by the vibration
+            double ms = (chunkStart + i) * 1000.0 / RATE;
+            bool affected = false;
+            for (int v = 0; v < pulses; v++) {
+                if (ms >= pulseStart[v] && ms < pulseStart[v] + pulseDuration[v] + VIBRATION_SETTLE) affected = true;
+            }
+            bool keptOld = i >= skip;
+            oldResult.samples++; newResult.samples++;
+            if (affected && keptOld) oldResult.vibrationKept++;
+            if (!affected && !keptOld) oldResult.cleanDiscarded++;
+            if (affected && keptNew[i]) newResult.vibrationKept++;
+            if (!affected && !keptNew[i]) newResult.cleanDiscarded++;
+        }
+    }
+
+    printf("%-14s settle %4u ms: last-movement: %5u vibration kept, %5u clean discarded; intervals: %5u vibration kept, %5u clean discarded (of %u)\n",
+        name, settleMs, oldResult.vibrationKept, oldResult.cleanDiscarded, newResult.vibrationKept, newResult.cleanDiscarded, newResult.samples);
+    // The settle time covers the physical vibration, so nothing affected should be kept
+    if (settleMs >= VIBRATION_SETTLE && newResult.vibrationKept > 0) failures++;
+    if (newResult.cleanDiscarded > oldResult.cleanDiscarded) failures++;
+}
+
+// As MotorController::patterns[]
+static const int patternShort[]       = { 100, 0 };
+static const int patternDoubleLong[]  = { 250, 250,  250, 0 };
+static const int patternTripleShort[] = { 100, 100,  100, 100,  100, 0 };
+static const int patternTripleLong[]  = { 250, 250,  250, 250,  250, 0 };
+static const int patternMetronome[]   = { 50, 550,  50, 550,  50, 550,  50, 550,  50, 0 };
+
+int main(int argc, char *argv[]) {
+    testRuns();
+
+    const unsigned int settles[] = { 400, 3584 };   // Short, and CUEBAND_TRACK_MOTOR_TIMES
+    for (unsigned int s = 0; s < sizeof(settles) / sizeof(settles[0]); s++) {
+        replay("short", patternShort, 20000, 600, settles[s]);
+        replay("double-long", patternDoubleLong, 20000, 600, settles[s]);
+        replay("triple-short", patternTripleShort, 20000, 600, settles[s]);
+        replay("triple-long", patternTripleLong, 7000, 600, settles[s]);
+        replay("metronome", patternMetronome, 3000, 600, settles[s]);
+    }
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1 @@
+g++ -std=c++17 MotorIntervalsTest.cpp -o ./motorintervalstest && ./motorintervalstest
@@ -0,0 +1,116 @@
+// Host test: task profile statistics from simulated snapshots of the FreeRTOS run-time counters (1024 Hz), with a task
+// created and one deleted between samples, the counters wrapping, the UART lines, and the daily record layout.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "taskprofile.h"
+#include "components/activity/recordfields.h"
+
+#define HZ TASK_PROFILE_COUNTER_HZ
+
+static bool check(bool ok, const char *name) {
+  printf("%s: %s\n", ok ? "OK" : "FAIL", name);
+  return ok;
+}
+
+static const task_profile_task_t *find(const task_profile_t *profile, const char *name) {
+  for (int i = 0; i < profile->count; i++) {
+    if (strcmp(profile->tasks[i].name, name) == 0) return &profile->tasks[i];
+  }
+  return NULL;
+}
+
+int main(int argc, char *argv[]) {
+  int failures = 0;
+  static task_profile_t profile;
+  task_profile_sample_t samples[4];
+
+  // Counters start near the wrap to check differences across it
+  const uint32_t start = 0xffffffff - 30 * HZ;
+  task_profile_init(&profile);
+  samples[0] = (task_profile_sample_t){"IDLE", 1, start - 1000, 100};
+  samples[1] = (task_profile_sample_t){"MAIN", 3, 600, 80};
+  samples[2] = (task_profile_sample_t){"ble", 7, 400, 50};
+  task_profile_sample(&profile, samples, 3, start, 9000, 8000);
+
+  // 60 s later: MAIN used 10%, ble 5%, a new task (created mid-interval) 1%, IDLE the rest; ble's stack use grew
+  const uint32_t interval = 60 * HZ;
+  samples[0].runTime += interval * 84 / 100;
+  samples[1].runTime += interval * 10 / 100;
+  samples[2].runTime += interval * 5 / 100;
+  samples[2].stackFree = 30;
+  samples[3] = (task_profile_sample_t){"Hea", 9, interval / 100, 200};
+  task_profile_sample(&profile, samples, 4, start + interval, 7000, 6500);
+  const task_profile_task_t *main = find(&profile, "MAIN");
+  const task_profile_task_t *ble = find(&profile, "ble");
+  const task_profile_task_t *hr = find(&profile, "Hea");
+  failures += !check(profile.interval == interval && main && main->cpu == 100 && ble && ble->cpu == 50 && hr && hr->cpu == 10, "cpu per interval (across the counter wrap)");
+  failures += !check(ble->stackFree == 30 && main->stackFree == 80 && profile.heapMinimum == 6500, "stack and heap low-water marks");
+
+  // A quiet interval: the peak is kept, the task that was deleted is dropped
+  samples[0].runTime += interval * 99 / 100;
+  samples[1].runTime += interval * 1 / 100;
+  samples[2].stackFree = 40;  // (a high-water mark can only be reported lower)
+  task_profile_sample(&profile, samples, 3, start + 2 * interval, 7200, 6500);
+  main = find(&profile, "MAIN");
+  ble = find(&profile, "ble");
+  failures += !check(main->cpu == 10 && main->cpuPeak == 100 && ble->cpu == 0 && ble->stackFree == 30, "peak cpu and lowest stack kept");
+  failures += !check(profile.count == 3 && find(&profile, "Hea") == NULL, "deleted task dropped");
+
+  // More tasks than slots
+  task_profile_t full;
+  task_profile_sample_t many[TASK_PROFILE_MAX_TASKS + 2];
+  char names[TASK_PROFILE_MAX_TASKS + 2][4];
+  task_profile_init(&full);
+  for (int i = 0; i < TASK_PROFILE_MAX_TASKS + 2; i++) {
+    snprintf(names[i], sizeof(names[i]), "t%d", i);
+    many[i] = (task_profile_sample_t){names[i], (uint32_t)i + 1, 0, 10};
+  }
+  task_profile_sample(&full, many, TASK_PROFILE_MAX_TASKS + 2, 0, 0, 0);
+  failures += !check(full.count == TASK_PROFILE_MAX_TASKS, "tasks beyond the slots ignored");
+
+  // UART lines
+  char line[TASK_PROFILE_LINE_MAX];
+  int lines = 0;
+  bool formatted = true;
+  for (int i = 0; ; i++) {
+    size_t len = task_profile_format(&profile, i, line, sizeof(line));
+    if (len == 0) break;
+    printf("    %s", line);
+    if (strncmp(line, "ZP:", 3) != 0 || line[len - 1] != '\n') formatted = false;
+    lines++;
+  }
+  task_profile_format(&profile, 1, line, sizeof(line));
+  formatted = formatted && strcmp(line, "ZP:MAIN 3 1.0 10.0 80\r\n") == 0;
+  task_profile_format(&profile, profile.count, line, sizeof(line));
+  formatted = formatted && strcmp(line, "ZP:heap 7200 6500 3 60\r\n") == 0;
+  failures += !check(formatted && lines == profile.count + 1, "UART lines");
+  failures += !check(task_profile_format(&profile, 0, line, 8) == 7 && strlen(line) == 7, "UART line truncated to the buffer");
+
+  // Record since boot (the counters wrapped, so the period is short of the total): MAIN's whole run time over it
+  uint8_t record[TASK_PROFILE_RECORD_MAX];
+  size_t len = task_profile_record(&profile, record, sizeof(record));
+  uint32_t period = record_get32(record);
+  bool layout = len == TASK_PROFILE_RECORD_HEADER + 3 * TASK_PROFILE_RECORD_TASK && record[8] == 3;
+  layout = layout && period == start + 2 * interval && record_get16(record + 4) == 7200 && record_get16(record + 6) == 6500;
+  const uint8_t *t = record + TASK_PROFILE_RECORD_HEADER + TASK_PROFILE_RECORD_TASK;  // MAIN
+  const uint32_t mainRunTime = 600 + interval * 11 / 100;
+  layout = layout && memcmp(t, "MAI", 3) == 0 && t[3] == 3 && record_get16(t + 4) == (mainRunTime * 1000 + period / 2) / period && t[6] == 10 && record_get16(t + 7) == 80;
+  failures += !check(layout, "record layout");
+
+  // The next record covers only the period since
+  samples[0].runTime += interval / 2;
+  samples[1].runTime += interval / 2;
+  task_profile_sample(&profile, samples, 3, start + 3 * interval, 7200, 6500);
+  len = task_profile_record(&profile, record, sizeof(record));
+  period = record_get32(record);
+  t = record + TASK_PROFILE_RECORD_HEADER + TASK_PROFILE_RECORD_TASK;
+  failures += !check(period == interval && record_get16(t + 4) == 500 && t[6] == 50, "record covers the period since the last");
+  failures += !check(task_profile_record(&profile, record, TASK_PROFILE_RECORD_HEADER + TASK_PROFILE_RECORD_TASK) == TASK_PROFILE_RECORD_HEADER + TASK_PROFILE_RECORD_TASK && record[8] == 1, "record truncated to the buffer");
+
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,116 @@
+// Task profile
+
+#include <string.h>
+#include <stdio.h>
+
+#include "taskprofile.h"
+#include "components/activity/recordfields.h"
+
+void task_profile_init(task_profile_t *profile) {
+	memset(profile, 0, sizeof(*profile));
+}
+
+static task_profile_task_t *task_profile_find(task_profile_t *profile, const task_profile_sample_t *sample) {
+	for (int i = 0; i < profile->count; i++) {
+		if (profile->tasks[i].number == sample->number) return &profile->tasks[i];
+	}
+	if (profile->count >= TASK_PROFILE_MAX_TASKS) return NULL;
+	task_profile_task_t *task = &profile->tasks[profile->count++];
+	memset(task, 0, sizeof(*task));
+	task->number = sample->number;
+	if (sample->name != NULL) strncpy(task->name, sample->name, TASK_PROFILE_NAME_SIZE - 1);
+	// A task created since the last sample: its run time counts from zero (so also since the last record)
+	task->stackFree = 0xffff;
+	return task;
+}
+
+static uint16_t task_profile_permille(uint32_t part, uint32_t total) {
+	if (total == 0) return 0;
+	uint64_t permille = ((uint64_t)part * 1000 + total / 2) / total;
+	return permille > 1000 ? 1000 : (uint16_t)permille;
+}
+
+void task_profile_sample(task_profile_t *profile, const task_profile_sample_t *samples, int count, uint32_t totalRunTime, uint32_t heapFree, uint32_t heapMinimum) {
+	bool first = (profile->samples == 0);
+	// Counters are free-running, so intervals are differences (wrapping)
+	uint32_t interval = totalRunTime - profile->totalRunTime;
+	if (first) {
+		interval = totalRunTime;
+		profile->recordTotalRunTime = 0;
+	}
+
+	for (int i = 0; i < profile->count; i++) profile->tasks[i].present = 0;
+	for (int i = 0; i < count; i++) {
+		task_profile_task_t *task = task_profile_find(profile, &samples[i]);
+		if (task == NULL) continue;
+		task->cpu = task_profile_permille(samples[i].runTime - task->runTime, interval);
+		if (task->cpu > task->cpuPeak) task->cpuPeak = task->cpu;
+		if (samples[i].stackFree < task->stackFree) task->stackFree = samples[i].stackFree;
+		task->runTime = samples[i].runTime;
+		task->present = 1;
+	}
+
+	// Tasks that have been deleted no longer take a slot
+	int kept = 0;
+	for (int i = 0; i < profile->count; i++) {
+		if (!profile->tasks[i].present) continue;
+		if (kept != i) profile->tasks[kept] = profile->tasks[i];
+		kept++;
+	}
+	profile->count = kept;
+
+	profile->totalRunTime = totalRunTime;
+	profile->interval = interval;
+	profile->heapFree = heapFree;
+	profile->heapMinimum = heapMinimum;
+	profile->samples++;
+}
+
+size_t task_profile_format(const task_profile_t *profile, int index, char *buffer, size_t size) {
+	int len;
+	if (index < 0 || index > profile->count || size == 0) return 0;
+	if (index < profile->count) {
+		const task_profile_task_t *task = &profile->tasks[index];
+		len = snprintf(buffer, size, "ZP:%s %u %u.%u %u.%u %u\r\n", task->name, (unsigned int)task->number,
+			task->cpu / 10, task->cpu % 10, task->cpuPeak / 10, task->cpuPeak % 10, (unsigned int)task->stackFree);
+	} else {
+		len = snprintf(buffer, size, "ZP:heap %u %u %u %u\r\n", (unsigned int)profile->heapFree, (unsigned int)profile->heapMinimum,
+			(unsigned int)profile->samples, (unsigned int)(profile->interval / TASK_PROFILE_COUNTER_HZ));
+	}
+	if (len < 0) return 0;
+	return ((size_t)len >= size) ? size - 1 : (size_t)len;
+}
+
+size_t task_profile_record(task_profile_t *profile, uint8_t *buffer, size_t size) {
+	int tasks = profile->count;
+	if (size < TASK_PROFILE_RECORD_HEADER) return 0;
+	if (TASK_PROFILE_RECORD_HEADER + (size_t)tasks * TASK_PROFILE_RECORD_TASK > size) tasks = (int)((size - TASK_PROFILE_RECORD_HEADER) / TASK_PROFILE_RECORD_TASK);
+
+	uint32_t period = profile->totalRunTime - profile->recordTotalRunTime;
+	record_put32(buffer + 0, period);
+	record_put16(buffer + 4, profile->heapFree);
+	record_put16(buffer + 6, profile->heapMinimum);
+	buffer[8] = (uint8_t)tasks;
+
+	uint8_t *p = buffer + TASK_PROFILE_RECORD_HEADER;
+	for (int i = 0; i < tasks; i++) {
+		const task_profile_task_t *task = &profile->tasks[i];
+		memset(p, 0, 3);
+		size_t nameLength = strlen(task->name);		// (always terminated)
+		if (nameLength > 3) nameLength = 3;
+		memcpy(p, task->name, nameLength);
+		p[3] = (uint8_t)task->number;
+		record_put16(p + 4, task_profile_permille(task->runTime - task->recordRunTime, period));
+		p[6] = (uint8_t)((task->cpuPeak + 5) / 10);
+		record_put16(p + 7, task->stackFree);
+		p += TASK_PROFILE_RECORD_TASK;
+	}
+
+	// Start the next period
+	profile->recordTotalRunTime = profile->totalRunTime;
+	for (int i = 0; i < profile->count; i++) {
+		profile->tasks[i].recordRunTime = profile->tasks[i].runTime;
+		profile->tasks[i].cpuPeak = profile->tasks[i].cpu;
+	}
+	return (size_t)(p - buffer);
+}
@@ -0,0 +1,71 @@
+// Task profile: per-task CPU use (from the FreeRTOS run-time counters), stack high-water marks, and heap low-water mark,
+// sampled periodically.  CPU use is per-mille of the sample interval (the idle task's share is time idle or asleep).
+// The device snapshots the tasks (uxTaskGetSystemState) and passes them in; this only keeps the statistics.
+
+#ifndef TASKPROFILE_H
+#define TASKPROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TASK_PROFILE_COUNTER_HZ 1024			// Run-time counter rate (RTC1, the tick rate)
+#define TASK_PROFILE_MAX_TASKS 10
+#define TASK_PROFILE_NAME_SIZE 8			// configMAX_TASK_NAME_LEN is 4, so names are at most 3 characters
+
+typedef struct {
+	uint32_t number;						// Task number (xTaskNumber)
+	char name[TASK_PROFILE_NAME_SIZE];
+	uint32_t runTime;						// Run-time counter at the last sample
+	uint32_t recordRunTime;					// Run-time counter at the last record
+	uint16_t cpu;							// Per-mille of the last interval
+	uint16_t cpuPeak;						// Highest interval since the last record
+	uint16_t stackFree;						// Stack high-water mark (words never used, lowest ever)
+	uint8_t present;						// Seen in the last sample
+} task_profile_task_t;
+
+typedef struct {
+	const char *name;
+	uint32_t number;
+	uint32_t runTime;
+	uint16_t stackFree;
+} task_profile_sample_t;
+
+typedef struct {
+	task_profile_task_t tasks[TASK_PROFILE_MAX_TASKS];
+	int count;
+	uint32_t samples;
+	uint32_t totalRunTime;					// Run-time counter at the last sample
+	uint32_t interval;						// Counts in the last interval
+	uint32_t recordTotalRunTime;			// Run-time counter at the last record
+	uint32_t heapFree;
+	uint32_t heapMinimum;					// Lowest free heap ever (xPortGetMinimumEverFreeHeapSize)
+} task_profile_t;
+
+void task_profile_init(task_profile_t *profile);
+
+// Add a snapshot of the tasks, with the run-time counter (total) at the time of the snapshot
+void task_profile_sample(task_profile_t *profile, const task_profile_sample_t *samples, int count, uint32_t totalRunTime, uint32_t heapFree, uint32_t heapMinimum);
+
+// One line per task: "ZP:<name> <number> <cpu %> <peak cpu %> <stack free words>\r\n", then (index == count)
+// "ZP:heap <free> <minimum> <samples> <interval s>\r\n"; returns 0 past the end.
+#define TASK_PROFILE_LINE_MAX 64
+size_t task_profile_format(const task_profile_t *profile, int index, char *buffer, size_t size);
+
+// Binary record of the period since the last record (then starts a new period):
+// @0 u32 period (run-time counts), @4 u16 free heap (bytes), @6 u16 minimum free heap, @8 u8 tasks,
+// then per task: @0 char[3] name, @3 u8 number, @4 u16 average cpu (per-mille of the period), @6 u8 peak cpu (per-cent), @7 u16 stack free (words)
+#define TASK_PROFILE_RECORD_HEADER 9
+#define TASK_PROFILE_RECORD_TASK 9
+#define TASK_PROFILE_RECORD_MAX (TASK_PROFILE_RECORD_HEADER + TASK_PROFILE_MAX_TASKS * TASK_PROFILE_RECORD_TASK)
+size_t task_profile_record(task_profile_t *profile, uint8_t *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
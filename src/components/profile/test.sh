@@ -0,0 +1 @@
+gcc -O2 -std=c99 -Wall -Wextra -I../.. -c taskprofile.c -o taskprofile.o && g++ -O2 -Wall -I../.. TaskProfileTest.cpp taskprofile.o -o ./taskprofiletest && ./taskprofiletest
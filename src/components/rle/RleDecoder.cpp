@@ -1,4 +1,5 @@
 #include "components/rle/RleDecoder.h"
+#include <cstring>
 
 using namespace Pinetime::Tools;
 
@@ -8,29 +9,71 @@ RleDecoder::RleDecoder(const uint8_t* buffer, size_t size) : buffer {buffer}, si
 RleDecoder::RleDecoder(const uint8_t* buffer, size_t size, uint16_t foregroundColor, uint16_t backgroundColor) : RleDecoder {buffer, size} {
   this->foregroundColor = foregroundColor;
   this->backgroundColor = backgroundColor;
+  this->color = backgroundColor;
 }
 
 void RleDecoder::DecodeNext(uint8_t* output, size_t maxBytes) {
-  for (; encodedBufferIndex < size; encodedBufferIndex++) {
-    uint8_t rl = buffer[encodedBufferIndex] - processedCount;
-    while (rl) {
-      output[bp] = color >> 8;
-      output[bp + 1] = color & 0xff;
-      bp += 2;
-      rl -= 1;
-      processedCount++;
+  Decode(output, maxBytes / 2);
+}
+
+size_t RleDecoder::DecodeLines(uint8_t* output, size_t width, size_t maxLines) {
+  if (width == 0) return 0;
+  return Decode(output, width * maxLines) / width;
+}
 
-      if (bp >= maxBytes) {
-        bp = 0;
-        y += 1;
-        return;
-      }
+// Writes a run of pixels of one color, as 32-bit words (two pixels) once the output is word aligned
+uint8_t* RleDecoder::Fill(uint8_t* output, size_t pixels, uint16_t color) {
+  uint8_t high = color >> 8;
+  uint8_t low = color & 0xff;
+  if (pixels < 4) {
+    // Short runs (e.g. dithering or text edges) are quicker written directly
+    for (; pixels > 0; pixels--) {
+      output[0] = high;
+      output[1] = low;
+      output += 2;
     }
-    processedCount = 0;
+    return output;
+  }
+  if ((reinterpret_cast<uintptr_t>(output) & 3) != 0) {
+    output[0] = high;
+    output[1] = low;
+    output += 2;
+    pixels--;
+  }
+  uint32_t pair;
+  const uint8_t bytes[4] = {high, low, high, low};
+  std::memcpy(&pair, bytes, sizeof(pair));    // (byte order of the pixels in memory)
+  for (; pixels >= 2; pixels -= 2) {
+    std::memcpy(output, &pair, sizeof(pair));
+    output += 4;
+  }
+  if (pixels > 0) {
+    output[0] = high;
+    output[1] = low;
+    output += 2;
+  }
+  return output;
+}
 
-    if (color == backgroundColor)
-      color = foregroundColor;
-    else
-      color = backgroundColor;
+// Decodes up to 'pixels' pixels, a whole run at a time, returning the number written (fewer at the end of the image)
+size_t RleDecoder::Decode(uint8_t* output, size_t pixels) {
+  size_t written = 0;
+  while (written < pixels && encodedBufferIndex < size) {
+    size_t rl = static_cast<uint8_t>(buffer[encodedBufferIndex] - processedCount);
+    size_t count = pixels - written;
+    if (rl <= count) {
+      // Whole (remaining) run, then switch color
+      output = Fill(output, rl, color);
+      written += rl;
+      processedCount = 0;
+      encodedBufferIndex++;
+      color = (color == backgroundColor) ? foregroundColor : backgroundColor;
+    } else {
+      // Run continues into the next call
+      output = Fill(output, count, color);
+      written += count;
+      processedCount += count;
+    }
   }
+  return written;
 }
@@ -6,7 +6,8 @@
 namespace Pinetime {
   namespace Tools {
     /* 1-bit RLE decoder. Provide the encoded buffer to the constructor and then call DecodeNext() by
-     * specifying the output (decoded) buffer and the maximum number of bytes this buffer can handle.
+     * specifying the output (decoded) buffer and the maximum number of bytes this buffer can handle,
+     * or DecodeLines() to decode several whole lines at once (for fewer, larger display transfers).
      *
      * Code from https://github.com/daniel-thompson/wasp-bootloader by Daniel Thompson released under the MIT license.
      */
@@ -17,13 +18,18 @@ namespace Pinetime {
 
       void DecodeNext(uint8_t* output, size_t maxBytes);
 
+      // Decodes up to maxLines lines of 'width' pixels (2 bytes each, high byte first) to the output, returning the number of
+      // whole lines decoded (fewer at the end of the image). Runs are written with 32-bit stores when the output is aligned.
+      size_t DecodeLines(uint8_t* output, size_t width, size_t maxLines);
+
     private:
+      size_t Decode(uint8_t* output, size_t pixels);
+      static uint8_t* Fill(uint8_t* output, size_t pixels, uint16_t color);
+
       const uint8_t* buffer;
       size_t size;
 
       size_t encodedBufferIndex = 0;
-      int y = 0;
-      uint16_t bp = 0;
       uint16_t foregroundColor = 0xffff;
       uint16_t backgroundColor = 0;
       uint16_t color = backgroundColor;
@@ -0,0 +1,159 @@
+// Host test of the 1-bit RLE decoder.
+// Images encoded by tools/rle_encode.py (see RleTestImages.py, which generates rletestimages.h) are decoded with
+// DecodeNext() one line at a time and with DecodeLines() several lines per call (at both word-aligned and half-word
+// offsets), and compared pixel by pixel with the source images.  Then benchmarks decoding the recovery logo per frame:
+// the previous pixel-at-a-time decoder, DecodeNext() and DecodeLines(), with the display transfers each needs.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "components/rle/RleDecoder.h"
+
+using namespace Pinetime::Tools;
+
+typedef struct {
+    const char *name;
+    size_t width, height;
+    const uint8_t *rle;
+    size_t size;
+    const uint8_t *bits;    // Expected pixels (1 = foreground), packed most-significant bit first
+} test_image_t;
+
+#include "rletestimages.h"
+
+static const uint16_t foreground = 0xf81e;  // Distinct bytes to catch byte order errors
+static const uint16_t background = 0x0841;
+
+static int failures = 0;
+
+static bool expectedBit(const test_image_t *image, size_t pixel) {
+    return (image->bits[pixel >> 3] >> (7 - (pixel & 7))) & 1;
+}
+
+// Compare decoded pixels (from 'firstPixel') with the image; returns the number of wrong pixels
+static unsigned int compare(const test_image_t *image, const uint8_t *output, size_t firstPixel, size_t pixels) {
+    unsigned int wrong = 0;
+    for (size_t i = 0; i < pixels; i++) {
+        uint16_t expected = expectedBit(image, firstPixel + i) ? foreground : background;
+        if (output[2 * i] != (expected >> 8) || output[2 * i + 1] != (expected & 0xff)) wrong++;
+    }
+    return wrong;
+}
+
+static uint8_t outputStorage[240 * 240 * 2 + 8] __attribute__((aligned(4)));
+
+static void testImage(const test_image_t *image) {
+    bool ok = true;
+
+    // DecodeNext(), one line per call
+    {
+        RleDecoder decoder(image->rle, image->size, foreground, background);
+        unsigned int wrong = 0;
+        for (size_t y = 0; y < image->height; y++) {
+            decoder.DecodeNext(outputStorage, image->width * 2);
+            wrong += compare(image, outputStorage, y * image->width, image->width);
+        }
+        if (wrong) { printf("FAIL: %s: DecodeNext() %u wrong pixels\n", image->name, wrong); ok = false; }
+    }
+
+    // DecodeLines(), several lines per call, aligned and half-word offset (odd widths also misalign later runs)
+    const size_t linesPerCall[] = { 1, 3, 8, 17, 240 };
+    for (size_t offset = 0; offset <= 2; offset += 2) {
+        for (size_t l = 0; l < sizeof(linesPerCall) / sizeof(linesPerCall[0]); l++) {
+            RleDecoder decoder(image->rle, image->size, foreground, background);
+            uint8_t *output = outputStorage + offset;
+            unsigned int wrong = 0;
+            size_t y = 0;
+            while (y < image->height) {
+                memset(outputStorage, 0xaa, sizeof(outputStorage));
+                size_t lines = decoder.DecodeLines(output, image->width, linesPerCall[l]);
+                size_t expectedLines = (image->height - y < linesPerCall[l]) ? image->height - y : linesPerCall[l];
+                if (lines != expectedLines) { wrong++; break; }
+                wrong += compare(image, output, y * image->width, lines * image->width);
+                // Nothing written past the lines returned
+                if (output[lines * image->width * 2] != 0xaa) wrong++;
+                y += lines;
+            }
+            if (decoder.DecodeLines(output, image->width, 1) != 0) wrong++;     // End of image
+            if (wrong) { printf("FAIL: %s: DecodeLines(%u) at offset %u: %u wrong\n", image->name, (unsigned int)linesPerCall[l], (unsigned int)offset, wrong); ok = false; }
+        }
+    }
+
+    printf("%-8s %3ux%-3u %5u bytes RLE -- %s\n", image->name, (unsigned int)image->width, (unsigned int)image->height, (unsigned int)image->size, ok ? "OK" : "FAIL");
+    if (!ok) failures++;
+}
+
+// The previous decoder (pixel at a time), for the benchmark
+class PreviousRleDecoder {
+public:
+    PreviousRleDecoder(const uint8_t* buffer, size_t size) : buffer {buffer}, size {size} {}
+    void DecodeNext(uint8_t* output, size_t maxBytes) {
+        for (; encodedBufferIndex < size; encodedBufferIndex++) {
+            uint8_t rl = buffer[encodedBufferIndex] - processedCount;
+            while (rl) {
+                output[bp] = color >> 8;
+                output[bp + 1] = color & 0xff;
+                bp += 2;
+                rl -= 1;
+                processedCount++;
+                if (bp >= maxBytes) {
+                    bp = 0;
+                    return;
+                }
+            }
+            processedCount = 0;
+            color = (color == backgroundColor) ? foregroundColor : backgroundColor;
+        }
+    }
+private:
+    const uint8_t* buffer;
+    size_t size;
+    size_t encodedBufferIndex = 0;
+    uint16_t bp = 0;
+    uint16_t foregroundColor = 0xffff;
+    uint16_t backgroundColor = 0;
+    uint16_t color = backgroundColor;
+    int processedCount = 0;
+};
+
+static volatile uint8_t sink;
+
+static void benchmark(const test_image_t *image, int frames) {
+    const size_t width = image->width, height = image->height;
+    double nanos[3] = {0};
+    unsigned int transfers[3] = {0};
+    for (int method = 0; method < 3; method++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; frame++) {
+            transfers[method] = 0;
+            if (method == 0) {
+                PreviousRleDecoder decoder(image->rle, image->size);
+                for (size_t y = 0; y < height; y++) { decoder.DecodeNext(outputStorage, width * 2); transfers[method]++; }
+            } else if (method == 1) {
+                RleDecoder decoder(image->rle, image->size);
+                for (size_t y = 0; y < height; y++) { decoder.DecodeNext(outputStorage, width * 2); transfers[method]++; }
+            } else {
+                RleDecoder decoder(image->rle, image->size);
+                for (size_t y = 0; y < height; y += 8) { decoder.DecodeLines(outputStorage, width, 8); transfers[method]++; }
+            }
+            sink = outputStorage[frame & 0xff];
+        }
+        nanos[method] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+    }
+    printf("Decode %s per frame (host): previous %.1f us (%u transfers), DecodeNext %.1f us (%u transfers), DecodeLines(8) %.1f us (%u transfers)\n",
+        image->name, nanos[0] / 1000, transfers[0], nanos[1] / 1000, transfers[1], nanos[2] / 1000, transfers[2]);
+}
+
+int main(int argc, char *argv[]) {
+    for (size_t i = 0; i < sizeof(testImages) / sizeof(testImages[0]); i++) {
+        testImage(&testImages[i]);
+    }
+    benchmark(&testImages[0], 2000);    // Logo
+    benchmark(&testImages[3], 500);     // Noise (short runs)
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+
+# Generates rletestimages.h for RleDecoderTest.cpp: test images encoded by tools/rle_encode.py, each with the expected
+# pixels (1 = foreground) taken from the source image.  The first image is the recovery logo, which is also checked
+# against the committed displayapp/icons/infinitime/infinitime-nb.c.
+
+import os
+import random
+import re
+import struct
+import sys
+import types
+import zlib
+
+here = os.path.dirname(os.path.abspath(__file__))
+tools = os.path.join(here, '..', '..', '..', 'tools')
+icons = os.path.join(here, '..', '..', 'displayapp', 'icons', 'infinitime')
+
+# The encoder only needs PIL to open files, so allow a minimal PNG reader to stand in for it
+try:
+    from PIL import Image
+except ImportError:
+    Image = None
+    sys.modules['PIL'] = types.SimpleNamespace(Image=None)
+
+# Load the encoder functions from the tool (everything before its command-line handling)
+source = open(os.path.join(tools, 'rle_encode.py')).read()
+rle_encode = {}
+exec(compile(source[:source.index('parser = argparse')], 'rle_encode.py', 'exec'), rle_encode)
+encode = rle_encode['encode']
+
+class Pixels:
+    """Image object with the attributes encode() uses."""
+    def __init__(self, width, height, pixel):
+        self.width = width
+        self.height = height
+        self.pixels = {(x, y): pixel(x, y) for y in range(height) for x in range(width)}
+
+    def load(self):
+        return self.pixels
+
+def read_png(filename):
+    """Minimal non-interlaced 8-bit PNG reader (when PIL is not installed)."""
+    data = open(filename, 'rb').read()
+    pos, idat = 8, b''
+    while pos < len(data):
+        length, kind = struct.unpack('>I4s', data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        if kind == b'IHDR':
+            width, height, depth, color_type, _, _, interlace = struct.unpack('>IIBBBBB', chunk)
+            assert depth == 8 and interlace == 0
+        elif kind == b'IDAT':
+            idat += chunk
+        pos += 12 + length
+    channels = {0: 1, 2: 3, 4: 2, 6: 4}[color_type]
+    raw = zlib.decompress(idat)
+    stride = width * channels
+    rows, previous = [], bytearray(stride)
+    for y in range(height):
+        filter_type = raw[y * (stride + 1)]
+        row = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for i in range(stride):
+            a = row[i - channels] if i >= channels else 0
+            b = previous[i]
+            c = previous[i - channels] if i >= channels else 0
+            if filter_type == 1: row[i] = (row[i] + a) & 0xff
+            elif filter_type == 2: row[i] = (row[i] + b) & 0xff
+            elif filter_type == 3: row[i] = (row[i] + ((a + b) >> 1)) & 0xff
+            elif filter_type == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                row[i] = (row[i] + (a if pa <= pb and pa <= pc else b if pb <= pc else c)) & 0xff
+        rows.append(row)
+        previous = row
+    return Pixels(width, height, lambda x, y: tuple(rows[y][x * channels:(x + 1) * channels]))
+
+def load_png(filename):
+    if Image is not None:
+        return Image.open(filename)
+    return read_png(filename)
+
+def expected_bits(im):
+    """Foreground where the source pixel differs from the first pixel's run colour (each change of value is a new run)."""
+    pixels = im.load()
+    bits, current, value = [], pixels[0, 0], 0
+    for y in range(im.height):
+        for x in range(im.width):
+            if pixels[x, y] != current:
+                current = pixels[x, y]
+                value ^= 1
+            bits.append(value)
+    return bits
+
+def images():
+    random.seed(1)
+    yield 'logo', load_png(os.path.join(icons, 'infinitime-nb.png'))
+    yield 'blank', Pixels(240, 240, lambda x, y: 0)                                        # Runs over 255 (255, 0 escapes)
+    yield 'checker', Pixels(240, 240, lambda x, y: (x + y) & 1)                             # Single-pixel runs
+    yield 'noise', Pixels(240, 240, lambda x, y: 1 if random.random() < 0.3 else 0)
+    yield 'stripes', Pixels(240, 240, lambda x, y: 1 if (x // 3) % 2 else 0)                # Odd run lengths
+    yield 'bands', Pixels(240, 240, lambda x, y: 1 if 60 <= y < 180 and (y // 17) % 2 else 0)  # Runs spanning many lines
+    yield 'disc', Pixels(240, 240, lambda x, y: 1 if (x - 120) ** 2 + (y - 113) ** 2 < 90 ** 2 else 0)
+    yield 'small', Pixels(37, 11, lambda x, y: 1 if (x * y) % 7 == 1 else 0)               # Odd width
+
+def committed_logo():
+    text = open(os.path.join(icons, 'infinitime-nb.c')).read()
+    return bytes(int(v, 16) for v in re.findall(r'0x([0-9a-fA-F]+)', text))
+
+def main():
+    out = sys.stdout
+    out.write('// Generated by RleTestImages.py\n\n')
+    names = []
+    for name, im in images():
+        width, height, rle = encode(im)
+        if name == 'logo' and rle != committed_logo():
+            sys.stderr.write('WARNING: re-encoded logo differs from infinitime-nb.c\n')
+        bits = expected_bits(im)
+        packed = bytes(sum(bits[i + j] << (7 - j) for j in range(8) if i + j < len(bits)) for i in range(0, len(bits), 8))
+        for label, data in (('rle', rle), ('bits', packed)):
+            out.write(f'static const uint8_t {name}_{label}[] = {{')
+            for i, value in enumerate(data):
+                out.write(('\n  ' if i % 24 == 0 else '') + f'0x{value:02x},')
+            out.write('\n};\n')
+        names.append((name, width, height))
+    out.write('\nstatic const test_image_t testImages[] = {\n')
+    for name, width, height in names:
+        out.write(f'  {{ "{name}", {width}, {height}, {name}_rle, sizeof({name}_rle), {name}_bits }},\n')
+    out.write('};\n')
+
+main()
@@ -0,0 +1 @@
+python3 RleTestImages.py > rletestimages.h && g++ -O2 -I../.. RleDecoderTest.cpp RleDecoder.cpp -o ./rledecodertest && ./rledecodertest "$@"
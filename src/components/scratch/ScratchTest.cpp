@@ -0,0 +1,70 @@
+// Host test: scratch arena leases (alignment, guard and misuse checks), and a random interleaving of the services'
+// leases, as they can overlap on the device, to check they always succeed and never overlap.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "scratch.h"
+
+static uint8_t arena[SCRATCH_ARENA_SIZE] __attribute__((aligned(SCRATCH_ALIGN)));
+
+static bool check(bool ok, const char *name) {
+  printf("%s: %s\n", ok ? "OK" : "FAIL", name);
+  return ok;
+}
+
+int main(int argc, char *argv[]) {
+  int failures = 0;
+
+  // Basic use and misuse
+  scratch_init(arena, sizeof(arena));
+  uint8_t *a = (uint8_t *)scratch_acquire(SCRATCH_OWNER_UART_BLOCK, SCRATCH_SIZE_UART_BLOCK);
+  uint8_t *b = (uint8_t *)scratch_acquire(SCRATCH_OWNER_INFO_TEXT, 10);
+  bool aligned = a != NULL && b != NULL && ((uintptr_t)a % SCRATCH_ALIGN) == 0 && ((uintptr_t)b % SCRATCH_ALIGN) == 0;
+  bool disjoint = aligned && (b >= a + SCRATCH_SIZE_UART_BLOCK + SCRATCH_GUARD_SIZE || a >= b + 10 + SCRATCH_GUARD_SIZE);
+  failures += !check(aligned && disjoint, "aligned, disjoint leases");
+  failures += !check(scratch_acquire(SCRATCH_OWNER_UART_BLOCK, 1) == NULL && scratch_stats()->errors == 1, "second acquire by an owner is an error");
+  failures += !check(scratch_acquire(SCRATCH_OWNER_DFU_PACKET, 1) == NULL && scratch_stats()->errors == 2, "acquire while a shared region is leased is an error");
+  failures += !check(!scratch_release(SCRATCH_OWNER_DFU_PACKET, a) && scratch_held(SCRATCH_OWNER_UART_BLOCK) && scratch_stats()->errors == 3, "release by another owner is an error");
+  b[10] = 0;  // Overrun
+  failures += !check(!scratch_release(SCRATCH_OWNER_INFO_TEXT, b) && scratch_stats()->errors == 4, "overrun detected on release");
+  failures += !check(scratch_release(SCRATCH_OWNER_UART_BLOCK, a) && scratch_stats()->inUse == 0, "release");
+  failures += !check(scratch_acquire(SCRATCH_OWNER_DFU_PACKET, SCRATCH_REGION_BLE_WRITE) == NULL && scratch_stats()->failures == 1, "too large fails");
+  char line[SCRATCH_LINE_MAX];
+  scratch_format(line, sizeof(line));
+  printf("    %s", line);
+  scratch_init(arena, SCRATCH_REGION_BLE_WRITE);
+  failures += !check(scratch_acquire(SCRATCH_OWNER_ACTIVITY_BLOCK, 1) == NULL && scratch_stats()->failures == 1, "arena too small: regions past the end fail");
+
+  // Random interleaving: the activity block is held while its notifications are queued (BLE host task); a UART block
+  // read or a DFU packet is held briefly within a BLE write (also the BLE host task, so never both); the info text is
+  // held briefly by the display task, so can overlap either.
+  scratch_init(arena, sizeof(arena));
+  srand(1);
+  static const size_t sizes[SCRATCH_OWNER_COUNT] = {SCRATCH_SIZE_UART_BLOCK, SCRATCH_SIZE_ACTIVITY_BLOCK, SCRATCH_SIZE_DFU_PACKET, SCRATCH_SIZE_INFO_TEXT};
+  uint8_t *held[SCRATCH_OWNER_COUNT] = {0};
+  bool corrupt = false;
+  for (int step = 0; step < 1000000; step++) {
+    scratch_owner_t owner = (scratch_owner_t)(rand() % SCRATCH_OWNER_COUNT);
+    if (held[owner] != NULL) {
+      for (size_t i = 0; i < sizes[owner]; i++) if (held[owner][i] != (uint8_t)(owner + 1)) corrupt = true;
+      scratch_release(owner, held[owner]);
+      held[owner] = NULL;
+    } else {
+      bool bleBusy = held[SCRATCH_OWNER_UART_BLOCK] != NULL || held[SCRATCH_OWNER_DFU_PACKET] != NULL;
+      if ((owner == SCRATCH_OWNER_UART_BLOCK || owner == SCRATCH_OWNER_DFU_PACKET) && bleBusy) continue;
+      held[owner] = (uint8_t *)scratch_acquire(owner, sizes[owner]);
+      if (held[owner] != NULL) memset(held[owner], owner + 1, sizes[owner]);
+    }
+  }
+  const scratch_stats_t *stats = scratch_stats();
+  scratch_format(line, sizeof(line));
+  printf("    %s", line);
+  failures += !check(stats->failures == 0 && stats->errors == 0 && !corrupt, "service leases always succeed, without overlap");
+  printf("    arena %u bytes, peak lease use %u (previously: %u static, plus up to %u on the heap)\n", SCRATCH_ARENA_SIZE, (unsigned int)stats->peak, 256, SCRATCH_SIZE_UART_BLOCK + SCRATCH_SIZE_ACTIVITY_BLOCK);
+
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,133 @@
+// Scratch arena
+
+#include <stdio.h>
+#include <string.h>
+
+#include "scratch.h"
+
+#ifdef NRF52
+#include <nrf.h>
+#endif
+
+// Region of each owner
+typedef enum {
+	SCRATCH_REGION_ID_BLE_WRITE,
+	SCRATCH_REGION_ID_ACTIVITY,
+	SCRATCH_REGION_ID_INFO,
+	SCRATCH_REGION_COUNT,
+} scratch_region_id_t;
+
+static const uint8_t scratchOwnerRegion[SCRATCH_OWNER_COUNT] = {
+	SCRATCH_REGION_ID_BLE_WRITE,	// SCRATCH_OWNER_UART_BLOCK
+	SCRATCH_REGION_ID_ACTIVITY,		// SCRATCH_OWNER_ACTIVITY_BLOCK
+	SCRATCH_REGION_ID_BLE_WRITE,	// SCRATCH_OWNER_DFU_PACKET
+	SCRATCH_REGION_ID_INFO,			// SCRATCH_OWNER_INFO_TEXT
+};
+
+static const size_t scratchRegionSize[SCRATCH_REGION_COUNT] = {
+	SCRATCH_REGION_BLE_WRITE,
+	SCRATCH_REGION_ACTIVITY,
+	SCRATCH_REGION_INFO,
+};
+
+typedef struct {
+	size_t offset;
+	size_t size;
+	int holder;				// Owner holding the lease, or -1
+	size_t leaseSize;
+} scratch_region_t;
+
+static uint8_t *scratchArena;
+static scratch_region_t scratchRegions[SCRATCH_REGION_COUNT];
+static scratch_stats_t scratchStats;
+
+// Leases are taken and returned from different tasks
+#ifdef NRF52
+#define SCRATCH_LOCK() uint32_t primask = __get_PRIMASK(); __disable_irq()
+#define SCRATCH_UNLOCK() __set_PRIMASK(primask)
+#else
+#define SCRATCH_LOCK()
+#define SCRATCH_UNLOCK()
+#endif
+
+void scratch_init(void *arena, size_t size) {
+	scratchArena = (uint8_t *)arena;
+	memset(&scratchStats, 0, sizeof(scratchStats));
+	scratchStats.size = size;
+	size_t offset = 0;
+	for (int i = 0; i < SCRATCH_REGION_COUNT; i++) {
+		scratchRegions[i].offset = offset;
+		scratchRegions[i].size = (offset + scratchRegionSize[i] <= size) ? scratchRegionSize[i] : 0;
+		scratchRegions[i].holder = -1;
+		scratchRegions[i].leaseSize = 0;
+		offset += scratchRegionSize[i];
+	}
+}
+
+void *scratch_acquire(scratch_owner_t owner, size_t size) {
+	if ((unsigned)owner >= SCRATCH_OWNER_COUNT || scratchArena == NULL) return NULL;
+	scratch_region_t *region = &scratchRegions[scratchOwnerRegion[owner]];
+	void *buffer = NULL;
+
+	SCRATCH_LOCK();
+	if (size > scratchStats.ownerPeak[owner]) scratchStats.ownerPeak[owner] = size;
+	if (region->holder >= 0) {
+		scratchStats.errors++;
+	} else if (SCRATCH_FOOTPRINT(size) > region->size) {
+		scratchStats.failures++;
+	} else {
+		region->holder = owner;
+		region->leaseSize = size;
+		scratchStats.leases++;
+		scratchStats.inUse += size;
+		if (scratchStats.inUse > scratchStats.peak) scratchStats.peak = scratchStats.inUse;
+		buffer = scratchArena + region->offset;
+	}
+	SCRATCH_UNLOCK();
+
+	if (buffer != NULL) memset((uint8_t *)buffer + size, SCRATCH_GUARD_BYTE, SCRATCH_GUARD_SIZE);
+	return buffer;
+}
+
+int scratch_release(scratch_owner_t owner, void *buffer) {
+	if (buffer == NULL) return 1;
+	if ((unsigned)owner >= SCRATCH_OWNER_COUNT) return 0;
+	scratch_region_t *region = &scratchRegions[scratchOwnerRegion[owner]];
+	int ok = 1;
+
+	SCRATCH_LOCK();
+	if (region->holder != (int)owner || buffer != scratchArena + region->offset) {
+		ok = 0;
+	} else {
+		const uint8_t *guard = scratchArena + region->offset + region->leaseSize;
+		for (size_t i = 0; i < SCRATCH_GUARD_SIZE; i++) {
+			if (guard[i] != SCRATCH_GUARD_BYTE) ok = 0;
+		}
+		scratchStats.inUse -= region->leaseSize;
+		region->holder = -1;
+	}
+	if (!ok) scratchStats.errors++;
+	SCRATCH_UNLOCK();
+
+	return ok;
+}
+
+int scratch_held(scratch_owner_t owner) {
+	return (unsigned)owner < SCRATCH_OWNER_COUNT && scratchRegions[scratchOwnerRegion[owner]].holder == (int)owner;
+}
+
+const scratch_stats_t *scratch_stats(void) {
+	return &scratchStats;
+}
+
+size_t scratch_format(char *buffer, size_t size) {
+	const scratch_stats_t *s = &scratchStats;
+	int len = snprintf(buffer, size, "ZM:%u %u %u %lu %lu %lu ", (unsigned int)s->size, (unsigned int)s->inUse, (unsigned int)s->peak, (unsigned long)s->leases, (unsigned long)s->failures, (unsigned long)s->errors);
+	for (int i = 0; i < SCRATCH_OWNER_COUNT && len >= 0 && (size_t)len < size; i++) {
+		len += snprintf(buffer + len, size - len, "%s%u", i ? "/" : "", (unsigned int)s->ownerPeak[i]);
+	}
+	if (len >= 0 && (size_t)len < size) len += snprintf(buffer + len, size - len, "\r\n");
+	if (len < 0) len = 0;
+	if ((size_t)len >= size) len = size ? size - 1 : 0;
+	return (size_t)len;
+}
@@ -0,0 +1,75 @@
+// Scratch arena: transfer buffers leased from one statically reserved buffer, rather than each service allocating its
+// own from the heap (or sharing a single buffer unchecked).  Each owner has a fixed region, so allocation is deterministic;
+// owners that can never hold leases at the same time share a region.  Each owner holds at most one lease, which is
+// followed by a guard, checked on release.  Acquiring while the region is leased (overlapping use), mismatched releases,
+// and overruns are counted as errors.
+
+#ifndef SCRATCH_H
+#define SCRATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SCRATCH_ALIGN 8
+#define SCRATCH_GUARD_SIZE 4
+#define SCRATCH_GUARD_BYTE 0xa5
+// Arena space taken by a lease of the given size
+#define SCRATCH_FOOTPRINT(_size) ((((_size) + SCRATCH_GUARD_SIZE) + SCRATCH_ALIGN - 1) & ~(SCRATCH_ALIGN - 1))
+
+// Largest lease of each owner
+#define SCRATCH_SIZE_UART_BLOCK (256 * 2 + 1)		// ACTIVITY_BLOCK_SIZE as hex, with a terminator
+#define SCRATCH_SIZE_ACTIVITY_BLOCK (2 + 256)		// Length prefix and ACTIVITY_BLOCK_SIZE
+#define SCRATCH_SIZE_DFU_PACKET 253					// ATT MTU 256, less the opcode and handle
+#define SCRATCH_SIZE_INFO_TEXT 256
+
+// Regions: the UART block and DFU packet are only leased within a BLE write (in the NimBLE host task), so share one
+#define SCRATCH_REGION_BLE_WRITE SCRATCH_FOOTPRINT(SCRATCH_SIZE_UART_BLOCK > SCRATCH_SIZE_DFU_PACKET ? SCRATCH_SIZE_UART_BLOCK : SCRATCH_SIZE_DFU_PACKET)
+#define SCRATCH_REGION_ACTIVITY SCRATCH_FOOTPRINT(SCRATCH_SIZE_ACTIVITY_BLOCK)
+#define SCRATCH_REGION_INFO SCRATCH_FOOTPRINT(SCRATCH_SIZE_INFO_TEXT)
+#define SCRATCH_ARENA_SIZE (SCRATCH_REGION_BLE_WRITE + SCRATCH_REGION_ACTIVITY + SCRATCH_REGION_INFO)
+
+typedef enum {
+	SCRATCH_OWNER_UART_BLOCK,		// UartService 'R': block read as hex/base64 text
+	SCRATCH_OWNER_ACTIVITY_BLOCK,	// ActivityService: block being sent as notifications
+	SCRATCH_OWNER_DFU_PACKET,		// DfuService: large packet copied from the mbuf chain
+	SCRATCH_OWNER_INFO_TEXT,		// InfoApp: debug text
+	SCRATCH_OWNER_COUNT,
+} scratch_owner_t;
+
+typedef struct {
+	size_t size;							// Arena size
+	size_t inUse;							// Bytes currently leased (as requested)
+	size_t peak;							// High-water mark of inUse
+	size_t ownerPeak[SCRATCH_OWNER_COUNT];	// Largest lease requested by each owner
+	uint32_t leases;						// Successful acquires
+	uint32_t failures;						// Acquires larger than the owner's region
+	uint32_t errors;						// Overlapping use: acquire while the region is leased, release of a buffer not held, guard overwritten
+} scratch_stats_t;
+
+// The arena should be SCRATCH_ARENA_SIZE bytes, aligned to SCRATCH_ALIGN (regions that do not fit are never leased)
+void scratch_init(void *arena, size_t size);
+
+// Lease a buffer (aligned to SCRATCH_ALIGN), NULL if it does not fit the owner's region or the region is already leased
+void *scratch_acquire(scratch_owner_t owner, size_t size);
+
+// Return the owner's lease (NULL is ignored): false if the buffer is not the owner's lease, or its guard was overwritten
+int scratch_release(scratch_owner_t owner, void *buffer);
+
+// Whether the owner holds a lease
+int scratch_held(scratch_owner_t owner);
+
+const scratch_stats_t *scratch_stats(void);
+
+// One line: "ZM:<size> <in use> <peak> <leases> <failures> <errors> <owner 0 peak>/<owner 1 peak>/...\r\n"
+#define SCRATCH_LINE_MAX 80
+size_t scratch_format(char *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1 @@
+gcc -O2 -c scratch.c -o scratch.o && g++ -O2 ScratchTest.cpp scratch.o -o ./scratchtest && ./scratchtest
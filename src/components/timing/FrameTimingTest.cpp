@@ -0,0 +1,122 @@
+// Host test of the display frame timing histograms.
+// Checks the bucket boundaries, the statistics and UART line format ('zf' command), that only lv_task_handler() calls
+// which flushed are recorded as renders, and times real intervals with the host clock.  Then replays a simulated
+// full-screen transition (modelled render, flush and transfer costs) to show the output for a UI change.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "frametiming.h"
+
+static int failures = 0;
+
+#define CHECK(_cond, ...) do { if (!(_cond)) { printf("FAIL: " __VA_ARGS__); printf("\n"); failures++; } } while (0)
+
+static void testBuckets() {
+    const struct { uint32_t us; int bucket; } cases[] = {
+        { 0, 0 }, { 31, 0 }, { 32, 1 }, { 63, 1 }, { 64, 2 }, { 1000, 5 }, { 1024, 6 },
+        { 16383, 9 }, { 16384, 10 }, { 65535, 11 }, { 131071, 12 }, { 131072, 13 }, { 0xffffffff, 13 },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        int bucket = frame_timing_bucket(cases[i].us);
+        CHECK(bucket == cases[i].bucket, "bucket(%u) = %d, expected %d", (unsigned int)cases[i].us, bucket, cases[i].bucket);
+    }
+}
+
+static void testStats() {
+    char line[FRAME_TIMING_LINE_MAX];
+    frame_timing_reset();
+    frame_timing_add(FRAME_TIMING_FLUSH, 100, 64 * 50);     // Half of the time awake
+    frame_timing_add(FRAME_TIMING_FLUSH, 300, 64 * 150);
+    frame_timing_add(FRAME_TIMING_FLUSH, 20, 64 * 10);
+    const frame_timing_stat_t *stat = frame_timing_stat(FRAME_TIMING_FLUSH);
+    CHECK(stat->count == 3 && stat->maxUs == 300 && stat->totalUs == 420, "flush statistics");
+    frame_timing_format(FRAME_TIMING_FLUSH, line, sizeof(line));
+    CHECK(strcmp(line, "ZF:flush 3 140 300 50 1/0/1/0/1/0/0/0/0/0/0/0/0/0\r\n") == 0, "format: %s", line);
+    frame_timing_format(FRAME_TIMING_SPI_TRANSFER, line, sizeof(line));
+    CHECK(strcmp(line, "ZF:spi 0 0 0 0 0/0/0/0/0/0/0/0/0/0/0/0/0/0\r\n") == 0, "format empty: %s", line);
+
+    // Longest line still fits the UART response buffer
+    frame_timing_stat_t *full = (frame_timing_stat_t *)frame_timing_stat(FRAME_TIMING_RENDER);
+    full->count = 999999; full->maxUs = 9999999; full->totalUs = 999999ull * 999999; full->totalCycles = full->totalUs * 64;
+    for (int i = 0; i < FRAME_TIMING_BUCKETS; i++) full->histogram[i] = 999999;
+    size_t len = frame_timing_format(FRAME_TIMING_RENDER, line, sizeof(line));
+    CHECK(len == strlen(line) && len < sizeof(line) && strcmp(line + len - 2, "\r\n") == 0, "full line (%u): %s", (unsigned int)len, line);
+    // Truncated to a small buffer
+    char small[16];
+    len = frame_timing_format(FRAME_TIMING_RENDER, small, sizeof(small));
+    CHECK(len == strlen(small) && len == sizeof(small) - 1, "truncated: %s", small);
+
+    frame_timing_reset();
+    CHECK(frame_timing_stat(FRAME_TIMING_FLUSH)->count == 0 && frame_timing_stat(FRAME_TIMING_RENDER)->histogram[0] == 0, "reset");
+}
+
+static void testHandler() {
+    frame_timing_reset();
+    for (int i = 0; i < 10; i++) {      // Idle calls
+        frame_timing_handler_begin();
+        frame_timing_handler_end();
+    }
+    frame_timing_handler_begin();       // A call that refreshed
+    frame_timing_add(FRAME_TIMING_FLUSH, 1000, 64000);
+    frame_timing_handler_end();
+    CHECK(frame_timing_idle_count() == 10 && frame_timing_stat(FRAME_TIMING_RENDER)->count == 1, "handler: idle %u, render %u",
+          (unsigned int)frame_timing_idle_count(), (unsigned int)frame_timing_stat(FRAME_TIMING_RENDER)->count);
+}
+
+static void testClock() {
+    const long delays[] = { 50, 2000, 20000 };  // us: timed from the cycle counter, then the RTC
+    for (size_t i = 0; i < sizeof(delays) / sizeof(delays[0]); i++) {
+        frame_timing_reset();
+        frame_timing_mark_t start = frame_timing_mark();
+        struct timespec ts = { 0, delays[i] * 1000 };
+        nanosleep(&ts, NULL);
+        frame_timing_record(FRAME_TIMING_DRAW_BUFFER, start);
+        uint32_t us = frame_timing_stat(FRAME_TIMING_DRAW_BUFFER)->maxUs;
+        // At least the delay (less one RTC tick), and not wildly more (host scheduling)
+        CHECK(us + 1000000 / FRAME_TIMING_RTC_HZ >= (uint32_t)delays[i] && us < (uint32_t)delays[i] * 3 + 1000, "timed %ld us as %u us", delays[i], (unsigned int)us);
+    }
+}
+
+// Full-screen transition: 60 bands of 4 lines (LV_HOR_RES_MAX * 4 buffers), 8 MHz SPI, modelled CPU costs
+static void simulate(double renderUsPerPixel) {
+    frame_timing_reset();
+    for (int frame = 0; frame < 10; frame++) {
+        frame_timing_add(FRAME_TIMING_LOAD_APP, 4000, 4000 * FRAME_TIMING_CPU_MHZ);
+        uint32_t frameUs = 0, frameCycles = 0;
+        for (int band = 0; band < 60; band++) {
+            uint32_t renderUs = (uint32_t)(renderUsPerPixel * 240 * 4);
+            uint32_t transferUs = 240 * 4 * 2 + 8 * 2;      // Pixel bytes, plus a 2 us interrupt per 255-byte chunk
+            uint32_t drawUs = 3 * 5 + 8 * 5;                // Blocking address window writes
+            frame_timing_add(FRAME_TIMING_DRAW_BUFFER, drawUs, drawUs * FRAME_TIMING_CPU_MHZ);
+            frame_timing_add(FRAME_TIMING_FLUSH, drawUs + 5, (drawUs + 5) * FRAME_TIMING_CPU_MHZ);
+            frame_timing_add(FRAME_TIMING_SPI_TRANSFER, transferUs, 8 * 2 * FRAME_TIMING_CPU_MHZ);
+            // Rendering overlaps the previous band's transfer
+            uint32_t bandUs = (renderUs > transferUs ? renderUs : transferUs) + drawUs + 5;
+            frameUs += bandUs;
+            frameCycles += (renderUs + drawUs + 5) * FRAME_TIMING_CPU_MHZ;
+        }
+        frame_timing_add(FRAME_TIMING_RENDER, frameUs, frameCycles);
+    }
+    printf("Simulated transition, render %.2f us/px:\n", renderUsPerPixel);
+    for (int id = 0; id < FRAME_TIMING_COUNT; id++) {
+        char line[FRAME_TIMING_LINE_MAX];
+        frame_timing_format((frame_timing_id_t)id, line, sizeof(line));
+        printf("  %s", line);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    frame_timing_init();
+    testBuckets();
+    testStats();
+    testHandler();
+    testClock();
+    simulate(0.25);
+    simulate(4.0);
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
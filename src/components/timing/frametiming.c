@@ -0,0 +1,125 @@
+// Display frame timing histograms
+
+#include <stdio.h>
+#include <string.h>
+
+#include "frametiming.h"
+
+#ifdef NRF52
+#include <nrf.h>
+#else
+#include <time.h>
+#endif
+
+static frame_timing_stat_t frameTimingStats[FRAME_TIMING_COUNT];
+static uint32_t frameTimingIdle;
+static frame_timing_mark_t frameTimingHandlerStart;
+static uint32_t frameTimingHandlerFlushes;
+
+static const char *frameTimingNames[FRAME_TIMING_COUNT] = {
+	"render", "flush", "draw", "spi", "load",
+};
+
+void frame_timing_init(void) {
+#ifdef NRF52
+	// Enable the DWT cycle counter
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+	frame_timing_reset();
+}
+
+void frame_timing_reset(void) {
+	memset(frameTimingStats, 0, sizeof(frameTimingStats));
+	frameTimingIdle = 0;
+}
+
+frame_timing_mark_t frame_timing_mark(void) {
+	frame_timing_mark_t mark;
+#ifdef NRF52
+	mark.cycles = DWT->CYCCNT;
+	mark.ticks = NRF_RTC1->COUNTER;		// FreeRTOS tick (portNRF_RTC_REG), always running
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	uint64_t ns = (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+	mark.cycles = (uint32_t)(ns * FRAME_TIMING_CPU_MHZ / 1000);
+	mark.ticks = (uint32_t)(ns * FRAME_TIMING_RTC_HZ / 1000000000) & FRAME_TIMING_RTC_MASK;
+#endif
+	return mark;
+}
+
+void frame_timing_record(frame_timing_id_t id, frame_timing_mark_t start) {
+	frame_timing_mark_t now = frame_timing_mark();
+	uint32_t cycles = now.cycles - start.cycles;
+	uint32_t ticks = (now.ticks - start.ticks) & FRAME_TIMING_RTC_MASK;
+	uint32_t us;
+	if (ticks >= FRAME_TIMING_RTC_MIN_TICKS) {
+		us = (uint32_t)(((uint64_t)ticks * 1000000) / FRAME_TIMING_RTC_HZ);
+	} else {
+		us = cycles / FRAME_TIMING_CPU_MHZ;
+	}
+	frame_timing_add(id, us, cycles);
+}
+
+int frame_timing_bucket(uint32_t us) {
+	int bucket = 0;
+	us >>= FRAME_TIMING_BUCKET_SHIFT;
+	while (us && bucket < FRAME_TIMING_BUCKETS - 1) {
+		us >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+void frame_timing_add(frame_timing_id_t id, uint32_t us, uint32_t cycles) {
+	if ((unsigned int)id >= FRAME_TIMING_COUNT) return;
+	frame_timing_stat_t *stat = &frameTimingStats[id];
+	stat->count++;
+	if (us > stat->maxUs) stat->maxUs = us;
+	stat->totalUs += us;
+	stat->totalCycles += cycles;
+	stat->histogram[frame_timing_bucket(us)]++;
+}
+
+void frame_timing_handler_begin(void) {
+	frameTimingHandlerFlushes = frameTimingStats[FRAME_TIMING_FLUSH].count;
+	frameTimingHandlerStart = frame_timing_mark();
+}
+
+void frame_timing_handler_end(void) {
+	if (frameTimingStats[FRAME_TIMING_FLUSH].count != frameTimingHandlerFlushes) {
+		frame_timing_record(FRAME_TIMING_RENDER, frameTimingHandlerStart);
+	} else {
+		frameTimingIdle++;
+	}
+}
+
+const frame_timing_stat_t *frame_timing_stat(frame_timing_id_t id) {
+	if ((unsigned int)id >= FRAME_TIMING_COUNT) return NULL;
+	return &frameTimingStats[id];
+}
+
+uint32_t frame_timing_idle_count(void) {
+	return frameTimingIdle;
+}
+
+const char *frame_timing_name(frame_timing_id_t id) {
+	if ((unsigned int)id >= FRAME_TIMING_COUNT) return "?";
+	return frameTimingNames[id];
+}
+
+size_t frame_timing_format(frame_timing_id_t id, char *buffer, size_t size) {
+	const frame_timing_stat_t *stat = frame_timing_stat(id);
+	if (stat == NULL || size == 0) return 0;
+	unsigned long mean = stat->count ? (unsigned long)(stat->totalUs / stat->count) : 0;
+	unsigned int cpu = stat->totalUs ? (unsigned int)((stat->totalCycles / FRAME_TIMING_CPU_MHZ) * 100 / stat->totalUs) : 0;
+	if (cpu > 100) cpu = 100;
+	int len = snprintf(buffer, size, "ZF:%s %lu %lu %lu %u ", frame_timing_name(id), (unsigned long)stat->count, mean, (unsigned long)stat->maxUs, cpu);
+	for (int i = 0; i < FRAME_TIMING_BUCKETS && len >= 0 && (size_t)len < size; i++) {
+		len += snprintf(buffer + len, size - len, "%lu%s", (unsigned long)stat->histogram[i], (i < FRAME_TIMING_BUCKETS - 1) ? "/" : "\r\n");
+	}
+	if (len < 0) { buffer[0] = '\0'; return 0; }
+	return ((size_t)len < size) ? (size_t)len : size - 1;
+}
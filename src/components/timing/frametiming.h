@@ -0,0 +1,70 @@
+// Display frame timing: histograms of LVGL rendering, display flush, LCD DrawBuffer and SPI transfer durations.
+// On the device, intervals are timed with the DWT cycle counter and the RTC (the cycle counter stops while the CPU
+// sleeps); the host build uses the system clock, or modelled durations can be added directly for simulations.
+
+#ifndef FRAMETIMING_H
+#define FRAMETIMING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FRAME_TIMING_CPU_MHZ 64
+#define FRAME_TIMING_RTC_HZ 1024			// RTC1 is prescaled to the FreeRTOS tick rate (configTICK_RATE_HZ)
+#define FRAME_TIMING_RTC_MASK 0xffffff		// 24-bit RTC counter
+#define FRAME_TIMING_RTC_MIN_TICKS 2		// Shorter intervals (< ~2 ms) are timed from the cycle counter instead
+
+// Log2 histogram of microseconds: bucket 0 is < 32 us, bucket n is < 32 << n us, the last bucket is everything longer
+#define FRAME_TIMING_BUCKET_SHIFT 5
+#define FRAME_TIMING_BUCKETS 14				// ... 32 ms, 64 ms, 128 ms, >= 128 ms
+
+typedef enum {
+	FRAME_TIMING_RENDER,		// lv_task_handler() calls that flushed anything (refreshing the screen)
+	FRAME_TIMING_FLUSH,			// LittleVgl::FlushDisplay()
+	FRAME_TIMING_DRAW_BUFFER,	// St7789::DrawBuffer() (address window and starting the transfer)
+	FRAME_TIMING_SPI_TRANSFER,	// SpiMaster::Write() multi-byte transfers to the display, start to end-of-transfer interrupt
+	FRAME_TIMING_LOAD_APP,		// DisplayApp::LoadApp() (screen construction)
+	FRAME_TIMING_COUNT,
+} frame_timing_id_t;
+
+typedef struct {
+	uint32_t cycles;
+	uint32_t ticks;
+} frame_timing_mark_t;
+
+typedef struct {
+	uint32_t count;
+	uint32_t maxUs;
+	uint64_t totalUs;
+	uint64_t totalCycles;					// CPU cycles while awake (all tasks and interrupts) over the intervals
+	uint32_t histogram[FRAME_TIMING_BUCKETS];
+} frame_timing_stat_t;
+
+void frame_timing_init(void);
+void frame_timing_reset(void);
+
+frame_timing_mark_t frame_timing_mark(void);
+void frame_timing_record(frame_timing_id_t id, frame_timing_mark_t start);
+void frame_timing_add(frame_timing_id_t id, uint32_t us, uint32_t cycles);
+
+// Around lv_task_handler(): only calls that flushed are recorded as renders, the others are counted as idle
+void frame_timing_handler_begin(void);
+void frame_timing_handler_end(void);
+
+const frame_timing_stat_t *frame_timing_stat(frame_timing_id_t id);
+uint32_t frame_timing_idle_count(void);
+const char *frame_timing_name(frame_timing_id_t id);
+int frame_timing_bucket(uint32_t us);
+
+// One line: "ZF:<name> <count> <mean us> <max us> <cpu %> <bucket 0>/<bucket 1>/.../<bucket 13>\r\n"
+#define FRAME_TIMING_LINE_MAX 160
+size_t frame_timing_format(frame_timing_id_t id, char *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
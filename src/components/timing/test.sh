@@ -0,0 +1 @@
+gcc -c frametiming.c -o frametiming.o && g++ FrameTimingTest.cpp frametiming.o -o ./frametimingtest && ./frametimingtest "$@"
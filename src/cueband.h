@@ -47,8 +47,10 @@
 #define CUEBAND_TRUSTED_CONNECTION      // Determine if a connection is trusted (required)
 #define CUEBAND_USE_TRUSTED_CONNECTION  // Default switch for specific services to require trusted connections
 
-// Global scratch buffer (only safe if use is not overlapped) to save some RAM (an not require dynamic allocation)
-#define CUEBAND_GLOBAL_SCRATCH_BUFFER 256
+// Static scratch arena from which services lease transfer buffers (UART/activity block reads, DFU packets, info app text),
+// rather than allocating them from the heap, with checks for overlapping use (UART 'zm' command). See: components/scratch/scratch.h
+#define CUEBAND_SCRATCH_ARENA
+//#define CUEBAND_GLOBAL_SCRATCH_BUFFER 256       // (previously) Global scratch buffer (only safe if use is not overlapped) to save some RAM (an not require dynamic allocation)
 #ifdef CUEBAND_GLOBAL_SCRATCH_BUFFER
 extern unsigned char cuebandGlobalScratchBuffer[CUEBAND_GLOBAL_SCRATCH_BUFFER] __attribute__((aligned(8)));
 #endif
@@ -85,7 +87,7 @@ extern unsigned char cuebandGlobalScratchBuffer[CUEBAND_GLOBAL_SCRATCH_BUFFER] _
     #define CUEBAND_INFO_APP_BARCODE
     #define CUEBAND_INFO_APP_QR
     #define QR_IMAGE_INVERT     // More recent specs of QR Codes allow light-on dark -- also saves memory as the quiet zone is skipped as the image is displayed on a dark background
-    #define QR_TRUE_COLOR       // Can only transform (zoom) a true color image rather than 1bpp image, but a scale of x4 is (4*4=)x16 the number of pixels, and at LV_COLOR_DEPTH==16 takes the same amount of memory
+    #define CUEBAND_INFO_APP_QR_URL "HTTPS://CUE.BAND/D/"    // Provisioning URL prefix for the QR Code (followed by the address and device key; alphanumeric-mode characters only)
 #endif
 
 #define CUEBAND_METRONOME_ENABLED
@@ -97,11 +99,24 @@ extern unsigned char cuebandGlobalScratchBuffer[CUEBAND_GLOBAL_SCRATCH_BUFFER] _
 #define CUEBAND_HR_EPOCH
 #define CUEBAND_HR_SAMPLING_SHORT_DELAY     // Always use a short delay while sampling
 #define CUEBAND_DEBUG_PREVIOUS_BPM 5        // Store recent entries for debugging
+#define CUEBAND_HR_STABLE_TOLERANCE 3       // Consecutive BPM updates within this many bpm count towards a stable reading (logged as the micro-epoch HR confidence)
+//#define CUEBAND_HR_EPOCH_ADAPTIVE         // End each HR sampling window early once the reading is stable, and extend it (up to a cap) while moving
+#ifdef CUEBAND_HR_EPOCH_ADAPTIVE
+    #define CUEBAND_HR_ADAPTIVE_STABLE 4        // Consecutive stable BPM updates to end the sampling window
+    #define CUEBAND_HR_ADAPTIVE_EXTEND 30       // Maximum extension of the sampling window while moving (seconds)
+    #define CUEBAND_HR_ADAPTIVE_MOTION 205      // Mean abs(SVM-1) above which the window is extended (1g=4096, so ~0.05g)
+#endif
+//#define CUEBAND_PPG_FIXED_FFT             // Heart rate spectrum from a fixed-point real FFT rather than float arduinoFFT (saves 256 bytes RAM in the HR task and the float FFT code)
+//#define CUEBAND_PPG_SLIDING_DFT           // Heart rate spectrum from a per-sample sliding DFT of only the heart rate bins, rather than a full FFT every update
+#if defined(CUEBAND_PPG_FIXED_FFT) || defined(CUEBAND_PPG_SLIDING_DFT)
+    #define CUEBAND_PPG_FIXED_POINT
+#endif
 
 // Cue prompts
 #ifndef CUEBAND_HR_LOGGER
     #define CUEBAND_CUE_ENABLED
 #endif
+#define CUEBAND_CUE_JOURNAL 32      // Append small state changes (options/impromptu) to a journal, compacting to the full cue file after this many records
 
 #define CUEBAND_DEFAULT_SCREEN_TIMEOUT 30000    // 15000 // Ideally matching one of the options in SettingDisplay.cpp
 
@@ -121,6 +136,8 @@ extern unsigned char cuebandGlobalScratchBuffer[CUEBAND_GLOBAL_SCRATCH_BUFFER] _
 //#define CUEBAND_DETECT_WEAR_TIME (10 * 60)  // (when activity is enabled) detect the watch is unlikely to be worn after 10 minutes of no movement on at least two of the axes
 #define CUEBAND_NO_SCHEDULED_PROMPTS_WHEN_UNSET_TIME    // When time is unset, do not use scheduled prompts (but do use impromptu ones)
 #define CUEBAND_SILENT_WHEN_UNWORN          // Do not prompt when unworn
+//#define CUEBAND_DETECT_SLEEP 40             // (when activity is enabled) classify each epoch as sleep/wake (sleep when the weighted recent mean filtered abs(SVM-1) is below 40/4096 g, ~10 mg)
+//#define CUEBAND_SILENT_WHEN_ASLEEP          // Do not prompt when the wearer is classified as asleep
 
 #define CUEBAND_UPTIME_1024                 // Track system uptime in units of 1024
 #define CUEBAND_TRACK_MOTOR_TIMES (35*1024/10)  // Determine when the motor was active until (e.g. so that any affected accelerometer samples can be ignored), this is the settle time (+ jitter, etc) to add in milliseconds
@@ -129,6 +146,15 @@ extern unsigned char cuebandGlobalScratchBuffer[CUEBAND_GLOBAL_SCRATCH_BUFFER] _
 #define CUEBAND_SYMBOLS
 
 #define CUEBAND_APP_RELOAD_SCREENS            // Cueband app reloads for each screen (so that the transitions work correctly)
+#define CUEBAND_REDRAW_ON_CHANGE              // Controllers count changes to displayed state, so screens only redraw the labels whose value has changed
+//#define CUEBAND_ASYNC_DISPLAY_FLUSH           // (not tested) LVGL flush returns once the SPI transfer has started, and the buffer is released from the end-of-transfer interrupt
+//#define CUEBAND_DEBUG_FRAME_TIMING          // Histograms of render, flush, DrawBuffer, SPI transfer and app load times (UART 'zf' command, 'zF' to also reset)
+#define CUEBAND_TASK_PROFILE                  // Per-task CPU use (FreeRTOS run-time stats, counted at the 1024 Hz tick), stack and heap low-water marks (UART 'zp' command)
+#define CUEBAND_TASK_PROFILE_INTERVAL 60      // Profile sample interval (seconds)
+//#define CUEBAND_TASK_PROFILE_RECORD         // (Untested on device) Also write a daily task profile record block into the activity log (format CUEBAND_FORMAT_RECORD_TASK_PROFILE)
+#define CUEBAND_ENERGY_ACCOUNTING             // Estimated charge per subsystem (motor on-ms, screen-on, HR sensor and BLE connected seconds, notifications, accelerometer reads) per epoch, from a calibration table (UART 'ze' command)
+#define CUEBAND_ENERGY_EPOCH 60               // Energy accounting epoch (seconds, as the activity epoch)
+#define CUEBAND_ENERGY_RECORD                 // Also write a daily energy summary record block into the activity log (format CUEBAND_FORMAT_RECORD_ENERGY; tools/activity_decode.py --records)
 #define CUEBAND_MANUAL_PROMPT_MUTE_STOP       // When manually prompting, mute button stops on first press, rather than enter mute screen
 
 #define CUEBAND_MOTOR_PATTERNS  // Allow vibration motor patterns
@@ -141,6 +167,9 @@ extern unsigned char cuebandGlobalScratchBuffer[CUEBAND_GLOBAL_SCRATCH_BUFFER] _
 #define CUEBAND_LONGER_PRESS_INFO
 
 #define CUEBAND_FIX_DFU_LARGE_PACKETS                   // Could do with more testing (but uses original code for smaller MTU anyway)
+#define CUEBAND_DFU_STREAMING_CRC                       // Update the image CRC as each DFU packet is received, rather than reading the whole image back from flash to validate it
+//#define CUEBAND_DFU_VERIFY_READBACK                   // (with streaming CRC) Also read the image back from flash after the transfer to check the CRC of what was written
+#define CUEBAND_DFU_PAGE_WRITES                         // Program the DFU image in whole, aligned flash pages, erasing each sector just ahead of the writes (rather than all before the transfer)
 
 // Local build configuration overrides above switches
 #if defined(__has_include)
@@ -274,10 +303,17 @@ extern unsigned char cuebandGlobalScratchBuffer[CUEBAND_GLOBAL_SCRATCH_BUFFER] _
         // FIFO settings
         #define CUEBAND_FIFO_POLL_RATE 10        // 10 Hz -- Read FIFO approximately this rate (plus jitter) -- TODO: Consider using watermark interrupt instead
 
+        //#define CUEBAND_FIFO_WATERMARK 25        // While asleep, drain the FIFO on its watermark interrupt (samples: 0.5 s at 50 Hz) rather than polling at CUEBAND_FIFO_POLL_RATE
+        #ifdef CUEBAND_FIFO_WATERMARK
+            #define CUEBAND_FIFO_WATERMARK_TIMEOUT 1000   // Fallback drain interval (ms) in case an interrupt is missed
+        #endif
+
         #define CUEBAND_SAMPLE_MAX 32  // (120 * CUEBAND_BUFFER_SAMPLE_RATE / CUEBAND_FIFO_POLL_RATE / 100) // 60 samples (allow 20% margin on rate)
 
         #define CUEBAND_FIFO_BUFFER_LENGTH (CUEBAND_SAMPLE_MAX * 6)   // FIFO: 360 bytes (up to 1024)
 
+        #define CUEBAND_FIFO_DIRECT_DECODE      // Decode FIFO frames in one pass straight into the sample buffer (rather than via bma4_extract_accel() chunks)
+
         #define CUEBAND_BUFFER_EFFECTIVE_RATE CUEBAND_BUFFER_SAMPLE_RATE
     #else
         // If not using FIFO, fall back to (rubbish) polled sampling
@@ -326,6 +362,10 @@ extern unsigned char cuebandGlobalScratchBuffer[CUEBAND_GLOBAL_SCRATCH_BUFFER] _
 
 #endif
 
+#define CUEBAND_FS_CACHE_SIZE 128           // littlefs read/program cache size (default 16): larger caches mean fewer, larger SPI transfers (see components/fs/LfsConfigTest.cpp), but each open file also takes this from the heap
+//#define CUEBAND_FS_LOOKAHEAD_SIZE 16        // littlefs lookahead bitmap (bytes, 8 blocks each, default 16)
+//#define CUEBAND_SPI_FLASH_FAST_READ         // Read the external flash with Fast Read (0x0B, one dummy byte): only faster above the nRF52832's 8 MHz SPI clock limit, where Read (0x03) is already within spec
+
 #if defined(CUEBAND_ACTIVITY_ENABLED)
     #define CUEBAND_FS_FILESIZE_ENABLED
     #define CUEBAND_FS_FILETELL_ENABLED
@@ -338,7 +378,9 @@ extern unsigned char cuebandGlobalScratchBuffer[CUEBAND_GLOBAL_SCRATCH_BUFFER] _
 
 //#define CUEBAND_NO_ADV_RSP              // Optional test: do not split name into advertising response (name truncated, no UUID advertised)
 
-#define CUEBAND_DELAY_START 50          // Delay cue.band service initialization (main loop iterations) -- 50 from start = approx. 3-5 seconds.
+#define CUEBAND_DELAY_START 5000        // Delay cue.band service initialization, without CUEBAND_BOOT_STAGES (ms from the start of the system task loop)
+#define CUEBAND_BOOT_STAGES             // Start cue.band services (cue schedule, activity log) in dependency order as soon as each is ready, one per loop iteration; 'zb' reports the times from main() to the scheduler, advertising and logging
+#define CUEBAND_JOB_SCHEDULER           // System task loop blocks until its next job is due (motion, time/1 Hz events, BLE discovery, delayed start), each at its own cadence, rather than waking every 100 ticks to run them all
 
 #ifdef CUEBAND_HR_LOGGER
     // Logging (8 days)
@@ -350,6 +392,11 @@ extern unsigned char cuebandGlobalScratchBuffer[CUEBAND_GLOBAL_SCRATCH_BUFFER] _
     #define CUEBAND_ACTIVITY_FILES 4            // 3-4 files gives 30-40 days
 #endif
 
+//#define CUEBAND_ACTIVITY_RAW_LOG            // (Untested on device) Store activity blocks in a raw circular log at the top of the external flash, rather than littlefs files (the file system is reduced, so is reformatted)
+#ifdef CUEBAND_ACTIVITY_RAW_LOG
+    #define CUEBAND_ACTIVITY_RAW_LOG_SECTORS ((CUEBAND_ACTIVITY_FILES * CUEBAND_ACTIVITY_MAXIMUM_BLOCKS) / 16 + 1)    // Same capacity as the files (16 blocks per 4 kB sector), plus the sector being reused
+#endif
+
 #ifdef CUEBAND_ACTIVITY_EPOCH_INTERVAL
     #ifdef CUEBAND_CONFIGURATION_WARNINGS
         #warning "This build has a non-default CUEBAND_ACTIVITY_EPOCH_INTERVAL and must not be used for a release"
@@ -380,7 +427,7 @@ extern unsigned char cuebandGlobalScratchBuffer[CUEBAND_GLOBAL_SCRATCH_BUFFER] _
     #endif
 #else
     #ifdef CUEBAND_HR_LOGGER
-        #define CUEBAND_FORMAT_VERSION CUEBAND_FORMAT_VERSION_MICRO_EPOCHS_0080
+        #define CUEBAND_FORMAT_VERSION CUEBAND_FORMAT_VERSION_MICRO_EPOCHS_STATS_0081
     #else
         #define CUEBAND_FORMAT_VERSION CUEBAND_FORMAT_VERSION_ORIGINAL_ACTIVITY_0002
     #endif
@@ -399,6 +446,7 @@ extern unsigned char cuebandGlobalScratchBuffer[CUEBAND_GLOBAL_SCRATCH_BUFFER] _
 #define CUEBAND_FORMAT_VERSION_ORIGINAL_ACTIVITY_0002 0x0002
 #define CUEBAND_FORMAT_VERSION_HR_RANGE_0003 0x0003
 #define CUEBAND_FORMAT_VERSION_MICRO_EPOCHS_0080 0x0080
+#define CUEBAND_FORMAT_VERSION_MICRO_EPOCHS_STATS_0081 0x0081
 #ifdef CUEBAND_HR_LOGGER
     #define CUEBAND_FORMAT_VERSION_MIN 0x0080
 #else
@@ -406,10 +454,19 @@ extern unsigned char cuebandGlobalScratchBuffer[CUEBAND_GLOBAL_SCRATCH_BUFFER] _
 #endif
 #define CUEBAND_FORMAT_VERSION_MAX 0xfffe   // unused
 
+// Record blocks, interleaved with the activity blocks (at a block boundary): header @20 is the record length in bytes, @22-@25 are 0xff
+#define CUEBAND_FORMAT_RECORD_TASK_PROFILE 0xf001   // components/profile/taskprofile.h
+#define CUEBAND_FORMAT_RECORD_ENERGY 0xf002         // components/energy/energyaccount.h
+#if defined(CUEBAND_TASK_PROFILE_RECORD) || defined(CUEBAND_ENERGY_RECORD)
+    #define CUEBAND_ACTIVITY_RECORDS
+#endif
+
 // 0x0000=30 Hz data, no high-pass filter, no SVMMO
 // 0x0001=30 Hz data, no high-pass filter, SVMMO present
 // 0x0002=40 Hz data, SVMMO, high-pass SVMMO
 // 0x0003=40 Hz, SVMMO, HR range
+// 0x0080=50 Hz, micro-epochs
+// 0x0081=50 Hz, micro-epochs, per-axis mean/SD/mean-abs epoch summary
 
 #define CUEBAND_TX_COUNT 26    // Queue multiple notifications at once (hopefully to send more than one per connection interval)
 //#define CUEBAND_DEBUG_DUMMY_MISSING_BLOCKS
@@ -452,6 +509,12 @@ void cblog(const char *str);
 #if defined(CUEBAND_STREAM_ENABLED) && !defined(CUEBAND_SERVICE_UART_ENABLED)
     #error "CUEBAND_STREAM_ENABLED requires CUEBAND_SERVICE_UART_ENABLED"
 #endif
+#if defined(CUEBAND_PPG_FIXED_FFT) && defined(CUEBAND_PPG_SLIDING_DFT)
+    #error "At most one of CUEBAND_PPG_FIXED_FFT / CUEBAND_PPG_SLIDING_DFT may be defined"
+#endif
+#if defined(CUEBAND_FIFO_WATERMARK) && (CUEBAND_FIFO_WATERMARK > CUEBAND_SAMPLE_MAX)
+    #error "CUEBAND_FIFO_WATERMARK must not exceed CUEBAND_SAMPLE_MAX"
+#endif
 #if defined(CUEBAND_POLLED_ENABLED) && defined(CUEBAND_FIFO_ENABLED)
     #error "At most one of CUEBAND_POLLED_ENABLED / CUEBAND_FIFO_ENABLED may be defined"
 #endif
@@ -461,6 +524,21 @@ void cblog(const char *str);
 #if defined(CUEBAND_NO_SCHEDULED_PROMPTS_WHEN_UNSET_TIME) && !defined(CUEBAND_DETECT_UNSET_TIME)
     #error "CUEBAND_NO_SCHEDULED_PROMPTS_WHEN_UNSET_TIME requires CUEBAND_DETECT_UNSET_TIME"
 #endif
+#if defined(CUEBAND_SILENT_WHEN_ASLEEP) && !defined(CUEBAND_DETECT_SLEEP)
+    #error "CUEBAND_SILENT_WHEN_ASLEEP requires CUEBAND_DETECT_SLEEP"
+#endif
+#if defined(CUEBAND_DEBUG_FRAME_TIMING) && defined(PINETIME_IS_RECOVERY_LOADER)
+    #undef CUEBAND_DEBUG_FRAME_TIMING   // Nothing initializes or reports it in the recovery loader
+#endif
+#if defined(CUEBAND_TASK_PROFILE) && defined(PINETIME_IS_RECOVERY_LOADER)
+    #undef CUEBAND_TASK_PROFILE         // (no run-time stats in the recovery loader)
+#endif
+#if defined(CUEBAND_TASK_PROFILE_RECORD) && (!defined(CUEBAND_TASK_PROFILE) || !defined(CUEBAND_ACTIVITY_ENABLED))
+    #error "CUEBAND_TASK_PROFILE_RECORD requires CUEBAND_TASK_PROFILE and CUEBAND_ACTIVITY_ENABLED"
+#endif
+#if defined(CUEBAND_ENERGY_RECORD) && (!defined(CUEBAND_ENERGY_ACCOUNTING) || !defined(CUEBAND_ACTIVITY_ENABLED))
+    #error "CUEBAND_ENERGY_RECORD requires CUEBAND_ENERGY_ACCOUNTING and CUEBAND_ACTIVITY_ENABLED"
+#endif
 
 // Debug CUEBAND_TRACK_MOTOR_TIMES
 #ifdef CUEBAND_DEBUG_TRACK_MOTOR_TIMES
@@ -44,6 +44,9 @@
 #ifdef CUEBAND_OPTIONS_APP_ENABLED
 #include "displayapp/screens/settings/SettingCueBandOptions.h"
 #endif
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+#include "components/timing/frametiming.h"
+#endif
 
 #include "drivers/Cst816s.h"
 #include "drivers/St7789.h"
@@ -142,6 +145,9 @@ void DisplayApp::Start(System::BootErrors error) {
 void DisplayApp::Process(void* instance) {
   auto* app = static_cast<DisplayApp*>(instance);
   NRF_LOG_INFO("displayapp task started!");
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+  frame_timing_init();
+#endif
   app->InitHw();
 
   // Send a dummy notification to unlock the lvgl display driver for the first iteration
@@ -172,7 +178,13 @@ void DisplayApp::Refresh() {
       if (!currentScreen->IsRunning()) {
         LoadPreviousScreen();
       }
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+      frame_timing_handler_begin();
+      queueTimeout = lv_task_handler();
+      frame_timing_handler_end();
+#else
       queueTimeout = lv_task_handler();
+#endif
       break;
     default:
       queueTimeout = portMAX_DELAY;
@@ -362,6 +374,9 @@ void DisplayApp::ReturnApp(Apps app, DisplayApp::FullRefreshDirections direction
 }
 
 void DisplayApp::LoadApp(Apps app, DisplayApp::FullRefreshDirections direction) {
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+  frame_timing_mark_t loadStart = frame_timing_mark();
+#endif
   touchHandler.CancelTap();
   currentScreen.reset(nullptr);
   SetFullRefresh(direction);
@@ -629,6 +644,9 @@ case Apps::Weather: break;
 #ifdef CUEBAND_CUE_ENABLED
   systemTask->ReportAppActivated(currentApp);
 #endif
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+  frame_timing_record(FRAME_TIMING_LOAD_APP, loadStart);
+#endif
 }
 
 void DisplayApp::PushMessage(Messages msg) {
@@ -92,20 +92,24 @@ void DisplayApp::Refresh() {
 
 void DisplayApp::DisplayLogo(uint16_t color) {
   Pinetime::Tools::RleDecoder rleDecoder(infinitime_nb, sizeof(infinitime_nb), color, colorBlack);
-  for (int i = 0; i < displayWidth; i++) {
-    rleDecoder.DecodeNext(displayBuffer, displayWidth * bytesPerPixel);
+  int buffer = 0;
+  for (int i = 0; i < displayHeight;) {
+    size_t lines = rleDecoder.DecodeLines(displayBuffer[buffer], displayWidth, logoLinesPerDraw);
+    if (lines == 0) break;
     ulTaskNotifyTake(pdTRUE, 500);
-    lcd.DrawBuffer(0, i, displayWidth, 1, reinterpret_cast<const uint8_t*>(displayBuffer), displayWidth * bytesPerPixel);
+    lcd.DrawBuffer(0, i, displayWidth, lines, reinterpret_cast<const uint8_t*>(displayBuffer[buffer]), displayWidth * lines * bytesPerPixel);
+    i += lines;
+    buffer ^= 1;
   }
 }
 
 void DisplayApp::DisplayOtaProgress(uint8_t percent, uint16_t color) {
   const uint8_t barHeight = 20;
-  std::fill(displayBuffer, displayBuffer + (displayWidth * bytesPerPixel), color);
+  std::fill(displayBuffer[0], displayBuffer[0] + (displayWidth * bytesPerPixel), color);
   for (int i = 0; i < barHeight; i++) {
     ulTaskNotifyTake(pdTRUE, 500);
     uint16_t barWidth = std::min(static_cast<float>(percent) * 2.4f, static_cast<float>(displayWidth));
-    lcd.DrawBuffer(0, displayWidth - barHeight + i, barWidth, 1, reinterpret_cast<const uint8_t*>(displayBuffer), barWidth * bytesPerPixel);
+    lcd.DrawBuffer(0, displayWidth - barHeight + i, barWidth, 1, reinterpret_cast<const uint8_t*>(displayBuffer[0]), barWidth * bytesPerPixel);
   }
 }
 
@@ -91,7 +91,8 @@ namespace Pinetime {
       static constexpr uint16_t colorRed = 0xff00;
       static constexpr uint16_t colorRedSwapped = 0x00ff;
       static constexpr uint16_t colorBlack = 0x0000;
-      uint8_t displayBuffer[displayWidth * bytesPerPixel];
+      static constexpr uint8_t logoLinesPerDraw = 8;
+      uint8_t displayBuffer[2][displayWidth * logoLinesPerDraw * bytesPerPixel] __attribute__((aligned(4)));  // Decoded into one while the other is sent
     };
   }
 }
@@ -0,0 +1,184 @@
+// Host model of the LVGL display flush over a simulated SPI bus.
+// Replays a full-screen transition (LVGL rendering 240 lines in bands into two alternating buffers, each flushed with
+// LittleVgl::FlushDisplay() mapping through writeOffset) and reports the frame time for each flush strategy:
+//
+//   sync   - flush waits for the pixel data transfer to end before lv_disp_flush_ready() (no overlap)
+//   notify - (previous) transfer left running, flush_ready straight away, next flush takes the task notification first
+//   async  - (CUEBAND_ASYNC_DISPLAY_FLUSH) flush_ready from the end-of-transfer interrupt, LVGL waits in wait_cb
+//
+// It also checks that no buffer is rendered into while it is being transferred, and that the DataCommand pin does not
+// change during a transfer -- including with a stray task notification (e.g. the initial dummy one, or another driver).
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#define HOR_RES 240
+#define VISIBLE_LINES 240           // LittleVgl::visibleNbLines
+#define TOTAL_LINES 320             // LittleVgl::totalNbLines
+#define BUFFER_PIXELS (HOR_RES * 4) // LV_HOR_RES_MAX * 4
+
+// Simulated bus and CPU costs (microseconds)
+#define SPI_BYTE_US (8.0 / 8.0)     // 8 MHz
+#define SINGLE_WRITE_US 4.0         // Blocking single byte write: mutex, FTPAN-58 workaround setup, poll (plus the byte)
+#define CHUNK_ISR_US 2.0            // SpiMaster::OnEndEvent() per 255-byte DMA chunk
+#define NOTIFY_WAKE_US 10.0         // Task wake-up after the end-of-transfer notification
+#define FLUSH_CPU_US 5.0            // FlushDisplay() arithmetic and calls
+
+enum strategy_t { STRATEGY_SYNC, STRATEGY_NOTIFY, STRATEGY_ASYNC };
+static const char *strategyNames[] = { "sync", "notify", "async" };
+
+typedef struct {
+    double now;                     // CPU (display task) time
+    double busFreeAt;               // End of the transfer in progress
+    double bufferFreeAt[2];         // End of the last transfer from each buffer
+    double dataEndAt;               // End of the last pixel data transfer (DataCommand pin must not change before)
+    double lastReadyAt;             // Time the previous flush was reported ready to LVGL
+    double notifyAt[64];            // Times notifications become pending (ring of future ones)
+    int notifyCount;
+    unsigned int transfers;
+    unsigned int violations;
+} sim_t;
+
+static void notifyLater(sim_t *sim, double at) {
+    if (sim->notifyCount < (int)(sizeof(sim->notifyAt) / sizeof(sim->notifyAt[0]))) sim->notifyAt[sim->notifyCount++] = at;
+}
+
+// ulTaskNotifyTake(pdTRUE, timeout): returns at the earliest pending notification (or the timeout), clearing the count
+static void notifyTake(sim_t *sim, double timeoutUs) {
+    double earliest = sim->now + timeoutUs;
+    for (int i = 0; i < sim->notifyCount; i++) {
+        if (sim->notifyAt[i] < earliest) earliest = sim->notifyAt[i];
+    }
+    if (earliest > sim->now) sim->now = earliest + NOTIFY_WAKE_US;
+    // Clear everything pending by then
+    int kept = 0;
+    for (int i = 0; i < sim->notifyCount; i++) {
+        if (sim->notifyAt[i] > sim->now) sim->notifyAt[kept++] = sim->notifyAt[i];
+    }
+    sim->notifyCount = kept;
+}
+
+// St7789::WriteCommand()/WriteData(): a blocking single byte write
+static void singleWrite(sim_t *sim, bool command, bool waitForData) {
+    if (command && waitForData && sim->now < sim->dataEndAt) {
+        sim->now = sim->dataEndAt;      // St7789::WaitDataTransfer() (only with the async driver change)
+    }
+    if (sim->now < sim->dataEndAt) sim->violations++;   // DataCommand pin changed during pixel data
+    if (sim->now < sim->busFreeAt) sim->now = sim->busFreeAt;   // Bus mutex
+    sim->now += SINGLE_WRITE_US + SPI_BYTE_US;
+}
+
+// St7789::DrawBuffer(): address window then a DMA transfer that continues after the call returns; returns its end time
+static double drawBuffer(sim_t *sim, int buffer, unsigned int rows, unsigned int width, bool waitForData) {
+    for (int i = 0; i < 3; i++) {
+        singleWrite(sim, true, waitForData);                // Column, row address set; write to RAM
+        if (i < 2) for (int j = 0; j < 4; j++) singleWrite(sim, false, waitForData);
+    }
+    if (sim->now < sim->busFreeAt) sim->now = sim->busFreeAt;
+    unsigned int bytes = rows * width * 2;
+    double end = sim->now + bytes * SPI_BYTE_US + ((bytes + 254) / 255) * CHUNK_ISR_US;
+    sim->busFreeAt = end;
+    sim->dataEndAt = end;
+    if (sim->bufferFreeAt[buffer] < end) sim->bufferFreeAt[buffer] = end;
+    notifyLater(sim, end);              // vTaskNotifyGiveFromISR() at the end of each transfer
+    sim->transfers++;
+    return end;
+}
+
+// LittleVgl::FlushDisplay() for one band (area y1..y2 in screen lines) under the given strategy
+static void flush(sim_t *sim, strategy_t strategy, int buffer, unsigned int areaY1, unsigned int areaY2, unsigned int writeOffset) {
+    if (strategy == STRATEGY_NOTIFY) notifyTake(sim, 200000);
+    sim->now += FLUSH_CPU_US;
+
+    bool waitForData = (strategy == STRATEGY_ASYNC);
+    unsigned int y1 = (areaY1 + writeOffset) % TOTAL_LINES;
+    unsigned int y2 = (areaY2 + writeOffset) % TOTAL_LINES;
+    double end;
+    if (y2 < y1) {
+        drawBuffer(sim, buffer, TOTAL_LINES - y1, HOR_RES, waitForData);
+        if (strategy != STRATEGY_ASYNC) notifyTake(sim, 100000);
+        end = drawBuffer(sim, buffer, y2 + 1, HOR_RES, waitForData);
+    } else {
+        end = drawBuffer(sim, buffer, areaY2 - areaY1 + 1, HOR_RES, waitForData);
+    }
+
+    if (strategy == STRATEGY_SYNC) {
+        notifyTake(sim, 200000);
+        sim->lastReadyAt = sim->now;
+    } else if (strategy == STRATEGY_NOTIFY) {
+        sim->lastReadyAt = sim->now;    // lv_disp_flush_ready() straight away
+    } else {
+        sim->lastReadyAt = end;         // lv_disp_flush_ready() from the interrupt
+    }
+}
+
+// A full-screen transition: LVGL renders each band into alternating buffers, waiting (wait_cb) for the previous flush
+static double transition(strategy_t strategy, double renderUsPerPixel, unsigned int writeOffset, int strayAtBand, unsigned int *violations) {
+    sim_t sim;
+    memset(&sim, 0, sizeof(sim));
+    // The dummy notification from DisplayApp::Process() (consumed by the first flush in the notify strategy)
+    if (strategy == STRATEGY_NOTIFY) notifyLater(&sim, 0);
+
+    unsigned int rows = BUFFER_PIXELS / HOR_RES;
+    int band = 0;
+    for (unsigned int y = 0; y < VISIBLE_LINES; y += rows, band++) {
+        int buffer = band & 1;
+        // Render into this buffer -- it must not still be transferring
+        if (sim.now < sim.bufferFreeAt[buffer]) sim.violations++;
+        sim.now += renderUsPerPixel * rows * HOR_RES;
+
+        // lv_refr_vdb_flush(): in double buffered mode, wait until the previous flush is ready
+        if (strategy == STRATEGY_ASYNC) {
+            while (sim.now < sim.lastReadyAt) notifyTake(&sim, 200000);
+        } else if (sim.now < sim.lastReadyAt) {
+            sim.now = sim.lastReadyAt;
+        }
+
+        if (band == strayAtBand) notifyLater(&sim, sim.now);    // An unrelated notification to the display task
+        unsigned int y2 = y + rows - 1;
+        if (y2 >= VISIBLE_LINES) y2 = VISIBLE_LINES - 1;
+        flush(&sim, strategy, buffer, y, y2, writeOffset);
+    }
+    // Frame is on the panel once the last transfer ends
+    double frame = (sim.busFreeAt > sim.now) ? sim.busFreeAt : sim.now;
+    *violations = sim.violations;
+    return frame;
+}
+
+int main(int argc, char *argv[]) {
+    int failures = 0;
+    const double renderCosts[] = { 0.05, 0.25, 0.5, 1.0 };      // us per pixel (fills ... images/anti-aliased text)
+    // writeOffset after successive scrolls ((writeOffset + visibleNbLines) % totalNbLines), including one that wraps mid-band
+    const unsigned int offsets[] = { 0, 240, 162 };
+
+    printf("Full-screen transition frame time (ms), %u-line bands, %.0f MHz SPI\n", BUFFER_PIXELS / HOR_RES, 8.0 / SPI_BYTE_US);
+    printf("render us/px  offset      sync    notify     async\n");
+    for (unsigned int o = 0; o < sizeof(offsets) / sizeof(offsets[0]); o++) {
+        for (unsigned int r = 0; r < sizeof(renderCosts) / sizeof(renderCosts[0]); r++) {
+            double frame[3];
+            printf("%12.2f  %6u", renderCosts[r], offsets[o]);
+            for (int s = STRATEGY_SYNC; s <= STRATEGY_ASYNC; s++) {
+                unsigned int violations = 0;
+                frame[s] = transition((strategy_t)s, renderCosts[r], offsets[o], -1, &violations);
+                printf("  %8.2f", frame[s] / 1000);
+                if (violations) { printf("!"); failures++; }
+            }
+            printf("\n");
+            // Overlapping the render with the transfer should be no slower than no overlap
+            if (frame[STRATEGY_ASYNC] > frame[STRATEGY_SYNC]) failures++;
+        }
+    }
+
+    // A stray notification: the previous handshake changes the DataCommand pin (or reuses a buffer) mid-transfer
+    for (int s = STRATEGY_NOTIFY; s <= STRATEGY_ASYNC; s++) {
+        unsigned int violations = 0;
+        transition((strategy_t)s, 0.25, 0, 10, &violations);
+        printf("Stray notification, %-6s: %u violation(s)\n", strategyNames[s], violations);
+        if (s == STRATEGY_ASYNC && violations) failures++;
+    }
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
@@ -1,3 +1,5 @@
+#include "cueband.h"
+
 #include "displayapp/LittleVgl.h"
 #include "displayapp/lv_pinetime_theme.h"
 
@@ -6,6 +8,9 @@
 //#include <projdefs.h>
 #include "drivers/Cst816s.h"
 #include "drivers/St7789.h"
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+#include "components/timing/frametiming.h"
+#endif
 
 using namespace Pinetime::Components;
 
@@ -13,8 +18,26 @@ lv_style_t* LabelBigStyle = nullptr;
 
 static void disp_flush(lv_disp_drv_t* disp_drv, const lv_area_t* area, lv_color_t* color_p) {
   auto* lvgl = static_cast<LittleVgl*>(disp_drv->user_data);
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+  frame_timing_mark_t start = frame_timing_mark();
+  lvgl->FlushDisplay(area, color_p);
+  frame_timing_record(FRAME_TIMING_FLUSH, start);
+#else
   lvgl->FlushDisplay(area, color_p);
+#endif
+}
+
+#ifdef CUEBAND_ASYNC_DISPLAY_FLUSH
+// From the SPI end-of-transfer interrupt: LVGL may now reuse the buffer (it renders into the other one meanwhile)
+static void flush_complete(void* context) {
+  lv_disp_flush_ready(static_cast<lv_disp_drv_t*>(context));
+}
+
+// LVGL waiting for the buffer being transferred: block until the SPI driver notifies this task of the end of a transfer
+static void flush_wait(lv_disp_drv_t* disp_drv) {
+  ulTaskNotifyTake(pdTRUE, 200);
 }
+#endif
 
 static void rounder(lv_disp_drv_t* disp_drv, lv_area_t* area) {
   auto* lvgl = static_cast<LittleVgl*>(disp_drv->user_data);
@@ -57,6 +80,9 @@ void LittleVgl::InitDisplay() {
   disp_drv.buffer = &disp_buf_2;
   disp_drv.user_data = this;
   disp_drv.rounder_cb = rounder;
+#ifdef CUEBAND_ASYNC_DISPLAY_FLUSH
+  disp_drv.wait_cb = flush_wait;
+#endif
 
   /*Finally register the driver*/
   lv_disp_drv_register(&disp_drv);
@@ -93,9 +119,14 @@ void LittleVgl::SetFullRefresh(FullRefreshDirections direction) {
 void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
   uint16_t y1, y2, width, height = 0;
 
+#ifndef CUEBAND_ASYNC_DISPLAY_FLUSH
   ulTaskNotifyTake(pdTRUE, 200);
   // Notification is still needed (even if there is a mutex on SPI) because of the DataCommand pin
   // which cannot be set/clear during a transfer.
+#else
+  // LVGL only calls this once the previous flush is ready (its transfer has ended), and the LCD driver waits for
+  // any pixel data still being transferred before it changes the DataCommand pin.
+#endif
 
   if ((scrollDirection == LittleVgl::FullRefreshDirections::Down) && (area->y2 == visibleNbLines - 1)) {
     writeOffset = ((writeOffset + totalNbLines) - visibleNbLines) % totalNbLines;
@@ -160,15 +191,27 @@ void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
 
     if (height > 0) {
       lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2);
+#ifndef CUEBAND_ASYNC_DISPLAY_FLUSH
       ulTaskNotifyTake(pdTRUE, 100);
+#endif
     }
 
     uint16_t pixOffset = width * height;
     height = y2 + 1;
+#ifdef CUEBAND_ASYNC_DISPLAY_FLUSH
+    lcd.DrawBuffer(area->x1, 0, width, height, reinterpret_cast<const uint8_t*>(color_p + pixOffset), width * height * 2, flush_complete, &disp_drv);
+    return;
+#else
     lcd.DrawBuffer(area->x1, 0, width, height, reinterpret_cast<const uint8_t*>(color_p + pixOffset), width * height * 2);
+#endif
 
   } else {
+#ifdef CUEBAND_ASYNC_DISPLAY_FLUSH
+    lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2, flush_complete, &disp_drv);
+    return;
+#else
     lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2);
+#endif
   }
 
   // IMPORTANT!!!
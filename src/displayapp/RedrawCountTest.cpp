@@ -0,0 +1,178 @@
+// Host harness counting watch face redraws per minute.
+// Simulated controllers (time, battery, BLE, cue status) change at realistic rates while the watch face is polled every
+// LV_DISP_DEF_REFR_PERIOD, comparing the previous polling (read every value on each poll, set the cue status label every
+// poll) with the CUEBAND_REDRAW_ON_CHANGE change counts (WatchFaceDigital::Refresh()).  Counts label updates (each one
+// invalidates the label, so LVGL re-renders and re-sends its area) and the controller values read.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#define POLL_MS 20              // LV_DISP_DEF_REFR_PERIOD
+#define MINUTES 60
+
+// As Screens::DirtyValue
+template <class T> class DirtyValue {
+public:
+  bool IsUpdated() {
+    bool updated = isUpdated;
+    isUpdated = false;
+    return updated;
+  }
+  DirtyValue& operator=(const T& other) {
+    if (value != other) {
+      value = other;
+      isUpdated = true;
+    }
+    return *this;
+  }
+private:
+  T value {};
+  bool isUpdated {true};
+};
+
+// Simulated controllers, with change counts as the real ones
+struct Controllers {
+  uint32_t seconds = 8 * 60 * 60 + 59 * 60 + 30;
+  uint32_t minuteChangeCount = 1;
+  uint8_t battery = 80;
+  bool powerPresent = false;
+  uint32_t batteryChangeCount = 0;
+  bool bleConnected = false;
+  uint32_t bleChangeCount = 0;
+  // Cue: description regenerated (lazily) after each 1 Hz TimeChanged()
+  uint32_t cueRemaining = 45 * 60;
+  bool descriptionValid = false;
+  char description[32] = "";
+  uint32_t descriptionChangeCount = 0;
+  unsigned int descriptionBuilds = 0;
+
+  void Second(unsigned int elapsed) {
+    seconds++;
+    if (seconds % 60 == 0) minuteChangeCount++;
+    if (elapsed % (6 * 60) == 0 && battery > 0) { battery--; batteryChangeCount++; }    // ~1% every 6 minutes
+    if (elapsed % (17 * 60) == 0) { bleConnected = !bleConnected; bleChangeCount++; }   // Occasional (re)connection
+    if (cueRemaining > 0) cueRemaining--; else cueRemaining = 45 * 60;
+    descriptionValid = false;
+  }
+
+  // As niceTime() in CueController.cpp
+  static void NiceTime(char* buffer, unsigned int s) {
+    if (s < 60) sprintf(buffer, "%us", (s + 2) / 5 * 5);
+    else if (s < 90 * 60) sprintf(buffer, "%um", (s + 30) / 60);
+    else sprintf(buffer, "%uh", s / 60 / 60);
+  }
+
+  // As CueController::Description()
+  const char* Description() {
+    if (!descriptionValid) {
+      char previous[sizeof(description)];
+      strcpy(previous, description);
+      char duration[12];
+      NiceTime(duration, cueRemaining);
+      sprintf(description, "Cue (%s)", duration);
+      descriptionValid = true;
+      descriptionBuilds++;
+      if (strcmp(description, previous) != 0) descriptionChangeCount++;
+    }
+    return description;
+  }
+};
+
+struct Counts {
+  unsigned int labelUpdates = 0;    // Label text/icon set (each invalidates and redraws the label)
+  unsigned int timeLabelUpdates = 0;
+  unsigned int cueLabelUpdates = 0;
+  unsigned int valueReads = 0;      // Controller values read and compared
+  unsigned int dateDecompositions = 0;
+};
+
+// Previous WatchFaceDigital::Refresh()
+struct PollingFace {
+  DirtyValue<uint8_t> battery;
+  DirtyValue<bool> powerPresent;
+  DirtyValue<bool> ble;
+  DirtyValue<uint32_t> dateTime;
+  int displayedMinute = -1;
+
+  void Refresh(Controllers& c, Counts& n) {
+    powerPresent = c.powerPresent; battery = c.battery; ble = c.bleConnected; n.valueReads += 4;
+    if (powerPresent.IsUpdated()) n.labelUpdates++;
+    if (battery.IsUpdated()) n.labelUpdates++;
+    if (ble.IsUpdated()) n.labelUpdates++;
+    dateTime = c.seconds; n.valueReads++;
+    if (dateTime.IsUpdated()) {
+      n.dateDecompositions++;
+      int minute = (c.seconds / 60) % 60;
+      if (minute != displayedMinute) { displayedMinute = minute; n.labelUpdates++; n.timeLabelUpdates++; }
+    }
+    c.Description(); n.valueReads++;
+    n.labelUpdates++; n.cueLabelUpdates++;     // lv_label_set_text_fmt() on every poll
+  }
+};
+
+// WatchFaceDigital::Refresh() with CUEBAND_REDRAW_ON_CHANGE
+struct ChangeCountFace {
+  DirtyValue<uint32_t> batteryChanges, bleChanges, timeChanges, cueChanges;
+  DirtyValue<uint8_t> battery;
+  DirtyValue<bool> powerPresent;
+  DirtyValue<bool> ble;
+  DirtyValue<uint32_t> dateTime;
+  int displayedMinute = -1;
+
+  void Refresh(Controllers& c, Counts& n) {
+    batteryChanges = c.batteryChangeCount; bleChanges = c.bleChangeCount; n.valueReads += 2;
+    if (batteryChanges.IsUpdated() | bleChanges.IsUpdated()) {
+      powerPresent = c.powerPresent; battery = c.battery; ble = c.bleConnected; n.valueReads += 4;
+      if (powerPresent.IsUpdated()) n.labelUpdates++;
+      if (battery.IsUpdated()) n.labelUpdates++;
+      if (ble.IsUpdated()) n.labelUpdates++;
+    }
+    timeChanges = c.minuteChangeCount; n.valueReads++;
+    if (timeChanges.IsUpdated()) {
+      dateTime = c.seconds; n.valueReads++;
+    }
+    if (dateTime.IsUpdated()) {
+      n.dateDecompositions++;
+      int minute = (c.seconds / 60) % 60;
+      if (minute != displayedMinute) { displayedMinute = minute; n.labelUpdates++; n.timeLabelUpdates++; }
+    }
+    c.Description();
+    cueChanges = c.descriptionChangeCount; n.valueReads += 2;
+    if (cueChanges.IsUpdated()) { n.labelUpdates++; n.cueLabelUpdates++; }
+  }
+};
+
+template <class Face> static Counts Run(const char* name) {
+  Controllers controllers;
+  Face face;
+  Counts counts;
+  unsigned int polls = 0;
+  for (unsigned int ms = 0; ms < MINUTES * 60 * 1000; ms += POLL_MS) {
+    if (ms % 1000 == 0) controllers.Second(ms / 1000);
+    face.Refresh(controllers, counts);
+    polls++;
+  }
+  printf("%-13s per minute: %7.1f label redraws (time %.1f, cue status %.1f), %7.1f values read, %5.1f date decompositions, %4.1f cue descriptions built\n",
+         name, (double)counts.labelUpdates / MINUTES, (double)counts.timeLabelUpdates / MINUTES, (double)counts.cueLabelUpdates / MINUTES,
+         (double)counts.valueReads / MINUTES, (double)counts.dateDecompositions / MINUTES, (double)controllers.descriptionBuilds / MINUTES);
+  return counts;
+}
+
+int main(int argc, char *argv[]) {
+  printf("Watch face polled every %d ms for %d minutes\n", POLL_MS, MINUTES);
+  Counts polling = Run<PollingFace>("polling");
+  Counts changes = Run<ChangeCountFace>("change-counts");
+
+  bool ok = true;
+  // Same visible updates of the time (once a minute), far fewer redraws overall
+  if (changes.timeLabelUpdates != polling.timeLabelUpdates) ok = false;
+  if (changes.timeLabelUpdates > MINUTES + 1) ok = false;
+  if (changes.labelUpdates * 10 > polling.labelUpdates) ok = false;
+  // The cue status text changes every 5 seconds in its last minute, otherwise once a minute
+  if (changes.cueLabelUpdates > MINUTES * 12) ok = false;
+  if (changes.dateDecompositions > MINUTES + 1) ok = false;
+  printf("%s\n", ok ? "PASSED" : "FAILED");
+  return ok ? 0 : 1;
+}
@@ -8,6 +8,8 @@
 #include "displayapp/screens/Symbols.h"
 #include "displayapp/screens/BatteryIcon.h"
 
+#include <cstring>
+
 using namespace Pinetime::Applications::Screens;
 
 #define UNITS_X_OFFSET 80
@@ -70,6 +72,35 @@ static bool atMinDuration(const uint32_t *durations, uint32_t current) {
   return prev == 0;
 }
 
+// Only change (and so invalidate and redraw) objects whose displayed value differs
+static void SetText(lv_obj_t* label, const char* text) {
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+  if (strcmp(lv_label_get_text(label), text) == 0) return;
+#endif
+  lv_label_set_text(label, text);
+}
+
+static void SetStaticText(lv_obj_t* label, const char* text) {
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+  if (lv_label_get_text(label) == text) return;
+#endif
+  lv_label_set_text_static(label, text);
+}
+
+static void SetHidden(lv_obj_t* obj, bool hidden) {
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+  if (lv_obj_get_hidden(obj) == hidden) return;
+#endif
+  lv_obj_set_hidden(obj, hidden);
+}
+
+static void SetButtonColor(lv_obj_t* button, lv_color_t color) {
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+  if (lv_obj_get_style_bg_color(button, LV_BTN_PART_MAIN).full == color.full) return;
+#endif
+  lv_obj_set_style_local_bg_color(button, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, color);
+}
+
 static void ButtonEventHandler(lv_obj_t* obj, lv_event_t event) {
   auto* screen = static_cast<CueBandApp*>(obj->user_data);
   screen->OnButtonEvent(obj, event);
@@ -236,12 +267,12 @@ void CueBandApp::Update() {
 
 #if defined(CUEBAND_CUSTOMIZATION_NO_INVALID_TIME) && defined(CUEBAND_DETECT_UNSET_TIME)
     if (dateTimeController.IsUnset()) {
-      lv_label_set_text_fmt(label_time, "");
+      SetText(label_time, "");
     } else
 #endif
-    lv_label_set_text(label_time, dateTimeController.FormattedTime().c_str());
+    SetText(label_time, dateTimeController.FormattedTime().c_str());
     batteryIcon.SetBatteryPercentage(batteryController.PercentRemaining());
-    lv_obj_set_hidden(batteryIcon.GetObject(), screen == CUEBAND_SCREEN_MANUAL);  // Preferences button partially obscures battery level
+    SetHidden(batteryIcon.GetObject(), screen == CUEBAND_SCREEN_MANUAL);  // Preferences button partially obscures battery level
 
     static char text[80];
     static char durationText[16]; // "00"
@@ -262,7 +293,7 @@ void CueBandApp::Update() {
           //unitsStr = "#808080  Mute     Manual#";  // LV_COLOR_GRAY #808080
           unitsStr = " Mute     Manual";
         }
-        lv_label_set_text_static(units, unitsStr);
+        SetStaticText(units, unitsStr);
         lv_obj_align(units, lv_scr_act(), LV_ALIGN_CENTER, 0, UNITS_Y_OFFSET);
         break;
       }
@@ -281,7 +312,7 @@ void CueBandApp::Update() {
           }
           sprintf(durationText, "--");
         }
-        lv_label_set_text_static(units, "min");
+        SetStaticText(units, "min");
         lv_obj_align(units, lv_scr_act(), LV_ALIGN_CENTER, UNITS_X_OFFSET, UNITS_Y_OFFSET);
         break;
       }
@@ -296,7 +327,7 @@ void CueBandApp::Update() {
           p += sprintf(text, "No manual cue");
           sprintf(durationText, "--");
         }
-        lv_label_set_text_static(units, "min");
+        SetStaticText(units, "min");
         lv_obj_align(units, lv_scr_act(), LV_ALIGN_CENTER, UNITS_X_OFFSET, UNITS_Y_OFFSET);
         break;
       }
@@ -309,7 +340,7 @@ void CueBandApp::Update() {
         // _15 sec.
         // LV_COLOR_GRAY #808080
         p += sprintf(text, "Cue Preferences\n\n#808080 Interval Style#\n%3d %s   %s", lastInterval < 100 ? lastInterval : (lastInterval / 60), lastInterval < 100 ? "s" : "m", promptDescription[promptStyle % 16]);
-        lv_label_set_text_static(units, "");
+        SetStaticText(units, "");
         lv_obj_align(units, lv_scr_act(), LV_ALIGN_CENTER, UNITS_X_OFFSET, UNITS_Y_OFFSET);
         break;
       }
@@ -321,10 +352,10 @@ void CueBandApp::Update() {
         p += sprintf(text, "Cue Interval:");
         if (lastInterval < 100) {
           sprintf(durationText, "%d", (int)lastInterval);
-          lv_label_set_text_static(units, "sec");
+          SetStaticText(units, "sec");
         } else {
           sprintf(durationText, "%d", (int)(lastInterval / 60));
-          lv_label_set_text_static(units, "min");
+          SetStaticText(units, "min");
         }
         lv_obj_align(units, lv_scr_act(), LV_ALIGN_CENTER, UNITS_X_OFFSET, UNITS_Y_OFFSET);
         break;
@@ -335,7 +366,7 @@ void CueBandApp::Update() {
         unsigned int lastInterval = 0, promptStyle = 0;
         cueController.GetLastImpromptu(&lastInterval, &promptStyle);
         p += sprintf(text, "Cue Style:\n\n%s", promptDescription[promptStyle % 16]);
-        lv_label_set_text_static(units, "");
+        SetStaticText(units, "");
         lv_obj_align(units, lv_scr_act(), LV_ALIGN_CENTER, UNITS_X_OFFSET, UNITS_Y_OFFSET);
         break;
       }
@@ -346,8 +377,8 @@ void CueBandApp::Update() {
         break;
       }
     }
-    lv_label_set_text_static(lInfoIcon, symbol);
-    lv_label_set_text_static(duration, durationText);
+    SetStaticText(lInfoIcon, symbol);
+    SetText(duration, durationText);
     lv_obj_align(duration, lv_scr_act(), LV_ALIGN_CENTER, 0, DURATION_Y_OFFSET);
  
 
@@ -356,14 +387,14 @@ void CueBandApp::Update() {
     switch (screen) {
       case CUEBAND_SCREEN_OVERVIEW:
       {
-        lv_label_set_text_static(btnLeft_lbl, Symbols::cuebandSilence);
-        lv_obj_set_style_local_bg_color(btnLeft, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, cueController.IsSnoozed() ? LV_COLOR_RED : LV_COLOR_GRAY);
-        lv_obj_set_hidden(btnLeft, !isManualAllowed);
-        lv_obj_set_hidden(btnLeft_lbl, !isManualAllowed);
-        lv_label_set_text_static(btnRight_lbl, Symbols::cuebandImpromptu);
-        lv_obj_set_style_local_bg_color(btnRight, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, cueController.IsTemporary() ? LV_COLOR_GREEN : LV_COLOR_GRAY);
-        lv_obj_set_hidden(btnRight, !isManualAllowed);
-        lv_obj_set_hidden(btnRight_lbl, !isManualAllowed);
+        SetStaticText(btnLeft_lbl, Symbols::cuebandSilence);
+        SetButtonColor(btnLeft, cueController.IsSnoozed() ? LV_COLOR_RED : LV_COLOR_GRAY);
+        SetHidden(btnLeft, !isManualAllowed);
+        SetHidden(btnLeft_lbl, !isManualAllowed);
+        SetStaticText(btnRight_lbl, Symbols::cuebandImpromptu);
+        SetButtonColor(btnRight, cueController.IsTemporary() ? LV_COLOR_GREEN : LV_COLOR_GRAY);
+        SetHidden(btnRight, !isManualAllowed);
+        SetHidden(btnRight_lbl, !isManualAllowed);
         break;
       }
       case CUEBAND_SCREEN_SNOOZE:
@@ -372,14 +403,14 @@ void CueBandApp::Update() {
         bool leftEnabled = valid;
         bool minimum = !leftEnabled || atMinDuration(snoozeDurations, override_remaining);
         bool rightEnabled = !valid || !atMaxDuration(snoozeDurations, override_remaining);
-        lv_label_set_text_static(btnLeft_lbl, minimum ? Symbols::cuebandCancel : Symbols::cuebandMinus);
-        lv_obj_set_style_local_bg_color(btnLeft, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_GRAY);
-        lv_obj_set_hidden(btnLeft, !isManualAllowed || !leftEnabled);
-        lv_obj_set_hidden(btnLeft_lbl, !isManualAllowed || !leftEnabled);
-        lv_label_set_text_static(btnRight_lbl, rightEnabled ? Symbols::cuebandPlus : "");
-        lv_obj_set_style_local_bg_color(btnRight, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_GRAY);
-        lv_obj_set_hidden(btnRight, !isManualAllowed || !rightEnabled);
-        lv_obj_set_hidden(btnRight_lbl, !isManualAllowed || !rightEnabled);
+        SetStaticText(btnLeft_lbl, minimum ? Symbols::cuebandCancel : Symbols::cuebandMinus);
+        SetButtonColor(btnLeft, LV_COLOR_GRAY);
+        SetHidden(btnLeft, !isManualAllowed || !leftEnabled);
+        SetHidden(btnLeft_lbl, !isManualAllowed || !leftEnabled);
+        SetStaticText(btnRight_lbl, rightEnabled ? Symbols::cuebandPlus : "");
+        SetButtonColor(btnRight, LV_COLOR_GRAY);
+        SetHidden(btnRight, !isManualAllowed || !rightEnabled);
+        SetHidden(btnRight_lbl, !isManualAllowed || !rightEnabled);
         break;
       }
       case CUEBAND_SCREEN_MANUAL:
@@ -388,27 +419,27 @@ void CueBandApp::Update() {
         bool leftEnabled = valid;
         bool minimum = !leftEnabled || atMinDuration(impromptuDurations, override_remaining);
         bool rightEnabled = !valid || !atMaxDuration(impromptuDurations, override_remaining);
-        lv_label_set_text_static(btnLeft_lbl, minimum ? Symbols::cuebandCancel : Symbols::cuebandMinus);
-        lv_obj_set_style_local_bg_color(btnLeft, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_GRAY);
-        lv_obj_set_hidden(btnLeft, !isManualAllowed || !leftEnabled);
-        lv_obj_set_hidden(btnLeft_lbl, !isManualAllowed || !leftEnabled);
-        lv_label_set_text_static(btnRight_lbl, rightEnabled ? Symbols::cuebandPlus : "");
-        lv_obj_set_style_local_bg_color(btnRight, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_GRAY);
-        lv_obj_set_hidden(btnRight, !isManualAllowed || !rightEnabled);
-        lv_obj_set_hidden(btnRight_lbl, !isManualAllowed || !rightEnabled);
+        SetStaticText(btnLeft_lbl, minimum ? Symbols::cuebandCancel : Symbols::cuebandMinus);
+        SetButtonColor(btnLeft, LV_COLOR_GRAY);
+        SetHidden(btnLeft, !isManualAllowed || !leftEnabled);
+        SetHidden(btnLeft_lbl, !isManualAllowed || !leftEnabled);
+        SetStaticText(btnRight_lbl, rightEnabled ? Symbols::cuebandPlus : "");
+        SetButtonColor(btnRight, LV_COLOR_GRAY);
+        SetHidden(btnRight, !isManualAllowed || !rightEnabled);
+        SetHidden(btnRight_lbl, !isManualAllowed || !rightEnabled);
         showPreferences = true;
         break;
       }
       case CUEBAND_SCREEN_PREFERENCES:
       {
-        lv_label_set_text_static(btnLeft_lbl, Symbols::cuebandInterval);   // cuebandInterval
-        lv_obj_set_style_local_bg_color(btnLeft, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_GRAY);
-        lv_obj_set_hidden(btnLeft, !isManualAllowed);
-        lv_obj_set_hidden(btnLeft_lbl, !isManualAllowed);
-        lv_label_set_text_static(btnRight_lbl, Symbols::cuebandIntensity);  // cuebandIntensity
-        lv_obj_set_style_local_bg_color(btnRight, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_GRAY);
-        lv_obj_set_hidden(btnRight, !isManualAllowed);
-        lv_obj_set_hidden(btnRight_lbl, !isManualAllowed);
+        SetStaticText(btnLeft_lbl, Symbols::cuebandInterval);   // cuebandInterval
+        SetButtonColor(btnLeft, LV_COLOR_GRAY);
+        SetHidden(btnLeft, !isManualAllowed);
+        SetHidden(btnLeft_lbl, !isManualAllowed);
+        SetStaticText(btnRight_lbl, Symbols::cuebandIntensity);  // cuebandIntensity
+        SetButtonColor(btnRight, LV_COLOR_GRAY);
+        SetHidden(btnRight, !isManualAllowed);
+        SetHidden(btnRight_lbl, !isManualAllowed);
         break;
       }
       case CUEBAND_SCREEN_INTERVAL:
@@ -417,14 +448,14 @@ void CueBandApp::Update() {
         cueController.GetLastImpromptu(&interval, nullptr);
         bool leftEnabled = !atMinDuration(promptIntervals, interval);
         bool rightEnabled = !atMaxDuration(promptIntervals, interval);
-        lv_label_set_text_static(btnLeft_lbl, leftEnabled ? Symbols::cuebandMinus : "");
-        lv_obj_set_style_local_bg_color(btnLeft, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_GRAY);
-        lv_obj_set_hidden(btnLeft, !isManualAllowed || !leftEnabled);
-        lv_obj_set_hidden(btnLeft_lbl, !isManualAllowed || !leftEnabled);
-        lv_label_set_text_static(btnRight_lbl, rightEnabled ? Symbols::cuebandPlus : "");
-        lv_obj_set_style_local_bg_color(btnRight, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_GRAY);
-        lv_obj_set_hidden(btnRight, !isManualAllowed || !rightEnabled);
-        lv_obj_set_hidden(btnRight_lbl, !isManualAllowed || !rightEnabled);
+        SetStaticText(btnLeft_lbl, leftEnabled ? Symbols::cuebandMinus : "");
+        SetButtonColor(btnLeft, LV_COLOR_GRAY);
+        SetHidden(btnLeft, !isManualAllowed || !leftEnabled);
+        SetHidden(btnLeft_lbl, !isManualAllowed || !leftEnabled);
+        SetStaticText(btnRight_lbl, rightEnabled ? Symbols::cuebandPlus : "");
+        SetButtonColor(btnRight, LV_COLOR_GRAY);
+        SetHidden(btnRight, !isManualAllowed || !rightEnabled);
+        SetHidden(btnRight_lbl, !isManualAllowed || !rightEnabled);
         break;
       }
       case CUEBAND_SCREEN_STYLE:
@@ -433,34 +464,34 @@ void CueBandApp::Update() {
         cueController.GetLastImpromptu(nullptr, &promptStyle);
         bool leftEnabled = !atMinDuration(promptStyles, promptStyle);
         bool rightEnabled = !atMaxDuration(promptStyles, promptStyle, 0);
-        lv_label_set_text_static(btnLeft_lbl, leftEnabled ? Symbols::cuebandPrevious : "");
-        lv_obj_set_style_local_bg_color(btnLeft, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_GRAY);
-        lv_obj_set_hidden(btnLeft, !isManualAllowed || !leftEnabled);
-        lv_obj_set_hidden(btnLeft_lbl, !isManualAllowed || !leftEnabled);
-        lv_label_set_text_static(btnRight_lbl, rightEnabled ? Symbols::cuebandNext : "");
-        lv_obj_set_style_local_bg_color(btnRight, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_GRAY);
-        lv_obj_set_hidden(btnRight, !isManualAllowed || !rightEnabled);
-        lv_obj_set_hidden(btnRight_lbl, !isManualAllowed || !rightEnabled);
+        SetStaticText(btnLeft_lbl, leftEnabled ? Symbols::cuebandPrevious : "");
+        SetButtonColor(btnLeft, LV_COLOR_GRAY);
+        SetHidden(btnLeft, !isManualAllowed || !leftEnabled);
+        SetHidden(btnLeft_lbl, !isManualAllowed || !leftEnabled);
+        SetStaticText(btnRight_lbl, rightEnabled ? Symbols::cuebandNext : "");
+        SetButtonColor(btnRight, LV_COLOR_GRAY);
+        SetHidden(btnRight, !isManualAllowed || !rightEnabled);
+        SetHidden(btnRight_lbl, !isManualAllowed || !rightEnabled);
         break;
       }
       default:
       {
-        lv_label_set_text_static(btnLeft_lbl, Symbols::none);
-        lv_obj_set_style_local_bg_color(btnLeft, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_GRAY);
-        lv_obj_set_hidden(btnLeft, true);
-        lv_obj_set_hidden(btnLeft_lbl, true);
-        lv_label_set_text_static(btnRight_lbl, Symbols::none);
-        lv_obj_set_style_local_bg_color(btnRight, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_GRAY);
-        lv_obj_set_hidden(btnRight, true);
-        lv_obj_set_hidden(btnRight_lbl, true);
+        SetStaticText(btnLeft_lbl, Symbols::none);
+        SetButtonColor(btnLeft, LV_COLOR_GRAY);
+        SetHidden(btnLeft, true);
+        SetHidden(btnLeft_lbl, true);
+        SetStaticText(btnRight_lbl, Symbols::none);
+        SetButtonColor(btnRight, LV_COLOR_GRAY);
+        SetHidden(btnRight, true);
+        SetHidden(btnRight_lbl, true);
         break;
       }
     }
-    lv_obj_set_hidden(btnPreferences, !showPreferences);
-    lv_obj_set_hidden(btnPreferences_lbl, !showPreferences);
+    SetHidden(btnPreferences, !showPreferences);
+    SetHidden(btnPreferences_lbl, !showPreferences);
 
     //lv_label_set_text_fmt(lInfo, "%s", text);
-    lv_label_set_text_static(lInfo, text);
+    SetText(lInfo, text);
   }
 }
 
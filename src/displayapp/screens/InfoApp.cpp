@@ -6,6 +6,9 @@
 #include <lvgl/lvgl.h>
 #include "../DisplayApp.h"
 #include "Symbols.h"
+#ifdef CUEBAND_SCRATCH_ARENA
+#include "components/scratch/scratch.h"
+#endif
 
 using namespace Pinetime::Applications::Screens;
 
@@ -14,6 +17,46 @@ static void lv_update_task(struct _lv_task_t* task) {
   user_data->Update();
 }
 
+#if defined(CUEBAND_INFO_APP_ID) && defined(CUEBAND_INFO_APP_QR)
+// Image decoder for the 1bpp QR Code image (only), drawn at a whole multiple of its size
+static lv_coord_t QrImageScale(lv_coord_t dimension) {
+  lv_coord_t scale = QR_IMAGE_DISPLAY_MAX / dimension;
+  return scale > 1 ? scale : 1;
+}
+
+static lv_res_t QrDecoderInfo(lv_img_decoder_t* decoder, const void* src, lv_img_header_t* header) {
+  if (src != decoder->user_data) return LV_RES_INV;
+  const lv_img_dsc_t* image = static_cast<const lv_img_dsc_t*>(src);
+  lv_coord_t scale = QrImageScale(image->header.w);
+  header->always_zero = 0;
+  header->w = image->header.w * scale;
+  header->h = image->header.h * scale;
+  header->cf = LV_IMG_CF_TRUE_COLOR;   // Lines read as plain colors
+  return LV_RES_OK;
+}
+
+static lv_res_t QrDecoderOpen(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc) {
+  if (dsc->src != decoder->user_data) return LV_RES_INV;
+  dsc->img_data = nullptr;   // Read line-by-line
+  return LV_RES_OK;
+}
+
+static lv_res_t QrDecoderReadLine(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t* buf) {
+  static_assert(sizeof(lv_color_t) == sizeof(uint16_t), "Lines are read as 16-bit colors");
+  lv_img_dsc_t* image = static_cast<lv_img_dsc_t*>(decoder->user_data);
+  lv_coord_t scale = QrImageScale(image->header.w);
+  // The two palette entries (lv_color32_t: blue, green, red, alpha) -- lv_img_buf_get_px_color() gives only the index for an indexed image
+  const uint8_t* palette = image->data;
+  lv_color_t color0 = lv_color_make(palette[2], palette[1], palette[0]);
+  lv_color_t color1 = lv_color_make(palette[6], palette[5], palette[4]);
+  QrTinyBitmapReadLine(image->data + QR_IMAGE_PALETTE, (image->header.w + 7) >> 3, scale, x, y, len, color0.full, color1.full, reinterpret_cast<uint16_t*>(buf));
+  return LV_RES_OK;
+}
+
+static void QrDecoderClose(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc) {
+}
+#endif
+
 InfoApp::InfoApp(Pinetime::Applications::DisplayApp* app,
              System::SystemTask& systemTask,
              Pinetime::Controllers::DateTime& dateTimeController,
@@ -84,83 +127,64 @@ InfoApp::InfoApp(Pinetime::Applications::DisplayApp* app,
 
 #ifdef CUEBAND_INFO_APP_QR    // --- QR Code ---
 
-  // Use a (26 byte) buffer for holding the encoded payload and ECC calculations
+  // Use a (up to 172 byte) buffer for holding the encoded payload and ECC calculations
   uint8_t qrBuffer[QRTINY_BUFFER_SIZE] = { 0 };
 
-  // Encode one or more segments text to the buffer
+  // Encode one or more segments text to the buffer: provisioning URL with the address and device key (all alphanumeric)
+  char qrText[sizeof(CUEBAND_INFO_APP_QR_URL) + sizeof(shortAddress) + 10];
+#if defined(CUEBAND_TRUSTED_CONNECTION)
+  sprintf(qrText, "%s%s/%08lX", CUEBAND_INFO_APP_QR_URL, shortAddress, (unsigned long)systemTask.GetBleController().GetDeviceKey());
+#else
+  sprintf(qrText, "%s%s", CUEBAND_INFO_APP_QR_URL, shortAddress);
+#endif
   size_t payloadLength = 0;
-  payloadLength += QrTinyWriteAlphanumeric(qrBuffer, payloadLength, shortAddress);
+  payloadLength += QrTinyWriteAlphanumeric(qrBuffer, payloadLength, qrText);
 
   // Choose a format for the QR Code: a mask pattern (binary `000` to `111`) and an error correction level (`LOW`, `MEDIUM`, `QUARTILE`, `HIGH`).
-  uint16_t formatInfo = QRTINY_FORMATINFO_MASK_000_ECC_QUARTILE;  // Max alphanumeric: High=10, Quartile=16, Medium=20, Low=26 
+  uint16_t formatInfo = QRTINY_FORMATINFO_MASK_000_ECC_QUARTILE;  // Max alphanumeric V1-V6: 16, 29, 47, 67, 87, 108
 
-  // Compute the remaining buffer contents: any required padding and the calculated error-correction information
-  bool result = QrTinyGenerate(qrBuffer, payloadLength, formatInfo);
+  // Smallest version that fits, then compute the remaining buffer contents: any required padding and the calculated error-correction information
+  int qrVersion = QrTinyVersionForPayload(payloadLength, formatInfo);
+  bool result = qrVersion > 0 && QrTinyGenerate(qrBuffer, qrVersion, payloadLength, formatInfo);
+  if (!result) qrVersion = QRTINY_VERSION_MIN;
 
   // Clear image data
   memset(data_qr, 0, sizeof(data_qr));
 
-  #ifndef QR_TRUE_COLOR
-    // Set image palette entries
-    data_qr[0] = 0x00; data_qr[1] = 0x00; data_qr[2] = 0x00; data_qr[3] = 0xff; // Color of index 0
-    data_qr[4] = 0xff; data_qr[5] = 0xff; data_qr[6] = 0xff; data_qr[7] = 0xff; // Color of index 1
-  #endif
-
-  // Set image pixels from QR code
-  if (result) {
-    for (int y = 0; y < QR_IMAGE_MAGNIFY * QR_IMAGE_TRUE_DIMENSION; y++) {
-      for (int x = 0; x < QR_IMAGE_MAGNIFY * QR_IMAGE_TRUE_DIMENSION; x++) {
-        int module = QrTinyModuleGet(qrBuffer, formatInfo, (x / QR_IMAGE_MAGNIFY) - QR_QUIET, (y / QR_IMAGE_MAGNIFY) - QR_QUIET);
+  // Set image palette entries (bits are set for dark modules)
 #ifdef QR_IMAGE_INVERT
-        module = !module;
-#endif
-#ifdef QR_TRUE_COLOR
-        int ofs = (y * QR_IMAGE_DIMENSION + x) * QR_PIXEL_BYTES;
-        if (module) { // 1=dark (swapped if inverted)
-          data_qr[ofs + 0] = 0x00; data_qr[ofs + 1] = 0x00;
-        } else {      // 0=light (swapped if inverted)
-          data_qr[ofs + 0] = 0xff; data_qr[ofs + 1] = 0xff;
-        }
+  data_qr[0] = 0x00; data_qr[1] = 0x00; data_qr[2] = 0x00; data_qr[3] = 0xff; // Color of index 0
+  data_qr[4] = 0xff; data_qr[5] = 0xff; data_qr[6] = 0xff; data_qr[7] = 0xff; // Color of index 1
 #else
-        int ofs = QR_IMAGE_PALETTE + ((y * QR_IMAGE_DIMENSION) >> 3) + (x >> 3);
-        int mask = 1 << (7 - (x & 0x07));
-        if (module) {
-          data_qr[ofs] &= ~mask;  // 1=dark (swapped if inverted)
-        } else {
-          data_qr[ofs] |= mask;   // 0=light (swapped if inverted)
-        }
+  data_qr[0] = 0xff; data_qr[1] = 0xff; data_qr[2] = 0xff; data_qr[3] = 0xff; // Color of index 0
+  data_qr[4] = 0x00; data_qr[5] = 0x00; data_qr[6] = 0x00; data_qr[7] = 0xff; // Color of index 1
 #endif
-      }
-    }
+
+  // Set image pixels from QR code (one per module)
+  if (result) {
+    QrTinyRender(qrBuffer, qrVersion, formatInfo, QR_QUIET, data_qr + QR_IMAGE_PALETTE, QRTINY_BITMAP_STRIDE(qrVersion, QR_QUIET));
   }
 
   // Set image header
   image_qr.header.always_zero = 0;
-  image_qr.header.w = QR_IMAGE_DIMENSION;
-  image_qr.header.h = QR_IMAGE_DIMENSION;
-  image_qr.data_size = QR_IMAGE_SIZE;
-  #ifdef QR_TRUE_COLOR
-    image_qr.header.cf = LV_IMG_CF_TRUE_COLOR;
-  #else
-    image_qr.header.cf = LV_IMG_CF_INDEXED_1BIT;
-  #endif
+  image_qr.header.w = QRTINY_BITMAP_DIMENSION(qrVersion, QR_QUIET);
+  image_qr.header.h = QRTINY_BITMAP_DIMENSION(qrVersion, QR_QUIET);
+  image_qr.data_size = QR_IMAGE_PALETTE + QRTINY_BITMAP_SIZE(qrVersion, QR_QUIET);
+  image_qr.header.cf = LV_IMG_CF_INDEXED_1BIT;
   image_qr.data = data_qr;
 
+  // The built-in decoder cannot zoom an indexed image, so this one scales it as it is drawn
+  qrDecoder = lv_img_decoder_create();
+  qrDecoder->user_data = &image_qr;
+  lv_img_decoder_set_info_cb(qrDecoder, QrDecoderInfo);
+  lv_img_decoder_set_open_cb(qrDecoder, QrDecoderOpen);
+  lv_img_decoder_set_read_line_cb(qrDecoder, QrDecoderReadLine);
+  lv_img_decoder_set_close_cb(qrDecoder, QrDecoderClose);
+
   // Create image object
   qr_obj = lv_img_create(lv_scr_act(), NULL);
   lv_img_set_src(qr_obj, &image_qr);
-#ifdef QR_IMAGE_ZOOM
-  lv_img_set_antialias(qr_obj, false);
-	lv_img_set_auto_size(qr_obj, true);
-	lv_img_set_zoom(qr_obj, QR_IMAGE_ZOOM * 256);   // 256=normal, 512=double
-  //lv_obj_set_size(qr_obj, QR_IMAGE_ZOOM * QR_IMAGE_DIMENSION, QR_IMAGE_ZOOM * QR_IMAGE_DIMENSION);
-#endif
-  lv_obj_align(qr_obj, NULL, LV_ALIGN_CENTER, 0, 
-    58
-#if (QR_QUIET < QRTINY_QUIET_STANDARD)    // Offset any missing quiet area
-    // + ((QRTINY_QUIET_STANDARD - QR_QUIET) * QR_IMAGE_MAGNIFY * QR_IMAGE_ZOOM) / 2  // centered
-#endif
-    );
+  lv_obj_align(qr_obj, NULL, LV_ALIGN_CENTER, 0, 58);
 
 #endif
 
@@ -173,6 +197,10 @@ InfoApp::InfoApp(Pinetime::Applications::DisplayApp* app,
 InfoApp::~InfoApp() {
   lv_task_del(taskUpdate);
   lv_obj_clean(lv_scr_act());
+#if defined(CUEBAND_INFO_APP_ID) && defined(CUEBAND_INFO_APP_QR)
+  lv_img_cache_invalidate_src(&image_qr);
+  lv_img_decoder_delete(qrDecoder);
+#endif
 }
 
 int InfoApp::ScreenCount() {
@@ -206,7 +234,10 @@ extern "C" uint32_t os_cputime_get32(void);
 void InfoApp::Update() {
   int thisScreen = 0;
 
-#ifdef CUEBAND_GLOBAL_SCRATCH_BUFFER
+#ifdef CUEBAND_SCRATCH_ARENA
+  char *debugText = (char *)scratch_acquire(SCRATCH_OWNER_INFO_TEXT, 256);
+  if (debugText == nullptr) return;
+#elif defined(CUEBAND_GLOBAL_SCRATCH_BUFFER)
   char *debugText = (char *)cuebandGlobalScratchBuffer;
 #else
   static char debugText[200];
@@ -306,6 +337,9 @@ void InfoApp::Update() {
 #endif
 
   lv_label_set_text_fmt(lInfo, "%s", debugText);
+#ifdef CUEBAND_SCRATCH_ARENA
+  scratch_release(SCRATCH_OWNER_INFO_TEXT, debugText);
+#endif
 }
 
 void InfoApp::Refresh() {
@@ -91,7 +91,6 @@ namespace Pinetime {
 #ifdef CUEBAND_INFO_APP_QR
           // Specified in cueband.h
           //#define QR_IMAGE_INVERT
-          //#define QR_TRUE_COLOR         // Can only transform (zoom) a true color image rather than 1bpp image (create a larger source image from magnification instead)
 
           // When inverted, assume dark background so no quiet zone required
           #ifdef QR_IMAGE_INVERT
@@ -100,25 +99,15 @@ namespace Pinetime {
             #define QR_QUIET QRTINY_QUIET_STANDARD
           #endif
 
-          #define QR_IMAGE_TRUE_DIMENSION (QRTINY_DIMENSION + QR_QUIET + QR_QUIET)  // (21+4+4=)29 dark on light (with quiet) or 21 inverted (no quiet on dark background)
-
-          #ifdef QR_TRUE_COLOR
-            #define QR_IMAGE_MAGNIFY 1  // Only write one pixel per module, image will be magnifed by zoom
-            #define QR_IMAGE_ZOOM 4     // Requires LV_USE_IMG_TRANSFORM in lv_conf.h
-            #define QR_IMAGE_PALETTE (0)
-            #define QR_PIXEL_BYTES 2    // Assuming LV_COLOR_DEPTH==16  /  LV_COLOR_SIZE==2
-            #define QR_IMAGE_DIMENSION (QR_IMAGE_MAGNIFY * QR_IMAGE_TRUE_DIMENSION)
-            #define QR_IMAGE_SIZE (QR_IMAGE_DIMENSION * QR_IMAGE_DIMENSION * QR_PIXEL_BYTES)   // Large!
-          #else
-            #define QR_IMAGE_MAGNIFY 4  // Cannot magnify by zoom, write multiple pixels per module
-            #define QR_IMAGE_PALETTE (2*4)
-            #define QR_IMAGE_DIMENSION (((QR_IMAGE_MAGNIFY * QR_IMAGE_TRUE_DIMENSION + 7) >> 3) << 3)  // Round to nearest byte
-            #define QR_IMAGE_SIZE (((QR_IMAGE_DIMENSION * QR_IMAGE_DIMENSION) >> 3) + QR_IMAGE_PALETTE)
-          #endif
+          // 1bpp source image (one pixel per module, up to (41+4+4=)49x49 dark on light, or 41x41 inverted), scaled when drawn
+          #define QR_IMAGE_DISPLAY_MAX 96   // Largest whole multiple of the modules that fits
+          #define QR_IMAGE_PALETTE (2*4)
+          #define QR_IMAGE_SIZE (QRTINY_BITMAP_SIZE(QRTINY_VERSION_MAX, QR_QUIET) + QR_IMAGE_PALETTE)   // 254 bytes inverted
 
           uint8_t data_qr[QR_IMAGE_SIZE] __attribute__((aligned(8)));
           lv_img_dsc_t image_qr = {0};
           lv_obj_t* qr_obj;
+          lv_img_decoder_t* qrDecoder = nullptr;
 #endif
 
 #endif
@@ -109,30 +109,44 @@ WatchFaceDigital::~WatchFaceDigital() {
 }
 
 void WatchFaceDigital::Refresh() {
-  powerPresent = batteryController.IsPowerPresent();
-  if (powerPresent.IsUpdated()) {
-    lv_label_set_text_static(batteryPlug, BatteryIcon::GetPlugIcon(powerPresent.Get()));
-  }
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+  // Cheap change counts from the controllers: only read and redraw the values that have changed
+  batteryChanges = batteryController.ChangeCount();
+  bleChanges = bleController.ChangeCount();
+  bool statusIconsChanged = batteryChanges.IsUpdated() | bleChanges.IsUpdated();
+  if (statusIconsChanged)
+#endif
+  {
+    powerPresent = batteryController.IsPowerPresent();
+    if (powerPresent.IsUpdated()) {
+      lv_label_set_text_static(batteryPlug, BatteryIcon::GetPlugIcon(powerPresent.Get()));
+    }
 
-  batteryPercentRemaining = batteryController.PercentRemaining();
-  if (batteryPercentRemaining.IsUpdated()) {
-    auto batteryPercent = batteryPercentRemaining.Get();
-    batteryIcon.SetBatteryPercentage(batteryPercent);
-  }
+    batteryPercentRemaining = batteryController.PercentRemaining();
+    if (batteryPercentRemaining.IsUpdated()) {
+      auto batteryPercent = batteryPercentRemaining.Get();
+      batteryIcon.SetBatteryPercentage(batteryPercent);
+    }
 
-  bleState = bleController.IsConnected();
-  bleRadioEnabled = bleController.IsRadioEnabled();
-  if (bleState.IsUpdated() || bleRadioEnabled.IsUpdated()) {
-    lv_label_set_text_static(bleIcon, BleIcon::GetIcon(bleState.Get()));
+    bleState = bleController.IsConnected();
+    bleRadioEnabled = bleController.IsRadioEnabled();
+    if (bleState.IsUpdated() || bleRadioEnabled.IsUpdated()) {
+      lv_label_set_text_static(bleIcon, BleIcon::GetIcon(bleState.Get()));
+    }
+    lv_obj_realign(batteryPlug);
+    lv_obj_realign(bleIcon);
   }
-  lv_obj_realign(batteryPlug);
-  lv_obj_realign(bleIcon);
 
   notificationState = notificatioManager.AreNewNotificationsAvailable();
   if (notificationState.IsUpdated()) {
     lv_label_set_text_static(notificationIcon, NotificationIcon::GetIcon(notificationState.Get()));
   }
 
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+  // The time is only displayed to the minute
+  timeChanges = dateTimeController.MinuteChangeCount();
+  if (timeChanges.IsUpdated())
+#endif
   currentDateTime = dateTimeController.CurrentDateTime();
 
   if (currentDateTime.IsUpdated()) {
@@ -251,10 +265,22 @@ void WatchFaceDigital::Refresh() {
 #endif
 
 #ifdef CUEBAND_WATCHFACE_CUE_STATUS
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+  // The description is only regenerated when the cue state has changed (at most once a second), and the label only set when the text differs
+  bool showStatus = app->GetCueController().IsShowStatus();
+  cueStatusShown = showStatus;
+  const char *description = showStatus ? app->GetCueController().Description() : "";
+  cueDescriptionChanges = app->GetCueController().DescriptionChangeCount();
+  if (cueDescriptionChanges.IsUpdated() | cueStatusShown.IsUpdated()) {
+    lv_label_set_text(cue_status, description);
+    lv_obj_align(cue_status, nullptr, LV_ALIGN_CENTER, 0, 84);
+  }
+#else
   if (app->GetCueController().IsShowStatus()) {
     const char *description = app->GetCueController().Description();
     lv_label_set_text_fmt(cue_status, "%s", description);
     lv_obj_align(cue_status, nullptr, LV_ALIGN_CENTER, 0, 84);
   }
 #endif
+#endif
 }
@@ -55,6 +55,15 @@ namespace Pinetime {
         DirtyValue<uint8_t> heartbeat {};
         DirtyValue<bool> heartbeatRunning {};
         DirtyValue<bool> notificationState {};
+#ifdef CUEBAND_REDRAW_ON_CHANGE
+        DirtyValue<uint32_t> batteryChanges {};
+        DirtyValue<uint32_t> bleChanges {};
+        DirtyValue<uint32_t> timeChanges {};
+#ifdef CUEBAND_WATCHFACE_CUE_STATUS
+        DirtyValue<bool> cueStatusShown {};
+        DirtyValue<uint32_t> cueDescriptionChanges {};
+#endif
+#endif
 
         lv_obj_t* label_time;
         lv_obj_t* label_time_ampm;
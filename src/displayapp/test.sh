@@ -0,0 +1,2 @@
+g++ FlushModelTest.cpp -o flushmodeltest && ./flushmodeltest "$@"
+g++ RedrawCountTest.cpp -o redrawcounttest && ./redrawcounttest "$@"
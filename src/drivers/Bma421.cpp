@@ -3,6 +3,9 @@
 #include <libraries/log/nrf_log.h>
 #include "drivers/TwiMaster.h"
 #include <drivers/Bma421_C/bma423.h>
+#ifdef CUEBAND_FIFO_DIRECT_DECODE
+#include "drivers/Bma421Fifo.h"
+#endif
 
 using namespace Pinetime::Drivers;
 
@@ -116,11 +119,29 @@ void Bma421::Init() {
   ret = bma4_set_fifo_config(BMA4_FIFO_ACCEL, BMA4_ENABLE, &bma); // (BMA4_FIFO_ACCEL | BMA4_FIFO_STOP_ON_FULL | BMA4_FIFO_HEADER) Configure FIFO
   if (ret != BMA4_OK) return;
 
+#ifdef CUEBAND_FIFO_WATERMARK
+  // FIFO watermark interrupt on INT1 (latched, cleared by ClearInterrupt() after draining)
+  ret = bma4_set_fifo_wm(CUEBAND_FIFO_WATERMARK * 6, &bma); // Watermark in bytes of headerless 6-byte accelerometer frames
+  if (ret != BMA4_OK) return;
+  struct bma4_int_pin_config int_pin_config;
+  int_pin_config.edge_ctrl = BMA4_LEVEL_TRIGGER;
+  int_pin_config.lvl = BMA4_ACTIVE_HIGH;
+  int_pin_config.od = BMA4_PUSH_PULL;
+  int_pin_config.output_en = BMA4_OUTPUT_ENABLE;
+  int_pin_config.input_en = BMA4_INPUT_DISABLE;
+  ret = bma4_set_int_pin_config(&int_pin_config, BMA4_INTR1_MAP, &bma);
+  if (ret != BMA4_OK) return;
+  ret = bma4_map_interrupt(BMA4_INTR1_MAP, BMA4_FIFO_WM_INT, BMA4_ENABLE, &bma);
+  if (ret != BMA4_OK) return;
+#endif
+
+#ifndef CUEBAND_FIFO_DIRECT_DECODE
   // Initialize FIFO buffer
   memset(&fifo_frame, 0, sizeof(fifo_frame));
   fifo_frame.data = fifo_buff;
   fifo_frame.length = sizeof(fifo_buff);
 #endif
+#endif
 
 #ifdef CUEBAND_BUFFER_ENABLED
   totalSamples = 0;
@@ -131,6 +152,16 @@ void Bma421::Init() {
   isOk = true;
 }
 
+#ifdef CUEBAND_FIFO_WATERMARK
+// Read the interrupt status to clear the latched watermark interrupt
+void Bma421::ClearInterrupt() {
+  if (not isOk)
+    return;
+  uint16_t int_status = 0;
+  bma4_read_int_status(&int_status, &bma);
+}
+#endif
+
 void Bma421::Reset() {
   uint8_t data = 0xb6;
   twiMaster.Write(deviceAddress, 0x7E, &data, 1);
@@ -157,6 +188,34 @@ Bma421::Values Bma421::Process() {
 #ifdef CUEBAND_BUFFER_ENABLED
 
 #ifdef CUEBAND_FIFO_ENABLED
+  // Count only the frames read by this drain (none if the FIFO was empty or the read failed), so a full read is not
+  // reported again and the previous samples are not passed on twice
+  lastCount = 0;
+#endif
+
+#if defined(CUEBAND_FIFO_ENABLED) && defined(CUEBAND_FIFO_DIRECT_DECODE)
+  int8_t ret;
+
+  // Read the FIFO length
+  uint16_t fifo_length = 0;
+  ret = bma4_get_fifo_length(&fifo_length, &bma);
+
+  // Read whole frames only (so the FIFO stays frame-aligned), up to the buffer size
+  uint32_t read_length = (fifo_length <= sizeof(fifo_buff)) ? fifo_length : sizeof(fifo_buff);
+  read_length -= read_length % Bma421Fifo::FrameSize;
+  if (ret == BMA4_OK && read_length > 0) {
+    // Headerless accelerometer-only frames, as configured in Init() (no need to re-read the FIFO config)
+    ret = bma4_read_regs(BMA4_FIFO_DATA_ADDR, fifo_buff, read_length, &bma);
+    if (ret == BMA4_OK) {
+      // Decode directly into the output buffer
+      unsigned int dropped = 0;
+      lastCount = Bma421Fifo::Decode(fifo_buff, read_length, accel_buffer, CUEBAND_SAMPLE_MAX, &dropped);
+      totalSamples += lastCount;
+      totalDropped += dropped;
+    }
+  }
+
+#elif defined(CUEBAND_FIFO_ENABLED)
   int8_t ret;
 
   // Read the FIFO length
@@ -32,6 +32,9 @@ namespace Pinetime {
       void Init();
       Values Process();
       void ResetStepCounter();
+#ifdef CUEBAND_FIFO_WATERMARK
+      void ClearInterrupt();
+#endif
 
       void Read(uint8_t registerAddress, uint8_t* buffer, size_t size);
       void Write(uint8_t registerAddress, const uint8_t* data, size_t size);
@@ -52,8 +55,10 @@ namespace Pinetime {
 #ifdef CUEBAND_FIFO_ENABLED
       // Static storage buffers for the FIFO buffer
       static uint8_t fifo_buff[];
+#ifndef CUEBAND_FIFO_DIRECT_DECODE
       struct bma4_fifo_frame fifo_frame;
 #endif
+#endif
 
 #ifdef CUEBAND_BUFFER_ENABLED
       static int16_t accel_buffer[]; // Flat array of data, CUEBAND_AXES width
@@ -0,0 +1,32 @@
+#include "drivers/Bma421Fifo.h"
+
+using namespace Pinetime::Drivers;
+
+size_t Bma421Fifo::Decode(const uint8_t* data, size_t length, int16_t* output, size_t maxSamples, unsigned int* dropped) {
+  size_t count = 0;
+  size_t index = 0;
+  while (index + FrameSize <= length) {
+    if (count < maxSamples) {
+      // 12-bit value (sign-extending, truncated towards zero as the Bosch driver) scaled to 16-bit width
+      for (size_t axis = 0; axis < 3; axis++) {
+        int16_t raw = (int16_t)((data[index + 1] << 8) | data[index]);
+        *output++ = (int16_t)((raw / 16) * 16);
+        index += 2;
+      }
+      count++;
+    } else {
+      index += FrameSize;
+      (*dropped)++;
+    }
+
+    // An empty frame marker ends the valid data
+    if (index + 2 < length && data[index] == 0x80 && data[index + 1] == 0x00) {
+      *dropped += (length - index) / FrameSize;
+      return count;
+    }
+  }
+
+  // Trailing partial frame (the read should be whole frames)
+  if (index < length) (*dropped)++;
+  return count;
+}
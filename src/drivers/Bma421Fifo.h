@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Drivers {
+    namespace Bma421Fifo {
+      static constexpr size_t FrameSize = 6;   // Headerless accelerometer-only frame: x/y/z little-endian, 12-bit left-aligned
+
+      // Decode headerless accelerometer FIFO frames directly to 16-bit scaled (x16) interleaved x/y/z samples in a single pass.
+      // Matches the Bosch bma4_extract_accel() path (including stopping at an "empty" 0x8000 marker), but without the
+      // intermediate struct bma4_accel array. Frames that do not fit the output, a trailing partial frame, and frames
+      // after an empty marker are added to *dropped. Returns the number of samples written.
+      size_t Decode(const uint8_t* data, size_t length, int16_t* output, size_t maxSamples, unsigned int* dropped);
+    }
+  }
+}
@@ -0,0 +1,149 @@
+// Host test: checks Bma421Fifo::Decode() is bit-exact with the Bosch bma4_read_fifo_data()/bma4_extract_accel() path
+// (as previously used by Bma421::Process()), on FIFO dumps given as files (raw binary) and on generated dumps.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Bma421_C/bma423.h"
+#include "Bma421Fifo.h"
+
+#define SAMPLE_MAX 32       // CUEBAND_SAMPLE_MAX
+#define AXES 3
+
+using namespace Pinetime::Drivers;
+
+static const uint8_t *dumpData;
+static size_t dumpLength;
+
+// Bus read serving the FIFO dump, with a headerless accelerometer-only FIFO configuration
+static int8_t busRead(uint8_t reg, uint8_t *data, uint32_t len, void *)
+{
+    memset(data, 0, len);
+    if (reg == BMA4_FIFO_DATA_ADDR)
+    {
+        memcpy(data, dumpData, len < dumpLength ? len : dumpLength);
+    }
+    else if (reg == BMA4_FIFO_CONFIG_1_ADDR)
+    {
+        data[0] = BMA4_FIFO_A_ENABLE;
+    }
+    return BMA4_OK;
+}
+static int8_t busWrite(uint8_t, const uint8_t *, uint32_t, void *) { return BMA4_OK; }
+static void delayUs(uint32_t, void *) {}
+
+// The previous Bma421::Process() FIFO path
+static size_t boschDecode(const uint8_t *data, size_t length, int16_t *output)
+{
+    static uint8_t buffer[1024];
+    struct bma4_dev dev;
+    memset(&dev, 0, sizeof(dev));
+    dev.intf = BMA4_I2C_INTF;
+    dev.bus_read = busRead;
+    dev.bus_write = busWrite;
+    dev.delay_us = delayUs;
+    dev.intf_ptr = &dev;
+    dev.read_write_len = 16;
+    dev.resolution = BMA4_12_BIT_RESOLUTION;
+
+    dumpData = data;
+    dumpLength = length;
+
+    struct bma4_fifo_frame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.data = buffer;
+    frame.length = (uint16_t)length;
+    if (bma4_read_fifo_data(&frame, &dev) != BMA4_OK) return 0;
+
+    struct bma4_accel accel[SAMPLE_MAX];
+    size_t written = 0;
+    for (;;)
+    {
+        uint16_t chunkSize = SAMPLE_MAX;
+        if (bma4_extract_accel(accel, &chunkSize, &frame, &dev) != BMA4_OK) break;
+        for (uint16_t i = 0; i < chunkSize; i++)
+        {
+            if (written < SAMPLE_MAX)
+            {
+                output[AXES * written + 0] = accel[i].x << 4;
+                output[AXES * written + 1] = accel[i].y << 4;
+                output[AXES * written + 2] = accel[i].z << 4;
+                written++;
+            }
+        }
+        if (chunkSize < SAMPLE_MAX) break;
+    }
+    return written;
+}
+
+// Returns 0 if both decoders agree
+static int compare(const char *label, const uint8_t *data, size_t length, bool verbose)
+{
+    int16_t expected[SAMPLE_MAX * AXES];
+    int16_t actual[SAMPLE_MAX * AXES];
+    size_t expectedCount = boschDecode(data, length, expected);
+    unsigned int dropped = 0;
+    size_t actualCount = Bma421Fifo::Decode(data, length, actual, SAMPLE_MAX, &dropped);
+
+    bool match = (expectedCount == actualCount) && memcmp(expected, actual, actualCount * AXES * sizeof(int16_t)) == 0;
+    if (verbose || !match)
+    {
+        printf("%s: %s -- %u bytes, %u/%u samples, %u dropped\n", match ? "PASS" : "FAIL", label, (unsigned int)length, (unsigned int)actualCount, (unsigned int)expectedCount, dropped);
+    }
+    return match ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    int fails = 0;
+    int tests = 0;
+    static uint8_t data[SAMPLE_MAX * Bma421Fifo::FrameSize];
+
+    // Captured FIFO dumps (raw binary, as read from the FIFO data register)
+    for (int i = 1; i < argc; i++)
+    {
+        FILE *fp = fopen(argv[i], "rb");
+        if (fp == NULL)
+        {
+            fprintf(stderr, "ERROR: Problem opening dump file: %s\n", argv[i]);
+            return -1;
+        }
+        size_t length = fread(data, 1, sizeof(data), fp);
+        fclose(fp);
+        fails += compare(argv[i], data, length, true);
+        tests++;
+    }
+
+    // Generated dumps: realistic 12-bit frames, arbitrary bytes, partial frames, and empty-frame markers
+    srand(1);
+    for (int iteration = 0; iteration < 20000; iteration++)
+    {
+        int frames = rand() % (SAMPLE_MAX + 1);
+        size_t length = frames * Bma421Fifo::FrameSize;
+        for (size_t i = 0; i < length; i += 2)
+        {
+            int16_t value;
+            if (iteration & 1) value = (int16_t)(rand() & 0xffff);                  // Any bit pattern
+            else value = (int16_t)(((rand() % 4096) - 2048) << 4);                  // Left-aligned 12-bit
+            data[i] = (uint8_t)value;
+            data[i + 1] = (uint8_t)(value >> 8);
+        }
+        if (length > 0 && (iteration % 7) == 0) length -= rand() % Bma421Fifo::FrameSize;   // Partial trailing frame
+        if (frames > 1 && (iteration % 11) == 0)
+        {
+            size_t at = (rand() % frames) * Bma421Fifo::FrameSize;  // Empty-frame marker
+            data[at] = 0x80;
+            data[at + 1] = 0x00;
+        }
+        char label[32];
+        sprintf(label, "generated %d", iteration);
+        fails += compare(label, data, length, false);
+        tests++;
+    }
+
+    printf("%s (%d of %d failed)\n", fails ? "FAILED" : "PASSED", fails, tests);
+    return fails;
+}
@@ -9,8 +9,8 @@ Spi::Spi(SpiMaster& spiMaster, uint8_t pinCsn) : spiMaster {spiMaster}, pinCsn {
   nrf_gpio_pin_set(pinCsn);
 }
 
-bool Spi::Write(const uint8_t* data, size_t size) {
-  return spiMaster.Write(pinCsn, data, size);
+bool Spi::Write(const uint8_t* data, size_t size, SpiMaster::TransferCompleteCallback onComplete, void* context) {
+  return spiMaster.Write(pinCsn, data, size, onComplete, context);
 }
 
 bool Spi::Read(uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize) {
@@ -26,6 +26,10 @@ bool Spi::WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* d
   return spiMaster.WriteCmdAndBuffer(pinCsn, cmd, cmdSize, data, dataSize);
 }
 
+void Spi::WaitIdle() {
+  spiMaster.WaitIdle();
+}
+
 bool Spi::Init() {
   nrf_gpio_pin_set(pinCsn); /* disable Set slave select (inactive high) */
   return true;
@@ -14,11 +14,15 @@ namespace Pinetime {
       Spi& operator=(Spi&&) = delete;
 
       bool Init();
-      bool Write(const uint8_t* data, size_t size);
+      bool Write(const uint8_t* data, size_t size, SpiMaster::TransferCompleteCallback onComplete = nullptr, void* context = nullptr);
       bool Read(uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize);
       bool WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize);
+      void WaitIdle();
       void Sleep();
       void Wakeup();
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+      void TimeTransfers() { spiMaster.TimeTransfers(pinCsn); }
+#endif
 
     private:
       SpiMaster& spiMaster;
@@ -136,16 +136,25 @@ void SpiMaster::OnEndEvent() {
 
     spiBaseAddress->TASKS_START = 1;
   } else {
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    if (taskToNotify != nullptr) {
-      vTaskNotifyGiveFromISR(taskToNotify, &xHigherPriorityTaskWoken);
-      portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
-    }
-
     nrf_gpio_pin_set(this->pinCsn);
     currentBufferAddr = 0;
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+    if (pinCsn == timedPinCsn) frame_timing_record(FRAME_TIMING_SPI_TRANSFER, transferStart);  // (not flash traffic)
+#endif
+    TransferCompleteCallback callback = onComplete;
+    onComplete = nullptr;
     BaseType_t xHigherPriorityTaskWoken2 = pdFALSE;
     xSemaphoreGiveFromISR(mutex, &xHigherPriorityTaskWoken2);
+
+    // The bus is released before the callback, and the task is notified after it (so it sees the callback's effect)
+    if (callback != nullptr) {
+      callback(onCompleteContext);
+    }
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    if (taskToNotify != nullptr) {
+      vTaskNotifyGiveFromISR(taskToNotify, &xHigherPriorityTaskWoken);
+    }
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken | xHigherPriorityTaskWoken2);
   }
 }
@@ -176,12 +185,14 @@ void SpiMaster::PrepareRx(const volatile uint32_t cmdAddress,
   spiBaseAddress->EVENTS_END = 0;
 }
 
-bool SpiMaster::Write(uint8_t pinCsn, const uint8_t* data, size_t size) {
+bool SpiMaster::Write(uint8_t pinCsn, const uint8_t* data, size_t size, TransferCompleteCallback onComplete, void* context) {
   if (data == nullptr)
     return false;
   auto ok = xSemaphoreTake(mutex, portMAX_DELAY);
   ASSERT(ok == true);
   taskToNotify = xTaskGetCurrentTaskHandle();
+  this->onComplete = (size == 1) ? nullptr : onComplete;
+  onCompleteContext = context;
 
   this->pinCsn = pinCsn;
 
@@ -193,6 +204,9 @@ bool SpiMaster::Write(uint8_t pinCsn, const uint8_t* data, size_t size) {
 
   nrf_gpio_pin_clear(this->pinCsn);
 
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+  transferStart = frame_timing_mark();
+#endif
   currentBufferAddr = (uint32_t) data;
   currentBufferSize = size;
 
@@ -208,11 +222,20 @@ bool SpiMaster::Write(uint8_t pinCsn, const uint8_t* data, size_t size) {
     nrf_gpio_pin_set(this->pinCsn);
     currentBufferAddr = 0;
     xSemaphoreGive(mutex);
+    if (onComplete != nullptr) {
+      onComplete(context);
+    }
   }
 
   return true;
 }
 
+// Blocks until any transfer in progress (e.g. an asynchronous Write()) has completed
+void SpiMaster::WaitIdle() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  xSemaphoreGive(mutex);
+}
+
 bool SpiMaster::Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize) {
   xSemaphoreTake(mutex, portMAX_DELAY);
 
@@ -234,11 +257,18 @@ bool SpiMaster::Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data
   while (spiBaseAddress->EVENTS_END == 0)
     ;
 
-  PrepareRx((uint32_t) cmd, cmdSize, (uint32_t) data, dataSize);
-  spiBaseAddress->TASKS_START = 1;
+  // EasyDMA transfers are at most 255 bytes: longer reads continue with further transfers while the chip select is held
+  // (e.g. a whole flash block in a single read command)
+  while (dataSize > 0) {
+    auto currentSize = std::min((size_t) 255, dataSize);
+    PrepareRx((uint32_t) cmd, cmdSize, (uint32_t) data, currentSize);
+    spiBaseAddress->TASKS_START = 1;
 
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
+    while (spiBaseAddress->EVENTS_END == 0)
+      ;
+    data += currentSize;
+    dataSize -= currentSize;
+  }
   nrf_gpio_pin_set(this->pinCsn);
 
   xSemaphoreGive(mutex);
@@ -283,11 +313,17 @@ bool SpiMaster::WriteCmdAndBuffer(uint8_t pinCsn, const uint8_t* cmd, size_t cmd
   while (spiBaseAddress->EVENTS_END == 0)
     ;
 
-  PrepareTx((uint32_t) data, dataSize);
-  spiBaseAddress->TASKS_START = 1;
+  // EasyDMA transfers are at most 255 bytes (e.g. a whole 256-byte flash page takes two)
+  while (dataSize > 0) {
+    auto currentSize = std::min((size_t) 255, dataSize);
+    PrepareTx((uint32_t) data, currentSize);
+    spiBaseAddress->TASKS_START = 1;
 
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
+    while (spiBaseAddress->EVENTS_END == 0)
+      ;
+    data += currentSize;
+    dataSize -= currentSize;
+  }
   nrf_gpio_pin_set(this->pinCsn);
 
   xSemaphoreGive(mutex);
@@ -5,6 +5,10 @@
 #include <FreeRTOS.h>
 #include <semphr.h>
 #include <task.h>
+#include "cueband.h"
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+#include "components/timing/frametiming.h"
+#endif
 
 namespace Pinetime {
   namespace Drivers {
@@ -29,12 +33,20 @@ namespace Pinetime {
       SpiMaster(SpiMaster&&) = delete;
       SpiMaster& operator=(SpiMaster&&) = delete;
 
+      // Called from the end-of-transfer interrupt once an asynchronous Write() has completed
+      using TransferCompleteCallback = void (*)(void* context);
+
       bool Init();
-      bool Write(uint8_t pinCsn, const uint8_t* data, size_t size);
+      bool Write(uint8_t pinCsn, const uint8_t* data, size_t size, TransferCompleteCallback onComplete = nullptr, void* context = nullptr);
       bool Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize);
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+      void TimeTransfers(uint8_t pinCsn) { timedPinCsn = pinCsn; }
+#endif
 
       bool WriteCmdAndBuffer(uint8_t pinCsn, const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize);
 
+      void WaitIdle();
+
       void OnStartedEvent();
       void OnEndEvent();
 
@@ -59,6 +71,12 @@ namespace Pinetime {
       volatile uint32_t currentBufferAddr = 0;
       volatile size_t currentBufferSize = 0;
       volatile TaskHandle_t taskToNotify;
+      volatile TransferCompleteCallback onComplete = nullptr;
+      void* volatile onCompleteContext = nullptr;
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+      frame_timing_mark_t transferStart = {};
+      uint8_t timedPinCsn = 0xff;   // Only transfers to this device are timed (the display)
+#endif
       SemaphoreHandle_t mutex = nullptr;
     };
   }
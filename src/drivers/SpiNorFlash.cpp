@@ -3,6 +3,7 @@
 #include <libraries/delay/nrf_delay.h>
 #include <libraries/log/nrf_log.h>
 #include "drivers/Spi.h"
+#include "cueband.h"
 
 using namespace Pinetime::Drivers;
 
@@ -21,6 +22,7 @@ void SpiNorFlash::Uninit() {
 }
 
 void SpiNorFlash::Sleep() {
+  WaitWriteComplete();
   auto cmd = static_cast<uint8_t>(Commands::DeepPowerDown);
   spi.Write(&cmd, sizeof(uint8_t));
   NRF_LOG_INFO("[SpiNorFlash] Sleep")
@@ -71,11 +73,22 @@ uint8_t SpiNorFlash::ReadConfigurationRegister() {
 }
 
 void SpiNorFlash::Read(uint32_t address, uint8_t* buffer, size_t size) {
+  WaitWriteComplete();
+  // The whole range is read by one command (the SPI master continues the transfer across DMA segments)
+#ifdef CUEBAND_SPI_FLASH_FAST_READ
+  static constexpr uint8_t cmdSize = 5;
+  uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::FastRead),
+                          static_cast<uint8_t>(address >> 16U),
+                          static_cast<uint8_t>(address >> 8U),
+                          static_cast<uint8_t>(address),
+                          0x00}; // Dummy byte
+#else
   static constexpr uint8_t cmdSize = 4;
   uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::Read),
                           static_cast<uint8_t>(address >> 16U),
                           static_cast<uint8_t>(address >> 8U),
                           static_cast<uint8_t>(address)};
+#endif
   spi.Read(reinterpret_cast<uint8_t*>(&cmd), cmdSize, buffer, size);
 }
 
@@ -85,20 +98,56 @@ void SpiNorFlash::WriteEnable() {
 }
 
 void SpiNorFlash::SectorErase(uint32_t sectorAddress) {
+  SectorEraseStart(sectorAddress);
+  WaitWriteComplete();
+}
+
+void SpiNorFlash::SectorEraseStart(uint32_t sectorAddress) {
   static constexpr uint8_t cmdSize = 4;
   uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::SectorErase),
                           static_cast<uint8_t>(sectorAddress >> 16U),
                           static_cast<uint8_t>(sectorAddress >> 8U),
                           static_cast<uint8_t>(sectorAddress)};
 
+  WaitWriteComplete();
   WriteEnable();
   while (!WriteEnabled())
     vTaskDelay(1);
 
   spi.Read(reinterpret_cast<uint8_t*>(&cmd), cmdSize, nullptr, 0);
+  writePending = true;
+}
+
+void SpiNorFlash::PageProgramStart(uint32_t address, const uint8_t* buffer, size_t size) {
+  static constexpr uint8_t cmdSize = 4;
+  uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::PageProgram),
+                          static_cast<uint8_t>(address >> 16U),
+                          static_cast<uint8_t>(address >> 8U),
+                          static_cast<uint8_t>(address)};
+
+  WaitWriteComplete();
+  WriteEnable();
+  while (!WriteEnabled())
+    vTaskDelay(1);
+
+  spi.WriteCmdAndBuffer(cmd, cmdSize, buffer, size);
+  writePending = true;
+}
+
+// Whether an erase or program started by this driver is still in progress
+bool SpiNorFlash::WritePending() {
+  if (writePending && !WriteInProgress()) {
+    writePending = false;
+  }
+  return writePending;
+}
 
+void SpiNorFlash::WaitWriteComplete() {
+  if (!writePending)
+    return;
   while (WriteInProgress())
     vTaskDelay(1);
+  writePending = false;
 }
 
 uint8_t SpiNorFlash::ReadSecurityRegister() {
@@ -117,8 +166,6 @@ bool SpiNorFlash::EraseFailed() {
 }
 
 void SpiNorFlash::Write(uint32_t address, const uint8_t* buffer, size_t size) {
-  static constexpr uint8_t cmdSize = 4;
-
   size_t len = size;
   uint32_t addr = address;
   const uint8_t* b = buffer;
@@ -126,19 +173,8 @@ void SpiNorFlash::Write(uint32_t address, const uint8_t* buffer, size_t size) {
     uint32_t pageLimit = (addr & ~(pageSize - 1u)) + pageSize;
     uint32_t toWrite = pageLimit - addr > len ? len : pageLimit - addr;
 
-    uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::PageProgram),
-                            static_cast<uint8_t>(addr >> 16U),
-                            static_cast<uint8_t>(addr >> 8U),
-                            static_cast<uint8_t>(addr)};
-
-    WriteEnable();
-    while (!WriteEnabled())
-      vTaskDelay(1);
-
-    spi.WriteCmdAndBuffer(cmd, cmdSize, b, toWrite);
-
-    while (WriteInProgress())
-      vTaskDelay(1);
+    PageProgramStart(addr, b, toWrite);
+    WaitWriteComplete();
 
     addr += toWrite;
     b += toWrite;
@@ -28,10 +28,18 @@ namespace Pinetime {
       void Write(uint32_t address, const uint8_t* buffer, size_t size);
       void WriteEnable();
       void SectorErase(uint32_t sectorAddress);
+      // Start a sector erase, or a program within one page, returning while the flash is busy (other calls wait for it)
+      void SectorEraseStart(uint32_t sectorAddress);
+      void PageProgramStart(uint32_t address, const uint8_t* buffer, size_t size);
+      bool WritePending();
+      void WaitWriteComplete();
       uint8_t ReadSecurityRegister();
       bool ProgramFailed();
       bool EraseFailed();
 
+      static constexpr uint16_t pageSize = 256;
+      static constexpr uint32_t sectorSize = 0x1000;
+
       void Init();
       void Uninit();
 
@@ -42,6 +50,7 @@ namespace Pinetime {
       enum class Commands : uint8_t {
         PageProgram = 0x02,
         Read = 0x03,
+        FastRead = 0x0B,
         ReadStatusRegister = 0x05,
         WriteEnable = 0x06,
         ReadConfigurationRegister = 0x15,
@@ -51,10 +60,10 @@ namespace Pinetime {
         ReleaseFromDeepPowerDown = 0xAB,
         DeepPowerDown = 0xB9
       };
-      static constexpr uint16_t pageSize = 256;
 
       Spi& spi;
       Identification device_id;
+      bool writePending = false;
     };
   }
 }
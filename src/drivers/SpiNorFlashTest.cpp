@@ -0,0 +1,229 @@
+// Host test: runs drivers/SpiNorFlash.cpp against a simulated SPI NOR flash (4 MB, 256-byte pages, 4 KB sectors) behind
+// a stand-in SPI bus (test/drivers/Spi.h, one call per chip-select framed transaction).  The device checks the command
+// sequencing (write enable before program/erase, nothing but status reads while busy, no page program crossing a page
+// boundary, the read command's address and dummy bytes), that busy polling yields (vTaskDelay) between status reads,
+// and the data; and reports the simulated time.  Build with -DCUEBAND_SPI_FLASH_FAST_READ for the Fast Read variant.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "drivers/SpiNorFlash.h"
+#include "drivers/Spi.h"
+
+using namespace Pinetime::Drivers;
+
+#define FLASH_SIZE (4 * 1024 * 1024)
+#define PAGE_SIZE 256
+#define SECTOR_SIZE 4096
+
+// Flash timing (typical datasheet values for 4 KB erase and 256-byte page program), SPI at 8 MHz
+#define ERASE_US 45000.0
+#define PROGRAM_BASE_US 100.0
+#define PROGRAM_PAGE_US 600.0       // ...plus this scaled by the fraction of the page programmed
+#define SPI_BYTE_US 1.0
+#define SPI_CALL_US 10.0
+#define TICK_US (1000000.0 / 1024)  // vTaskDelay(1)
+
+#ifdef CUEBAND_SPI_FLASH_FAST_READ
+#define READ_OPCODE 0x0B
+#define READ_CMD_SIZE 5
+#else
+#define READ_OPCODE 0x03
+#define READ_CMD_SIZE 4
+#endif
+
+static const uint8_t identification[] = {0x0b, 0x40, 0x16};
+static uint8_t memory[FLASH_SIZE];
+static double simNow;               // us
+static double busyUntil;
+static bool writeEnableLatch;
+static unsigned int busyPolls;      // Consecutive status reads while busy without yielding
+
+static unsigned int violations;
+static unsigned int transactions;
+static unsigned int readCommands;
+static unsigned int programs;
+static unsigned int erases;
+static unsigned int statusReads;
+static unsigned int delays;
+
+static void violation(const char *message, uint32_t address) {
+  if (violations < 10) printf("VIOLATION: %s (0x%06x)\n", message, (unsigned int)address);
+  violations++;
+}
+
+void vTaskDelay(uint32_t ticks) {
+  simNow += ticks * TICK_US;
+  busyPolls = 0;
+  delays++;
+}
+
+bool Spi::Transfer(const uint8_t* cmd, size_t cmdSize, const uint8_t* out, size_t outSize, uint8_t* in, size_t inSize) {
+  simNow += SPI_CALL_US + (cmdSize + outSize + inSize) * SPI_BYTE_US;
+  transactions++;
+  if (cmdSize < 1) {
+    violation("empty transaction", 0);
+    return false;
+  }
+
+  bool busy = simNow < busyUntil;
+  uint8_t opcode = cmd[0];
+  uint32_t address = (cmdSize >= 4) ? ((uint32_t)cmd[1] << 16) | ((uint32_t)cmd[2] << 8) | cmd[3] : 0;
+
+  if (opcode == 0x05) {  // Read Status Register
+    statusReads++;
+    // (a one-off WritePending() may be followed by the first poll of a wait)
+    busyPolls = busy ? busyPolls + 1 : 0;
+    if (busyPolls > 2) violation("status polled without yielding", 0);
+    uint8_t status = (busy ? 0x01 : 0x00) | ((writeEnableLatch || busy) ? 0x02 : 0x00);
+    for (size_t i = 0; i < inSize; i++) in[i] = status;
+    return true;
+  }
+  busyPolls = 0;
+  if (busy) {
+    violation("command while busy", address);
+    return true;  // Ignored by the device
+  }
+  if (busyUntil > 0) {
+    busyUntil = 0;
+    writeEnableLatch = false;  // Cleared on completion of a program or erase
+  }
+
+  switch (opcode) {
+    case 0x06:  // Write Enable
+      writeEnableLatch = true;
+      break;
+
+    case 0x03:  // Read
+    case 0x0B:  // Fast Read
+      readCommands++;
+      if (opcode != READ_OPCODE || cmdSize != READ_CMD_SIZE) violation("unexpected read command", address);
+      if (outSize != 0) violation("data sent with read command", address);
+      for (size_t i = 0; i < inSize; i++) in[i] = memory[(address + i) % FLASH_SIZE];
+      break;
+
+    case 0x02:  // Page Program
+      programs++;
+      if (!writeEnableLatch) {
+        violation("page program without write enable", address);
+        break;
+      }
+      if (cmdSize != 4 || outSize == 0) violation("malformed page program", address);
+      if ((address % PAGE_SIZE) + outSize > PAGE_SIZE) violation("page program crosses a page boundary", address);
+      for (size_t i = 0; i < outSize; i++) {
+        // Addresses wrap within the page (as the device)
+        uint32_t a = (address & ~(uint32_t)(PAGE_SIZE - 1)) | ((address + i) % PAGE_SIZE);
+        memory[a % FLASH_SIZE] &= out[i];
+      }
+      busyUntil = simNow + PROGRAM_BASE_US + PROGRAM_PAGE_US * (outSize > PAGE_SIZE ? PAGE_SIZE : outSize) / PAGE_SIZE;
+      break;
+
+    case 0x20:  // Sector Erase
+      erases++;
+      if (!writeEnableLatch) {
+        violation("sector erase without write enable", address);
+        break;
+      }
+      if (cmdSize != 4 || outSize != 0) violation("malformed sector erase", address);
+      memset(memory + (address % FLASH_SIZE) / SECTOR_SIZE * SECTOR_SIZE, 0xff, SECTOR_SIZE);
+      busyUntil = simNow + ERASE_US;
+      break;
+
+    case 0x9F:  // Read Identification
+      for (size_t i = 0; i < inSize; i++) in[i] = (i < sizeof(identification)) ? identification[i] : 0;
+      break;
+
+    case 0x15:  // Read Configuration Register
+    case 0x2B:  // Read Security Register
+      for (size_t i = 0; i < inSize; i++) in[i] = 0;
+      break;
+
+    case 0xAB:  // Release from Deep Power-Down
+    case 0xB9:  // Deep Power-Down
+      break;
+
+    default:
+      violation("unknown command", opcode);
+      break;
+  }
+  return true;
+}
+
+static double startTime;
+
+static void resetCounters() {
+  startTime = simNow;
+  transactions = readCommands = programs = erases = statusReads = delays = 0;
+}
+
+static bool check(bool ok, const char *name) {
+  printf("%s: %s\n", ok ? "OK" : "FAIL", name);
+  return ok;
+}
+
+int main(int argc, char *argv[]) {
+  static uint8_t data[3 * SECTOR_SIZE];
+  static uint8_t buffer[3 * SECTOR_SIZE];
+  int failures = 0;
+
+  memset(memory, 0x5a, sizeof(memory));  // Not erased
+  srand(1);
+  for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)rand();
+
+  Spi spi;
+  SpiNorFlash flash(spi);
+  flash.Init();
+
+  // Erase, then read the three sectors back with one command
+  resetCounters();
+  for (uint32_t sector = 0; sector < 3; sector++) flash.SectorErase(sector * SECTOR_SIZE);
+  double eraseUs = (simNow - startTime) / 3;
+  resetCounters();
+  flash.Read(0, buffer, sizeof(buffer));
+  bool blank = true;
+  for (size_t i = 0; i < sizeof(buffer); i++) if (buffer[i] != 0xff) blank = false;
+  failures += !check(blank && readCommands == 1, "erase and read back 12 KB in one read command");
+  printf("    erase %.1f ms/sector, read %.2f ms/KB (%u transaction(s))\n", eraseUs / 1000, (simNow - startTime) / 1000 / (sizeof(buffer) / 1024.0), transactions);
+
+  // Unaligned write spanning several pages: one program per page touched, none crossing a page boundary
+  const uint32_t address = 0x1f0;
+  const size_t size = 3000;
+  resetCounters();
+  flash.Write(address, data, size);
+  unsigned int pages = (address + size + PAGE_SIZE - 1) / PAGE_SIZE - address / PAGE_SIZE;
+  printf("    write %u bytes: %u page programs, %.2f ms/page, %u status reads, %u yields\n", (unsigned int)size, programs, (simNow - startTime) / 1000 / programs, statusReads, delays);
+  failures += !check(programs == pages, "one page program per page");
+  resetCounters();
+  flash.Read(0, buffer, sizeof(buffer));
+  bool same = memcmp(buffer + address, data, size) == 0;
+  for (size_t i = 0; i < sizeof(buffer); i++) if ((i < address || i >= address + size) && buffer[i] != 0xff) same = false;
+  failures += !check(same && readCommands == 1, "written data reads back, neighbouring bytes untouched");
+
+  // A read straight after starting a program or erase waits for it
+  flash.SectorErase(SECTOR_SIZE);
+  flash.PageProgramStart(SECTOR_SIZE + 0x40, data, 16);
+  flash.Read(SECTOR_SIZE + 0x40, buffer, 16);
+  bool waited = memcmp(buffer, data, 16) == 0;
+  flash.SectorEraseStart(2 * SECTOR_SIZE);
+  bool pending = flash.WritePending();
+  flash.Write(2 * SECTOR_SIZE + PAGE_SIZE - 8, data, 16);
+  flash.Read(2 * SECTOR_SIZE + PAGE_SIZE - 8, buffer, 16);
+  waited = waited && pending && memcmp(buffer, data, 16) == 0 && !flash.WritePending();
+  failures += !check(waited, "reads and writes wait for a program or erase in progress");
+
+  failures += !check(violations == 0, "command sequencing");
+
+  // The device model itself flags a program without write enable, and one crossing a page boundary
+  unsigned int before = violations;
+  uint8_t cmd[4] = {0x02, 0x00, 0x00, 0xf0};
+  spi.WriteCmdAndBuffer(cmd, sizeof(cmd), data, 32);
+  flash.WriteEnable();
+  spi.WriteCmdAndBuffer(cmd, sizeof(cmd), data, 32);
+  flash.WaitWriteComplete();
+  failures += !check(violations == before + 2, "simulated device detects sequencing errors");
+
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures ? 1 : 0;
+}
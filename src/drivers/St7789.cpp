@@ -3,6 +3,10 @@
 #include <libraries/delay/nrf_delay.h>
 #include <nrfx_log.h>
 #include "drivers/Spi.h"
+#include "cueband.h"
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+#include "components/timing/frametiming.h"
+#endif
 
 using namespace Pinetime::Drivers;
 
@@ -11,6 +15,9 @@ St7789::St7789(Spi& spi, uint8_t pinDataCommand) : spi {spi}, pinDataCommand {pi
 
 void St7789::Init() {
   spi.Init();
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+  spi.TimeTransfers();  // The SPI transfer histogram is of display transfers only
+#endif
   nrf_gpio_cfg_output(pinDataCommand);
   nrf_gpio_cfg_output(26);
   nrf_gpio_pin_set(26);
@@ -27,7 +34,16 @@ void St7789::Init() {
   DisplayOn();
 }
 
+void St7789::WaitDataTransfer() {
+  // The data/command pin must not change while pixel data may still be transferring
+  if (dataPending) {
+    spi.WaitIdle();
+    dataPending = false;
+  }
+}
+
 void St7789::WriteCommand(uint8_t cmd) {
+  WaitDataTransfer();
   nrf_gpio_pin_clear(pinDataCommand);
   WriteSpi(&cmd, 1);
 }
@@ -156,12 +172,27 @@ void St7789::DrawPixel(uint16_t x, uint16_t y, uint32_t color) {
 
   nrf_gpio_pin_set(pinDataCommand);
   WriteSpi(reinterpret_cast<const uint8_t*>(&color), 2);
-}
-
-void St7789::DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* data, size_t size) {
+  dataPending = true;
+}
+
+void St7789::DrawBuffer(uint16_t x,
+                        uint16_t y,
+                        uint16_t width,
+                        uint16_t height,
+                        const uint8_t* data,
+                        size_t size,
+                        SpiMaster::TransferCompleteCallback onComplete,
+                        void* context) {
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+  frame_timing_mark_t start = frame_timing_mark();
+#endif
   SetAddrWindow(x, y, x + width - 1, y + height - 1);
   nrf_gpio_pin_set(pinDataCommand);
-  WriteSpi(data, size);
+  spi.Write(data, size, onComplete, context);
+  dataPending = true;
+#ifdef CUEBAND_DEBUG_FRAME_TIMING
+  frame_timing_record(FRAME_TIMING_DRAW_BUFFER, start);
+#endif
 }
 
 void St7789::HardwareReset() {
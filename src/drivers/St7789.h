@@ -1,6 +1,7 @@
 #pragma once
 #include <cstddef>
 #include <cstdint>
+#include "drivers/SpiMaster.h"
 
 namespace Pinetime {
   namespace Drivers {
@@ -20,7 +21,15 @@ namespace Pinetime {
       void VerticalScrollDefinition(uint16_t topFixedLines, uint16_t scrollLines, uint16_t bottomFixedLines);
       void VerticalScrollStartAddress(uint16_t line);
 
-      void DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* data, size_t size);
+      // Returns once the pixel data transfer has started; onComplete (if any) is called from the interrupt when it ends
+      void DrawBuffer(uint16_t x,
+                      uint16_t y,
+                      uint16_t width,
+                      uint16_t height,
+                      const uint8_t* data,
+                      size_t size,
+                      SpiMaster::TransferCompleteCallback onComplete = nullptr,
+                      void* context = nullptr);
 
       void Sleep();
       void Wakeup();
@@ -29,6 +38,7 @@ namespace Pinetime {
       Spi& spi;
       uint8_t pinDataCommand;
       uint8_t verticalScrollingStartAddress = 0;
+      bool dataPending = false;
 
       void HardwareReset();
       void SoftwareReset();
@@ -45,6 +55,7 @@ namespace Pinetime {
       void SetAddrWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
       void SetVdv();
       void WriteCommand(uint8_t cmd);
+      void WaitDataTransfer();
       void WriteSpi(const uint8_t* data, size_t size);
 
       enum class Commands : uint8_t {
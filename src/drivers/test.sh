@@ -0,0 +1,3 @@
+gcc -c Bma421_C/bma4.c -o ./bma4.o && g++ -I.. Bma421FifoTest.cpp Bma421Fifo.cpp ./bma4.o -o ./bma421fifotest && ./bma421fifotest "$@"
+g++ -O2 -Itest -I.. SpiNorFlashTest.cpp SpiNorFlash.cpp -o ./spinorflashtest && ./spinorflashtest
+g++ -O2 -Itest -I.. -DCUEBAND_SPI_FLASH_FAST_READ SpiNorFlashTest.cpp SpiNorFlash.cpp -o ./spinorflashtest && ./spinorflashtest
@@ -0,0 +1,6 @@
+// Minimal host stand-in for FreeRTOS, only sufficient to compile SpiNorFlash.cpp for the simulated flash test
+#pragma once
+
+#include <stdint.h>
+
+void vTaskDelay(uint32_t ticks);    // Defined by the test (advances simulated time)
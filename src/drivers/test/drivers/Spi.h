@@ -0,0 +1,28 @@
+// Host stand-in for the SPI bus: each call is one chip-select framed transaction, handled by the test's simulated device
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include <task.h>
+
+namespace Pinetime {
+  namespace Drivers {
+    class Spi {
+    public:
+      bool Write(const uint8_t* data, size_t size) {
+        return Transfer(data, size, nullptr, 0, nullptr, 0);
+      }
+      bool Read(uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize) {
+        return Transfer(cmd, cmdSize, nullptr, 0, data, dataSize);
+      }
+      bool WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize) {
+        return Transfer(cmd, cmdSize, data, dataSize, nullptr, 0);
+      }
+
+    private:
+      // Defined by the test
+      bool Transfer(const uint8_t* cmd, size_t cmdSize, const uint8_t* out, size_t outSize, uint8_t* in, size_t inSize);
+    };
+  }
+}
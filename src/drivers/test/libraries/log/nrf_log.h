@@ -0,0 +1,7 @@
+// Minimal host stand-in for the nRF logging macros
+#pragma once
+
+#define NRF_LOG_INFO(...)
+#define NRF_LOG_WARNING(...)
+#define NRF_LOG_ERROR(...)
+#define NRF_LOG_DEBUG(...)
@@ -59,7 +59,7 @@ int HeartRateTask::HrStats(int *meanBpm, int *minBpm, int *maxBpm, bool clear) {
 #endif
 
 void HeartRateTask::Work() {
-  int lastBpm = 0;
+  lastBpm = 0;
   while (true) {
     Messages msg;
     uint32_t delay;
@@ -124,67 +124,84 @@ void HeartRateTask::Work() {
     }
 
     if (measurementStarted) {
-#ifdef CUEBAND_BUFFER_RAW_HR
       uint32_t hrs = heartRateSensor.ReadHrs();
       uint32_t als = heartRateSensor.ReadAls();
-      int8_t ambient = ppg.Preprocess(hrs, als);
-#else
-      int8_t ambient = ppg.Preprocess(heartRateSensor.ReadHrs(), heartRateSensor.ReadAls());
-#endif
-      auto bpm = ppg.HeartRate();
-
-      // If ambient light detected or a reset requested (bpm < 0)
-      if (ambient > 0) {
-        // Reset all DAQ buffers
-        ppg.Reset(true);
-        // Force state to NotEnoughData (below)
-        lastBpm = 0;
-        bpm = 0;
-      } else if (bpm < 0) {
-        // Reset all DAQ buffers except HRS buffer
-        ppg.Reset(false);
-        // Set HR to zero and update
-        bpm = 0;
-        controller.Update(Controllers::HeartRateController::States::Running, bpm);
-      }
+      ProcessSample(hrs, als);
+    }
+  }
+}
 
-      if (lastBpm == 0 && bpm == 0) {
-        controller.Update(Controllers::HeartRateController::States::NotEnoughData, bpm);
-      }
+// Process a sensor sample through the PPG and update the controller state (separate from Work() so it can be replayed on the host)
+int HeartRateTask::ProcessSample(uint32_t hrs, uint32_t als) {
+  int8_t ambient = ppg.Preprocess(hrs, als);
+#ifdef CUEBAND_HR_EPOCH
+  bool estimated = ppg.WindowReady();
+#endif
+  auto bpm = ppg.HeartRate();
+
+  // If ambient light detected or a reset requested (bpm < 0)
+  if (ambient > 0) {
+    // Reset all DAQ buffers
+    ppg.Reset(true);
+    // Force state to NotEnoughData (below)
+    lastBpm = 0;
+    bpm = 0;
+#ifdef CUEBAND_HR_EPOCH
+    stableCount = 0;
+#endif
+  } else if (bpm < 0) {
+    // Reset all DAQ buffers except HRS buffer
+    ppg.Reset(false);
+    // Set HR to zero and update
+    bpm = 0;
+    controller.Update(Controllers::HeartRateController::States::Running, bpm);
+  }
 
-      if (bpm != 0) {
-        lastBpm = bpm;
-        controller.Update(Controllers::HeartRateController::States::Running, lastBpm);
+  if (lastBpm == 0 && bpm == 0) {
+    controller.Update(Controllers::HeartRateController::States::NotEnoughData, bpm);
+  }
+
+  if (bpm != 0) {
+    lastBpm = bpm;
+    controller.Update(Controllers::HeartRateController::States::Running, lastBpm);
 #ifdef CUEBAND_BUFFER_RAW_HR
 lastMeasurement = lastBpm;
 lastMeasurementAge = 0;
 #endif
-      }
+  }
 
 #ifdef CUEBAND_HR_EPOCH
-      // Add HR stats
-      if (IsHrEpoch() && bpm > 0) {
-        if (countBpm == 0 || bpm < minBpm) minBpm = bpm;
-        if (countBpm == 0 || bpm > maxBpm) maxBpm = bpm;
-        sumBpm += bpm;
-        countBpm++;
-      }
+  // Add HR stats
+  if (IsHrEpoch() && bpm > 0) {
+    if (countBpm == 0 || bpm < minBpm) minBpm = bpm;
+    if (countBpm == 0 || bpm > maxBpm) maxBpm = bpm;
+    sumBpm += bpm;
+    countBpm++;
+    // Track consecutive stable readings
+    int delta = bpm - stableBpm;
+    if (stableCount > 0 && delta >= -CUEBAND_HR_STABLE_TOLERANCE && delta <= CUEBAND_HR_STABLE_TOLERANCE) stableCount++;
+    else stableCount = 1;
+    stableBpm = bpm;
+  } else if (IsHrEpoch() && estimated) {
+    // A lost reading (the window was analysed, but no valid estimate) breaks the stable run
+    stableCount = 0;
+  }
 #endif
 
 #ifdef CUEBAND_BUFFER_RAW_HR
-      if (lastMeasurementAge++ > 10 * 25) {
-        lastMeasurementAge = 0;
-        lastMeasurement = 0;
-      }
+  if (lastMeasurementAge++ > 10 * 25) {
+    lastMeasurementAge = 0;
+    lastMeasurement = 0;
+  }
 #if 1   // Include BPM and companded ALS (only suitable for rough inspection), rather than raw ALS
-      uint32_t hrmValue = (lastMeasurement << 24) | ((uint32_t)compander_compress((uint16_t)als) << 16) | hrs;
+  uint32_t hrmValue = (lastMeasurement << 24) | ((uint32_t)compander_compress((uint16_t)als) << 16) | hrs;
 #else
-      uint32_t hrmValue = (als << 16) | hrs;
+  uint32_t hrmValue = (als << 16) | hrs;
 #endif
-      BufferAdd(hrmValue);
+  BufferAdd(hrmValue);
 #endif
-    }
-  }
+
+  return bpm;
 }
 
 void HeartRateTask::PushMessage(HeartRateTask::Messages msg) {
@@ -202,12 +219,18 @@ void HeartRateTask::StartMeasurement() {
   numSamples = 0;
 #endif
   heartRateSensor.Enable();
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+  sensorEnabled = true;
+#endif
   ppg.Reset(true);
   vTaskDelay(100);
 }
 
 void HeartRateTask::StopMeasurement() {
   heartRateSensor.Disable();
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+  sensorEnabled = false;
+#endif
   ppg.Reset(true);
   vTaskDelay(100);
 #ifdef CUEBAND_BUFFER_RAW_HR
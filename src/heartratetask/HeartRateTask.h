@@ -22,10 +22,17 @@ namespace Pinetime {
       void Start();
       void Work();
       void PushMessage(Messages msg);
+      // Process a sensor sample (called from Work() while measuring), returns the BPM (0 when none)
+      int ProcessSample(uint32_t hrs, uint32_t als);
 
 #ifdef CUEBAND_HR_EPOCH
-      void SetHrEpoch(bool hrEpoch) { this->hrEpoch = hrEpoch; }
+      void SetHrEpoch(bool hrEpoch) {
+        if (hrEpoch && !this->hrEpoch) stableCount = 0;
+        this->hrEpoch = hrEpoch;
+      }
       bool IsHrEpoch() { return this->hrEpoch; }
+      // Number of consecutive BPM updates in this HR epoch within CUEBAND_HR_STABLE_TOLERANCE of the previous one
+      int HrStableCount() { return stableCount; }
       // Get heart rate tracker stats and clear
       int HrStats(int *meanBpm, int *minBpm, int *maxBpm, bool clear);
       int sumBpm = 0;
@@ -34,6 +41,10 @@ namespace Pinetime {
       int maxBpm = 0;
 #endif
 
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+      bool IsSensorEnabled() const { return sensorEnabled; }
+#endif
+
 #ifdef CUEBAND_BUFFER_RAW_HR
       void SetRawMeasurement(bool rawMeasurement) { this->rawMeasurement = rawMeasurement; }
       bool IsRawMeasurement() { return this->rawMeasurement; }
@@ -58,9 +69,15 @@ namespace Pinetime {
       Controllers::HeartRateController& controller;
       Controllers::Ppg ppg;
       bool measurementStarted = false;
+      int lastBpm = 0;
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+      bool sensorEnabled = false;
+#endif
 
 #ifdef CUEBAND_HR_EPOCH
       bool hrEpoch = false;
+      int stableCount = 0;
+      int stableBpm = 0;
 #endif
 #ifdef CUEBAND_BUFFER_RAW_HR
       bool rawMeasurement = false;
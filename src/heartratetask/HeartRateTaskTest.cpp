@@ -0,0 +1,330 @@
+// Host replay harness for the PPG heart rate estimator and the HeartRateTask state logic.
+// Feeds a recorded (or synthetic) HRS/ALS trace through HeartRateTask::ProcessSample() and reports
+// the BPM time series, time to the first valid reading, error against a reference column, and cost per sample.
+//
+// Trace CSV lines: time,hrs,als[,reference]   (time in seconds, reference BPM optional, non-numeric lines ignored)
+//
+// With -epoch <seconds>, the trace is split into HR sampling windows of that duration (each starting from a fresh
+// measurement, as the device does each hrmInterval). Each window's LED is treated as switched off once the reading is
+// stable for CUEBAND_HR_ADAPTIVE_STABLE updates, reporting the LED-on time saved by adaptive duty cycling.
+// (Extending windows while moving depends on the accelerometer, so is not simulated here.)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <chrono>
+
+#include "heartratetask/HeartRateTask.h"
+#include <drivers/Hrs3300.h>
+#include <components/heartrate/HeartRateController.h>
+
+using namespace Pinetime;
+
+#ifndef CUEBAND_HR_ADAPTIVE_STABLE
+    #define CUEBAND_HR_ADAPTIVE_STABLE 4
+#endif
+
+typedef struct
+{
+    Drivers::Hrs3300 *sensor;
+    Controllers::HeartRateController *controller;
+    Applications::HeartRateTask *task;
+    FILE *output;
+
+    // Adaptive sampling windows (-epoch)
+    double epochSeconds;        // 0 = a single continuous measurement
+    int window;                 // Current window index
+    bool windowStopped;         // Window reached a stable reading (LED off)
+    unsigned int windows;
+    unsigned int windowsStable;
+    double sumStableTime;       // Sum of time to a stable reading for stable windows
+    unsigned int ledOnSamples;
+
+    // HrStats accumulated over windows
+    int statsCount;
+    long statsSum;
+    int statsMin;
+    int statsMax;
+
+    // Results
+    unsigned int samples;
+    double startTime;
+    double lastTime;
+    double firstValidTime;      // < 0 if none
+    unsigned int validSamples;  // Samples while the controller reports a running heart rate
+    unsigned int estimates;     // Number of new BPM estimates (non-zero return from ProcessSample)
+    unsigned int compared;      // Samples with both a valid reading and a reference
+    double sumAbsError;
+    double sumSqError;
+    unsigned int within5;       // Compared samples within +/-5 BPM of the reference
+    double totalMicros;
+    double maxMicros;
+} replay_state_t;
+
+static const char *stateName(Controllers::HeartRateController::States state)
+{
+    switch (state)
+    {
+        case Controllers::HeartRateController::States::Stopped: return "stopped";
+        case Controllers::HeartRateController::States::NotEnoughData: return "not-enough-data";
+        case Controllers::HeartRateController::States::NoTouch: return "no-touch";
+        case Controllers::HeartRateController::States::Running: return "running";
+    }
+    return "?";
+}
+
+void accumulateStats(replay_state_t *state)
+{
+#ifdef CUEBAND_HR_EPOCH
+    int meanBpm, minBpm, maxBpm;
+    int count = state->task->HrStats(&meanBpm, &minBpm, &maxBpm, false);
+    if (count > 0)
+    {
+        if (state->statsCount == 0 || minBpm < state->statsMin) state->statsMin = minBpm;
+        if (state->statsCount == 0 || maxBpm > state->statsMax) state->statsMax = maxBpm;
+        state->statsSum += state->task->sumBpm;
+        state->statsCount += count;
+    }
+#endif
+}
+
+void startWindow(replay_state_t *state)
+{
+    if (state->task != NULL)
+    {
+        accumulateStats(state);
+        delete state->task;
+    }
+    // A fresh task (and PPG state) each window, as the measurement is restarted on the device
+    *state->controller = Controllers::HeartRateController();
+    state->task = new Applications::HeartRateTask(*state->sensor, *state->controller);
+#ifdef CUEBAND_HR_EPOCH
+    state->task->SetHrEpoch(true);
+#endif
+    state->windowStopped = false;
+    state->windows++;
+}
+
+void processSample(replay_state_t *state, double time, uint32_t hrs, uint32_t als, double reference)
+{
+    if (state->samples == 0) state->startTime = time;
+    state->lastTime = time;
+    state->samples++;
+
+    if (state->epochSeconds > 0)
+    {
+        int window = (int)floor((time - state->startTime) / state->epochSeconds);
+        if (state->task == NULL || window != state->window)
+        {
+            state->window = window;
+            startWindow(state);
+        }
+        if (state->windowStopped) return;
+    }
+    else if (state->task == NULL)
+    {
+        startWindow(state);
+    }
+    state->ledOnSamples++;
+
+    auto start = std::chrono::steady_clock::now();
+    int bpm = state->task->ProcessSample(hrs, als);
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    state->totalMicros += micros;
+    if (micros > state->maxMicros) state->maxMicros = micros;
+
+    if (bpm != 0) state->estimates++;
+
+    bool valid = state->controller->State() == Controllers::HeartRateController::States::Running && state->controller->HeartRate() > 0;
+    int reading = valid ? state->controller->HeartRate() : 0;
+    if (valid)
+    {
+        state->validSamples++;
+        if (state->firstValidTime < 0) state->firstValidTime = time - state->startTime;
+        if (reference > 0)
+        {
+            double error = reading - reference;
+            state->compared++;
+            state->sumAbsError += fabs(error);
+            state->sumSqError += error * error;
+            if (fabs(error) <= 5) state->within5++;
+        }
+    }
+
+#ifdef CUEBAND_HR_EPOCH
+    if (state->epochSeconds > 0 && state->task->HrStableCount() >= CUEBAND_HR_ADAPTIVE_STABLE)
+    {
+        state->windowStopped = true;
+        state->windowsStable++;
+        state->sumStableTime += time - state->startTime - state->window * state->epochSeconds;
+    }
+#endif
+
+    if (state->output != NULL)
+    {
+        fprintf(state->output, "%.3f,%u,%u,%d,%d,%s,%.1f\n", time, hrs, als, bpm, reading, stateName(state->controller->State()), reference);
+    }
+}
+
+int processFile(replay_state_t *state, const char *traceFile)
+{
+    FILE *fp = fopen(traceFile, "rt");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "ERROR: Problem opening trace file: %s\n", traceFile);
+        return -1;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        double time = 0, reference = 0;
+        unsigned int hrs = 0, als = 0;
+        int fields = sscanf(line, "%lf,%u,%u,%lf", &time, &hrs, &als, &reference);
+        if (fields < 3) continue;   // Header or comment
+        if (fields < 4) reference = 0;
+        processSample(state, time, hrs, als, reference);
+    }
+
+    fclose(fp);
+    return 0;
+}
+
+// Synthetic trace: pulse waveform with respiratory wander and noise, and a few seconds of bright ambient light part way through
+void processSynthetic(replay_state_t *state, double bpm, double seconds)
+{
+    srand(1);
+    double interval = Controllers::Ppg::deltaTms / 1000.0;
+    for (int i = 0; i * interval < seconds; i++)
+    {
+        double t = i * interval;
+        double phase = 2 * M_PI * bpm / 60 * t;
+        double value = 3000 + 40 * sin(phase) + 12 * sin(2 * phase + 1) + 20 * sin(2 * M_PI * 0.25 * t) + 8 * ((rand() % 1000) / 500.0 - 1);
+        bool ambient = t >= seconds / 2 && t < seconds / 2 + 5;
+        uint32_t als = ambient ? 5000 : 10;
+        processSample(state, t, (uint32_t)value, als, ambient ? 0 : bpm);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const char *traceFile = NULL;
+    const char *outputFile = NULL;
+    double syntheticBpm = 0;
+    double syntheticSeconds = 120;
+    double epochSeconds = 0;
+    int positional = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-input") && i + 1 < argc)
+        {
+            traceFile = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-output") && i + 1 < argc)
+        {
+            outputFile = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-synthetic") && i + 1 < argc)
+        {
+            syntheticBpm = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-seconds") && i + 1 < argc)
+        {
+            syntheticSeconds = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-epoch") && i + 1 < argc)
+        {
+            epochSeconds = atof(argv[++i]);
+        }
+        else if (argv[i][0] == '-')
+        {
+            fprintf(stderr, "ERROR: Unrecognized parameter: %s\n", argv[i]);
+            return -1;
+        }
+        else
+        {
+            if (positional == 0)
+            {
+                traceFile = argv[i];
+            }
+            else
+            {
+                fprintf(stderr, "ERROR: Unexpected positional parameter %d: %s\n", i + 1, argv[i]);
+                return -1;
+            }
+            positional++;
+        }
+    }
+
+    if (traceFile == NULL && syntheticBpm <= 0)
+    {
+        fprintf(stderr, "Usage: %s [-input] trace.csv | -synthetic <bpm> [-seconds 120]  [-epoch seconds] [-output bpm.csv]\n", argv[0]);
+        return -1;
+    }
+
+    static Drivers::Hrs3300 sensor;
+    static Controllers::HeartRateController controller;
+
+    replay_state_t state = {0};
+    state.sensor = &sensor;
+    state.controller = &controller;
+    state.task = NULL;
+    state.firstValidTime = -1;
+    state.epochSeconds = epochSeconds;
+
+    if (outputFile != NULL)
+    {
+        state.output = strcmp(outputFile, "-") ? fopen(outputFile, "wt") : stdout;
+        if (state.output == NULL)
+        {
+            fprintf(stderr, "ERROR: Problem opening output file: %s\n", outputFile);
+            return -1;
+        }
+        fprintf(state.output, "time,hrs,als,estimate,bpm,state,reference\n");
+    }
+
+    if (traceFile != NULL)
+    {
+        if (processFile(&state, traceFile) != 0) return -1;
+    }
+    else
+    {
+        processSynthetic(&state, syntheticBpm, syntheticSeconds);
+    }
+
+    if (state.output != NULL && state.output != stdout) fclose(state.output);
+
+    FILE *report = (state.output == stdout) ? stderr : stdout;
+    fprintf(report, "Samples: %u (%.1f s)\n", state.samples, state.lastTime - state.startTime);
+    if (state.firstValidTime >= 0) fprintf(report, "First valid: %.1f s\n", state.firstValidTime);
+    else fprintf(report, "First valid: (none)\n");
+    fprintf(report, "Valid: %u samples (%.1f%%), %u estimates\n", state.validSamples, state.samples ? 100.0 * state.validSamples / state.samples : 0.0, state.estimates);
+    if (state.compared > 0)
+    {
+        fprintf(report, "Error: MAE %.2f, RMSE %.2f BPM, %.1f%% within 5 BPM (%u compared)\n", state.sumAbsError / state.compared, sqrt(state.sumSqError / state.compared), 100.0 * state.within5 / state.compared, state.compared);
+    }
+    else
+    {
+        fprintf(report, "Error: (no reference)\n");
+    }
+#ifdef CUEBAND_HR_EPOCH
+    if (state.task != NULL) accumulateStats(&state);
+    if (state.statsCount > 0) fprintf(report, "HrStats: count %d, mean %d, min %d, max %d\n", state.statsCount, (int)(state.statsSum / state.statsCount), state.statsMin, state.statsMax);
+    else fprintf(report, "HrStats: count 0\n");
+    if (state.epochSeconds > 0)
+    {
+        double interval = Controllers::Ppg::deltaTms / 1000.0;
+        fprintf(report, "Adaptive: %u/%u windows stable (mean %.1f s), LED-on %.1f s of %.1f s (%.1f%% saved)\n", state.windowsStable, state.windows, state.windowsStable ? state.sumStableTime / state.windowsStable : 0.0, state.ledOnSamples * interval, state.samples * interval, state.samples ? 100.0 * (state.samples - state.ledOnSamples) / state.samples : 0.0);
+    }
+#endif
+    fprintf(report, "Cost: %.2f us/sample mean, %.2f us max (host), Ppg %u bytes\n", state.samples ? state.totalMicros / state.samples : 0.0, state.maxMicros, (unsigned int)sizeof(Controllers::Ppg));
+
+    delete state.task;
+
+    return (state.firstValidTime >= 0) ? 0 : 1;
+}
@@ -0,0 +1,12 @@
+# Host replay of the PPG heart rate estimator: builds each PPG variant and runs a trace (default: synthetic 72 BPM)
+# Usage: ./test.sh [-input trace.csv] [-output bpm.csv]   (trace lines: time,hrs,als[,reference])
+set -e
+ARGS="${@:--synthetic 72}"
+SOURCES="HeartRateTaskTest.cpp HeartRateTask.cpp ../components/heartrate/Ppg.cpp"
+FLAGS="-O2 -std=c++17 -Itest -I.. compander.o"
+gcc -O2 -c ../components/activity/compander.c -o compander.o
+if [ -f ../libs/arduinoFFT/src/arduinoFFT.h ]; then
+  g++ $FLAGS $SOURCES -o ./hrtest-float && echo "--- float FFT" && ./hrtest-float $ARGS
+fi
+g++ $FLAGS -DCUEBAND_PPG_FIXED_FFT $SOURCES -o ./hrtest-fixed && echo "--- fixed-point FFT" && ./hrtest-fixed $ARGS
+g++ $FLAGS -DCUEBAND_PPG_SLIDING_DFT $SOURCES -o ./hrtest-sliding && echo "--- sliding DFT" && ./hrtest-sliding $ARGS
@@ -0,0 +1,23 @@
+// Minimal host stand-in for FreeRTOS, only sufficient to compile HeartRateTask.cpp for the replay harness
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef void* TaskHandle_t;
+typedef void* QueueHandle_t;
+typedef long BaseType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS 1
+#define portMAX_DELAY 0xffffffffUL
+
+#define NRF_ERROR_NO_MEM 4
+#define APP_ERROR_HANDLER(_error) ((void)(_error))
+
+static inline QueueHandle_t xQueueCreate(size_t, size_t) { return nullptr; }
+static inline BaseType_t xQueueReceive(QueueHandle_t, void*, uint32_t) { return pdFALSE; }
+static inline BaseType_t xQueueSendFromISR(QueueHandle_t, const void*, BaseType_t* woken) { if (woken) *woken = pdFALSE; return pdPASS; }
+static inline BaseType_t xTaskCreate(void (*)(void*), const char*, uint16_t, void*, int, TaskHandle_t*) { return pdPASS; }
+static inline void vTaskDelay(uint32_t) {}
@@ -0,0 +1,32 @@
+// Host stand-in for the heart rate controller: records the last state update from the task
+#pragma once
+
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Applications {
+    class HeartRateTask;
+  }
+  namespace Controllers {
+    class HeartRateController {
+    public:
+      enum class States { Stopped, NotEnoughData, NoTouch, Running };
+
+      void Update(States newState, uint8_t heartRate) {
+        state = newState;
+        this->heartRate = heartRate;
+        updates++;
+      }
+      void SetHeartRateTask(Applications::HeartRateTask* task) { this->task = task; }
+      States State() const { return state; }
+      uint8_t HeartRate() const { return heartRate; }
+
+      unsigned int updates = 0;
+
+    private:
+      Applications::HeartRateTask* task = nullptr;
+      States state = States::Stopped;
+      uint8_t heartRate = 0;
+    };
+  }
+}
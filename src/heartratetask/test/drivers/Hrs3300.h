@@ -0,0 +1,19 @@
+// Host stand-in for the HRS3300 driver: the replay harness passes samples directly to HeartRateTask::ProcessSample()
+#pragma once
+
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Drivers {
+    class Hrs3300 {
+    public:
+      void Enable() {}
+      void Disable() {}
+      uint32_t ReadHrs() { return hrs; }
+      uint32_t ReadAls() { return als; }
+
+      uint32_t hrs = 0;
+      uint32_t als = 0;
+    };
+  }
+}
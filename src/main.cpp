@@ -4,6 +4,10 @@
 #ifdef CUEBAND_GLOBAL_SCRATCH_BUFFER // HACK: Dubious // 256
 unsigned char cuebandGlobalScratchBuffer[CUEBAND_GLOBAL_SCRATCH_BUFFER] __attribute__((aligned(8)));
 #endif
+#ifdef CUEBAND_SCRATCH_ARENA
+#include "components/scratch/scratch.h"
+static uint8_t scratchArena[SCRATCH_ARENA_SIZE] __attribute__((aligned(SCRATCH_ALIGN)));
+#endif
 
 // nrf
 #include <hal/nrf_rtc.h>
@@ -220,6 +224,12 @@ void nrfx_gpiote_evt_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action
     systemTask.OnTouchEvent();
     return;
   }
+#ifdef CUEBAND_FIFO_WATERMARK
+  if (pin == Pinetime::PinMap::Bma421Irq) {
+    systemTask.OnMotionInterrupt();
+    return;
+  }
+#endif
 
   BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
@@ -355,7 +365,16 @@ void calibrate_lf_clock_rc(nrf_drv_clock_evt_type_t event) {
 }
 
 int main(void) {
+#ifdef CUEBAND_BOOT_STAGES
+  // Time the start-up before the scheduler (the boot stage times count from the scheduler start)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
   logger.Init();
+#ifdef CUEBAND_SCRATCH_ARENA
+  scratch_init(scratchArena, sizeof(scratchArena));
+#endif
 
   nrf_drv_clock_init();
   nrf_drv_clock_lfclk_request(NULL);
@@ -406,6 +425,9 @@ int main(void) {
 
   nimble_port_init();
 
+#ifdef CUEBAND_BOOT_STAGES
+  systemTask.SetBootSchedulerMs(DWT->CYCCNT / (SystemCoreClock / 1000));
+#endif
   vTaskStartScheduler();
 
   for (;;) {
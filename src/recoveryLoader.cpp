@@ -80,7 +80,8 @@ void RefreshWatchdog() {
   NRF_WDT->RR[0] = WDT_RR_RR_Reload;
 }
 
-uint8_t displayBuffer[displayWidth * bytesPerPixel];
+static constexpr uint8_t logoLinesPerDraw = 8;
+uint8_t displayBuffer[2][displayWidth * logoLinesPerDraw * bytesPerPixel] __attribute__((aligned(4)));  // Decoded into one while the other is sent
 void Process(void* instance) {
   RefreshWatchdog();
   APP_GPIOTE_INIT(2);
@@ -121,20 +122,24 @@ void Process(void* instance) {
 
 void DisplayLogo() {
   Pinetime::Tools::RleDecoder rleDecoder(infinitime_nb, sizeof(infinitime_nb));
-  for (int i = 0; i < displayWidth; i++) {
-    rleDecoder.DecodeNext(displayBuffer, displayWidth * bytesPerPixel);
+  int buffer = 0;
+  for (int i = 0; i < displayHeight;) {
+    size_t lines = rleDecoder.DecodeLines(displayBuffer[buffer], displayWidth, logoLinesPerDraw);
+    if (lines == 0) break;
     ulTaskNotifyTake(pdTRUE, 500);
-    lcd.DrawBuffer(0, i, displayWidth, 1, reinterpret_cast<const uint8_t*>(displayBuffer), displayWidth * bytesPerPixel);
+    lcd.DrawBuffer(0, i, displayWidth, lines, reinterpret_cast<const uint8_t*>(displayBuffer[buffer]), displayWidth * lines * bytesPerPixel);
+    i += lines;
+    buffer ^= 1;
   }
 }
 
 void DisplayProgressBar(uint8_t percent, uint16_t color) {
   static constexpr uint8_t barHeight = 20;
-  std::fill(displayBuffer, displayBuffer + (displayWidth * bytesPerPixel), color);
+  std::fill(displayBuffer[0], displayBuffer[0] + (displayWidth * bytesPerPixel), color);
   for (int i = 0; i < barHeight; i++) {
     ulTaskNotifyTake(pdTRUE, 500);
     uint16_t barWidth = std::min(static_cast<float>(percent) * 2.4f, static_cast<float>(displayWidth));
-    lcd.DrawBuffer(0, displayWidth - barHeight + i, barWidth, 1, reinterpret_cast<const uint8_t*>(displayBuffer), barWidth * bytesPerPixel);
+    lcd.DrawBuffer(0, displayWidth - barHeight + i, barWidth, 1, reinterpret_cast<const uint8_t*>(displayBuffer[0]), barWidth * bytesPerPixel);
   }
 }
 
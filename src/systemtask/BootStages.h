@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace System {
+
+    // Start-up stages with declared dependencies, run one at a time from the system task loop (so messages are still
+    // handled between them) as soon as everything they depend on is done.  External stages are completed by an event
+    // rather than run.  Records the tick each stage completed.
+    // Kept free of RTOS dependencies so it can be tested on the host (see BootStagesTest.cpp).
+    template <size_t N> class BootStages {
+      static_assert(N <= 32, "Stages are held in a 32-bit mask");
+
+    public:
+      void Depends(size_t stage, size_t on) {
+        dependencies[stage] |= Bit(on);
+      }
+
+      void External(size_t stage) {
+        external |= Bit(stage);
+      }
+
+      void Done(size_t stage, uint32_t now) {
+        if (done & Bit(stage)) return;
+        done |= Bit(stage);
+        doneTicks[stage] = now;
+      }
+
+      bool IsDone(size_t stage) const {
+        return (done & Bit(stage)) != 0;
+      }
+
+      bool Complete() const {
+        return done == ((N == 32) ? 0xffffffff : Bit(N) - 1);
+      }
+
+      // Next stage to run (not done, not external, its dependencies done), or N if none is ready
+      size_t Next() const {
+        for (size_t stage = 0; stage < N; stage++) {
+          if ((done | external) & Bit(stage)) continue;
+          if ((dependencies[stage] & done) == dependencies[stage]) return stage;
+        }
+        return N;
+      }
+
+      // Ticks the stage completed (0 if not done)
+      uint32_t DoneTicks(size_t stage) const {
+        return IsDone(stage) ? doneTicks[stage] : 0;
+      }
+
+    private:
+      static constexpr uint32_t Bit(size_t stage) {
+        return (uint32_t)1 << stage;
+      }
+
+      uint32_t dependencies[N] = {};
+      uint32_t doneTicks[N] = {};
+      uint32_t done = 0;
+      uint32_t external = 0;
+    };
+  }
+}
@@ -0,0 +1,128 @@
+// Host test: BootStages runs each stage once, only after everything it depends on (including external stages completed by
+// events), one stage per loop iteration -- as SystemTask::RunBootStage() with the cue.band stages -- and, in the system task
+// loop order (the boot stage before the time job), that the activity log never starts before the first time update.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+
+#include "BootStages.h"
+#include "JobScheduler.h"
+
+using namespace Pinetime::System;
+
+static bool check(bool ok, const char *name) {
+  printf("%s: %s\n", ok ? "OK" : "FAIL", name);
+  return ok;
+}
+
+int main(int argc, char *argv[]) {
+  int failures = 0;
+
+  // The cue.band stages: the first loop iteration reads the cues, then (once the time job has run) the activity log
+  {
+    enum BootStage : size_t { BootAdvertising, BootTime, BootCues, BootActivity, BootStageCount };
+    BootStages<BootStageCount> stages;
+    stages.Done(BootAdvertising, 200);
+    stages.External(BootAdvertising);
+    stages.External(BootTime);
+    stages.Depends(BootActivity, BootTime);
+
+    std::vector<size_t> ran;
+    uint32_t now = 500;
+    for (int iteration = 0; iteration < 5 && !stages.Complete(); iteration++, now += 10) {
+      size_t stage = stages.Next();
+      if (stage != BootStageCount) {
+        ran.push_back(stage);
+        stages.Done(stage, now);
+      }
+      stages.Done(BootTime, now + 5);  // The time job, later in the iteration
+    }
+    failures += !check(ran == std::vector<size_t>({BootCues, BootActivity}), "cues, then the activity log once the time is updated");
+    failures += !check(stages.Complete() && stages.Next() == BootStageCount, "complete, nothing more to run");
+    failures += !check(stages.DoneTicks(BootAdvertising) == 200 && stages.DoneTicks(BootTime) == 505 &&
+                       stages.DoneTicks(BootCues) == 500 && stages.DoneTicks(BootActivity) == 510, "completion ticks");
+    stages.Done(BootTime, 900);
+    failures += !check(stages.DoneTicks(BootTime) == 505, "first completion kept");
+  }
+
+  // The system task loop: RunBootStage() at the top of each iteration, the time job (UpdateTime(), then BootTime done)
+  // later in it.  The first time update comes on the first iteration or is held back (e.g. messages waking the loop
+  // before the time job is due), with and without the cue stage.
+  for (uint32_t firstTime = 0; firstTime <= 40; firstTime += 10) {
+    for (int cues = 0; cues <= 1; cues++) {
+      enum BootStage : size_t { BootAdvertising, BootTime, BootCues, BootActivity, BootStageCount };
+      enum Job : size_t { JobTime, JobCount };
+      BootStages<BootStageCount> stages;
+      JobScheduler<JobCount> jobs;
+      stages.External(BootAdvertising);
+      stages.External(BootTime);
+      stages.Depends(BootActivity, BootTime);
+      stages.Done(BootAdvertising, 0);
+      if (!cues) stages.Done(BootCues, 0);
+      jobs.Schedule(JobTime, firstTime);
+
+      int timeUpdates = 0;
+      int activityAfterUpdates = -1;
+      uint32_t activityTick = 0, timeTick = 0;
+      for (uint32_t now = 0; now < 100 && !stages.Complete(); now += 5) {
+        size_t stage = stages.Next();
+        if (stage == BootActivity) {
+          activityAfterUpdates = timeUpdates;
+          activityTick = now;
+        }
+        if (stage != BootStageCount) stages.Done(stage, now);
+        if (jobs.Due(JobTime, now)) {
+          if (timeUpdates++ == 0) timeTick = now;
+          stages.Done(BootTime, now);
+          jobs.Schedule(JobTime, now + 20);
+        }
+      }
+      char name[80];
+      snprintf(name, sizeof(name), "activity log after the first time update (at %u, %s cues)", (unsigned)firstTime, cues ? "with" : "no");
+      failures += !check(stages.Complete() && activityAfterUpdates >= 1 && activityTick == timeTick + 5, name);
+    }
+  }
+
+  // Dependencies declared out of order, a chain and a fan-in, externals never run
+  {
+    BootStages<5> stages;
+    stages.Depends(0, 3);
+    stages.Depends(3, 1);
+    stages.Depends(2, 1);
+    stages.Depends(2, 4);
+    stages.External(4);
+    std::vector<size_t> ran;
+    for (int i = 0; i < 10; i++) {
+      size_t stage = stages.Next();
+      if (stage == 5) break;
+      ran.push_back(stage);
+      stages.Done(stage, i);
+    }
+    failures += !check(ran == std::vector<size_t>({1, 3, 0}) && !stages.Complete(), "waits for an external stage");
+    stages.Done(4, 20);
+    failures += !check(stages.Next() == 2, "runs once the external stage completes");
+    stages.Done(2, 21);
+    failures += !check(stages.Complete(), "complete");
+  }
+
+  // A cycle never becomes ready
+  {
+    BootStages<2> stages;
+    stages.Depends(0, 1);
+    stages.Depends(1, 0);
+    failures += !check(stages.Next() == 2 && !stages.Complete(), "cycle not run");
+  }
+
+  // All 32 stages
+  {
+    BootStages<32> stages;
+    for (size_t stage = 1; stage < 32; stage++) stages.Depends(stage, stage - 1);
+    size_t count = 0;
+    for (size_t stage; (stage = stages.Next()) != 32; count++) stages.Done(stage, count);
+    failures += !check(count == 32 && stages.Complete() && stages.DoneTicks(31) == 31, "32 stages in order");
+  }
+
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace System {
+
+    // Deadlines (in ticks, wrapping) for the system task's periodic jobs, so that its loop can block on the message queue
+    // until the earliest job is due, and each job runs at its own cadence rather than on every loop iteration.
+    // Kept free of RTOS dependencies so it can be tested on the host (see JobSchedulerTest.cpp).
+    template <size_t N> class JobScheduler {
+    public:
+      // Job is due at the given tick -- with some slack, it can wait for another wake-up up to that many ticks later
+      void Schedule(size_t job, uint32_t at, uint32_t slack = 0) {
+        deadline[job] = at;
+        latest[job] = at + slack;
+        scheduled[job] = true;
+      }
+
+      // Job is due by the given tick (unless already due sooner)
+      void ScheduleBy(size_t job, uint32_t at) {
+        if (!scheduled[job] || (int32_t)(at - latest[job]) < 0) Schedule(job, at);
+      }
+
+      void Cancel(size_t job) {
+        scheduled[job] = false;
+      }
+
+      bool IsScheduled(size_t job) const {
+        return scheduled[job];
+      }
+
+      // Whether the job is due -- if so, it is no longer scheduled (the job reschedules itself as required)
+      bool Due(size_t job, uint32_t now) {
+        if (!scheduled[job] || (int32_t)(now - deadline[job]) < 0) return false;
+        scheduled[job] = false;
+        runs++;
+        return true;
+      }
+
+      // Longest the caller may wait before it must run a job (up to the given maximum)
+      uint32_t WaitTicks(uint32_t now, uint32_t maximum) const {
+        uint32_t wait = maximum;
+        for (size_t job = 0; job < N; job++) {
+          if (!scheduled[job]) continue;
+          int32_t remaining = (int32_t)(latest[job] - now);
+          if (remaining <= 0) return 0;
+          if ((uint32_t)remaining < wait) wait = (uint32_t)remaining;
+        }
+        return wait;
+      }
+
+      uint32_t runs = 0;  // (Debug) Jobs run
+
+    private:
+      uint32_t deadline[N] = {};
+      uint32_t latest[N] = {};
+      bool scheduled[N] = {};
+    };
+  }
+}
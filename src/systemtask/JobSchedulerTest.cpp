@@ -0,0 +1,227 @@
+// Host test: JobScheduler deadlines (slack, bringing a job forward, cancelling, tick wrap), the motion job after a full
+// FIFO read, and a simulation of the system task loop -- the original (wakes at least every 100 ticks and runs every job)
+// against the scheduled loop (blocks until the next job is due) -- with random messages, checking both see each second
+// and each accelerometer poll exactly once (and start BLE discovery and the delayed services), and counting the
+// wake-ups and time-job runs per minute.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+
+#include "JobScheduler.h"
+#include "../components/motion/FifoScheduler.h"
+
+using namespace Pinetime::System;
+
+#define HZ 1024
+#define POLL_RATE 10                    // CUEBAND_FIFO_POLL_RATE
+#define DELAY_START (5 * HZ)
+#define DISCOVERY_DELAY (5 * 100)
+#define TIME_SLACK 128
+
+static bool check(bool ok, const char *name) {
+  printf("%s: %s\n", ok ? "OK" : "FAIL", name);
+  return ok;
+}
+
+struct Scenario {
+  const char *name;
+  bool awake;
+  bool sampling;
+};
+
+struct Output {
+  std::vector<uint32_t> seconds;        // Seconds seen by the 1 Hz events
+  std::vector<uint32_t> polls;          // Poll indices sampled
+  std::vector<uint32_t> discoveries;    // Ticks BLE discovery started
+  int starts = 0;                       // Delayed service starts
+  uint32_t maxSecondLatency = 0;        // Ticks from a second boundary to the 1 Hz events seeing it
+  unsigned int wakeups = 0;
+  unsigned int timeRuns = 0;
+};
+
+// Random messages (about one every 3 s), the first being a BLE connection
+static std::vector<uint32_t> messages(uint32_t duration, unsigned int seed) {
+  std::vector<uint32_t> at;
+  srand(seed);
+  for (uint32_t t = 2000; t < duration; t += 1 + rand() % (6 * HZ)) at.push_back(t);
+  return at;
+}
+
+// Time as DateTime::UpdateTime(): whole seconds since the phase
+static uint32_t seconds(uint32_t t, uint32_t phase) {
+  return (t - phase) / HZ;
+}
+
+static void events(Output &out, uint32_t t, uint32_t second, uint32_t phase, uint32_t *lastSecond) {
+  if (second == *lastSecond) return;
+  out.seconds.push_back(second);
+  uint32_t latency = t - (phase + second * HZ);
+  if (latency > out.maxSecondLatency) out.maxSecondLatency = latency;
+  *lastSecond = second;
+}
+
+static void motion(Output &out, const Scenario &s, uint32_t t, uint32_t *lastIndex) {
+  if (!s.sampling) return;
+  uint32_t index = (uint32_t)((uint64_t)t * POLL_RATE / HZ);
+  if (index != *lastIndex) {
+    out.polls.push_back(index);
+    *lastIndex = index;
+  }
+}
+
+// Original loop: UpdateMotion(), delayed start count, wait for a message (up to 100 ticks), discovery count, update time
+static Output original(const Scenario &s, uint32_t duration, uint32_t phase, const std::vector<uint32_t> &msgs) {
+  Output out;
+  uint32_t t = 0, lastIndex = 0, lastSecond = 0, second = 0;
+  int delayStart = DELAY_START / 100;
+  bool discovery = false;
+  int discoveryTimer = 0;
+  size_t next = 0;
+  while (t < duration) {
+    motion(out, s, t, &lastIndex);
+    if (delayStart != 0 && --delayStart == 0) out.starts++;
+    uint32_t wake = t + 100;
+    bool message = next < msgs.size() && msgs[next] <= wake;
+    t = message ? (msgs[next] > t ? msgs[next] : t) : wake;
+    out.wakeups++;
+    if (message && next++ == 0) {
+      discovery = true;
+      discoveryTimer = 5;
+    }
+    if (discovery) {
+      if (discoveryTimer == 0) {
+        discovery = false;
+        out.discoveries.push_back(t);
+      } else {
+        discoveryTimer--;
+      }
+    }
+    out.timeRuns++;
+    if (t >= phase) second = seconds(t, phase);
+    events(out, t, second, phase, &lastSecond);
+  }
+  return out;
+}
+
+// Scheduled loop, as SystemTask::Work() with CUEBAND_JOB_SCHEDULER
+enum Job : size_t { JobMotion, JobTime, JobBleDiscovery, JobDelayStart, JobCount };
+
+static void scheduleMotion(JobScheduler<JobCount> &jobs, const Scenario &s, uint32_t now) {
+  uint32_t wait = 100;
+  if (s.sampling) {
+    uint32_t index = (uint32_t)((uint64_t)now * POLL_RATE / HZ);
+    uint32_t next = (uint32_t)(((uint64_t)(index + 1) * HZ + POLL_RATE - 1) / POLL_RATE);
+    wait = next - now;
+  }
+  if (s.awake || s.sampling) jobs.ScheduleBy(JobMotion, now + wait);
+}
+
+static Output scheduled(const Scenario &s, uint32_t duration, uint32_t phase, const std::vector<uint32_t> &msgs) {
+  Output out;
+  JobScheduler<JobCount> jobs;
+  uint32_t t = 0, lastIndex = 0, lastSecond = 0, second = 0;
+  size_t next = 0;
+  jobs.Schedule(JobMotion, t);
+  jobs.Schedule(JobTime, t);
+  jobs.Schedule(JobDelayStart, t + DELAY_START);
+  while (t < duration) {
+    if (jobs.Due(JobMotion, t)) {
+      motion(out, s, t, &lastIndex);
+      scheduleMotion(jobs, s, t);
+    }
+    if (jobs.Due(JobDelayStart, t)) out.starts++;
+    uint32_t wait = jobs.WaitTicks(t, HZ);
+    bool message = next < msgs.size() && msgs[next] <= t + wait;
+    if (message || wait > 0) out.wakeups++;  // (a zero timeout does not block)
+    t = message ? (msgs[next] > t ? msgs[next] : t) : t + wait;
+    if (message && next++ == 0) jobs.Schedule(JobBleDiscovery, t + DISCOVERY_DELAY);
+    if (jobs.Due(JobBleDiscovery, t)) out.discoveries.push_back(t);
+    if (jobs.Due(JobTime, t)) {
+      out.timeRuns++;
+      if (t >= phase) second = seconds(t, phase);
+      uint32_t elapsed = (t >= phase) ? (t - phase) % HZ : 0;
+      uint32_t ticksToNextSecond = (t >= phase) ? HZ - elapsed : phase - t;  // DateTime::TicksToNextSecond()
+      jobs.Schedule(JobTime, t + ticksToNextSecond + 1, TIME_SLACK);
+    }
+    events(out, t, second, phase, &lastSecond);
+    scheduleMotion(jobs, s, t);
+  }
+  return out;
+}
+
+static bool everyOnce(const std::vector<uint32_t> &values, uint32_t first, uint32_t last) {
+  if (values.empty() || values.front() > first + 1 || values.back() + 1 < last) return false;
+  for (size_t i = 1; i < values.size(); i++) if (values[i] != values[i - 1] + 1) return false;
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  int failures = 0;
+
+  // Scheduler basics
+  {
+    JobScheduler<3> jobs;
+    const uint32_t now = 0xffffff00;  // Deadlines wrap
+    failures += !check(jobs.WaitTicks(now, 1000) == 1000 && !jobs.Due(0, now), "nothing scheduled: wait the maximum");
+    jobs.Schedule(0, now + 300);
+    jobs.Schedule(1, now + 200, 150);
+    failures += !check(jobs.WaitTicks(now, 1000) == 300 - 0 - 0 && jobs.WaitTicks(now + 100, 1000) == 200, "wait until the earliest latest-deadline");
+    failures += !check(!jobs.Due(1, now + 199) && jobs.Due(1, now + 200) && !jobs.IsScheduled(1), "due once from its deadline (across the wrap)");
+    jobs.ScheduleBy(0, now + 400);
+    failures += !check(jobs.WaitTicks(now, 1000) == 300, "ScheduleBy does not delay");
+    jobs.ScheduleBy(0, now + 50);
+    failures += !check(jobs.WaitTicks(now, 1000) == 50, "ScheduleBy brings forward");
+    jobs.Schedule(2, now - 10);
+    failures += !check(jobs.WaitTicks(now, 1000) == 0, "overdue: no wait");
+    jobs.Cancel(2);
+    jobs.Cancel(0);
+    failures += !check(jobs.WaitTicks(now, 1000) == 1000 && !jobs.Due(2, now), "cancelled");
+  }
+
+  // Motion job while asleep with the FIFO watermark, as SystemTask::ScheduleMotion(): after a full read it is due again
+  // straight away (the FIFO may still be above the watermark, with no new interrupt edge), otherwise at the fallback timeout
+  {
+    JobScheduler<JobCount> jobs;
+    Pinetime::Controllers::FifoScheduler fifo(HZ);
+    const uint32_t now = 5000;
+    fifo.Drained(now, true);
+    jobs.ScheduleBy(JobMotion, now + fifo.WaitTicks(now));
+    failures += !check(jobs.WaitTicks(now, HZ) == 0 && jobs.Due(JobMotion, now) && fifo.ShouldDrain(now), "full FIFO read: drain again immediately");
+    fifo.Drained(now, false);
+    jobs.ScheduleBy(JobMotion, now + fifo.WaitTicks(now));
+    failures += !check(jobs.WaitTicks(now, 2 * HZ) == HZ && !jobs.Due(JobMotion, now + HZ - 1) && jobs.Due(JobMotion, now + HZ), "partial read: wait for the interrupt or the timeout");
+  }
+
+  // Loop simulation
+  const uint32_t duration = 10 * 60 * HZ;
+  const Scenario scenarios[] = {
+    {"awake, sampling", true, true},
+    {"asleep, sampling", false, true},
+    {"asleep, not sampling", false, false},
+  };
+  for (const Scenario &s : scenarios) {
+    const uint32_t phase = 371;  // Second boundaries are not aligned with the tick count
+    std::vector<uint32_t> msgs = messages(duration, 3);
+    Output a = original(s, duration, phase, msgs);
+    Output b = scheduled(s, duration, phase, msgs);
+    const uint32_t lastSecond = seconds(duration - TIME_SLACK - 1, phase) - 1;
+    // (the loops stop at different points: compare the seconds up to the last both cover)
+    while (!a.seconds.empty() && a.seconds.back() > lastSecond) a.seconds.pop_back();
+    while (!b.seconds.empty() && b.seconds.back() > lastSecond) b.seconds.pop_back();
+    bool same = a.seconds == b.seconds && a.polls == b.polls && a.starts == 1 && b.starts == 1;
+    same = same && everyOnce(b.seconds, 0, lastSecond) && (!s.sampling || everyOnce(b.polls, 0, duration * POLL_RATE / HZ - 1));
+    same = same && a.discoveries.size() == 1 && b.discoveries.size() == 1 && b.discoveries[0] - msgs[0] >= DISCOVERY_DELAY;
+    printf("    %s: wake-ups/min %.1f -> %.1f, time job runs/min %.1f -> %.1f, second latency (ticks) %u -> %u\n", s.name,
+           a.wakeups / 10.0, b.wakeups / 10.0, a.timeRuns / 10.0, b.timeRuns / 10.0, a.maxSecondLatency, b.maxSecondLatency);
+    char name[80];
+    snprintf(name, sizeof(name), "%s: same outputs", s.name);
+    failures += !check(same, name);
+    snprintf(name, sizeof(name), "%s: fewer wake-ups and time job runs", s.name);
+    failures += !check(b.wakeups < a.wakeups && b.timeRuns * 5 < a.timeRuns && b.maxSecondLatency <= TIME_SLACK + 1, name);
+  }
+
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures ? 1 : 0;
+}
@@ -6,6 +6,12 @@
   #include <nrf_log.h>
 
 void Pinetime::System::SystemMonitor::Process() {
+#ifdef CUEBAND_TASK_PROFILE
+  if (profile.samples == 0 || xTaskGetTickCount() - lastProfileTick >= CUEBAND_TASK_PROFILE_INTERVAL * configTICK_RATE_HZ) {
+    ProfileSample();
+    lastProfileTick = xTaskGetTickCount();
+  }
+#endif
   if (xTaskGetTickCount() - lastTick > 10000) {
     NRF_LOG_INFO("---------------------------------------\nFree heap : %d", xPortGetFreeHeapSize());
     TaskStatus_t tasksStatus[10];
@@ -25,3 +31,29 @@ void Pinetime::System::SystemMonitor::Process() {
 void Pinetime::System::SystemMonitor::Process() {
 }
 #endif
+
+#ifdef CUEBAND_TASK_PROFILE
+#if configUSE_TRACE_FACILITY != 1 || configGENERATE_RUN_TIME_STATS != 1
+  #error "CUEBAND_TASK_PROFILE requires configUSE_TRACE_FACILITY and configGENERATE_RUN_TIME_STATS"
+#endif
+void Pinetime::System::SystemMonitor::ProfileSample() {
+  // Static rather than on the caller's (MAIN) stack
+  static TaskStatus_t tasksStatus[TASK_PROFILE_MAX_TASKS];
+  static task_profile_sample_t samples[TASK_PROFILE_MAX_TASKS];
+  uint32_t totalRunTime = 0;
+  auto nb = uxTaskGetSystemState(tasksStatus, TASK_PROFILE_MAX_TASKS, &totalRunTime);
+  for (uint32_t i = 0; i < nb; i++) {
+    samples[i].name = tasksStatus[i].pcTaskName;
+    samples[i].number = tasksStatus[i].xTaskNumber;
+    samples[i].runTime = tasksStatus[i].ulRunTimeCounter;
+    samples[i].stackFree = tasksStatus[i].usStackHighWaterMark;
+  }
+  task_profile_sample(&profile, samples, nb, totalRunTime, xPortGetFreeHeapSize(), xPortGetMinimumEverFreeHeapSize());
+}
+
+size_t Pinetime::System::SystemMonitor::ProfileRecord(uint8_t* buffer, size_t size) {
+  ProfileSample();
+  lastProfileTick = xTaskGetTickCount();
+  return task_profile_record(&profile, buffer, size);
+}
+#endif
@@ -1,15 +1,29 @@
 #pragma once
+#include "cueband.h"
 #include <FreeRTOS.h> // declares configUSE_TRACE_FACILITY
 #include <task.h>
+#ifdef CUEBAND_TASK_PROFILE
+#include "components/profile/taskprofile.h"
+#endif
 
 namespace Pinetime {
   namespace System {
     class SystemMonitor {
     public:
       void Process();
+#ifdef CUEBAND_TASK_PROFILE
+      const task_profile_t& Profile() const { return profile; }
+      size_t ProfileRecord(uint8_t* buffer, size_t size);   // Record of the period since the last record
+#endif
 #if configUSE_TRACE_FACILITY == 1
     private:
       mutable TickType_t lastTick = 0;
+#endif
+#ifdef CUEBAND_TASK_PROFILE
+    private:
+      void ProfileSample();
+      task_profile_t profile = {};
+      TickType_t lastProfileTick = 0;
 #endif
     };
   }
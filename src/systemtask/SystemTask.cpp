@@ -159,6 +159,9 @@ void SystemTask::Work() {
   fs.Init();
 
   nimbleController.Init();
+#ifdef CUEBAND_BOOT_STAGES
+  bootStages.Done(BootAdvertising, xTaskGetTickCount());  // (Init() starts advertising)
+#endif
   lcd.Init();
 
   twiMaster.Init();
@@ -221,6 +224,14 @@ void SystemTask::Work() {
   nrfx_gpiote_in_init(PinMap::PowerPresent, &pinConfig, nrfx_gpiote_evt_handler);
   nrfx_gpiote_in_event_enable(PinMap::PowerPresent, true);
 
+#ifdef CUEBAND_FIFO_WATERMARK
+  // Accelerometer FIFO watermark
+  pinConfig.sense = NRF_GPIOTE_POLARITY_LOTOHI;
+  pinConfig.pull = NRF_GPIO_PIN_NOPULL;
+  nrfx_gpiote_in_init(PinMap::Bma421Irq, &pinConfig, nrfx_gpiote_evt_handler);
+  nrfx_gpiote_in_event_enable(PinMap::Bma421Irq, true);
+#endif
+
   batteryController.MeasureVoltage();
 
   idleTimer = xTimerCreate("idleTimer", pdMS_TO_TICKS(2000), pdFALSE, this, IdleTimerCallback);
@@ -255,16 +266,60 @@ void SystemTask::Work() {
 
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "EndlessLoop"
+#ifdef CUEBAND_JOB_SCHEDULER
+  {
+    TickType_t start = xTaskGetTickCount();
+    jobs.Schedule(JobMotion, start);
+    jobs.Schedule(JobTime, start);
+#if (defined(CUEBAND_CUE_ENABLED) || defined(CUEBAND_ACTIVITY_ENABLED)) && !defined(CUEBAND_BOOT_STAGES)
+    jobs.Schedule(JobDelayStart, start + pdMS_TO_TICKS(CUEBAND_DELAY_START));
+#endif
+  }
+#endif
+#ifdef CUEBAND_BOOT_STAGES
+  // Each service starts as soon as what it needs is ready, one stage per loop iteration, rather than after a fixed delay
+  bootStages.External(BootAdvertising);
+  bootStages.External(BootTime);
+  bootStages.Depends(BootActivity, BootTime);  // Blocks are stamped with the current time
+#ifndef CUEBAND_CUE_ENABLED
+  bootStages.Done(BootCues, xTaskGetTickCount());
+#endif
+#ifndef CUEBAND_ACTIVITY_ENABLED
+  bootStages.Done(BootActivity, xTaskGetTickCount());
+#endif
+#endif
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+  energy_init(&energy, nullptr);
+#endif
   while (true) {
+#ifdef CUEBAND_JOB_SCHEDULER
+    if (jobs.Due(JobMotion, xTaskGetTickCount())) {
+#ifdef CUEBAND_TRACK_MOTOR_TIMES
+      dateTimeController.UpdateTime(nrf_rtc_counter_get(portNRF_RTC_REG));  // Motor masking compares sample times with Uptime1024()
+#endif
+      UpdateMotion();
+      ScheduleMotion(xTaskGetTickCount());
+    }
+#else
     UpdateMotion();
+#endif
 
 
+#ifdef CUEBAND_BOOT_STAGES
+    RunBootStage();
+#else
   // Start these additional services after a short delay
 #if defined(CUEBAND_CUE_ENABLED) || defined(CUEBAND_ACTIVITY_ENABLED) 
+    bool startServices = false;
+#ifdef CUEBAND_JOB_SCHEDULER
+    startServices = jobs.Due(JobDelayStart, xTaskGetTickCount());
+#else
     if (delayStart != 0) {
       delayStart--;
-      if (delayStart == 0) {  //if (dateTimeController.Uptime().count() > delayStart) {
-          //delayStart = 0;
+      startServices = (delayStart == 0);
+    }
+#endif
+    if (startServices) {
 #ifdef CUEBAND_ACTIVITY_ENABLED
           uint8_t accelerometerInfo = 0x00;
 
@@ -280,17 +335,32 @@ void SystemTask::Work() {
 #ifdef CUEBAND_CUE_ENABLED
           cueController.Init();
 #endif
-        }
     }
+#endif
 #endif
 
     uint8_t msg;
-    if (xQueueReceive(systemTasksMsgQueue, &msg, 
-#ifdef CUEBAND_FAST_LOOP_IF_REQUIRED
-      nimbleController.IsSending() ? 50 :
+#ifdef CUEBAND_JOB_SCHEDULER
+    // Block until a message arrives or the next job is due (the time job is always scheduled, so within a second)
+    TickType_t queueTimeout = jobs.WaitTicks(xTaskGetTickCount(), configTICK_RATE_HZ);
+#else
+    TickType_t queueTimeout = 100;
+#endif
+#if defined(CUEBAND_FAST_LOOP_IF_REQUIRED) && !defined(CUEBAND_JOB_SCHEDULER)
+    if (nimbleController.IsSending()) queueTimeout = 50;
 #endif
-      100
-    )) {
+#ifdef CUEBAND_BOOT_STAGES
+    if (bootStages.Next() != BootStageCount) queueTimeout = 0;  // Only handle any waiting messages before the next stage
+#endif
+#if defined(CUEBAND_FIFO_WATERMARK) && !defined(CUEBAND_JOB_SCHEDULER)
+    // While asleep and only sampling, block until the FIFO watermark interrupt (or the fallback timeout) rather than polling
+    if (queueTimeout == 100 && state == SystemTaskState::Sleeping && IsSampling() &&
+        !(settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) ||
+          settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::Shake))) {
+      queueTimeout = fifoScheduler.WaitTicks(xTaskGetTickCount());
+    }
+#endif
+    if (xQueueReceive(systemTasksMsgQueue, &msg, queueTimeout)) {
 
       Messages message = static_cast<Messages>(msg);
       switch (message) {
@@ -362,6 +432,9 @@ void SystemTask::Work() {
           }
           break;
         case Messages::OnNewNotification:
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+          energyCounters[ENERGY_NOTIFY]++;
+#endif
           if (settingsController.GetNotificationStatus() == Pinetime::Controllers::Settings::Notification::ON) {
             if (state == SystemTaskState::Sleeping) {
               GoToRunning();
@@ -390,8 +463,12 @@ void SystemTask::Work() {
           break;
         case Messages::BleConnected:
           ReloadIdleTimer();
+#ifdef CUEBAND_JOB_SCHEDULER
+          jobs.Schedule(JobBleDiscovery, xTaskGetTickCount() + bleDiscoveryDelay);
+#else
           isBleDiscoveryTimerRunning = true;
           bleDiscoveryTimer = 5;
+#endif
           break;
         case Messages::BleFirmwareUpdateStarted:
           doNotGoToSleep = true;
@@ -522,6 +599,14 @@ void SystemTask::Work() {
             nimbleController.DisableRadio();
           }
           break;
+#ifdef CUEBAND_FIFO_WATERMARK
+        case Messages::OnMotionInterrupt:
+          // FIFO is drained by UpdateMotion() at the top of the loop
+#ifdef CUEBAND_JOB_SCHEDULER
+          jobs.Schedule(JobMotion, xTaskGetTickCount());
+#endif
+          break;
+#endif
         default:
           break;
       }
@@ -532,11 +617,36 @@ void SystemTask::Work() {
     // ...if the disconnect occurs within 5 iterations of the loop (not really "seconds" as described?), StartDiscovery() will still be called.
     // This patch prevents that from happening -- but it might've been harmless anyway when it's not connected.
     // Not sure where the delay value comes from anyway, but I don't think it sounds robust -- perhaps there's a way to wait until the central has finished discovery.
+#ifdef CUEBAND_JOB_SCHEDULER
+    if (!bleController.IsConnected()) {
+      jobs.Cancel(JobBleDiscovery);
+    }
+#else
     if (isBleDiscoveryTimerRunning && !bleController.IsConnected()) {
       isBleDiscoveryTimerRunning = false;
     }
 #endif
+#endif
 
+#ifdef CUEBAND_JOB_SCHEDULER
+    if (jobs.Due(JobBleDiscovery, xTaskGetTickCount())) {
+      nimbleController.StartDiscovery();
+    }
+
+    // Once a second, just after the time changes (or on another wake-up within the slack after that), so the 1 Hz events
+    // below see each second
+    TickType_t timeTick = xTaskGetTickCount();
+    if (jobs.Due(JobTime, timeTick)) {
+      uint32_t systick_counter = nrf_rtc_counter_get(portNRF_RTC_REG);
+      dateTimeController.UpdateTime(systick_counter);
+      jobs.Schedule(JobTime, timeTick + dateTimeController.TicksToNextSecond(systick_counter) + 1, timeSlack);
+#ifdef CUEBAND_BOOT_STAGES
+      bootStages.Done(BootTime, timeTick);
+#endif
+      monitor.Process();
+      NoInit_BackUpTime = dateTimeController.CurrentDateTime();
+    }
+#else
     if (isBleDiscoveryTimerRunning) {
       if (bleDiscoveryTimer == 0) {
         isBleDiscoveryTimerRunning = false;
@@ -552,6 +662,10 @@ void SystemTask::Work() {
     uint32_t systick_counter = nrf_rtc_counter_get(portNRF_RTC_REG);
     dateTimeController.UpdateTime(systick_counter);
     NoInit_BackUpTime = dateTimeController.CurrentDateTime();
+#ifdef CUEBAND_BOOT_STAGES
+    bootStages.Done(BootTime, xTaskGetTickCount());
+#endif
+#endif
 
     // [cueband] 1 Hz events
     [[maybe_unused]] uint32_t now = std::chrono::duration_cast<std::chrono::seconds>(dateTimeController.CurrentDateTime().time_since_epoch()).count();
@@ -640,6 +754,16 @@ void SystemTask::Work() {
       // Sensor values
       activityController.SensorValues(lastBattery, lastTemperature);
 
+#ifdef CUEBAND_TASK_PROFILE_RECORD
+      // Daily task profile record (written into the log at the next block boundary)
+      if (xTaskGetTickCount() - profileRecordTick >= 24 * 60 * 60 * configTICK_RATE_HZ) {
+        static uint8_t record[TASK_PROFILE_RECORD_MAX];
+        size_t length = monitor.ProfileRecord(record, sizeof(record));
+        activityController.QueueRecord(CUEBAND_FORMAT_RECORD_TASK_PROFILE, record, length);
+        profileRecordTick = xTaskGetTickCount();
+      }
+#endif
+
       // Record the time as changed (may start a new epoch)
       activityController.TimeChanged(now);
 
@@ -654,9 +778,43 @@ void SystemTask::Work() {
 #endif
 #endif
 
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+    // Keyed on uptime (unaffected by setting the time, and the loop may not run every second while asleep)
+    uint32_t energyUptime = dateTimeController.Uptime().count();
+    if (energyUptime != energyLastUptime) {
+      // Seconds each subsystem was active, crediting the whole interval since the last pass to the current state
+      uint32_t elapsed = energyUptime - energyLastUptime;
+      if (state == SystemTaskState::Running) energyCounters[ENERGY_SCREEN] += elapsed;
+      if (heartRateApp.IsSensorEnabled()) energyCounters[ENERGY_HR] += elapsed;
+      if (bleController.IsConnected()) energyCounters[ENERGY_BLE] += elapsed;
+      energyLastUptime = energyUptime;
+
+      // Epochs by uptime, the first only taking the reference
+      if (!energy.started || energyUptime - energyEpochStart >= CUEBAND_ENERGY_EPOCH) {
+        energyCounters[ENERGY_BASE] = energyUptime;
+        energyCounters[ENERGY_MOTOR] = motorController.OnTimeMs();
+        energy_epoch(&energy, energyCounters);
+        energyEpochStart = energyUptime;
+#ifdef CUEBAND_ENERGY_RECORD
+        // Daily energy summary record (written into the log at the next block boundary)
+        if (energy.epochs >= 24 * 60 * 60 / CUEBAND_ENERGY_EPOCH) {
+          static_assert(ENERGY_RECORD_MAX <= ACTIVITY_RECORD_MAX, "Energy record exceeds the activity log record size");
+          static uint8_t record[ENERGY_RECORD_MAX];
+          size_t length = energy_record(&energy, record, sizeof(record));
+          activityController.QueueRecord(CUEBAND_FORMAT_RECORD_ENERGY, record, length);
+        }
+#endif
+      }
+    }
+#endif
+
     if (!nrf_gpio_pin_read(PinMap::Button)) {
       watchdog.Kick();
     }
+#ifdef CUEBAND_JOB_SCHEDULER
+    // Motion cadence depends on the current state (which messages may have changed)
+    ScheduleMotion(xTaskGetTickCount());
+#endif
 #ifdef CUEBAND_PREVENT_ACCIDENTAL_RECOVERY_MODE
     {  // Make it trickier to accidentally wipe the firmware by holding the button while worn (risky)
       // The original logic above is unchanged: always reset the watchdog timer while the button is released.
@@ -740,6 +898,14 @@ void SystemTask::UpdateMotion() {
   bool sampleNow = false;
   if (IsSampling()) {
     auto now = xTaskGetTickCount();
+#if defined(CUEBAND_FIFO_WATERMARK)
+    // Drain on the watermark interrupt or the fallback timeout
+    if (fifoScheduler.ShouldDrain(now)) {
+#ifdef CUEBAND_ACTIVITY_ENABLED
+      sampleNow = true;
+#endif
+    }
+#else
 #if defined(CUEBAND_FIFO_ENABLED)
     uint32_t currTickIndex = (uint32_t)((uint64_t)now * CUEBAND_FIFO_POLL_RATE / configTICK_RATE_HZ);
 #elif defined(CUEBAND_POLLED_ENABLED)
@@ -752,6 +918,7 @@ void SystemTask::UpdateMotion() {
       // Remember last polled tick
       samplingTickIndex = currTickIndex;
     }
+#endif
   }
 #endif
 
@@ -772,6 +939,9 @@ if (!sampleNow)   // While using polled sampling, do not consider returning earl
   }
 
   auto motionValues = motionSensor.Process();
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+  energyCounters[ENERGY_ACCEL]++;
+#endif
 
   motionController.IsSensorOk(motionSensor.IsOk());
 
@@ -782,6 +952,12 @@ if (!sampleNow)   // While using polled sampling, do not consider returning earl
   motionSensor.GetBufferData(&accelValues, &lastCount, &totalSamples);
   motionController.SetBufferData(accelValues, lastCount, totalSamples);
 
+#ifdef CUEBAND_FIFO_WATERMARK
+  // Clear a latched watermark interrupt and restart the fallback timeout (a full read may have left more data in the FIFO)
+  if (fifoScheduler.IsPending()) motionSensor.ClearInterrupt();
+  fifoScheduler.Drained(xTaskGetTickCount(), lastCount >= CUEBAND_SAMPLE_MAX);
+#endif
+
 #ifdef CUEBAND_ACTIVITY_ENABLED
   activityController.AddSamples(motionController);
 #endif
@@ -846,6 +1022,74 @@ bool SystemTask::IsSampling() {
 }
 #endif
 
+#ifdef CUEBAND_BOOT_STAGES
+// Run the next start-up stage that is ready (if any)
+void SystemTask::RunBootStage() {
+  size_t stage = bootStages.Next();
+  switch (stage) {
+#ifdef CUEBAND_CUE_ENABLED
+    case BootCues:
+      cueController.Init();
+      break;
+#endif
+#ifdef CUEBAND_ACTIVITY_ENABLED
+    case BootActivity: {
+      uint8_t accelerometerInfo = 0x00;
+
+      // Bottom nibble is accelerometer type
+      if (motionController.DeviceType() == Controllers::MotionController::DeviceTypes::BMA421) accelerometerInfo |= 0x01;
+      if (motionController.DeviceType() == Controllers::MotionController::DeviceTypes::BMA425) accelerometerInfo |= 0x05;
+
+      uint32_t now = std::chrono::duration_cast<std::chrono::seconds>(dateTimeController.CurrentDateTime().time_since_epoch()).count();
+      activityController.Init(now, bleController.Address(), accelerometerInfo);
+      break;
+    }
+#endif
+    default:
+      return;
+  }
+  bootStages.Done(stage, xTaskGetTickCount());
+  NRF_LOG_INFO("Boot stage %d done at %d ms", (int)stage, (int)BootStageMs((BootStage)stage));
+}
+#endif
+
+#ifdef CUEBAND_JOB_SCHEDULER
+// Schedule UpdateMotion() by when it is next needed in the current state
+void SystemTask::ScheduleMotion(TickType_t now) {
+  bool wakeMotion = settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) ||
+                    settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::Shake);
+  bool sending = false;
+#ifdef CUEBAND_FAST_LOOP_IF_REQUIRED
+  sending = nimbleController.IsSending();
+#endif
+  // Original loop rate while awake (and for raise/shake to wake), or faster while sending
+  TickType_t wait = sending ? 50 : 100;
+  bool needed = sending || state != SystemTaskState::Sleeping || wakeMotion;
+#if defined(CUEBAND_POLLED_ENABLED) || defined(CUEBAND_FIFO_ENABLED)
+  if (IsSampling()) {
+#if defined(CUEBAND_FIFO_WATERMARK)
+    // While asleep and only sampling, the watermark interrupt (or the fallback timeout), or straight away after a full read
+    if (!needed) wait = fifoScheduler.WaitTicks(now);
+#else
+    // The next poll (UpdateMotion() only samples when the poll index changes), which replaces the loop rate (it is about
+    // the same), unless sending faster
+#if defined(CUEBAND_FIFO_ENABLED)
+    const uint32_t rate = CUEBAND_FIFO_POLL_RATE;
+#elif defined(CUEBAND_POLLED_ENABLED)
+    const uint32_t rate = CUEBAND_POLLED_INPUT_RATE;
+#endif
+    uint32_t index = (uint32_t)((uint64_t)now * rate / configTICK_RATE_HZ);
+    TickType_t next = (TickType_t)(((uint64_t)(index + 1) * configTICK_RATE_HZ + rate - 1) / rate);
+    if (!sending || next - now < wait) wait = next - now;
+#endif
+    needed = true;
+  }
+#endif
+  // (Otherwise nothing to do until the state changes, which is checked after each wake-up)
+  if (needed) jobs.ScheduleBy(JobMotion, now + wait);
+}
+#endif
+
 void SystemTask::HandleButtonAction(Controllers::ButtonActions action) {
 #ifdef CUEBAND_ACTIVITY_ENABLED
   interactionCount++;
@@ -888,6 +1132,13 @@ void SystemTask::GoToRunning() {
   }
 }
 
+#ifdef CUEBAND_FIFO_WATERMARK
+void SystemTask::OnMotionInterrupt() {
+  fifoScheduler.Interrupt();
+  PushMessage(Messages::OnMotionInterrupt);
+}
+#endif
+
 void SystemTask::OnTouchEvent() {
 #ifdef CUEBAND_ACTIVITY_ENABLED
   interactionCount++;
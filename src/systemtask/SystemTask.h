@@ -17,8 +17,11 @@
 #include <drivers/Bma421.h>
 #include <drivers/PinMap.h>
 #include <components/motion/MotionController.h>
+#include "components/motion/FifoScheduler.h"
 
 #include "systemtask/SystemMonitor.h"
+#include "systemtask/JobScheduler.h"
+#include "systemtask/BootStages.h"
 #include "components/ble/NimbleController.h"
 #include "components/ble/NotificationManager.h"
 #include "components/motor/MotorController.h"
@@ -35,6 +38,9 @@
 #ifdef CUEBAND_CUE_ENABLED
 #include "components/cue/CueController.h"
 #endif
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+#include "components/energy/energyaccount.h"
+#endif
 #if defined(CUEBAND_INFO_APP_ENABLED)
 #include "components/battery/BatteryController.h"
 #endif
@@ -106,6 +112,9 @@ namespace Pinetime {
       void PushMessage(Messages msg);
 
       void OnTouchEvent();
+#ifdef CUEBAND_FIFO_WATERMARK
+      void OnMotionInterrupt();
+#endif
 
       void OnIdle();
       void OnDim();
@@ -152,6 +161,30 @@ namespace Pinetime {
             return motorController;
       }
 #endif
+#ifdef CUEBAND_TASK_PROFILE
+      SystemMonitor& GetMonitor() { return monitor; }
+#endif
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+      const energy_account_t& GetEnergy() const { return energy; }
+#endif
+#ifdef CUEBAND_BOOT_STAGES
+      // Start-up of the cue.band services: advertising and the first time update (external), reading the cue schedule,
+      // and the activity log (scan of the existing blocks)
+      enum BootStage : size_t { BootAdvertising, BootTime, BootCues, BootActivity, BootStageCount };
+      // Milliseconds from main() to the scheduler start, where the tick count (and so the stage times) starts from zero.
+      // Set by main(), timed by the cycle counter: nothing else runs that early (the LF clock is started by main()).
+      void SetBootSchedulerMs(uint32_t ms) {
+        bootSchedulerMs = ms;
+      }
+      uint32_t BootSchedulerMs() const {
+        return bootSchedulerMs;
+      }
+      // Milliseconds from main() the stage completed (0 if not yet done)
+      uint32_t BootStageMs(BootStage stage) const {
+        if (!bootStages.IsDone(stage)) return 0;
+        return bootSchedulerMs + (uint32_t)((uint64_t)bootStages.DoneTicks(stage) * 1000 / configTICK_RATE_HZ);
+      }
+#endif
 #ifdef CUEBAND_PREVENT_ACCIDENTAL_RECOVERY_MODE
       volatile bool resetPreventAccidentalRecovery = true;
 #endif
@@ -203,8 +236,17 @@ private: // hack
       static void Process(void* instance);
       void Work();
       void ReloadIdleTimer();
+#ifdef CUEBAND_JOB_SCHEDULER
+      // Periodic jobs of the loop in Work(), each run when due rather than on every iteration
+      enum Job : size_t { JobMotion, JobTime, JobBleDiscovery, JobDelayStart, JobCount };
+      JobScheduler<JobCount> jobs;
+      void ScheduleMotion(TickType_t now);
+      static constexpr TickType_t bleDiscoveryDelay = 5 * 100;  // (was 5 loop iterations)
+      static constexpr TickType_t timeSlack = 128;
+#else
       bool isBleDiscoveryTimerRunning = false;
       uint8_t bleDiscoveryTimer = 0;
+#endif
       TimerHandle_t dimTimer;
       TimerHandle_t idleTimer;
       TimerHandle_t measureBatteryTimer;
@@ -220,8 +262,13 @@ private: // hack
       bool stepCounterMustBeReset = false;
       static constexpr TickType_t batteryMeasurementPeriod = pdMS_TO_TICKS(10 * 60 * 1000);
 
-#if defined(CUEBAND_CUE_ENABLED) || defined(CUEBAND_ACTIVITY_ENABLED) 
-      int delayStart = CUEBAND_DELAY_START;
+#ifdef CUEBAND_BOOT_STAGES
+      BootStages<BootStageCount> bootStages;
+      uint32_t bootSchedulerMs = 0;
+      void RunBootStage();
+#endif
+#if (defined(CUEBAND_CUE_ENABLED) || defined(CUEBAND_ACTIVITY_ENABLED)) && !defined(CUEBAND_JOB_SCHEDULER) && !defined(CUEBAND_BOOT_STAGES)
+      int delayStart = pdMS_TO_TICKS(CUEBAND_DELAY_START) / 100;  // Loop iterations
 #endif
 
 #ifdef CUEBAND_CUE_ENABLED
@@ -251,11 +298,23 @@ private: // hack
 #ifdef CUEBAND_TRUSTED_CONNECTION
       uint32_t bleLastSecond = 0;
 #endif
+#ifdef CUEBAND_TASK_PROFILE_RECORD
+      TickType_t profileRecordTick = 0;
+#endif
+#ifdef CUEBAND_ENERGY_ACCOUNTING
+      energy_account_t energy;
+      uint32_t energyCounters[ENERGY_COUNT] = {};     // Usage counters (free-running)
+      uint32_t energyLastUptime = 0;                  // Uptime (seconds) the counters were last updated
+      uint32_t energyEpochStart = 0;                  // Uptime (seconds) the epoch started
+#endif
 
 #if defined(CUEBAND_POLLED_ENABLED) || defined(CUEBAND_FIFO_ENABLED)
       bool IsSampling();
       uint32_t samplingTickIndex = 0;
 #endif
+#ifdef CUEBAND_FIFO_WATERMARK
+      Pinetime::Controllers::FifoScheduler fifoScheduler {pdMS_TO_TICKS(CUEBAND_FIFO_WATERMARK_TIMEOUT)};
+#endif
 
       SystemMonitor monitor;
     };
@@ -0,0 +1,2 @@
+g++ -std=c++17 -O2 JobSchedulerTest.cpp -o ./jobschedulertest && ./jobschedulertest
+g++ -std=c++17 -O2 BootStagesTest.cpp -o ./bootstagestest && ./bootstagestest
@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+
+# Decode a downloaded device activity log (a sequence of 256-byte blocks) to CSV.
+# See "Device Activity Log Block Format" in README-cueband.md.
+
+import argparse
+import struct
+import sys
+
+BLOCK_SIZE = 256
+HEADER_SIZE = 30
+BLOCK_TYPE = 0x4441  # 'A', 'D'
+
+MICRO_EPOCH_COUNT = 12
+MICRO_EPOCH_SIZE = 4
+MACRO_EPOCH_SIZE = 74
+SUMMARY_SIZE = MACRO_EPOCH_SIZE - MICRO_EPOCH_COUNT * MICRO_EPOCH_SIZE   # 26
+
+# Record blocks (formats 0xf000 and above) hold one record after the header, its length @20 (see src/cueband.h)
+RECORD_FORMAT_MIN = 0xf000
+RECORD_FORMAT_TASK_PROFILE = 0xf001
+RECORD_FORMAT_ENERGY = 0xf002
+ENERGY_SUBSYSTEMS = ['base', 'motor', 'screen', 'hr', 'ble', 'notify', 'accel']
+
+
+def checksum_ok(block):
+    return sum(struct.unpack('<128H', block)) & 0xffff == 0
+
+
+def decode_header(block):
+    block_type, length, fmt, block_id = struct.unpack_from('<HHHI', block, 0)
+    device_id = ':'.join('%02X' % b for b in block[10:16])
+    timestamp, count, epoch_interval = struct.unpack_from('<IBB', block, 16)
+    return {
+        'type': block_type,
+        'format': fmt,
+        'block_id': block_id,
+        'device_id': device_id,
+        'timestamp': timestamp,
+        'count': count,
+        'epoch_interval': epoch_interval,
+        'configuration': block[22:26],
+        'battery': block[26],
+        'accelerometer': block[27],
+        'temperature': struct.unpack_from('<b', block, 28)[0],
+        'firmware': block[29],
+    }
+
+
+def decode_activity_sample(header, data):
+    """Format 0x0002/0x0003: 8-byte samples"""
+    events, prompts_steps, summary1, summary2 = struct.unpack('<HHHH', data)
+    row = {
+        'events': '0x%04x' % events,
+        'steps': prompts_steps & 0x3ff,
+        'snooze_muted': (prompts_steps >> 10) & 3,
+        'unworn_muted': (prompts_steps >> 12) & 3,
+        'prompts': (prompts_steps >> 14) & 3,
+        'mean_svmmo': summary2,
+    }
+    if header['format'] == 0x0003:
+        row['hr'] = summary1 & 0xff
+        row['hr_min_delta'] = (summary1 >> 8) & 0x0f
+        row['hr_max_delta'] = (summary1 >> 12) & 0x0f
+    else:
+        row['mean_filtered_svmmo'] = summary1
+    return row
+
+
+def decode_macro_epoch(header, data):
+    """Format 0x0080/0x0081: 74-byte macro epochs with 12 micro epochs"""
+    row = {}
+    if header['format'] >= 0x0081:
+        values = struct.unpack_from('<3h3H3HH', data, 0)
+        for i, axis in enumerate('xyz'):
+            row['mean_' + axis] = values[i]
+            row['sd_' + axis] = values[3 + i]
+            row['mean_abs_' + axis] = values[6 + i]
+        row['samples'] = values[9]
+        row['sleep'] = data[20]
+    micro = []
+    for i in range(MICRO_EPOCH_COUNT):
+        svmmo, bpm, steps = struct.unpack_from('<HBB', data, SUMMARY_SIZE + i * MICRO_EPOCH_SIZE)
+        micro.append({
+            'svmmo': svmmo,
+            'bpm': bpm,
+            'steps': steps & 0x1f,
+            'hr_confidence': steps >> 5,
+        })
+    return row, micro
+
+
+def decode_task_profile_record(data):
+    """Format 0xf001: daily task profile (components/profile/taskprofile.h), one row per task"""
+    period, heap_free, heap_minimum, tasks = struct.unpack_from('<IHHB', data, 0)
+    rows = []
+    for i in range(tasks):
+        offset = 9 + i * 9
+        if offset + 9 > len(data):
+            break
+        name = data[offset:offset + 3].rstrip(b'\0').decode('ascii', 'replace')
+        number, cpu, peak, stack_free = struct.unpack_from('<BHBH', data, offset + 3)
+        rows.append({
+            'period': period,
+            'heap_free': heap_free,
+            'heap_minimum': heap_minimum,
+            'task': name,
+            'task_number': number,
+            'cpu_permille': cpu,
+            'cpu_peak_percent': peak,
+            'stack_free_words': stack_free,
+        })
+    return rows
+
+
+def decode_energy_record(data):
+    """Format 0xf002: daily energy summary (components/energy/energyaccount.h), one row per subsystem"""
+    epochs, epoch_maximum, subsystems = struct.unpack_from('<IIB', data, 0)
+    rows = []
+    for i in range(subsystems):
+        offset = 9 + i * 8
+        if offset + 8 > len(data):
+            break
+        usage, charge = struct.unpack_from('<II', data, offset)
+        rows.append({
+            'epochs': epochs,
+            'epoch_maximum_uc': epoch_maximum,
+            'subsystem': ENERGY_SUBSYSTEMS[i] if i < len(ENERGY_SUBSYSTEMS) else str(i),
+            'usage': usage,
+            'charge_uc': charge,
+        })
+    return rows
+
+
+def decode_record(header, block):
+    data = block[HEADER_SIZE:HEADER_SIZE + min(header['count'], BLOCK_SIZE - HEADER_SIZE - 2)]
+    if header['format'] == RECORD_FORMAT_TASK_PROFILE:
+        return decode_task_profile_record(data)
+    if header['format'] == RECORD_FORMAT_ENERGY:
+        return decode_energy_record(data)
+    return []
+
+
+def decode(file, output, micro_epochs, records, verbose):
+    rows = []
+    index = 0
+    while True:
+        block = file.read(BLOCK_SIZE)
+        if len(block) < BLOCK_SIZE:
+            break
+        offset = index * BLOCK_SIZE
+        index += 1
+        header = decode_header(block)
+        if header['type'] != BLOCK_TYPE:
+            if verbose:
+                print('WARNING: Skipping block @%d with type 0x%04x' % (offset, header['type']), file=sys.stderr)
+            continue
+        if not checksum_ok(block):
+            print('WARNING: Skipping block @%d with invalid checksum' % offset, file=sys.stderr)
+            continue
+
+        fmt = header['format']
+        if fmt >= RECORD_FORMAT_MIN:
+            # Record blocks are not epochs: only output (instead of the epochs) with --records
+            if records:
+                base = {'time': header['timestamp'], 'block_id': header['block_id'], 'format': '0x%04x' % fmt}
+                rows.extend({**base, **row} for row in decode_record(header, block))
+            elif verbose:
+                print('NOTE: Skipping record block @%d with format 0x%04x' % (offset, fmt), file=sys.stderr)
+            continue
+        if records:
+            continue
+        sample_size = MACRO_EPOCH_SIZE if fmt >= 0x0080 else 8
+        capacity = (BLOCK_SIZE - HEADER_SIZE - 2) // sample_size
+        count = min(header['count'], capacity)
+        for i in range(count):
+            data = block[HEADER_SIZE + i * sample_size:HEADER_SIZE + (i + 1) * sample_size]
+            time = header['timestamp'] + i * header['epoch_interval']
+            base = {'time': time, 'block_id': header['block_id'], 'format': '0x%04x' % fmt}
+            if fmt >= 0x0080:
+                row, micro = decode_macro_epoch(header, data)
+                if micro_epochs:
+                    for j, m in enumerate(micro):
+                        rows.append({**base, 'time': time + j * header['epoch_interval'] // MICRO_EPOCH_COUNT, **m})
+                else:
+                    rows.append({**base, **row})
+            else:
+                rows.append({**base, **decode_activity_sample(header, data)})
+
+    columns = []
+    for row in rows:
+        for key in row:
+            if key not in columns:
+                columns.append(key)
+    output.write(','.join(columns) + '\n')
+    for row in rows:
+        output.write(','.join(str(row.get(key, '')) for key in columns) + '\n')
+    return len(rows)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode a device activity log to CSV.')
+    parser.add_argument('input', help='Activity log file (256-byte blocks)')
+    parser.add_argument('-o', '--output', help='CSV output file (default: stdout)')
+    parser.add_argument('--micro', action='store_true', help='Output the 5-second micro-epochs (formats 0x0080/0x0081) rather than the epoch summary')
+    parser.add_argument('--records', action='store_true', help='Output the record blocks (formats 0xf001 task profile, 0xf002 energy) rather than the epochs')
+    parser.add_argument('-v', '--verbose', action='store_true')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as file:
+        output = open(args.output, 'w') if args.output else sys.stdout
+        count = decode(file, output, args.micro, args.records, args.verbose)
+        if args.output:
+            output.close()
+    if args.verbose:
+        print('Decoded %d rows' % count, file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()